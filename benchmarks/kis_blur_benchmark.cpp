@@ -27,6 +27,13 @@
 #include <KisGlobalResourcesInterface.h>
 
 #include <KisPortingUtils.h>
+#include <KisSupportedArchitectures.h>
+#include <multiarch_test_util.h>
+
+#include "kis_convolution_kernel.h"
+#include "kis_convolution_worker_spatial.h"
+#include "kis_convolution_worker_spatial_vector.h"
+#include "KisConvolutionRowProcessorFactoryImpl.h"
 
 void KisBlurBenchmark::initTestCase()
 {
@@ -78,6 +85,79 @@ void KisBlurBenchmark::benchmarkFilter()
     }
 }
 
+namespace {
+
+KisConvolutionKernelSP createKernel(const QString &type)
+{
+    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> matrix;
+    qreal factor = 1.0;
+
+    if (type == "box-3x3") {
+        matrix.setOnes(3, 3);
+        factor = 9.0;
+    } else if (type == "gauss-5x5") {
+        Eigen::Matrix<qreal, 5, 1> binomial;
+        binomial << 1, 4, 6, 4, 1;
+        matrix = binomial * binomial.transpose();
+        factor = 256.0;
+    } else if (type == "sharpen-5x5") {
+        matrix.setConstant(5, 5, -1.0);
+        matrix(2, 2) = 25.0;
+    } else if (type == "gauss-1x9") {
+        matrix.resize(1, 9);
+        matrix << 1, 8, 28, 56, 70, 56, 28, 8, 1;
+        factor = 256.0;
+    }
+
+    return KisConvolutionKernel::fromMatrix(matrix, 0.0, factor);
+}
+
+}
+
+void KisBlurBenchmark::benchmarkSpatialConvolution_data()
+{
+    QTest::addColumn<QString>("worker");
+    QTest::addColumn<QString>("kernel");
+
+    const QStringList kernels = {"box-3x3", "gauss-5x5", "sharpen-5x5", "gauss-1x9"};
+
+    // the original per-pixel worker and the vectorized
+    // one compiled for every available architecture
+    QStringList workers = {"scalar"};
+    workers << KisSupportedArchitectures::availableArchNames();
+
+    Q_FOREACH (const QString &worker, workers) {
+        Q_FOREACH (const QString &kernel, kernels) {
+            QTest::addRow("%s-%s", worker.toLatin1().data(), kernel.toLatin1().data())
+                << worker << kernel;
+        }
+    }
+}
+
+void KisBlurBenchmark::benchmarkSpatialConvolution()
+{
+    QFETCH(QString, worker);
+    QFETCH(QString, kernel);
 
+    KisPaintDeviceSP dst = new KisPaintDevice(m_colorSpace);
+    KisPainter gc(dst);
+
+    QScopedPointer<KisConvolutionWorker<StandardIteratorFactory>> convolutionWorker;
+
+    if (worker == "scalar") {
+        convolutionWorker.reset(new KisConvolutionWorkerSpatial<StandardIteratorFactory>(&gc, 0));
+    } else {
+        KisConvolutionRowProcessorBase *rowProcessor =
+            TestUtil::createClassForArch<KisConvolutionRowProcessorFactoryImpl>(worker);
+        convolutionWorker.reset(new KisConvolutionWorkerSpatialVector<StandardIteratorFactory>(&gc, 0, rowProcessor));
+    }
+
+    const KisConvolutionKernelSP convolutionKernel = createKernel(kernel);
+    const QRect rect(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+
+    QBENCHMARK{
+        convolutionWorker->execute(convolutionKernel, m_device, rect.topLeft(), rect.topLeft(), rect.size(), QRect());
+    }
+}
 
 SIMPLE_TEST_MAIN(KisBlurBenchmark)
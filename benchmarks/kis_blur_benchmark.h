@@ -27,7 +27,10 @@ private Q_SLOTS:
     void cleanupTestCase();
     
     void benchmarkFilter();
-    
+
+    void benchmarkSpatialConvolution_data();
+    void benchmarkSpatialConvolution();
+
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "kis_composition_benchmark.h"
 #include <simpletest.h>
 #include <QElapsedTimer>
+#include <QScopedPointer>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOp.h>
@@ -30,6 +31,15 @@
 #include <KoCompositeOpCopy2.h>
 #include <KoOptimizedCompositeOpFactory.h>
 #include <KoAlphaDarkenParamsWrapper.h>
+#include <KoCompositeOpRegistry.h>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceBlendingPolicy.h>
+#include <KoCompositeOpGeneric.h>
+#endif
 
 // for posix_memalign()
 #include <stdlib.h>
@@ -162,6 +172,56 @@ struct RandomGenerator<double> : RandomGenerator<float>
     }
 };
 
+#ifdef HAVE_OPENEXR
+/**
+ * Every eighth value is one of the edge cases of the half
+ * conversions: zero, unit, the smallest and the largest
+ * denormals and the smallest normal value
+ */
+template <>
+struct RandomGenerator<half>
+{
+    RandomGenerator(int seed)
+        : m_smallint(0, 39),
+          m_rnd(seed)
+    {
+    }
+
+    half operator() () {
+        const int choice = m_smallint(m_rnd);
+
+        switch (choice) {
+        case 0:
+            return half(0.0f);
+        case 1:
+            return half(1.0f);
+        case 2:
+            return fromBits(0x0001);
+        case 3:
+            return fromBits(0x03ff);
+        case 4:
+            return fromBits(0x0400);
+        }
+
+        return half(m_smallfloat(m_rnd));
+    }
+
+    half unit() {
+        return KoColorSpaceMathsTraits<half>::unitValue;
+    }
+
+    static half fromBits(quint16 bits) {
+        half value;
+        value.setBits(bits);
+        return value;
+    }
+
+    boost::uniform_smallint<int> m_smallint;
+    boost::uniform_real<float> m_smallfloat;
+    boost::mt11213b m_rnd;
+};
+#endif
+
 
 template <typename channel_type>
 void generateDataLine(uint seed, int numPixels, quint8 *srcPixels, quint8 *dstPixels, quint8 *mask, AlphaRange srcAlphaRange, AlphaRange dstAlphaRange)
@@ -227,7 +287,8 @@ QVector<Tile> generateTiles(int size,
                             const int dstAlignmentShift,
                             AlphaRange srcAlphaRange,
                             AlphaRange dstAlphaRange,
-                            const quint32 pixelSize)
+                            const quint32 pixelSize,
+                            bool halfChannels = false)
 {
     QVector<Tile> tiles(size);
 
@@ -260,6 +321,10 @@ QVector<Tile> generateTiles(int size,
 
         if (pixelSize == 4) {
             generateDataLine<quint8>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#ifdef HAVE_OPENEXR
+        } else if (pixelSize == 8 && halfChannels) {
+            generateDataLine<half>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
+#endif
         } else if (pixelSize == 8) {
             generateDataLine<quint16>(1, numPixels, tiles[i].src, tiles[i].dst, tiles[i].mask, srcAlphaRange, dstAlphaRange);
         } else if (pixelSize == 16) {
@@ -364,8 +429,13 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
 {
     Q_ASSERT(op1->colorSpace()->pixelSize() == op2->colorSpace()->pixelSize());
     const quint32 pixelSize = op1->colorSpace()->pixelSize();
+#ifdef HAVE_OPENEXR
+    const bool halfChannels = op1->colorSpace()->colorDepthId() == Float16BitsColorDepthID;
+#else
+    const bool halfChannels = false;
+#endif
     const int alignment = 16;
-    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, op1->colorSpace()->pixelSize());
+    QVector<Tile> tiles = generateTiles(2, alignment, alignment, ALPHA_RANDOM, ALPHA_RANDOM, op1->colorSpace()->pixelSize(), halfChannels);
 
     KoCompositeOp::ParameterInfo params;
     params.dstRowStride  = 4 * rowStride;
@@ -392,6 +462,13 @@ bool compareTwoOps(bool haveMask, const KoCompositeOp *op1, const KoCompositeOp
     if (pixelSize == 4) {
         compareResult = compareTwoOpsPixels<quint8, Compare>(tiles, 10);
     }
+#ifdef HAVE_OPENEXR
+    else if (pixelSize == 8 && halfChannels) {
+        // the legacy ops round every intermediate value to half, so
+        // allow a few ulps around the unit value
+        compareResult = compareTwoOpsPixels<half, Compare>(tiles, half(4e-3f));
+    }
+#endif
     else if (pixelSize == 8) {
         compareResult = compareTwoOpsPixels<quint16, Compare>(tiles, 90);
     }
@@ -885,6 +962,84 @@ void KisCompositionBenchmark::compareRgbF32CopyOps()
     delete opAct;
 }
 
+#ifdef HAVE_OPENEXR
+namespace {
+
+template<half (*compositeFunc)(half, half)>
+KoCompositeOp *createLegacyOpF16(const KoColorSpace *cs, const QString &id)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, compositeFunc, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(cs, id, QString());
+}
+
+}
+#endif
+
+void KisCompositionBenchmark::compareRgbF16Ops_data()
+{
+    QTest::addColumn<QString>("id");
+    QTest::addColumn<bool>("haveMask");
+
+    const QStringList ids = {COMPOSITE_ALPHA_DARKEN, COMPOSITE_OVER, COMPOSITE_COPY,
+                             COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_ADD,
+                             COMPOSITE_SUBTRACT, COMPOSITE_DARKEN, COMPOSITE_LIGHTEN};
+
+    Q_FOREACH (const QString &id, ids) {
+        QTest::addRow("%s-mask", id.toLatin1().data()) << id << true;
+        QTest::addRow("%s-nomask", id.toLatin1().data()) << id << false;
+    }
+}
+
+void KisCompositionBenchmark::compareRgbF16Ops()
+{
+#ifdef HAVE_OPENEXR
+    QFETCH(QString, id);
+    QFETCH(bool, haveMask);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->colorSpace("RGBA", "F16", "");
+    QVERIFY(cs);
+
+    QScopedPointer<KoCompositeOp> opAct;
+    QScopedPointer<KoCompositeOp> opExp;
+
+    if (id == COMPOSITE_ALPHA_DARKEN) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs));
+        opExp.reset(new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(cs));
+    } else if (id == COMPOSITE_OVER) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createOverOpF16(cs));
+        opExp.reset(new KoCompositeOpOver<KoRgbF16Traits>(cs));
+    } else if (id == COMPOSITE_COPY) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createCopyOpF16(cs));
+        opExp.reset(new KoCompositeOpCopy2<KoRgbF16Traits>(cs));
+    } else if (id == COMPOSITE_MULT) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createMultiplyOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfMultiply<half>>(cs, id));
+    } else if (id == COMPOSITE_SCREEN) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createScreenOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfScreen<half>>(cs, id));
+    } else if (id == COMPOSITE_ADD) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createAdditionOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfAddition<half>>(cs, id));
+    } else if (id == COMPOSITE_SUBTRACT) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createSubtractOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfSubtract<half>>(cs, id));
+    } else if (id == COMPOSITE_DARKEN) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createDarkenOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfDarkenOnly<half>>(cs, id));
+    } else if (id == COMPOSITE_LIGHTEN) {
+        opAct.reset(KoOptimizedCompositeOpFactory::createLightenOpF16(cs));
+        opExp.reset(createLegacyOpF16<&cfLightenOnly<half>>(cs, id));
+    }
+
+    QVERIFY(opAct && opExp);
+
+    // the alpha of the pixels may be a denormal, so the colors are
+    // compared premultiplied to not amplify the rounding errors
+    QVERIFY(compareTwoOps<PixelEqualPremultiplied>(haveMask, opAct.data(), opExp.data()));
+#else
+    QSKIP("Krita is built without OpenEXR, RGBA F16 is not available");
+#endif
+}
+
 void KisCompositionBenchmark::testRgb8CompositeAlphaDarkenLegacy()
 {
     const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
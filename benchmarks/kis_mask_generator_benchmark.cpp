@@ -81,4 +81,109 @@ void KisMaskGeneratorBenchmark::benchmarkSquare()
     }
 }
 
+#include <KisSupportedArchitectures.h>
+#include <kis_global.h>
+#include "kis_mask_generator.h"
+#include "kis_cubic_curve.h"
+
+namespace {
+
+template<class Generator, class... Args>
+KisMaskGenerator *createGenerator(bool useScalarApplicator, Args... args)
+{
+    Generator *generator = new Generator(args...);
+
+    if (useScalarApplicator) {
+        generator->setMaskScalarApplicator();
+    }
+
+    return generator;
+}
+
+KisMaskGenerator *createGenerator(const QString &type, qreal diameter, bool useScalarApplicator)
+{
+    const KisCubicCurve curve(QString("0,1;1,0"));
+
+    if (type == "circle") {
+        return createGenerator<KisCircleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, true);
+    } else if (type == "gauss-circle") {
+        return createGenerator<KisGaussCircleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, true);
+    } else if (type == "curve-circle") {
+        return createGenerator<KisCurveCircleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, curve, true);
+    } else if (type == "rect") {
+        return createGenerator<KisRectangleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, true);
+    } else if (type == "gauss-rect") {
+        return createGenerator<KisGaussRectangleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, true);
+    } else if (type == "curve-rect") {
+        return createGenerator<KisCurveRectangleMaskGenerator>(useScalarApplicator, diameter, 0.8, 0.5, 0.5, 2, curve, true);
+    }
+
+    return nullptr;
+}
+
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGenerators_data()
+{
+    QTest::addColumn<QString>("arch");
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("size");
+
+    const QStringList types = {"circle", "gauss-circle", "curve-circle",
+                               "rect", "gauss-rect", "curve-rect"};
+
+    // 5px dabs are supersampled
+    const QVector<int> sizes = {5, 25, 100, 500};
+
+    // the applicators of the library are created either for the best
+    // architecture or as the scalar version, so compare those two
+    const QStringList available = KisSupportedArchitectures::availableArchNames();
+    QStringList archs = {available.first()};
+    if (available.size() > 1) {
+        archs << available.last();
+    }
+
+    Q_FOREACH (const QString &arch, archs) {
+        Q_FOREACH (const QString &type, types) {
+            Q_FOREACH (int size, sizes) {
+                QTest::addRow("%s-%s-%d", arch.toLatin1().data(), type.toLatin1().data(), size)
+                    << arch << type << size;
+            }
+        }
+    }
+}
+
+void KisMaskGeneratorBenchmark::benchmarkGenerators()
+{
+    QFETCH(QString, arch);
+    QFETCH(QString, type);
+    QFETCH(int, size);
+
+    QScopedPointer<KisMaskGenerator> gen(createGenerator(type, size, arch == "generic"));
+
+    QVERIFY(gen);
+
+    const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisFixedPaintDeviceSP dev = new KisFixedPaintDevice(cs);
+    dev->setRect(QRect(0, 0, size + 2, size + 2));
+    dev->initialize();
+
+    MaskProcessingData data(dev, cs, nullptr,
+                            0.0, 1.0,
+                            0.5 * dev->bounds().width(), 0.5 * dev->bounds().height(), 0);
+
+    KisBrushMaskApplicatorBase *applicator = gen->applicator();
+    applicator->initializeData(&data);
+
+    // the dabs are usually rendered in one go, so repeat
+    // the small ones to get measurable numbers
+    const int repeats = qMax(1, 250000 / pow2(size));
+
+    QBENCHMARK {
+        for (int i = 0; i < repeats; i++) {
+            applicator->process(dev->bounds());
+        }
+    }
+}
+
 SIMPLE_TEST_MAIN(KisMaskGeneratorBenchmark)
@@ -18,6 +18,9 @@ private Q_SLOTS:
     void benchmarkSIMD_FadedBrush();
     void benchmarkSquare();
 
+    void benchmarkGenerators_data();
+    void benchmarkGenerators();
+
 };
 
 #endif
@@ -184,6 +184,126 @@ void KisPainterBenchmark::benchmarkFixedBitBltSelection()
 
 }
 
+void KisPainterBenchmark::benchmarkFixedBitBltWithFixedSelection_data()
+{
+    QTest::addColumn<bool>("useUserSelection");
+
+    QTest::newRow("fixed-selection") << false;
+    QTest::newRow("fixed-and-user-selection") << true;
+}
+
+void KisPainterBenchmark::benchmarkFixedBitBltWithFixedSelection()
+{
+    QFETCH(bool, useUserSelection);
+
+    QImage img(TEST_IMAGE_WIDTH,TEST_IMAGE_HEIGHT,QImage::Format_ARGB32);
+    img.fill(128);
+
+    KisFixedPaintDeviceSP fdev = new KisFixedPaintDevice(m_colorSpace);
+    fdev->convertFromQImage(img, 0);
+
+    KisFixedPaintDeviceSP fixedSelection = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    fixedSelection->setRect(img.rect());
+    fixedSelection->lazyGrowBufferWithoutInitialization();
+    const quint8 fixedSelectionValue = 128;
+    fixedSelection->fill(0, 0, img.width(), img.height(), &fixedSelectionValue);
+
+    KisPaintDeviceSP dst = new KisPaintDevice(m_colorSpace);
+    dst->fill(img.rect(), m_color);
+
+    KisPainter gc(dst);
+
+    if (useUserSelection) {
+        KisSelectionSP selection = new KisSelection();
+        selection->pixelSelection()->select(QRect(0, 0, TEST_IMAGE_WIDTH / 2, TEST_IMAGE_HEIGHT), 200);
+        selection->updateProjection();
+        gc.setSelection(selection);
+    }
+
+    QBENCHMARK{
+        for (int i = 0; i < CYCLES ; i++){
+            gc.bltFixedWithFixedSelection(0, 0, fdev, fixedSelection, img.width(), img.height());
+        }
+    }
+}
+
+void KisPainterBenchmark::benchmarkFusedSelectionComposite_data()
+{
+    QTest::addColumn<bool>("fused");
+
+    QTest::newRow("premultiplied-selection") << false;
+    QTest::newRow("fused-selection") << true;
+}
+
+/**
+ * Compares the old way of applying the user selection (merging it into
+ * the mask with a separate COMPOSITE_MULT pass) with the selection
+ * being applied by the composite op itself
+ */
+void KisPainterBenchmark::benchmarkFusedSelectionComposite()
+{
+    QFETCH(bool, fused);
+
+    const int width = TEST_IMAGE_WIDTH;
+    const int height = TEST_IMAGE_HEIGHT;
+    const int pixelSize = m_colorSpace->pixelSize();
+
+    QVector<quint8> srcBytes(width * height * pixelSize);
+    QVector<quint8> dstBytes(width * height * pixelSize);
+    QVector<quint8> maskBytes(width * height, 128);
+    QVector<quint8> selectionBytes(width * height, 200);
+    QVector<quint8> mergedBytes(width * height);
+
+    for (int i = 0; i < width * height; i++) {
+        memcpy(srcBytes.data() + i * pixelSize, m_color.data(), pixelSize);
+        memcpy(dstBytes.data() + i * pixelSize, m_color.data(), pixelSize);
+    }
+
+    const KoCompositeOp *op = m_colorSpace->compositeOp(COMPOSITE_OVER);
+    const KoCompositeOp *multiplyOp = KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT);
+
+    KoCompositeOp::ParameterInfo params;
+    params.dstRowStart   = dstBytes.data();
+    params.dstRowStride  = width * pixelSize;
+    params.srcRowStart   = srcBytes.data();
+    params.srcRowStride  = width * pixelSize;
+    params.rows          = height;
+    params.cols          = width;
+    params.opacity       = 0.8f;
+    params.flow          = 0.9f;
+
+    QBENCHMARK{
+        for (int i = 0; i < CYCLES ; i++){
+            if (fused) {
+                params.maskRowStart       = maskBytes.constData();
+                params.maskRowStride      = width;
+                params.selectionRowStart  = selectionBytes.constData();
+                params.selectionRowStride = width;
+            } else {
+                mergedBytes = selectionBytes;
+
+                KoCompositeOp::ParameterInfo multiplyParams;
+                multiplyParams.dstRowStart  = mergedBytes.data();
+                multiplyParams.dstRowStride = width;
+                multiplyParams.srcRowStart  = maskBytes.constData();
+                multiplyParams.srcRowStride = width;
+                multiplyParams.rows         = height;
+                multiplyParams.cols         = width;
+                multiplyParams.opacity      = 1.0f;
+                multiplyParams.flow         = 1.0f;
+                multiplyOp->composite(multiplyParams);
+
+                params.maskRowStart  = mergedBytes.constData();
+                params.maskRowStride = width;
+            }
+
+            m_colorSpace->bitBlt(m_colorSpace, params, op,
+                                 KoColorConversionTransformation::internalRenderingIntent(),
+                                 KoColorConversionTransformation::internalConversionFlags());
+        }
+    }
+}
+
 void KisPainterBenchmark::benchmarkDrawThickLine()
 {
     KisPaintDeviceSP dev = new KisPaintDevice(m_colorSpace);
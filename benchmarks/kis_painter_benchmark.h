@@ -32,6 +32,10 @@ private Q_SLOTS:
     void benchmarkBitBltSelection();
     void benchmarkFixedBitBlt();
     void benchmarkFixedBitBltSelection();
+    void benchmarkFixedBitBltWithFixedSelection_data();
+    void benchmarkFixedBitBltWithFixedSelection();
+    void benchmarkFusedSelectionComposite_data();
+    void benchmarkFusedSelectionComposite();
     
     void benchmarkDrawThickLine();
     void benchmarkDrawQtLine();
@@ -9,12 +9,24 @@
 #include "kis_benchmark_values.h"
 
 #include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
 
 #include <kis_group_layer.h>
 #include <kis_paint_device.h>
 #include <KisDocument.h>
 #include <kis_image.h>
 #include <KisPart.h>
+#include <kis_paint_layer.h>
+#include <kis_filter_mask.h>
+#include <kis_adjustment_layer.h>
+#include <kis_image_config.h>
+#include <KisImageConfigNotifier.h>
+#include <kis_iterator_ng.h>
+#include <filter/kis_filter.h>
+#include <filter/kis_filter_configuration.h>
+#include <filter/kis_filter_registry.h>
+#include <KisGlobalResourcesInterface.h>
 
 void KisProjectionBenchmark::initTestCase()
 {
@@ -45,6 +57,138 @@ void KisProjectionBenchmark::benchmarkLoading()
         delete doc2;
     }
 }
+void KisProjectionBenchmark::benchmarkColorAdjustmentMasks_data()
+{
+    QTest::addColumn<bool>("useGrayscale");
+    QTest::addColumn<int>("numMasks");
+    QTest::addColumn<bool>("fuseMasks");
+
+    for (int i = 0; i < 2; i++) {
+        const bool useGrayscale = i;
+
+        Q_FOREACH (int numMasks, QList<int>({1, 5, 8})) {
+            Q_FOREACH (bool fuseMasks, QList<bool>({false, true})) {
+                QTest::addRow("%s-%d-masks-%s",
+                              useGrayscale ? "graya8" : "rgba8",
+                              numMasks,
+                              fuseMasks ? "fused" : "separate")
+                        << useGrayscale << numMasks << fuseMasks;
+            }
+        }
+    }
+}
+
+void KisProjectionBenchmark::benchmarkColorAdjustmentMasks()
+{
+    QFETCH(bool, useGrayscale);
+    QFETCH(int, numMasks);
+    QFETCH(bool, fuseMasks);
+
+    const KoColorSpace *cs = useGrayscale ?
+        KoColorSpaceRegistry::instance()->graya8() :
+        KoColorSpaceRegistry::instance()->rgb8();
+
+    const QRect imageRect(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "color adjustment masks benchmark");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer, image->root());
+
+    KoColor color(cs);
+    srand(31524744);
+
+    KisSequentialIterator it(layer->paintDevice(), imageRect);
+    while (it.nextPixel()) {
+        color.fromQColor(QColor(rand() % 255, rand() % 255, rand() % 255));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    const QStringList filterIds = useGrayscale ?
+        QStringList({"invert", "levels", "perchannel"}) :
+        QStringList({"invert", "desaturate", "hsvadjustment", "colorbalance", "perchannel"});
+
+    for (int i = 0; i < numMasks; i++) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterIds[i % filterIds.size()]);
+        QVERIFY(filter);
+
+        KisFilterMaskSP mask = new KisFilterMask(image, QString("mask %1").arg(i));
+        mask->setFilter(filter->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot());
+        image->addNode(mask, layer);
+    }
+
+    KisImageConfig(false).setFuseColorAdjustmentMasks(fuseMasks);
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    KisImageConfig(false).setFuseColorAdjustmentMasks(KisImageConfig(true).fuseColorAdjustmentMasks(true));
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+}
+
+void KisProjectionBenchmark::benchmarkAdjustmentLayers_data()
+{
+    QTest::addColumn<int>("numLayers");
+    QTest::addColumn<bool>("fuseLayers");
+
+    Q_FOREACH (int numLayers, QList<int>({1, 5, 8})) {
+        Q_FOREACH (bool fuseLayers, QList<bool>({false, true})) {
+            QTest::addRow("%d-layers-%s",
+                          numLayers,
+                          fuseLayers ? "fused" : "separate")
+                    << numLayers << fuseLayers;
+        }
+    }
+}
+
+void KisProjectionBenchmark::benchmarkAdjustmentLayers()
+{
+    QFETCH(int, numLayers);
+    QFETCH(bool, fuseLayers);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    const QRect imageRect(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), cs, "adjustment layers benchmark");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "layer", OPACITY_OPAQUE_U8, cs);
+    image->addNode(layer, image->root());
+
+    KoColor color(cs);
+    srand(31524744);
 
+    KisSequentialIterator it(layer->paintDevice(), imageRect);
+    while (it.nextPixel()) {
+        color.fromQColor(QColor(rand() % 255, rand() % 255, rand() % 255));
+        memcpy(it.rawData(), color.data(), cs->pixelSize());
+    }
+
+    const QStringList filterIds({"invert", "desaturate", "hsvadjustment", "colorbalance", "perchannel"});
+
+    for (int i = 0; i < numLayers; i++) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterIds[i % filterIds.size()]);
+        QVERIFY(filter);
+
+        KisAdjustmentLayerSP adjustmentLayer =
+            new KisAdjustmentLayer(image, QString("adjustment %1").arg(i),
+                                   filter->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot(),
+                                   0);
+        image->addNode(adjustmentLayer, image->root());
+    }
+
+    KisImageConfig(false).setFuseColorAdjustmentMasks(fuseLayers);
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+
+    // update the paint layer, so that the adjustment layers are
+    // recalculated as the ones above the filthy node
+    QBENCHMARK {
+        layer->setDirty(imageRect);
+        image->waitForDone();
+    }
+
+    KisImageConfig(false).setFuseColorAdjustmentMasks(KisImageConfig(true).fuseColorAdjustmentMasks(true));
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+}
 
 SIMPLE_TEST_MAIN(KisProjectionBenchmark)
@@ -20,6 +20,12 @@ private Q_SLOTS:
 
     void benchmarkProjection();
     void benchmarkLoading();
+
+    void benchmarkColorAdjustmentMasks_data();
+    void benchmarkColorAdjustmentMasks();
+
+    void benchmarkAdjustmentLayers_data();
+    void benchmarkAdjustmentLayers();
 };
 
 #endif
@@ -310,9 +310,9 @@ macro(xsimd_compile_for_all_implementations _srcs _src)
       _xsimd_compile_one_implementation(${_srcs} AVX+FMA
          "-mavx -mfma"    "/arch:AVX")
       _xsimd_compile_one_implementation(${_srcs} AVX2
-         "-mavx2"         "/arch:AVX2")
+         "-mavx2 -mf16c"  "/arch:AVX2")
       _xsimd_compile_one_implementation(${_srcs} AVX2+FMA
-         "-mavx2 -mfma"   "/arch:AVX2")
+         "-mavx2 -mfma -mf16c" "/arch:AVX2")
       _xsimd_compile_one_implementation(${_srcs} AVX512F
          "-mavx512f"      "/arch:AVX512")
       _xsimd_compile_one_implementation(${_srcs} AVX512BW
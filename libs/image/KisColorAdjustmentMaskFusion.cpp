@@ -0,0 +1,434 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisColorAdjustmentMaskFusion.h"
+
+#include <atomic>
+
+#include <QBitArray>
+#include <QSharedPointer>
+#include <QVector>
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceConstants.h>
+#include <KoColorTransformation.h>
+#include <KoCompositeOp.h>
+#include <KoCompositeOpRegistry.h>
+
+#include "kis_abstract_projection_plane.h"
+#include "kis_adjustment_layer.h"
+#include "kis_assert.h"
+#include "kis_busy_progress_indicator.h"
+#include "kis_color_transformation_configuration.h"
+#include "kis_color_transformation_filter.h"
+#include "kis_filter_mask.h"
+#include "kis_filter_registry.h"
+#include "kis_image_config.h"
+#include "KisImageConfigNotifier.h"
+#include "kis_paint_device.h"
+#include "kis_pixel_selection.h"
+#include "kis_projection_leaf.h"
+#include "kis_selection.h"
+#include "kis_sequential_iterator.h"
+
+
+namespace {
+
+struct Step {
+    KisNodeSP node;
+
+    // the original of the adjustment layer, null for masks
+    KisPaintDeviceSP original;
+
+    KisFilterConfigurationSP config;
+    KoColorTransformation *transformation = 0;
+    bool ownsTransformation = false;
+    KisSelectionSP selection;
+
+    // keeps the temporary target of the node from appearing
+    // while the node is being applied
+    QSharedPointer<KisIndirectPaintingSupport::ReadLocker> locker;
+};
+
+}
+
+struct KisColorAdjustmentMaskFusion::Private
+{
+    KisPaintDeviceSP projection;
+    const KoColorSpace *colorSpace = 0;
+    bool isSupported = false;
+
+    QVector<Step> steps;
+
+    bool createTransformation(Step &step) const;
+    bool canUseLookupTable(const QRect &applyRect) const;
+    void applyLookupTable(const QRect &applyRect);
+    void applySteps(const QRect &applyRect);
+    void applyStepsToOriginals(const QRect &applyRect);
+};
+
+KisColorAdjustmentMaskFusion::KisColorAdjustmentMaskFusion(KisPaintDeviceSP projection)
+    : m_d(new Private)
+{
+    m_d->projection = projection;
+    m_d->colorSpace = projection->colorSpace();
+
+    /**
+     * KisFilter::process() filters a separate device in the
+     * composition source color space for such devices, so
+     * leave them to the usual path
+     */
+    m_d->isSupported =
+        m_d->colorSpace == projection->compositionSourceColorSpace() ||
+        *m_d->colorSpace == *projection->compositionSourceColorSpace();
+}
+
+KisColorAdjustmentMaskFusion::~KisColorAdjustmentMaskFusion()
+{
+    Q_FOREACH (const Step &step, m_d->steps) {
+        if (step.ownsTransformation) {
+            delete step.transformation;
+        }
+    }
+}
+
+bool KisColorAdjustmentMaskFusion::isEnabled()
+{
+    /**
+     * The flag is checked on every update of the projection, so it is
+     * read from the config only when the config changes
+     */
+    struct EnabledFlag {
+        EnabledFlag() {
+            update();
+            QObject::connect(KisImageConfigNotifier::instance(), &KisImageConfigNotifier::configChanged,
+                             [this] () { update(); });
+        }
+
+        void update() {
+            value.store(KisImageConfig(true).fuseColorAdjustmentMasks());
+        }
+
+        std::atomic<bool> value;
+    };
+
+    static EnabledFlag flag;
+    return flag.value.load();
+}
+
+bool KisColorAdjustmentMaskFusion::Private::createTransformation(Step &step) const
+{
+    if (!step.config) return false;
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value(step.config->name());
+    const KisColorTransformationFilter *colorFilter =
+        dynamic_cast<const KisColorTransformationFilter*>(filter.data());
+    if (!colorFilter) return false;
+
+    // the transformation is created in the same way as
+    // KisColorTransformationFilter::processImpl() does
+    const KisColorTransformationConfiguration *colorConfig =
+        dynamic_cast<const KisColorTransformationConfiguration*>(step.config.data());
+
+    if (colorConfig) {
+        step.transformation = colorConfig->colorTransformation(colorSpace, colorFilter);
+    } else {
+        step.transformation = colorFilter->createTransformation(colorSpace, step.config);
+        step.ownsTransformation = true;
+    }
+
+    return step.transformation;
+}
+
+bool KisColorAdjustmentMaskFusion::tryAddMask(KisEffectMaskSP mask)
+{
+    if (!m_d->isSupported) return false;
+    if (!m_d->steps.isEmpty() && m_d->steps.first().original) return false;
+
+    KisFilterMask *filterMask = dynamic_cast<KisFilterMask*>(mask.data());
+    if (!filterMask) return false;
+
+    Step step;
+    step.config = filterMask->filter();
+
+    step.locker.reset(new KisIndirectPaintingSupport::ReadLocker(filterMask));
+    if (filterMask->hasTemporaryTarget()) return false;
+
+    if (!m_d->createTransformation(step)) return false;
+
+    step.node = mask;
+    step.selection = mask->selection();
+
+    m_d->steps.append(step);
+
+    return true;
+}
+
+bool KisColorAdjustmentMaskFusion::tryAddAdjustmentLayer(KisProjectionLeafSP leaf, const QRect &applyRect)
+{
+    if (!m_d->isSupported) return false;
+    if (!m_d->steps.isEmpty() && !m_d->steps.first().original) return false;
+
+    KisAdjustmentLayer *layer = qobject_cast<KisAdjustmentLayer*>(leaf->node().data());
+    if (!layer) return false;
+
+    if (!leaf->visible() ||
+        leaf->opacity() != OPACITY_OPAQUE_U8 ||
+        layer->compositeOpId() != COMPOSITE_COPY ||
+        layer->hasEffectMasks() ||
+        layer->layerStyle()) {
+
+        return false;
+    }
+
+    const QBitArray channelFlags = leaf->channelFlags();
+    if (channelFlags.count(false) > 0) return false;
+
+    KisPaintDeviceSP original = layer->original();
+    if (*original->colorSpace() != *m_d->colorSpace) return false;
+
+    if (layer->projectionPlane()->needRectForOriginal(applyRect) != applyRect) return false;
+
+    Step step;
+    step.config = layer->filter();
+
+    /**
+     * Adjustment layers always have a selection, which is totally
+     * selected by default. Only such selections can be skipped.
+     *
+     * The selection is fetched with the temporary target painted on
+     * it, which is never totally selected. The temporary target is not
+     * locked here, because the layer locks it again when its projection
+     * is recalculated.
+     */
+    KisSelectionSP selection = layer->fetchComposedInternalSelection(applyRect);
+    if (selection) {
+        KisPixelSelectionSP projection = selection->projection();
+
+        if (*projection->defaultPixel().data() != MAX_SELECTED ||
+            projection->extent().intersects(applyRect)) {
+
+            return false;
+        }
+    }
+
+    if (!m_d->createTransformation(step)) return false;
+
+    step.node = layer;
+    step.original = original;
+
+    m_d->steps.append(step);
+
+    return true;
+}
+
+int KisColorAdjustmentMaskFusion::numMasks() const
+{
+    return m_d->steps.size();
+}
+
+void KisColorAdjustmentMaskFusion::apply(const QRect &applyRect)
+{
+    if (m_d->steps.isEmpty() || applyRect.isEmpty()) return;
+
+    Q_FOREACH (const Step &step, m_d->steps) {
+        KisBusyProgressIndicator *indicator = step.node->busyProgressIndicator();
+        if (indicator) {
+            indicator->update();
+        }
+
+        if (step.selection) {
+            step.selection->updateProjection(applyRect);
+        }
+    }
+
+    if (m_d->canUseLookupTable(applyRect)) {
+        m_d->applyLookupTable(applyRect);
+    } else {
+        m_d->applySteps(applyRect);
+    }
+}
+
+void KisColorAdjustmentMaskFusion::applyToOriginals(const QRect &applyRect)
+{
+    if (m_d->steps.isEmpty() || applyRect.isEmpty()) return;
+
+    Q_FOREACH (const Step &step, m_d->steps) {
+        KIS_SAFE_ASSERT_RECOVER_RETURN(step.original);
+
+        KisBusyProgressIndicator *indicator = step.node->busyProgressIndicator();
+        if (indicator) {
+            indicator->update();
+        }
+
+        step.original->clear(applyRect);
+    }
+
+    /**
+     * Outside the extent of the projection the originals are left
+     * cleared, as KisUpdateOriginalVisitor does it
+     */
+    const QRect rect = applyRect & m_d->projection->extent();
+    if (rect.isEmpty()) return;
+
+    m_d->applyStepsToOriginals(rect);
+}
+
+bool KisColorAdjustmentMaskFusion::Private::canUseLookupTable(const QRect &applyRect) const
+{
+    const int pixelSize = colorSpace->pixelSize();
+    if (pixelSize > 2) return false;
+
+    Q_FOREACH (const Step &step, steps) {
+        if (step.selection) return false;
+    }
+
+    // building the table costs as much as transforming that many pixels
+    const qint64 numEntries = 1 << (8 * pixelSize);
+    return qint64(applyRect.width()) * applyRect.height() > numEntries;
+}
+
+void KisColorAdjustmentMaskFusion::Private::applyLookupTable(const QRect &applyRect)
+{
+    const int pixelSize = colorSpace->pixelSize();
+    const int numEntries = 1 << (8 * pixelSize);
+
+    /**
+     * Every entry of the table is a pixel, whose bytes form its own
+     * index, so the table is initialized with all the possible pixels
+     * and then transformed by the whole chain at once
+     */
+    QVector<quint8> table(numEntries * pixelSize);
+    quint8 *entry = table.data();
+    for (int i = 0; i < numEntries; i++) {
+        for (int b = 0; b < pixelSize; b++) {
+            *entry++ = quint8(i >> (8 * b));
+        }
+    }
+
+    Q_FOREACH (const Step &step, steps) {
+        step.transformation->transform(table.constData(), table.data(), numEntries);
+    }
+
+    KisSequentialIterator it(projection, applyRect);
+
+    if (pixelSize == 1) {
+        while (it.nextPixel()) {
+            quint8 *ptr = it.rawData();
+            *ptr = table[*ptr];
+        }
+    } else {
+        while (it.nextPixel()) {
+            quint8 *ptr = it.rawData();
+            const int index = 2 * (ptr[0] | (ptr[1] << 8));
+            ptr[0] = table[index];
+            ptr[1] = table[index + 1];
+        }
+    }
+}
+
+void KisColorAdjustmentMaskFusion::Private::applySteps(const QRect &applyRect)
+{
+    const int pixelSize = colorSpace->pixelSize();
+
+    // masks don't have any compositing, see KisMask::mergeInMaskInternal()
+    const KoCompositeOp *copyOp = colorSpace->compositeOp(COMPOSITE_COPY);
+
+    QVector<QSharedPointer<KisSequentialConstIterator>> selectionIterators(steps.size());
+    for (int i = 0; i < steps.size(); i++) {
+        if (steps[i].selection) {
+            selectionIterators[i].reset(
+                new KisSequentialConstIterator(steps[i].selection->projection(), applyRect));
+        }
+    }
+
+    QVector<quint8> transformed;
+
+    KisSequentialIterator it(projection, applyRect);
+
+    /**
+     * The devices may have different offsets, so the iterators
+     * should move by the number of pixels available in all of them
+     */
+    auto numConseqPixels = [&] () {
+        int result = it.nConseqPixels();
+        Q_FOREACH (const QSharedPointer<KisSequentialConstIterator> &selectionIt, selectionIterators) {
+            if (selectionIt) {
+                result = qMin(result, selectionIt->nConseqPixels());
+            }
+        }
+        return result;
+    };
+
+    int conseq = numConseqPixels();
+    while (it.nextPixels(conseq)) {
+        Q_FOREACH (const QSharedPointer<KisSequentialConstIterator> &selectionIt, selectionIterators) {
+            if (selectionIt) {
+                selectionIt->nextPixels(conseq);
+            }
+        }
+
+        conseq = numConseqPixels();
+        quint8 *pixels = it.rawData();
+
+        for (int i = 0; i < steps.size(); i++) {
+            const Step &step = steps[i];
+
+            if (!step.selection) {
+                step.transformation->transform(pixels, pixels, conseq);
+            } else {
+                transformed.resize(conseq * pixelSize);
+                step.transformation->transform(pixels, transformed.data(), conseq);
+
+                copyOp->composite(pixels, 0,
+                                  transformed.constData(), 0,
+                                  selectionIterators[i]->rawDataConst(), 0,
+                                  1, conseq,
+                                  OPACITY_OPAQUE_F);
+            }
+        }
+    }
+}
+
+void KisColorAdjustmentMaskFusion::Private::applyStepsToOriginals(const QRect &applyRect)
+{
+    KisSequentialConstIterator srcIt(projection, applyRect);
+
+    QVector<QSharedPointer<KisSequentialIterator>> dstIterators(steps.size());
+    for (int i = 0; i < steps.size(); i++) {
+        dstIterators[i].reset(new KisSequentialIterator(steps[i].original, applyRect));
+    }
+
+    /**
+     * The devices may have different offsets, so the iterators
+     * should move by the number of pixels available in all of them
+     */
+    auto numConseqPixels = [&] () {
+        int result = srcIt.nConseqPixels();
+        Q_FOREACH (const QSharedPointer<KisSequentialIterator> &dstIt, dstIterators) {
+            result = qMin(result, dstIt->nConseqPixels());
+        }
+        return result;
+    };
+
+    int conseq = numConseqPixels();
+    while (srcIt.nextPixels(conseq)) {
+        Q_FOREACH (const QSharedPointer<KisSequentialIterator> &dstIt, dstIterators) {
+            dstIt->nextPixels(conseq);
+        }
+
+        conseq = numConseqPixels();
+
+        // every layer filters the original of the layer below it
+        const quint8 *src = srcIt.rawDataConst();
+
+        for (int i = 0; i < steps.size(); i++) {
+            quint8 *dst = dstIterators[i]->rawData();
+            steps[i].transformation->transform(src, dst, conseq);
+            src = dst;
+        }
+    }
+}
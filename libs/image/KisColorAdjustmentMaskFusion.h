@@ -0,0 +1,103 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCOLORADJUSTMENTMASKFUSION_H
+#define KISCOLORADJUSTMENTMASKFUSION_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+
+/**
+ * Applies a sequence of filter masks with pointwise color adjustment
+ * filters (KisColorTransformationFilter) in a single pass.
+ *
+ * When such masks are applied one by one, every mask copies the
+ * projection into a cache device, transforms it and copies the result
+ * back. Here the pixels of the projection are read once, all the
+ * transformations are applied to them in place and the result is
+ * written once. The selections of the masks are applied in between,
+ * exactly as KisMask::apply() does it.
+ *
+ * If none of the masks has a selection and a pixel takes at most two
+ * bytes (alpha and grayscale 8-bit spaces), the whole chain is baked
+ * into a lookup table with an entry for every possible pixel.
+ *
+ * Usage:
+ *
+ * \code{.cpp}
+ * KisColorAdjustmentMaskFusion fusion(projection);
+ * while (fusion.tryAddMask(mask)) { ... }
+ * if (fusion.numMasks() > 1) fusion.apply(rect);
+ * \endcode
+ *
+ * A stack of adjustment layers is fused in the same way by
+ * KisAsyncMerger, see tryAddAdjustmentLayer(). The masks and the
+ * adjustment layers cannot be added to the same fusion.
+ */
+class KRITAIMAGE_EXPORT KisColorAdjustmentMaskFusion
+{
+public:
+    KisColorAdjustmentMaskFusion(KisPaintDeviceSP projection);
+    ~KisColorAdjustmentMaskFusion();
+
+    /**
+     * @return true if the masks and the adjustment layers should be fused, see
+     *         KisImageConfig::fuseColorAdjustmentMasks(); the value
+     *         is reread on KisImageConfigNotifier::configChanged()
+     */
+    static bool isEnabled();
+
+    /**
+     * Adds \p mask to the sequence if it can be applied in the same
+     * pass as the already added ones.
+     *
+     * @return false if \p mask is not a filter mask with a pointwise
+     *         color adjustment filter or it is being painted on now;
+     *         the mask is not added in such a case
+     */
+    bool tryAddMask(KisEffectMaskSP mask);
+
+    /**
+     * Adds the adjustment layer of \p leaf to the sequence if its
+     * original can be computed in the same pass as the originals of
+     * the already added layers.
+     *
+     * The layer is composited with COPY, so when it is visible, fully
+     * opaque, has no effect masks, no layer style, no channel flags and
+     * its selection covers the whole \p applyRect, it just replaces
+     * the projection with the filtered projection, and the next layer
+     * filters the result of the previous one.
+     *
+     * @return false if the layer doesn't fit these conditions or its
+     *         filter is not a pointwise color adjustment; the layer is
+     *         not added in such a case
+     */
+    bool tryAddAdjustmentLayer(KisProjectionLeafSP leaf, const QRect &applyRect);
+
+    int numMasks() const;
+
+    /**
+     * Applies all the added masks to \p applyRect of the projection
+     */
+    void apply(const QRect &applyRect);
+
+    /**
+     * Writes the originals of all the added adjustment layers in
+     * \p applyRect, reading the projection only once. The projections
+     * of the layers are not recalculated.
+     */
+    void applyToOriginals(const QRect &applyRect);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISCOLORADJUSTMENTMASKFUSION_H
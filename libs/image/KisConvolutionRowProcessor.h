@@ -0,0 +1,146 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCONVOLUTIONROWPROCESSOR_H
+#define KISCONVOLUTIONROWPROCESSOR_H
+
+#include "KisConvolutionRowProcessorBase.h"
+
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+namespace KisConvolutionRowProcessorDetail
+{
+
+/**
+ * Processes the pixels one by one. Used for the scalar version and
+ * for the tail of the rows in the vectorized one.
+ *
+ * The kernel is templated by the architecture only to keep the copies
+ * compiled with different instruction sets apart.
+ */
+template<typename _impl>
+struct ScalarKernel {
+    static void convolveRow(const float *src, float *dst, int offset, int numPixels,
+                            const float *kernel, int kernelSize,
+                            bool accumulate)
+    {
+        for (int i = offset; i < numPixels; i++) {
+            float sum = accumulate ? dst[i] : 0.0f;
+
+            for (int k = 0; k < kernelSize; k++) {
+                sum += kernel[k] * src[i + k];
+            }
+
+            dst[i] = sum;
+        }
+    }
+
+    static void combineRows(const float *const *rows, const float *weights, int numRows,
+                            float *dst, int offset, int numPixels,
+                            bool accumulate)
+    {
+        for (int i = offset; i < numPixels; i++) {
+            float sum = accumulate ? dst[i] : 0.0f;
+
+            for (int r = 0; r < numRows; r++) {
+                sum += weights[r] * rows[r][i];
+            }
+
+            dst[i] = sum;
+        }
+    }
+};
+
+/**
+ * Processes float_v::size pixels at once. The sums are kept in the
+ * registers until the whole kernel is applied, so every destination
+ * value is stored only once.
+ */
+template<typename _impl>
+struct VectorKernel {
+    using float_v = xsimd::batch<float, _impl>;
+
+    static int convolveRow(const float *src, float *dst, int numPixels,
+                           const float *kernel, int kernelSize,
+                           bool accumulate)
+    {
+        const int numBlocks = numPixels / static_cast<int>(float_v::size);
+
+        for (int i = 0; i < numBlocks; i++) {
+            const int offset = i * static_cast<int>(float_v::size);
+
+            float_v sum = accumulate ? float_v::load_unaligned(dst + offset) : float_v(0.0f);
+
+            for (int k = 0; k < kernelSize; k++) {
+                sum = xsimd::fma(float_v(kernel[k]), float_v::load_unaligned(src + offset + k), sum);
+            }
+
+            sum.store_unaligned(dst + offset);
+        }
+
+        return numBlocks * static_cast<int>(float_v::size);
+    }
+
+    static int combineRows(const float *const *rows, const float *weights, int numRows,
+                           float *dst, int numPixels,
+                           bool accumulate)
+    {
+        const int numBlocks = numPixels / static_cast<int>(float_v::size);
+
+        for (int i = 0; i < numBlocks; i++) {
+            const int offset = i * static_cast<int>(float_v::size);
+
+            float_v sum = accumulate ? float_v::load_unaligned(dst + offset) : float_v(0.0f);
+
+            for (int r = 0; r < numRows; r++) {
+                sum = xsimd::fma(float_v(weights[r]), float_v::load_unaligned(rows[r] + offset), sum);
+            }
+
+            sum.store_unaligned(dst + offset);
+        }
+
+        return numBlocks * static_cast<int>(float_v::size);
+    }
+};
+
+} // namespace KisConvolutionRowProcessorDetail
+
+template<typename _impl = xsimd::current_arch>
+class KisConvolutionRowProcessor : public KisConvolutionRowProcessorBase
+{
+public:
+    void convolveRow(const float *src, float *dst, int numPixels,
+                     const float *kernel, int kernelSize,
+                     bool accumulate) const override
+    {
+        int offset = 0;
+
+        if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+            offset = KisConvolutionRowProcessorDetail::VectorKernel<_impl>::convolveRow(src, dst, numPixels, kernel, kernelSize, accumulate);
+        }
+
+        KisConvolutionRowProcessorDetail::ScalarKernel<_impl>::convolveRow(src, dst, offset, numPixels, kernel, kernelSize, accumulate);
+    }
+
+    void combineRows(const float *const *rows, const float *weights, int numRows,
+                     float *dst, int numPixels,
+                     bool accumulate) const override
+    {
+        int offset = 0;
+
+        if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+            offset = KisConvolutionRowProcessorDetail::VectorKernel<_impl>::combineRows(rows, weights, numRows, dst, numPixels, accumulate);
+        }
+
+        KisConvolutionRowProcessorDetail::ScalarKernel<_impl>::combineRows(rows, weights, numRows, dst, offset, numPixels, accumulate);
+    }
+};
+
+#endif // KISCONVOLUTIONROWPROCESSOR_H
@@ -0,0 +1,43 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCONVOLUTIONROWPROCESSORBASE_H
+#define KISCONVOLUTIONROWPROCESSORBASE_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * Inner loops of the spatial convolution, compiled for every supported
+ * architecture. All the buffers are planar rows of floats, so the
+ * implementations can process several pixels per instruction.
+ */
+class KRITAIMAGE_EXPORT KisConvolutionRowProcessorBase
+{
+public:
+    virtual ~KisConvolutionRowProcessorBase();
+
+    /**
+     * dst[i] = sum(kernel[k] * src[i + k]), where i is in [0, numPixels)
+     * and k is in [0, kernelSize). \p src should contain
+     * numPixels + kernelSize - 1 values. When \p accumulate is true,
+     * the sum is added to the values of \p dst instead.
+     */
+    virtual void convolveRow(const float *src, float *dst, int numPixels,
+                             const float *kernel, int kernelSize,
+                             bool accumulate) const = 0;
+
+    /**
+     * dst[i] = sum(weights[r] * rows[r][i]), where i is in [0, numPixels)
+     * and r is in [0, numRows). When \p accumulate is true, the sum is
+     * added to the values of \p dst instead.
+     */
+    virtual void combineRows(const float *const *rows, const float *weights, int numRows,
+                             float *dst, int numPixels,
+                             bool accumulate) const = 0;
+};
+
+#endif // KISCONVOLUTIONROWPROCESSORBASE_H
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisConvolutionRowProcessorFactory.h"
+
+#include "KisConvolutionRowProcessorFactoryImpl.h"
+
+KisConvolutionRowProcessorBase *KisConvolutionRowProcessorFactory::create()
+{
+    return createOptimizedClass<KisConvolutionRowProcessorFactoryImpl>();
+}
+
+KisConvolutionRowProcessorBase *KisConvolutionRowProcessorFactory::createScalar()
+{
+    return createScalarClass<KisConvolutionRowProcessorFactoryImpl>();
+}
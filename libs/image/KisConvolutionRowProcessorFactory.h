@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCONVOLUTIONROWPROCESSORFACTORY_H
+#define KISCONVOLUTIONROWPROCESSORFACTORY_H
+
+#include "kritaimage_export.h"
+
+class KisConvolutionRowProcessorBase;
+
+class KRITAIMAGE_EXPORT KisConvolutionRowProcessorFactory
+{
+public:
+    static KisConvolutionRowProcessorBase* create();
+    static KisConvolutionRowProcessorBase* createScalar();
+};
+
+#endif // KISCONVOLUTIONROWPROCESSORFACTORY_H
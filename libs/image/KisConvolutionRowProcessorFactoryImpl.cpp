@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisConvolutionRowProcessorFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisConvolutionRowProcessor.h"
+
+template<>
+KisConvolutionRowProcessorBase *
+KisConvolutionRowProcessorFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisConvolutionRowProcessor<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
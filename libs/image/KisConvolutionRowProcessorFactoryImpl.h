@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCONVOLUTIONROWPROCESSORFACTORYIMPL_H
+#define KISCONVOLUTIONROWPROCESSORFACTORYIMPL_H
+
+#include <KisConvolutionRowProcessorBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAIMAGE_EXPORT KisConvolutionRowProcessorFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisConvolutionRowProcessorBase* create();
+};
+
+#endif // KISCONVOLUTIONROWPROCESSORFACTORYIMPL_H
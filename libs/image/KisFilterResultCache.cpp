@@ -0,0 +1,320 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFilterResultCache.h"
+
+#include <atomic>
+#include <algorithm>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "kis_datamanager.h"
+#include "kis_image_config.h"
+#include "KisImageConfigNotifier.h"
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_selection.h"
+#include "KisRegion.h"
+#include "krita_utils.h"
+
+
+namespace {
+
+// the size of the tiles of the paint devices
+constexpr int cellSize = 64;
+
+/**
+ * The cached tiles are shared with the projection of the layer until
+ * the projection is rewritten, so usually they cost no memory. This
+ * limit counts them as if they were never shared.
+ */
+constexpr int maxCacheSizeBytes = 64 * 1024 * 1024;
+
+/**
+ * Everything except the source pixels the result of the filter
+ * depends on. When any of it changes, the cached tiles are dropped.
+ */
+struct State {
+    const KisFilterConfiguration *config = 0;
+    const KoColorSpace *srcColorSpace = 0;
+    const KoColorSpace *dstColorSpace = 0;
+    QPoint srcOffset;
+    QPoint dstOffset;
+    QRect bounds;
+    KoColor srcDefaultPixel;
+    KoColor dstDefaultPixel;
+
+    bool operator==(const State &rhs) const {
+        return config == rhs.config &&
+            srcColorSpace == rhs.srcColorSpace &&
+            dstColorSpace == rhs.dstColorSpace &&
+            srcOffset == rhs.srcOffset &&
+            dstOffset == rhs.dstOffset &&
+            bounds == rhs.bounds &&
+            srcDefaultPixel == rhs.srcDefaultPixel &&
+            dstDefaultPixel == rhs.dstDefaultPixel;
+    }
+
+    bool operator!=(const State &rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+struct CachedCell {
+    QRect rect;
+    QVector<quint64> revisions;
+    quint64 lastUse = 0;
+};
+
+struct Level {
+    State state;
+    KisPaintDeviceSP device;
+    QHash<quint64, CachedCell> cells;
+};
+
+struct Cell {
+    QRect rect;
+    quint64 key = 0;
+    QVector<quint64> revisions;
+};
+
+inline quint64 cellKey(const QRect &cellRect)
+{
+    return quint64(quint32(cellRect.x())) << 32 | quint32(cellRect.y());
+}
+
+}
+
+struct KisFilterResultCache::Private
+{
+    QMutex mutex;
+
+    /**
+     * Every level of detail has its own cache, so that the
+     * instant preview doesn't drop the results of the full
+     * resolution
+     */
+    QHash<int, Level> levels;
+
+    quint64 lastUse = 0;
+
+    void dropOldCells(int maxCells);
+};
+
+void KisFilterResultCache::Private::dropOldCells(int maxCells)
+{
+    int numCells = 0;
+    Q_FOREACH (const Level &level, levels) {
+        numCells += level.cells.size();
+    }
+
+    if (numCells <= maxCells) return;
+
+    struct CellRef {
+        quint64 lastUse;
+        int lod;
+        quint64 key;
+    };
+
+    QVector<CellRef> refs;
+    refs.reserve(numCells);
+
+    for (auto levelIt = levels.constBegin(); levelIt != levels.constEnd(); ++levelIt) {
+        for (auto it = levelIt->cells.constBegin(); it != levelIt->cells.constEnd(); ++it) {
+            refs.append({it->lastUse, levelIt.key(), it.key()});
+        }
+    }
+
+    std::sort(refs.begin(), refs.end(),
+              [] (const CellRef &lhs, const CellRef &rhs) {
+                  return lhs.lastUse < rhs.lastUse;
+              });
+
+    // drop a quarter more than needed, so that we don't sort on every update
+    const int numDropped = numCells - maxCells * 3 / 4;
+
+    for (int i = 0; i < numDropped; i++) {
+        Level &level = levels[refs[i].lod];
+        auto it = level.cells.find(refs[i].key);
+        level.device->clear(it->rect);
+        level.cells.erase(it);
+    }
+}
+
+KisFilterResultCache::KisFilterResultCache()
+    : m_d(new Private)
+{
+}
+
+KisFilterResultCache::~KisFilterResultCache()
+{
+}
+
+bool KisFilterResultCache::isEnabled()
+{
+    /**
+     * The flag is checked on every update of the projection, so it is
+     * read from the config only when the config changes
+     */
+    struct EnabledFlag {
+        EnabledFlag() {
+            update();
+            QObject::connect(KisImageConfigNotifier::instance(), &KisImageConfigNotifier::configChanged,
+                             [this] () { update(); });
+        }
+
+        void update() {
+            value.store(KisImageConfig(true).cacheFilterResults());
+        }
+
+        std::atomic<bool> value;
+    };
+
+    static EnabledFlag flag;
+    return flag.value.load();
+}
+
+void KisFilterResultCache::process(const KisFilter *filter,
+                                   KisFilterConfigurationSP config,
+                                   KisPaintDeviceSP src,
+                                   KisPaintDeviceSP dst,
+                                   const QRect &rect)
+{
+    if (rect.isEmpty()) return;
+
+    /**
+     * The result is stitched from the pieces filtered separately,
+     * which is only correct for the filters that can be split into
+     * patches
+     */
+    if (!filter->supportsThreading()) {
+        filter->process(src, dst, KisSelectionSP(), rect, config);
+        return;
+    }
+
+    const int lod = src->defaultBounds()->currentLevelOfDetail();
+
+    State state;
+    state.config = config.data();
+    state.srcColorSpace = src->colorSpace();
+    state.dstColorSpace = dst->colorSpace();
+    state.srcOffset = QPoint(src->x(), src->y());
+    state.dstOffset = QPoint(dst->x(), dst->y());
+    state.bounds = src->defaultBounds()->bounds();
+    state.srcDefaultPixel = src->defaultPixel();
+    state.dstDefaultPixel = dst->defaultPixel();
+
+    /**
+     * The cells are aligned to the tiles of the destination device,
+     * so that the cached results could be shared with it
+     */
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(rect.translated(-state.dstOffset),
+                                         QSize(cellSize, cellSize));
+
+    QVector<Cell> fullCells;
+    QVector<QRect> missedRects;
+
+    KisDataManagerSP srcDataManager = src->dataManager();
+
+    Q_FOREACH (const QRect &patch, patches) {
+        const QRect cellRect = patch.translated(state.dstOffset);
+
+        if (patch.width() != cellSize || patch.height() != cellSize) {
+            missedRects << cellRect;
+            continue;
+        }
+
+        Cell cell;
+        cell.rect = cellRect;
+        cell.key = cellKey(patch);
+
+        const QRect needRect = filter->neededRect(cellRect, config, lod);
+        srcDataManager->tileDataRevisions(needRect.translated(-state.srcOffset), cell.revisions);
+
+        fullCells << cell;
+    }
+
+    QVector<Cell> newCells;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        Level &level = m_d->levels[lod];
+
+        if (!level.device || level.state != state) {
+            level.state = state;
+            level.device = new KisPaintDevice(state.dstColorSpace);
+            level.device->setDefaultPixel(state.dstDefaultPixel);
+            level.device->moveTo(state.dstOffset);
+            level.cells.clear();
+        }
+
+        const quint64 currentUse = ++m_d->lastUse;
+
+        Q_FOREACH (const Cell &cell, fullCells) {
+            auto it = level.cells.find(cell.key);
+
+            if (it != level.cells.end() && it->revisions == cell.revisions) {
+                KisPainter::copyAreaOptimized(cell.rect.topLeft(), level.device, dst, cell.rect);
+                it->lastUse = currentUse;
+            } else {
+                missedRects << cell.rect;
+                newCells << cell;
+            }
+        }
+    }
+
+    if (missedRects.isEmpty()) return;
+
+    if (newCells.size() == fullCells.size()) {
+        // nothing has been taken from the cache
+        filter->process(src, dst, KisSelectionSP(), rect, config);
+    } else {
+        auto endIt = KisRegion::mergeSparseRects(missedRects.begin(), missedRects.end());
+
+        for (auto it = missedRects.begin(); it != endIt; ++it) {
+            filter->process(src, dst, KisSelectionSP(), *it, config);
+        }
+    }
+
+    if (newCells.isEmpty()) return;
+
+    QMutexLocker l(&m_d->mutex);
+
+    Level &level = m_d->levels[lod];
+
+    // the cache might have been reset while the filter was running
+    if (!level.device || level.state != state) return;
+
+    const quint64 currentUse = ++m_d->lastUse;
+
+    Q_FOREACH (const Cell &cell, newCells) {
+        KisPainter::copyAreaOptimized(cell.rect.topLeft(), dst, level.device, cell.rect);
+
+        CachedCell &cachedCell = level.cells[cell.key];
+        cachedCell.rect = cell.rect;
+        cachedCell.revisions = cell.revisions;
+        cachedCell.lastUse = currentUse;
+    }
+
+    const int cellBytes = cellSize * cellSize * state.dstColorSpace->pixelSize();
+    m_d->dropOldCells(maxCacheSizeBytes / cellBytes);
+}
+
+void KisFilterResultCache::invalidate()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->levels.clear();
+}
@@ -0,0 +1,80 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFILTERRESULTCACHE_H
+#define KISFILTERRESULTCACHE_H
+
+#include <QScopedPointer>
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+
+class QRect;
+
+/**
+ * Keeps the pixels produced by the filter of a filter mask, so that
+ * they could be reused when the mask is applied again, but the pixels
+ * the filter depends on have not changed.
+ *
+ * The result is stored per tile of the destination device. Every tile
+ * is keyed by the revisions of the source tiles covering the rect the
+ * filter needs for it (KisFilter::neededRect()), so a change of the
+ * source invalidates exactly the tiles it can influence. Only the
+ * tiles lying completely inside the processed rect are cached, the
+ * rest is always filtered again.
+ *
+ * The source of a mask is a copy-on-write clone of the layer original,
+ * so the tiles that haven't been painted on keep their revisions
+ * between the updates of the projection. Only the tiles crossing the
+ * border of the updated rect are copied pixel by pixel and get new
+ * revisions, so the cells needing them are always filtered again.
+ *
+ * The cached tiles are shared with the destination device through
+ * copy-on-write, so the cache doesn't copy pixels unless the
+ * destination is changed later. The least recently used tiles are
+ * dropped when the cache grows over 64 MiB.
+ *
+ * Filters that don't support threading are never cached, because
+ * their result can't be stitched from separately filtered pieces.
+ *
+ * The cache doesn't track the filter configuration, call invalidate()
+ * whenever it changes.
+ */
+class KRITAIMAGE_EXPORT KisFilterResultCache
+{
+public:
+    KisFilterResultCache();
+    ~KisFilterResultCache();
+
+    /**
+     * @return true if the results of the filters should be cached,
+     *         see KisImageConfig::cacheFilterResults(). The value
+     *         is reread on KisImageConfigNotifier::configChanged()
+     */
+    static bool isEnabled();
+
+    /**
+     * Does the same as KisFilter::process() without a selection, but
+     * takes the tiles that have already been filtered from the same
+     * source pixels from the cache.
+     */
+    void process(const KisFilter *filter,
+                 KisFilterConfigurationSP config,
+                 KisPaintDeviceSP src,
+                 KisPaintDeviceSP dst,
+                 const QRect &rect);
+
+    /**
+     * Drops all the cached results
+     */
+    void invalidate();
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFILTERRESULTCACHE_H
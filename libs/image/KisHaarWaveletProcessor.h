@@ -0,0 +1,261 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETPROCESSOR_H
+#define KISHAARWAVELETPROCESSOR_H
+
+#include "KisHaarWaveletProcessorBase.h"
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+namespace KisHaarWaveletProcessorDetail
+{
+
+/**
+ * The butterflies are computed from the sums and the differences of
+ * the two source rows, so that the scalar and the vector versions add
+ * the values in the same order and give exactly the same result:
+ *
+ *    LL = ((s11 + s21) + (s12 + s22)) * factor
+ *    HL = ((s11 + s21) - (s12 + s22)) * factor
+ *    LH = ((s11 - s21) + (s12 - s22)) * factor
+ *    HH = ((s11 - s21) - (s12 - s22)) * factor
+ *
+ * The kernel is templated by the architecture only to keep the copies
+ * compiled with different instruction sets apart.
+ */
+template<typename _impl>
+struct ScalarKernel {
+    static void transformRow(const float *s1, const float *s2,
+                             float *ll, float *hl, float *lh, float *hh,
+                             int offset, int halfsize, float factor)
+    {
+        for (int j = offset; j < halfsize; j++) {
+            const float sumEven = s1[2 * j] + s2[2 * j];
+            const float sumOdd = s1[2 * j + 1] + s2[2 * j + 1];
+            const float diffEven = s1[2 * j] - s2[2 * j];
+            const float diffOdd = s1[2 * j + 1] - s2[2 * j + 1];
+
+            ll[j] = (sumEven + sumOdd) * factor;
+            hl[j] = (sumEven - sumOdd) * factor;
+            lh[j] = (diffEven + diffOdd) * factor;
+            hh[j] = (diffEven - diffOdd) * factor;
+        }
+    }
+
+    static void untransformRow(const float *ll, const float *hl, const float *lh, const float *hh,
+                               float *s1, float *s2,
+                               int offset, int halfsize, float factor)
+    {
+        for (int j = offset; j < halfsize; j++) {
+            const float sumLow = ll[j] + lh[j];
+            const float sumHigh = hl[j] + hh[j];
+            const float diffLow = ll[j] - lh[j];
+            const float diffHigh = hl[j] - hh[j];
+
+            s1[2 * j] = (sumLow + sumHigh) * factor;
+            s1[2 * j + 1] = (sumLow - sumHigh) * factor;
+            s2[2 * j] = (diffLow + diffHigh) * factor;
+            s2[2 * j + 1] = (diffLow - diffHigh) * factor;
+        }
+    }
+};
+
+/**
+ * Processes float_v::size blocks at once. The source rows are split
+ * into the even and the odd columns with a couple of shuffles, so the
+ * butterflies themselves are plain vertical operations.
+ */
+template<typename _impl>
+struct VectorKernel {
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr bool isAvx()
+    {
+#if XSIMD_WITH_AVX
+        return std::is_base_of<xsimd::avx, _impl>::value;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * The only widths the shuffles are implemented for: the 128-bit
+     * registers and AVX
+     */
+    static constexpr bool isSupported()
+    {
+        return isAvx() || float_v::size == 4;
+    }
+
+    static void deinterleave(const float *src, float_v &even, float_v &odd)
+    {
+#if XSIMD_WITH_AVX
+        if constexpr (isAvx()) {
+            const __m256 a = _mm256_loadu_ps(src);
+            const __m256 b = _mm256_loadu_ps(src + 8);
+            const __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+            const __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+            even = float_v(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+            odd = float_v(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+            return;
+        }
+#endif
+        const float_v a = float_v::load_unaligned(src);
+        const float_v b = float_v::load_unaligned(src + float_v::size);
+        const float_v t1 = xsimd::zip_lo(a, b);
+        const float_v t2 = xsimd::zip_hi(a, b);
+        even = xsimd::zip_lo(t1, t2);
+        odd = xsimd::zip_hi(t1, t2);
+    }
+
+    static void interleave(float *dst, const float_v &even, const float_v &odd)
+    {
+#if XSIMD_WITH_AVX
+        if constexpr (isAvx()) {
+            const __m256 lo = _mm256_unpacklo_ps(even, odd);
+            const __m256 hi = _mm256_unpackhi_ps(even, odd);
+            _mm256_storeu_ps(dst, _mm256_permute2f128_ps(lo, hi, 0x20));
+            _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+            return;
+        }
+#endif
+        xsimd::zip_lo(even, odd).store_unaligned(dst);
+        xsimd::zip_hi(even, odd).store_unaligned(dst + float_v::size);
+    }
+
+    static int transformRow(const float *s1, const float *s2,
+                            float *ll, float *hl, float *lh, float *hh,
+                            int halfsize, float factor)
+    {
+        if constexpr (!isSupported()) {
+            return 0;
+        } else {
+            const int numBlocks = halfsize / static_cast<int>(float_v::size);
+            const float_v factor_v(factor);
+
+            for (int i = 0; i < numBlocks; i++) {
+                const int j = i * static_cast<int>(float_v::size);
+
+                float_v even1, odd1, even2, odd2;
+                deinterleave(s1 + 2 * j, even1, odd1);
+                deinterleave(s2 + 2 * j, even2, odd2);
+
+                const float_v sumEven = even1 + even2;
+                const float_v sumOdd = odd1 + odd2;
+                const float_v diffEven = even1 - even2;
+                const float_v diffOdd = odd1 - odd2;
+
+                ((sumEven + sumOdd) * factor_v).store_unaligned(ll + j);
+                ((sumEven - sumOdd) * factor_v).store_unaligned(hl + j);
+                ((diffEven + diffOdd) * factor_v).store_unaligned(lh + j);
+                ((diffEven - diffOdd) * factor_v).store_unaligned(hh + j);
+            }
+
+            return numBlocks * static_cast<int>(float_v::size);
+        }
+    }
+
+    static int untransformRow(const float *ll, const float *hl, const float *lh, const float *hh,
+                              float *s1, float *s2,
+                              int halfsize, float factor)
+    {
+        if constexpr (!isSupported()) {
+            return 0;
+        } else {
+            const int numBlocks = halfsize / static_cast<int>(float_v::size);
+            const float_v factor_v(factor);
+
+            for (int i = 0; i < numBlocks; i++) {
+                const int j = i * static_cast<int>(float_v::size);
+
+                const float_v valueLL = float_v::load_unaligned(ll + j);
+                const float_v valueHL = float_v::load_unaligned(hl + j);
+                const float_v valueLH = float_v::load_unaligned(lh + j);
+                const float_v valueHH = float_v::load_unaligned(hh + j);
+
+                const float_v sumLow = valueLL + valueLH;
+                const float_v sumHigh = valueHL + valueHH;
+                const float_v diffLow = valueLL - valueLH;
+                const float_v diffHigh = valueHL - valueHH;
+
+                interleave(s1 + 2 * j, (sumLow + sumHigh) * factor_v, (sumLow - sumHigh) * factor_v);
+                interleave(s2 + 2 * j, (diffLow + diffHigh) * factor_v, (diffLow - diffHigh) * factor_v);
+            }
+
+            return numBlocks * static_cast<int>(float_v::size);
+        }
+    }
+};
+
+} // namespace KisHaarWaveletProcessorDetail
+
+template<typename _impl = xsimd::current_arch>
+class KisHaarWaveletProcessor : public KisHaarWaveletProcessorBase
+{
+public:
+    void transformLevel(float *plane, float *buff, int stride, int size) const override
+    {
+        const int halfsize = size / 2;
+        const float factor = M_SQRT1_2;
+
+        for (int i = 0; i < halfsize; i++) {
+            const float *s1 = plane + 2 * i * stride;
+            const float *s2 = s1 + stride;
+            float *ll = buff + i * stride;
+            float *hl = ll + halfsize;
+            float *lh = buff + (halfsize + i) * stride;
+            float *hh = lh + halfsize;
+
+            int offset = 0;
+
+            if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+                offset = KisHaarWaveletProcessorDetail::VectorKernel<_impl>::transformRow(s1, s2, ll, hl, lh, hh, halfsize, factor);
+            }
+
+            KisHaarWaveletProcessorDetail::ScalarKernel<_impl>::transformRow(s1, s2, ll, hl, lh, hh, offset, halfsize, factor);
+        }
+
+        for (int i = 0; i < size; i++) {
+            memcpy(plane + i * stride, buff + i * stride, size * sizeof(float));
+        }
+    }
+
+    void untransformLevel(float *plane, float *buff, int stride, int size) const override
+    {
+        const int halfsize = size / 2;
+        const float factor = 0.25 * M_SQRT2;
+
+        for (int i = 0; i < halfsize; i++) {
+            const float *ll = plane + i * stride;
+            const float *hl = ll + halfsize;
+            const float *lh = plane + (halfsize + i) * stride;
+            const float *hh = lh + halfsize;
+            float *s1 = buff + 2 * i * stride;
+            float *s2 = s1 + stride;
+
+            int offset = 0;
+
+            if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+                offset = KisHaarWaveletProcessorDetail::VectorKernel<_impl>::untransformRow(ll, hl, lh, hh, s1, s2, halfsize, factor);
+            }
+
+            KisHaarWaveletProcessorDetail::ScalarKernel<_impl>::untransformRow(ll, hl, lh, hh, s1, s2, offset, halfsize, factor);
+        }
+
+        for (int i = 0; i < size; i++) {
+            memcpy(plane + i * stride, buff + i * stride, size * sizeof(float));
+        }
+    }
+};
+
+#endif // KISHAARWAVELETPROCESSOR_H
@@ -0,0 +1,38 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETPROCESSORBASE_H
+#define KISHAARWAVELETPROCESSORBASE_H
+
+#include <QtGlobal>
+#include "kritaimage_export.h"
+
+/**
+ * The 2x2 butterflies of the Haar wavelet transform used by
+ * KisMathToolbox, compiled for every supported architecture. The
+ * coefficients are stored in square planes of floats, one plane per
+ * channel.
+ */
+class KRITAIMAGE_EXPORT KisHaarWaveletProcessorBase
+{
+public:
+    virtual ~KisHaarWaveletProcessorBase();
+
+    /**
+     * One level of the transform for the top-left \p size x \p size
+     * area of \p plane. The averages are written into the top-left
+     * quarter of the area and the details into the other three.
+     * \p buff should have the same size and \p stride as \p plane.
+     */
+    virtual void transformLevel(float *plane, float *buff, int stride, int size) const = 0;
+
+    /**
+     * The inverse of transformLevel()
+     */
+    virtual void untransformLevel(float *plane, float *buff, int stride, int size) const = 0;
+};
+
+#endif // KISHAARWAVELETPROCESSORBASE_H
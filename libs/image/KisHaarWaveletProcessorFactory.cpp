@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHaarWaveletProcessorFactory.h"
+
+#include "KisHaarWaveletProcessorFactoryImpl.h"
+
+KisHaarWaveletProcessorBase *KisHaarWaveletProcessorFactory::create()
+{
+    return createOptimizedClass<KisHaarWaveletProcessorFactoryImpl>();
+}
+
+KisHaarWaveletProcessorBase *KisHaarWaveletProcessorFactory::createScalar()
+{
+    return createScalarClass<KisHaarWaveletProcessorFactoryImpl>();
+}
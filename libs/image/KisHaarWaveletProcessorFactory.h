@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETPROCESSORFACTORY_H
+#define KISHAARWAVELETPROCESSORFACTORY_H
+
+#include "kritaimage_export.h"
+
+class KisHaarWaveletProcessorBase;
+
+class KRITAIMAGE_EXPORT KisHaarWaveletProcessorFactory
+{
+public:
+    static KisHaarWaveletProcessorBase* create();
+    static KisHaarWaveletProcessorBase* createScalar();
+};
+
+#endif // KISHAARWAVELETPROCESSORFACTORY_H
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHaarWaveletProcessorFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "KisHaarWaveletProcessor.h"
+
+template<>
+KisHaarWaveletProcessorBase *
+KisHaarWaveletProcessorFactoryImpl::create<xsimd::current_arch>()
+{
+    return new KisHaarWaveletProcessor<xsimd::current_arch>();
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAARWAVELETPROCESSORFACTORYIMPL_H
+#define KISHAARWAVELETPROCESSORFACTORYIMPL_H
+
+#include <KisHaarWaveletProcessorBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAIMAGE_EXPORT KisHaarWaveletProcessorFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisHaarWaveletProcessorBase* create();
+};
+
+#endif // KISHAARWAVELETPROCESSORFACTORYIMPL_H
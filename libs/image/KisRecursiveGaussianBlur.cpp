@@ -0,0 +1,459 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRecursiveGaussianBlur.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <QBitArray>
+#include <QRect>
+#include <QVector>
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include "kis_assert.h"
+#include "kis_default_bounds.h"
+#include "kis_gaussian_kernel.h"
+#include "kis_math_toolbox.h"
+#include "kis_paint_device.h"
+
+namespace {
+
+/**
+ * The recursion is done in double precision: the poles of the filter
+ * get very close to 1.0 for big sigmas and a single precision state
+ * just explodes. The buffers themselves are stored in floats.
+ */
+struct DericheCoefficients {
+    double n[4];
+    double m[4];
+    double d[4];
+
+    double causalGain;
+    double anticausalGain;
+};
+
+/**
+ * When the kernel is wider than this threshold, the recursive filter
+ * becomes faster than the explicit kernel.
+ */
+const int minKernelSizeForRecursiveFilter = 13;
+
+/**
+ * The vertical pass processes the columns in the strips of this
+ * number of floats, so the state of the recursion fits into the cache.
+ */
+const int maxLineSize = 256;
+
+DericheCoefficients dericheCoefficients(qreal sigma)
+{
+    /**
+     * The fourth-order approximation of the Gaussian by R. Deriche
+     * ("Recursively implementing the Gaussian and its derivatives",
+     * 1993). The impulse response is split into the causal and
+     * anti-causal parts, which are applied in the opposite directions
+     * and summed up.
+     */
+
+    const double a0 = 1.680;
+    const double a1 = 3.735;
+    const double w0 = 0.6318;
+    const double b0 = 1.783;
+    const double c0 = -0.6803;
+    const double c1 = -0.2598;
+    const double w1 = 1.997;
+    const double b1 = 1.723;
+
+    sigma = qMax(sigma, 0.5);
+
+    const double e0 = std::exp(-b0 / sigma);
+    const double e1 = std::exp(-b1 / sigma);
+    const double cos0 = std::cos(w0 / sigma);
+    const double sin0 = std::sin(w0 / sigma);
+    const double cos1 = std::cos(w1 / sigma);
+    const double sin1 = std::sin(w1 / sigma);
+
+    DericheCoefficients c;
+
+    c.n[0] = a0 + c0;
+    c.n[1] = e1 * (c1 * sin1 - (c0 + 2 * a0) * cos1) +
+             e0 * (a1 * sin0 - (2 * c0 + a0) * cos0);
+    c.n[2] = 2 * e0 * e1 * ((a0 + c0) * cos1 * cos0 - a1 * cos1 * sin0 - c1 * cos0 * sin1) +
+             c0 * e0 * e0 + a0 * e1 * e1;
+    c.n[3] = e1 * e0 * e0 * (c1 * sin1 - c0 * cos1) +
+             e0 * e1 * e1 * (a1 * sin0 - a0 * cos0);
+
+    c.d[0] = -2 * e1 * cos1 - 2 * e0 * cos0;
+    c.d[1] = 4 * cos1 * cos0 * e0 * e1 + e1 * e1 + e0 * e0;
+    c.d[2] = -2 * cos0 * e0 * e1 * e1 - 2 * cos1 * e1 * e0 * e0;
+    c.d[3] = e0 * e0 * e1 * e1;
+
+    c.m[0] = c.n[1] - c.d[0] * c.n[0];
+    c.m[1] = c.n[2] - c.d[1] * c.n[0];
+    c.m[2] = c.n[3] - c.d[2] * c.n[0];
+    c.m[3] = -c.d[3] * c.n[0];
+
+    const double denominator = 1.0 + c.d[0] + c.d[1] + c.d[2] + c.d[3];
+    const double nSum = c.n[0] + c.n[1] + c.n[2] + c.n[3];
+    const double mSum = c.m[0] + c.m[1] + c.m[2] + c.m[3];
+
+    // normalize the filter to have unit gain on a constant signal
+    const double normalization = denominator / (nSum + mSum);
+
+    for (int i = 0; i < 4; i++) {
+        c.n[i] *= normalization;
+        c.m[i] *= normalization;
+    }
+
+    // the steady state of the both parts for a constant signal
+    c.causalGain = nSum * normalization / denominator;
+    c.anticausalGain = mSum * normalization / denominator;
+
+    return c;
+}
+
+/**
+ * Applies the filter to \p count samples with the distance of
+ * \p stride floats between them. Every sample is a vector of
+ * \p lineSize contiguous floats filtered independently, so the
+ * inner loops run over contiguous memory and can be vectorized.
+ *
+ * The signal outside the range is considered to be equal to the
+ * first and the last sample respectively.
+ */
+void filterLine(float *data, int count, int stride, int lineSize,
+                const DericheCoefficients &c, QVector<double> &workspace)
+{
+    if (count <= 1) return;
+
+    const int historySize = 8 * lineSize;
+    workspace.resize(historySize + count * lineSize);
+
+    double *x[4];
+    double *y[4];
+    for (int i = 0; i < 4; i++) {
+        x[i] = workspace.data() + i * lineSize;
+        y[i] = workspace.data() + (4 + i) * lineSize;
+    }
+    double *causal = workspace.data() + historySize;
+
+    auto rotate = [] (double **history) {
+        double *oldest = history[3];
+        history[3] = history[2];
+        history[2] = history[1];
+        history[1] = history[0];
+        history[0] = oldest;
+    };
+
+    // causal part: x[k] and y[k] hold the samples n-1-k
+
+    for (int j = 0; j < lineSize; j++) {
+        const double value = data[j];
+        for (int k = 0; k < 4; k++) {
+            x[k][j] = value;
+            y[k][j] = value * c.causalGain;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const float *src = data + i * stride;
+        double *dst = causal + i * lineSize;
+
+        double *newX = x[3];
+        double *newY = y[3];
+
+        for (int j = 0; j < lineSize; j++) {
+            const double value = src[j];
+            const double result =
+                c.n[0] * value + c.n[1] * x[0][j] + c.n[2] * x[1][j] + c.n[3] * x[2][j] -
+                c.d[0] * y[0][j] - c.d[1] * y[1][j] - c.d[2] * y[2][j] - c.d[3] * y[3][j];
+
+            newX[j] = value;
+            newY[j] = result;
+            dst[j] = result;
+        }
+
+        rotate(x);
+        rotate(y);
+    }
+
+    // anti-causal part: x[k] and y[k] hold the samples n+1+k
+
+    const float *last = data + (count - 1) * stride;
+    for (int j = 0; j < lineSize; j++) {
+        const double value = last[j];
+        for (int k = 0; k < 4; k++) {
+            x[k][j] = value;
+            y[k][j] = value * c.anticausalGain;
+        }
+    }
+
+    for (int i = count - 1; i >= 0; i--) {
+        float *dst = data + i * stride;
+        const double *causalPart = causal + i * lineSize;
+
+        double *newX = x[3];
+        double *newY = y[3];
+
+        for (int j = 0; j < lineSize; j++) {
+            const double result =
+                c.m[0] * x[0][j] + c.m[1] * x[1][j] + c.m[2] * x[2][j] + c.m[3] * x[3][j] -
+                c.d[0] * y[0][j] - c.d[1] * y[1][j] - c.d[2] * y[2][j] - c.d[3] * y[3][j];
+
+            newX[j] = dst[j];
+            newY[j] = result;
+            dst[j] = causalPart[j] + result;
+        }
+
+        rotate(x);
+        rotate(y);
+    }
+}
+
+inline void limitValue(qreal *value, qreal lowBound, qreal highBound) {
+    if (*value > highBound) {
+        *value = highBound;
+    } else if (!(*value >= lowBound)) {  // value < lowBound or value == NaN
+        *value = lowBound;
+    }
+}
+
+}
+
+bool KisRecursiveGaussianBlur::isPreferredFor(qreal radius)
+{
+    return radius > 0.0 &&
+        KisGaussianKernel::kernelSizeFromRadius(radius) > minKernelSizeForRecursiveFilter;
+}
+
+void KisRecursiveGaussianBlur::blurBuffer(float *data, int width, int height, int numChannels,
+                                          qreal xSigma, qreal ySigma)
+{
+    QVector<double> workspace;
+
+    if (xSigma > 0.0) {
+        const DericheCoefficients c = dericheCoefficients(xSigma);
+        const int rowStride = width * numChannels;
+
+        for (int row = 0; row < height; row++) {
+            filterLine(data + row * rowStride, width, numChannels, numChannels, c, workspace);
+        }
+    }
+
+    if (ySigma > 0.0) {
+        const DericheCoefficients c = dericheCoefficients(ySigma);
+        const int rowStride = width * numChannels;
+
+        for (int column = 0; column < rowStride; column += maxLineSize) {
+            const int lineSize = qMin(maxLineSize, rowStride - column);
+            filterLine(data + column, height, rowStride, lineSize, c, workspace);
+        }
+    }
+}
+
+bool KisRecursiveGaussianBlur::apply(KisPaintDeviceSP device,
+                                     const QRect &rect,
+                                     qreal xRadius, qreal yRadius,
+                                     const QBitArray &channelFlags,
+                                     KoUpdater *progressUpdater,
+                                     KisConvolutionBorderOp borderOp)
+{
+    if (rect.isEmpty()) return true;
+
+    const KoColorSpace *cs = device->colorSpace();
+
+    QList<KoChannelInfo*> channels;
+    {
+        const QList<KoChannelInfo*> allChannels = cs->channels();
+        for (int i = 0; i < allChannels.size(); i++) {
+            if (channelFlags.isEmpty() || channelFlags.testBit(i)) {
+                channels.append(allChannels[i]);
+            }
+        }
+    }
+
+    if (channels.isEmpty()) return true;
+
+    KisMathToolbox mathToolbox;
+    QVector<PtrToDouble> toDouble(channels.size());
+    QVector<PtrFromDouble> fromDouble(channels.size());
+    QVector<PtrFromDoubleCheckNull> fromDoubleCheckNull(channels.size());
+
+    if (!mathToolbox.getToDoubleChannelPtr(channels, toDouble) ||
+        !mathToolbox.getFromDoubleChannelPtr(channels, fromDouble) ||
+        !mathToolbox.getFromDoubleCheckNullChannelPtr(channels, fromDoubleCheckNull)) {
+
+        return false;
+    }
+
+    const int numChannels = channels.size();
+    QVector<qreal> minClamp(numChannels);
+    QVector<qreal> maxClamp(numChannels);
+    QVector<int> channelPos(numChannels);
+    int alphaIndex = -1;
+
+    for (int k = 0; k < numChannels; k++) {
+        minClamp[k] = mathToolbox.minChannelValue(channels[k]);
+        maxClamp[k] = mathToolbox.maxChannelValue(channels[k]);
+        channelPos[k] = channels[k]->pos();
+
+        if (channels[k]->channelType() == KoChannelInfo::ALPHA) {
+            alphaIndex = k;
+        }
+    }
+
+    /**
+     * Read the same area the explicit kernel would read, so the filter
+     * could be a drop-in replacement for it in the filters that declare
+     * their need rects from the kernel size.
+     */
+    const qreal xSigma = xRadius > 0.0 ? KisGaussianKernel::sigmaFromRadius(xRadius) : 0.0;
+    const qreal ySigma = yRadius > 0.0 ? KisGaussianKernel::sigmaFromRadius(yRadius) : 0.0;
+    const int xMargin = xRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(xRadius) / 2 : 0;
+    const int yMargin = yRadius > 0.0 ? KisGaussianKernel::kernelSizeFromRadius(yRadius) / 2 : 0;
+
+    const QRect needRect = rect.adjusted(-xMargin, -yMargin, xMargin, yMargin);
+
+    if (device->defaultBounds()->wrapAroundMode()) {
+        borderOp = BORDER_IGNORE;
+    }
+
+    QRect readRect = needRect;
+
+    if (borderOp == BORDER_REPEAT) {
+        // the same data rect as KisConvolutionPainter uses
+        const QRect boundsRect = device->defaultBounds()->bounds();
+        QRect dataRect = rect | boundsRect;
+
+        KIS_SAFE_ASSERT_RECOVER(boundsRect != KisDefaultBounds().bounds()) {
+            dataRect = rect | device->exactBounds();
+        }
+
+        readRect &= dataRect;
+    }
+
+    const int pixelSize = cs->pixelSize();
+    QVector<quint8> srcBytes(readRect.width() * readRect.height() * pixelSize);
+    device->readBytes(srcBytes.data(), readRect);
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(10);
+    }
+
+    // convert the pixels into the premultiplied float representation
+
+    const int width = needRect.width();
+    const int height = needRect.height();
+    QVector<float> buffer(width * height * numChannels);
+
+    {
+        float *dstPtr = buffer.data();
+
+        for (int y = needRect.top(); y <= needRect.bottom(); y++) {
+            const int srcY = qBound(readRect.top(), y, readRect.bottom()) - readRect.top();
+            const quint8 *srcRow = srcBytes.constData() + srcY * readRect.width() * pixelSize;
+
+            for (int x = needRect.left(); x <= needRect.right(); x++) {
+                const int srcX = qBound(readRect.left(), x, readRect.right()) - readRect.left();
+                const quint8 *srcPtr = srcRow + srcX * pixelSize;
+
+                const double alphaValue =
+                    alphaIndex >= 0 ? toDouble[alphaIndex](srcPtr, channelPos[alphaIndex]) : 1.0;
+
+                for (int k = 0; k < numChannels; k++) {
+                    dstPtr[k] = k != alphaIndex ?
+                        toDouble[k](srcPtr, channelPos[k]) * alphaValue :
+                        alphaValue;
+                }
+
+                dstPtr += numChannels;
+            }
+        }
+    }
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(20);
+    }
+
+    blurBuffer(buffer.data(), width, height, numChannels, xSigma, ySigma);
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(80);
+    }
+
+    // write the result back, the channels that were not blurred keep
+    // their original values
+
+    QVector<quint8> dstBytes(rect.width() * rect.height() * pixelSize);
+
+    for (int y = 0; y < rect.height(); y++) {
+        const int srcY = rect.top() + y - readRect.top();
+        const int srcX = rect.left() - readRect.left();
+
+        memcpy(dstBytes.data() + y * rect.width() * pixelSize,
+               srcBytes.constData() + (srcY * readRect.width() + srcX) * pixelSize,
+               rect.width() * pixelSize);
+    }
+
+    {
+        quint8 *dstPtr = dstBytes.data();
+
+        for (int y = 0; y < rect.height(); y++) {
+            const float *srcPtr = buffer.constData() +
+                ((y + yMargin) * width + xMargin) * numChannels;
+
+            for (int x = 0; x < rect.width(); x++) {
+                if (alphaIndex >= 0) {
+                    qreal alphaValue = srcPtr[alphaIndex];
+                    limitValue(&alphaValue, minClamp[alphaIndex], maxClamp[alphaIndex]);
+
+                    bool alphaIsNullInDstSpace = false;
+                    fromDoubleCheckNull[alphaIndex](dstPtr, channelPos[alphaIndex], alphaValue, &alphaIsNullInDstSpace);
+
+                    if (!alphaIsNullInDstSpace &&
+                        alphaValue > std::numeric_limits<qreal>::epsilon()) {
+
+                        const qreal alphaValueInv = 1.0 / alphaValue;
+
+                        for (int k = 0; k < numChannels; k++) {
+                            if (k == alphaIndex) continue;
+
+                            qreal value = srcPtr[k] * alphaValueInv;
+                            limitValue(&value, minClamp[k], maxClamp[k]);
+                            fromDouble[k](dstPtr, channelPos[k], value);
+                        }
+                    } else {
+                        for (int k = 0; k < numChannels; k++) {
+                            if (k == alphaIndex) continue;
+                            fromDouble[k](dstPtr, channelPos[k], 0.0);
+                        }
+                    }
+                } else {
+                    for (int k = 0; k < numChannels; k++) {
+                        qreal value = srcPtr[k];
+                        limitValue(&value, minClamp[k], maxClamp[k]);
+                        fromDouble[k](dstPtr, channelPos[k], value);
+                    }
+                }
+
+                srcPtr += numChannels;
+                dstPtr += pixelSize;
+            }
+        }
+    }
+
+    device->writeBytes(dstBytes.constData(), rect);
+
+    if (progressUpdater) {
+        progressUpdater->setProgress(100);
+    }
+
+    return true;
+}
@@ -0,0 +1,72 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISRECURSIVEGAUSSIANBLUR_H
+#define KISRECURSIVEGAUSSIANBLUR_H
+
+#include "kritaimage_export.h"
+#include "kis_types.h"
+#include "kis_convolution_painter.h"
+
+class QRect;
+class QBitArray;
+class KoUpdater;
+
+/**
+ * @brief Gaussian blur with the cost independent of the radius
+ *
+ * The blur is implemented as a fourth-order recursive (IIR) filter by
+ * Deriche, applied along the rows and then along the columns of the
+ * area. Every pass costs a fixed number of multiplications per channel
+ * of a pixel, so a 300px blur is as fast as a 10px one and doesn't need
+ * any huge kernel or FFT buffers.
+ *
+ * The result is an approximation of the convolution with the kernel
+ * created by KisGaussianKernel. The difference is a small fraction of
+ * an 8-bit level, but for small radii the explicit kernel is both exact
+ * and fast, so the filter is used only for the big ones (see
+ * isPreferredFor()).
+ *
+ * The color channels are premultiplied by alpha, just like the
+ * convolution workers do.
+ */
+class KRITAIMAGE_EXPORT KisRecursiveGaussianBlur
+{
+public:
+    /**
+     * @return true if the recursive filter should be used instead of
+     *         the explicit kernel for the blur along one axis with the
+     *         given radius
+     */
+    static bool isPreferredFor(qreal radius);
+
+    /**
+     * Blurs \p rect of \p device in place. The meaning of the
+     * arguments is the same as in KisGaussianKernel::applyGaussian().
+     * The pixels are read before anything is written, so no
+     * transaction is needed to protect the source.
+     *
+     * @return false if the channel type of the color space is not
+     *         supported, the device is not touched in such a case
+     */
+    static bool apply(KisPaintDeviceSP device,
+                      const QRect &rect,
+                      qreal xRadius, qreal yRadius,
+                      const QBitArray &channelFlags,
+                      KoUpdater *progressUpdater,
+                      KisConvolutionBorderOp borderOp = BORDER_REPEAT);
+
+    /**
+     * Blurs a buffer of \p width x \p height pixels with \p numChannels
+     * interleaved float channels in place. Zero sigma disables the
+     * blur in the corresponding direction. The values outside the
+     * buffer are considered to be equal to the ones on its border.
+     */
+    static void blurBuffer(float *data, int width, int height, int numChannels,
+                           qreal xSigma, qreal ySigma);
+};
+
+#endif // KISRECURSIVEGAUSSIANBLUR_H
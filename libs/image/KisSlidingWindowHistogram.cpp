@@ -0,0 +1,139 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingWindowHistogram.h"
+
+#include <kis_assert.h>
+
+#include <QtMath>
+
+
+KisSlidingWindowHistogram::KisSlidingWindowHistogram(int numBins, int payloadSize, int width, int radius)
+    : m_numBins(numBins),
+      m_payloadSize(payloadSize),
+      m_width(width),
+      m_radius(radius),
+      m_columnCounts(width * numBins),
+      m_columnPayload(width * numBins * payloadSize),
+      m_columnTotals(width),
+      m_kernelCounts(numBins),
+      m_kernelPayload(numBins * payloadSize)
+{
+    KIS_SAFE_ASSERT_RECOVER_NOOP(width >= 2 * radius + 1);
+}
+
+void KisSlidingWindowHistogram::addRow(const int *bins, const float *payload)
+{
+    updateRow(bins, payload, 1);
+}
+
+void KisSlidingWindowHistogram::removeRow(const int *bins, const float *payload)
+{
+    updateRow(bins, payload, -1);
+}
+
+void KisSlidingWindowHistogram::updateRow(const int *bins, const float *payload, int sign)
+{
+    for (int x = 0; x < m_width; x++) {
+        const int bin = bins[x];
+        if (bin < 0) continue;
+
+        KIS_SAFE_ASSERT_RECOVER(bin < m_numBins) { continue; }
+
+        m_columnCounts[x * m_numBins + bin] += sign;
+        m_columnTotals[x] += sign;
+
+        if (m_payloadSize) {
+            float *dst = m_columnPayload.data() + (x * m_numBins + bin) * m_payloadSize;
+            const float *src = payload + x * m_payloadSize;
+
+            for (int i = 0; i < m_payloadSize; i++) {
+                dst[i] += sign * src[i];
+            }
+        }
+    }
+}
+
+void KisSlidingWindowHistogram::addColumn(int column, int sign)
+{
+    // the columns with all the pixels skipped are quite common
+    // for transparent areas, no need to touch them
+    if (!m_columnTotals[column]) return;
+
+    const int *srcCounts = m_columnCounts.constData() + column * m_numBins;
+    int *dstCounts = m_kernelCounts.data();
+
+    for (int i = 0; i < m_numBins; i++) {
+        dstCounts[i] += sign * srcCounts[i];
+    }
+
+    m_kernelTotal += sign * m_columnTotals[column];
+
+    if (m_payloadSize) {
+        const int size = m_numBins * m_payloadSize;
+        const float *srcPayload = m_columnPayload.constData() + column * size;
+        float *dstPayload = m_kernelPayload.data();
+
+        for (int i = 0; i < size; i++) {
+            dstPayload[i] += sign * srcPayload[i];
+        }
+    }
+}
+
+void KisSlidingWindowHistogram::resetKernel()
+{
+    m_kernelCounts.fill(0);
+    m_kernelPayload.fill(0.0f);
+    m_kernelTotal = 0;
+    m_kernelColumn = 0;
+
+    for (int x = 0; x < 2 * m_radius + 1; x++) {
+        addColumn(x, 1);
+    }
+}
+
+void KisSlidingWindowHistogram::moveKernel()
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(m_kernelColumn + 2 * m_radius + 1 < m_width);
+
+    addColumn(m_kernelColumn, -1);
+    addColumn(m_kernelColumn + 2 * m_radius + 1, 1);
+    m_kernelColumn++;
+}
+
+int KisSlidingWindowHistogram::mostFrequentBin() const
+{
+    if (!m_kernelTotal) return -1;
+
+    int result = 0;
+    int maxCount = m_kernelCounts[0];
+
+    for (int i = 1; i < m_numBins; i++) {
+        if (m_kernelCounts[i] > maxCount) {
+            result = i;
+            maxCount = m_kernelCounts[i];
+        }
+    }
+
+    return result;
+}
+
+int KisSlidingWindowHistogram::percentileBin(qreal percentile) const
+{
+    if (!m_kernelTotal) return -1;
+
+    const int index = qRound(qBound(0.0, percentile, 1.0) * (m_kernelTotal - 1));
+
+    int sum = 0;
+    for (int i = 0; i < m_numBins; i++) {
+        sum += m_kernelCounts[i];
+        if (sum > index) {
+            return i;
+        }
+    }
+
+    return m_numBins - 1;
+}
@@ -0,0 +1,146 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSLIDINGWINDOWHISTOGRAM_H
+#define KISSLIDINGWINDOWHISTOGRAM_H
+
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+/**
+ * Histogram of a square window of (2 * radius + 1) pixels sliding
+ * over a block of rows, implemented after "Median Filtering in
+ * Constant Time" by S. Perreault and P. Hébert.
+ *
+ * Every column of the source block keeps its own histogram of the
+ * 2 * radius + 1 rows covered by the window. Moving the window down
+ * updates each column histogram with one added and one removed pixel,
+ * and moving it to the right adds one column histogram and subtracts
+ * another one. Therefore the cost per pixel depends on the number of
+ * bins only, not on the radius.
+ *
+ * Every bin may also accumulate a "payload" of several float values,
+ * e.g. the sums of the channels of the pixels falling into it.
+ *
+ * Usage:
+ *
+ * \code{.cpp}
+ * KisSlidingWindowHistogram hist(numBins, 0, width + 2 * radius, radius);
+ *
+ * for (int row = 0; row < 2 * radius + 1; row++) {
+ *     hist.addRow(bins(row), 0);
+ * }
+ *
+ * for (int y = 0; y < height; y++) {
+ *     if (y > 0) {
+ *         hist.removeRow(bins(y - 1), 0);
+ *         hist.addRow(bins(y + 2 * radius), 0);
+ *     }
+ *
+ *     hist.resetKernel();
+ *     for (int x = 0; x < width; x++) {
+ *         if (x > 0) hist.moveKernel();
+ *         // hist.counts() is the histogram of the window at (x, y)
+ *     }
+ * }
+ * \endcode
+ */
+class KRITAIMAGE_EXPORT KisSlidingWindowHistogram
+{
+public:
+    /**
+     * @param numBins the number of bins in the histogram
+     * @param payloadSize the number of floats accumulated in every bin
+     * @param width the width of the source rows, i.e. the width of
+     *              the result plus 2 * \p radius
+     * @param radius the radius of the window
+     */
+    KisSlidingWindowHistogram(int numBins, int payloadSize, int width, int radius);
+
+    /**
+     * Adds a row of the source block into the column histograms.
+     *
+     * @param bins \p width bin indexes, pixels with a negative index
+     *             are skipped
+     * @param payload \p width * \p payloadSize values, may be null if
+     *                there is no payload
+     */
+    void addRow(const int *bins, const float *payload);
+
+    /**
+     * Removes the row, previously added with addRow()
+     */
+    void removeRow(const int *bins, const float *payload);
+
+    /**
+     * Moves the window to the first column of the current rows
+     */
+    void resetKernel();
+
+    /**
+     * Moves the window one column to the right
+     */
+    void moveKernel();
+
+    int numBins() const {
+        return m_numBins;
+    }
+
+    /**
+     * @return the number of the pixels in the window, except the
+     *         skipped ones
+     */
+    int totalCount() const {
+        return m_kernelTotal;
+    }
+
+    const int* counts() const {
+        return m_kernelCounts.constData();
+    }
+
+    /**
+     * @return the payload accumulated in \p bin of the window
+     */
+    const float* payload(int bin) const {
+        return m_kernelPayload.constData() + bin * m_payloadSize;
+    }
+
+    /**
+     * @return the bin with the highest count in the window; the lowest
+     *         one if there are several of them, or -1 if the window is
+     *         empty
+     */
+    int mostFrequentBin() const;
+
+    /**
+     * @return the bin containing the \p percentile of the pixels in the
+     *         window, where 0.5 means the median, or -1 if the window is
+     *         empty
+     */
+    int percentileBin(qreal percentile) const;
+
+private:
+    void updateRow(const int *bins, const float *payload, int sign);
+    void addColumn(int column, int sign);
+
+private:
+    const int m_numBins;
+    const int m_payloadSize;
+    const int m_width;
+    const int m_radius;
+
+    QVector<int> m_columnCounts;
+    QVector<float> m_columnPayload;
+    QVector<int> m_columnTotals;
+
+    QVector<int> m_kernelCounts;
+    QVector<float> m_kernelPayload;
+    int m_kernelTotal = 0;
+    int m_kernelColumn = 0;
+};
+
+#endif // KISSLIDINGWINDOWHISTOGRAM_H
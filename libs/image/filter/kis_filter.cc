@@ -18,6 +18,7 @@
 #include "kis_types.h"
 #include <kis_painter.h>
 #include <KoUpdater.h>
+#include <KisRunnableStrokeJobUtils.h>
 
 KisFilter::KisFilter(const KoID& _id, const KoID & category, const QString & entry)
     : KisBaseProcessor(_id, category, entry),
@@ -30,6 +31,17 @@ KisFilter::~KisFilter()
 {
 }
 
+void KisFilter::addProcessJobs(QVector<KisRunnableStrokeJobData*> &jobs,
+                               KisPaintDeviceSP device,
+                               const QRect& applyRect,
+                               const KisFilterConfigurationSP config,
+                               KoUpdater* progressUpdater) const
+{
+    KritaUtils::addJobSequential(jobs, [this, device, applyRect, config, progressUpdater] () {
+        processImpl(device, applyRect, config, progressUpdater);
+    });
+}
+
 void KisFilter::process(KisPaintDeviceSP device,
                         const QRect& applyRect,
                         const KisFilterConfigurationSP config,
@@ -9,6 +9,7 @@
 #include <list>
 
 #include <QString>
+#include <QVector>
 
 #include <klocalizedstring.h>
 
@@ -20,6 +21,8 @@
 
 #include "kritaimage_export.h"
 
+class KisRunnableStrokeJobData;
+
 /**
  * Basic interface of a Krita filter.
  */
@@ -50,6 +53,24 @@ public:
                              const KisFilterConfigurationSP config,
                              KoUpdater* progressUpdater = 0 ) const = 0;
 
+    /**
+     * Adds the jobs that do the same as processImpl() to \p jobs.
+     *
+     * The filter strokes use it for the filters that don't support
+     * threading, i.e. the ones that cannot be split into independent
+     * patches. Such a filter may override it to split the work into
+     * its own stages, which will then run on the threads of the
+     * strokes framework, within the thread limit of the image.
+     *
+     * The default implementation adds a single sequential job that
+     * calls processImpl().
+     */
+    virtual void addProcessJobs(QVector<KisRunnableStrokeJobData*> &jobs,
+                                KisPaintDeviceSP device,
+                                const QRect& applyRect,
+                                const KisFilterConfigurationSP config,
+                                KoUpdater* progressUpdater = 0) const;
+
     /**
      * Filter \p src device and write the result into \p dst device.
      * If \p dst is an alpha color space device, it will get special
@@ -33,6 +33,7 @@
 #include "kis_refresh_subtree_walker.h"
 
 #include "kis_abstract_projection_plane.h"
+#include "KisColorAdjustmentMaskFusion.h"
 
 
 //#define DEBUG_MERGER
@@ -166,6 +167,69 @@ private:
 };
 
 
+namespace {
+
+/**
+ * Computes the originals of a run of consecutive adjustment layers
+ * starting at \p item in a single pass over \p projection, see
+ * KisColorAdjustmentMaskFusion::tryAddAdjustmentLayer().
+ *
+ * The fused items are popped from \p leafStack and \p item is
+ * replaced with the topmost of them. The layers are composited with
+ * COPY, so only that one should be composited with the projection.
+ */
+bool fuseAdjustmentLayers(KisMergeWalker::JobItem &item,
+                          KisMergeWalker::LeafStack &leafStack,
+                          KisPaintDeviceSP projection,
+                          KisNodeSP startNode)
+{
+    if (!(item.m_position & (KisMergeWalker::N_FILTHY | KisMergeWalker::N_ABOVE_FILTHY)) ||
+        item.m_position & KisMergeWalker::N_TOPMOST ||
+        leafStack.isEmpty()) {
+
+        return false;
+    }
+
+    KisColorAdjustmentMaskFusion fusion(projection);
+    if (!fusion.tryAddAdjustmentLayer(item.m_leaf, item.m_applyRect)) return false;
+
+    QVector<KisMergeWalker::JobItem> items({item});
+
+    while (!(items.last().m_position & KisMergeWalker::N_TOPMOST) && !leafStack.isEmpty()) {
+        const KisMergeWalker::JobItem &nextItem = leafStack.top();
+
+        if (!(nextItem.m_position & (KisMergeWalker::N_FILTHY | KisMergeWalker::N_ABOVE_FILTHY)) ||
+            nextItem.m_position & KisMergeWalker::N_EXTRA ||
+            nextItem.m_applyRect != item.m_applyRect ||
+            nextItem.m_leaf->parent() != item.m_leaf->parent() ||
+            !fusion.tryAddAdjustmentLayer(nextItem.m_leaf, nextItem.m_applyRect)) {
+
+            break;
+        }
+
+        items.append(leafStack.pop());
+    }
+
+    if (items.size() < 2) return false;
+
+    fusion.applyToOriginals(item.m_applyRect);
+
+    Q_FOREACH (const KisMergeWalker::JobItem &fusedItem, items) {
+        DEBUG_NODE_ACTION("Updating", "FUSED", fusedItem.m_leaf, fusedItem.m_applyRect);
+
+        KisNodeSP filthyNode = fusedItem.m_position & KisMergeWalker::N_FILTHY ?
+            startNode : fusedItem.m_leaf->node();
+
+        fusedItem.m_leaf->projectionPlane()->recalculate(fusedItem.m_applyRect, filthyNode, fusedItem.m_renderFlags);
+    }
+
+    item = items.last();
+
+    return true;
+}
+
+}
+
 /*********************************************************************/
 /*                     KisAsyncMerger                                */
 /*********************************************************************/
@@ -217,7 +281,16 @@ void KisAsyncMerger::startMerge(KisBaseRectsWalker &walker, bool notifyClones) {
         KisUpdateOriginalVisitor originalVisitor(applyRect,
                                                  m_currentProjection);
 
-        if(item.m_position & KisMergeWalker::N_FILTHY) {
+        const bool isFused =
+            m_currentProjection &&
+            KisColorAdjustmentMaskFusion::isEnabled() &&
+            fuseAdjustmentLayers(item, leafStack, m_currentProjection, walker.startNode());
+
+        if (isFused) {
+            // the whole run has been recalculated, continue from its topmost layer
+            currentLeaf = item.m_leaf;
+        }
+        else if(item.m_position & KisMergeWalker::N_FILTHY) {
             DEBUG_NODE_ACTION("Updating", "N_FILTHY", currentLeaf, applyRect);
             if (currentLeaf->shouldBeRendered()) {
                 currentLeaf->accept(originalVisitor);
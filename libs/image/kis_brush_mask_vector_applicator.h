@@ -13,6 +13,8 @@
 
 #if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE) && XSIMD_UNIVERSAL_BUILD_PASS
 
+#include <algorithm>
+
 #include "kis_brush_mask_scalar_applicator.h"
 
 template<class V>
@@ -93,10 +95,45 @@ void KisBrushMaskVectorApplicator<MaskGenerator, impl>::processVector(const QRec
 
     auto *buffer =xsimd::vector_aligned_malloc<float>(simdWidth);
 
+    // small dabs are supersampled the same way as in the scalar version,
+    // the samples are averaged in the buffer before applying the mask
+    int supersample = 1;
+    if (m_maskGenerator->shouldSupersample()) {
+        supersample = (m_maskGenerator->shouldSupersample6x6() ? 6 : 3);
+    }
+    const float invss = 1.0f / supersample;
+    const float_v vInvSampleArea(1.0f / pow2(supersample));
+
+    float *sampleBuffer = supersample > 1 ? xsimd::vector_aligned_malloc<float>(simdWidth) : nullptr;
+
     FastRowProcessor<MaskGenerator> processor(m_maskGenerator);
 
     for (int y = rect.y(); y < rect.y() + rect.height(); y++) {
-        processor.template process<impl>(buffer, simdWidth, y, m_d->cosa, m_d->sina, m_d->centerX, m_d->centerY);
+        if (supersample == 1) {
+            processor.template process<impl>(buffer, simdWidth, y, m_d->cosa, m_d->sina, m_d->centerX, m_d->centerY);
+        } else {
+            std::fill_n(buffer, simdWidth, 0.0f);
+
+            for (int sy = 0; sy < supersample; sy++) {
+                for (int sx = 0; sx < supersample; sx++) {
+                    processor.template process<impl>(sampleBuffer, simdWidth,
+                                                     y + sy * invss,
+                                                     m_d->cosa, m_d->sina,
+                                                     m_d->centerX - sx * invss,
+                                                     m_d->centerY);
+
+                    for (size_t i = 0; i < simdWidth; i += float_v::size) {
+                        const float_v sum = float_v::load_aligned(buffer + i) + float_v::load_aligned(sampleBuffer + i);
+                        sum.store_aligned(buffer + i);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < simdWidth; i += float_v::size) {
+                const float_v value = float_v::load_aligned(buffer + i) * vInvSampleArea;
+                value.store_aligned(buffer + i);
+            }
+        }
 
         if (m_d->randomness != 0.0 || m_d->density != 1.0) {
             for (int x = 0; x < width; x++) {
@@ -136,6 +173,10 @@ void KisBrushMaskVectorApplicator<MaskGenerator, impl>::processVector(const QRec
         dabPointer += offset;
     } // endfor y
     xsimd::vector_aligned_free(buffer);
+
+    if (sampleBuffer) {
+        xsimd::vector_aligned_free(sampleBuffer);
+    }
 }
 
 #endif /* defined HAVE_XSIMD */
@@ -34,11 +34,13 @@
 #include <KoChannelInfo.h>
 #include "kis_types.h"
 #include "kis_default_bounds.h"
+#include "kis_image_config.h"
 
 #include "kis_selection.h"
 
 #include "kis_convolution_worker.h"
 #include "kis_convolution_worker_spatial.h"
+#include "kis_convolution_worker_spatial_vector.h"
 
 #include "config_convolution.h"
 
@@ -71,18 +73,28 @@ KisConvolutionWorker<factory>* KisConvolutionPainter::createWorker(const KisConv
                                                                    KisPainter *painter,
                                                                    KoUpdater *progress)
 {
-    KisConvolutionWorker<factory> *worker;
+    KisConvolutionWorker<factory> *worker = 0;
 
 #ifdef HAVE_FFTW3
-    if (useFFTImplementation(kernel)) {
-        worker = new KisConvolutionWorkerFFT<factory>(painter, progress);
-    } else {
-        worker = new KisConvolutionWorkerSpatial<factory>(painter, progress);
-    }
+    const bool useFFT = useFFTImplementation(kernel);
 #else
     Q_UNUSED(kernel);
-    worker = new KisConvolutionWorkerSpatial<factory>(painter, progress);
+    const bool useFFT = false;
+#endif
+
+    if (useFFT) {
+#ifdef HAVE_FFTW3
+        const int threadLimit = m_fftThreadLimit > 0 ?
+            m_fftThreadLimit : KisImageConfig(true).maxNumberOfThreads();
+
+        worker = new KisConvolutionWorkerFFT<factory>(painter, progress,
+                                                      m_fftMemoryLimit, threadLimit);
 #endif
+    } else if (KisConvolutionWorkerSpatialVector<factory>::supportsColorSpace(painter->device()->colorSpace())) {
+        worker = new KisConvolutionWorkerSpatialVector<factory>(painter, progress);
+    } else {
+        worker = new KisConvolutionWorkerSpatial<factory>(painter, progress);
+    }
 
     return worker;
 }
@@ -127,6 +139,16 @@ void KisConvolutionPainter::setEnginePreference(EnginePreference value)
     m_enginePreference = value;
 }
 
+void KisConvolutionPainter::setFFTMemoryLimit(qint64 bytes)
+{
+    m_fftMemoryLimit = bytes;
+}
+
+void KisConvolutionPainter::setFFTThreadLimit(int threads)
+{
+    m_fftThreadLimit = threads;
+}
+
 void KisConvolutionPainter::applyMatrix(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, KisConvolutionBorderOp borderOp)
 {
     /**
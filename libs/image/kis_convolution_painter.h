@@ -46,6 +46,26 @@ public:
 
     void setEnginePreference(EnginePreference value);
 
+    /**
+     * Sets the maximum amount of memory (in bytes) the FFT engine may
+     * allocate for its buffers. If the area passed to applyMatrix()
+     * needs more than that, it is convolved in blocks (overlap-save),
+     * so the memory usage doesn't depend on the size of the image.
+     * Zero or a negative value removes the limit. The default is 256 MiB.
+     */
+    void setFFTMemoryLimit(qint64 bytes);
+
+    /**
+     * Sets the maximum number of threads the FFT engine may use for
+     * the transforms. The threads are split among all the FFT
+     * convolutions running at the same time. Zero or a negative value
+     * means the thread limit of the image, see
+     * KisImageConfig::maxNumberOfThreads(), which is the default. The
+     * transforms run in a single thread if FFTW is built without
+     * threads support.
+     */
+    void setFFTThreadLimit(int threads);
+
     /**
      * Convolve all channels in src using the specified kernel; there is only one kernel for all
      * channels possible.
@@ -95,5 +115,7 @@ private:
 
 private:
     EnginePreference m_enginePreference;
+    qint64 m_fftMemoryLimit {256 * 1024 * 1024};
+    int m_fftThreadLimit {0};
 };
 #endif //KIS_CONVOLUTION_PAINTER_H_
@@ -9,18 +9,25 @@
 #define KIS_CONVOLUTION_WORKER_FFT_H
 
 #include <iostream>
+#include <tuple>
 
 #include <KoChannelInfo.h>
 
 #include "kis_convolution_worker.h"
 #include "kis_math_toolbox.h"
 
+#include <QMap>
 #include <QMutex>
+#include <QSharedPointer>
 #include <QVector>
 #include <QTextStream>
 #include <QFile>
 #include <QDir>
 
+#include <KisMpl.h>
+
+#include "config_convolution.h"
+
 #include <fftw3.h>
 
 template<class _IteratorFactory_> class KisConvolutionWorkerFFT;
@@ -29,17 +36,150 @@ class KisConvolutionWorkerFFTLock
 private:
     static QMutex fftwMutex;
     template<class _IteratorFactory_> friend class KisConvolutionWorkerFFT;
+    friend class KisConvolutionWorkerFFTPlanCache;
 };
 
 QMutex KisConvolutionWorkerFFTLock::fftwMutex;
 
+/**
+ * FFTW planner is not thread-safe, so creation and destruction of the
+ * plans must be serialized with KisConvolutionWorkerFFTLock::fftwMutex.
+ * Execution of a plan on new arrays (fftw_execute_dft_*()) is thread-safe
+ * though, so the plans are created once per transform size and then
+ * shared by all the workers, which execute them without any locking.
+ *
+ * The plans are created for in-place transforms of the arrays allocated
+ * with fftw_malloc(), so they can be executed on any such array.
+ *
+ * When FFTW is built with threads support, a plan runs every transform
+ * in the number of threads it was created for, so the thread count is
+ * a part of the key of the cache.
+ */
+class KisConvolutionWorkerFFTPlanCache
+{
+public:
+    struct Plans {
+        fftw_plan forward {nullptr};
+        fftw_plan backward {nullptr};
+    };
+    using PlansSP = QSharedPointer<Plans>;
+
+    static PlansSP plans(int width, int height, int numThreads)
+    {
+        // evicted plans are destroyed after the lock is released,
+        // because the deleter needs the same lock
+        QList<PlansSP> evictedPlans;
+
+        QMutexLocker l(&KisConvolutionWorkerFFTLock::fftwMutex);
+
+        const PlanKey key(width, height, numThreads);
+
+        auto it = s_plans.find(key);
+        if (it != s_plans.end()) {
+            s_usedKeys.removeOne(key);
+            s_usedKeys.prepend(key);
+            return it.value();
+        }
+
+        const int fftLength = height * (width / 2 + 1);
+
+        fftw_complex *buffer = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * fftLength);
+
+#ifdef HAVE_FFTW3_THREADS
+        static const bool threadsInitialized = fftw_init_threads();
+        fftw_plan_with_nthreads(threadsInitialized ? numThreads : 1);
+#else
+        Q_UNUSED(numThreads);
+#endif
+
+        Plans *rawPlans = new Plans();
+        rawPlans->forward = fftw_plan_dft_r2c_2d(height, width, (double*)buffer, buffer, FFTW_ESTIMATE);
+        rawPlans->backward = fftw_plan_dft_c2r_2d(height, width, buffer, (double*)buffer, FFTW_ESTIMATE);
+
+        fftw_free(buffer);
+
+        PlansSP plans(rawPlans, &destroyPlans);
+
+        s_plans.insert(key, plans);
+        s_usedKeys.prepend(key);
+
+        while (s_usedKeys.size() > maxCachedPlans) {
+            evictedPlans.append(s_plans.take(s_usedKeys.takeLast()));
+        }
+
+        l.unlock();
+        evictedPlans.clear();
+
+        return plans;
+    }
+
+    /**
+     * The filters process the image in patches, which already run in
+     * parallel, so the threads of the image thread limit are split among
+     * all the FFT convolutions running at the same time. A big area
+     * convolved alone (e.g. by a filter that doesn't support threading)
+     * gets all of them. Small transforms don't scale, so they always
+     * run in a single thread.
+     *
+     * Every call must be paired with releaseThreads().
+     */
+    static int acquireThreads(int threadLimit, quint32 fftLength)
+    {
+        const int numRunning = s_numRunningTransforms.fetchAndAddOrdered(1) + 1;
+
+#ifdef HAVE_FFTW3_THREADS
+        if (fftLength >= minFFTLengthForThreads) {
+            return qMax(1, threadLimit / numRunning);
+        }
+#else
+        Q_UNUSED(threadLimit);
+        Q_UNUSED(fftLength);
+        Q_UNUSED(numRunning);
+#endif
+
+        return 1;
+    }
+
+    static void releaseThreads()
+    {
+        s_numRunningTransforms.deref();
+    }
+
+private:
+    static void destroyPlans(Plans *plans)
+    {
+        QMutexLocker l(&KisConvolutionWorkerFFTLock::fftwMutex);
+        fftw_destroy_plan(plans->forward);
+        fftw_destroy_plan(plans->backward);
+        delete plans;
+    }
+
+private:
+    static const int maxCachedPlans = 16;
+
+    // about a 256x256 image, the smaller transforms don't scale
+    static const quint32 minFFTLengthForThreads = 256 * 129;
+
+    using PlanKey = std::tuple<int, int, int>;
+
+    static QMap<PlanKey, PlansSP> s_plans;
+    static QList<PlanKey> s_usedKeys;
+    static QAtomicInt s_numRunningTransforms;
+};
+
+QMap<KisConvolutionWorkerFFTPlanCache::PlanKey, KisConvolutionWorkerFFTPlanCache::PlansSP> KisConvolutionWorkerFFTPlanCache::s_plans;
+QList<KisConvolutionWorkerFFTPlanCache::PlanKey> KisConvolutionWorkerFFTPlanCache::s_usedKeys;
+QAtomicInt KisConvolutionWorkerFFTPlanCache::s_numRunningTransforms;
+
 
 template<class _IteratorFactory_>
 class KisConvolutionWorkerFFT : public KisConvolutionWorker<_IteratorFactory_>
 {
 public:
-    KisConvolutionWorkerFFT(KisPainter *painter, KoUpdater *progress)
-        : KisConvolutionWorker<_IteratorFactory_>(painter, progress)
+    KisConvolutionWorkerFFT(KisPainter *painter, KoUpdater *progress, qint64 memoryLimit, int threadLimit)
+        : KisConvolutionWorker<_IteratorFactory_>(painter, progress),
+          m_memoryLimit(memoryLimit),
+          m_threadLimit(threadLimit)
     {
     }
 
@@ -72,15 +212,29 @@ public:
         const quint32 halfKernelWidth = (kernel->width() - 1) / 2;
         const quint32 halfKernelHeight = (kernel->height() - 1) / 2;
 
-        m_fftWidth = areaSize.width() + 4 * halfKernelWidth;
-        m_fftHeight = areaSize.height() + 2 * halfKernelHeight;
+        // find out which channels need convolving
+        QList<KoChannelInfo*> convChannelList = this->convolvableChannelList(src);
+
+        /**
+         * When the buffers for the whole area don't fit into the memory
+         * limit, the area is convolved in blocks using overlap-save
+         * method: every block reads its own margins of the half-kernel
+         * size from the device and only the central part of the result,
+         * which is not affected by the circular wrapping of the FFT, is
+         * written back. The peak memory usage is defined by the size of
+         * the block only, while the image itself stays in the tiles
+         * (which can be swapped out).
+         */
+        const QSize blockSize = chooseBlockSize(areaSize, halfKernelWidth, halfKernelHeight,
+                                                convChannelList.count());
 
         /**
-         * FIXME: check whether this "optimization" is needed to
-         * be uncommented. My tests showed about 30% better performance
-         * when the line is commented out (DK).
+         * FFTW is the fastest on the sizes that factor into small primes,
+         * for the big prime factors it may be a few times slower. Reading
+         * a few more pixels is much cheaper than that.
          */
-        //optimumDimensions(m_fftWidth, m_fftHeight);
+        m_fftWidth = optimumFFTSize(blockSize.width() + 4 * halfKernelWidth);
+        m_fftHeight = optimumFFTSize(blockSize.height() + 2 * halfKernelHeight);
 
         m_fftLength = m_fftHeight * (m_fftWidth / 2 + 1);
         m_extraMem = (m_fftWidth % 2) ? 1 : 2;
@@ -90,9 +244,6 @@ public:
         memset(m_kernelFFT, 0, sizeof(fftw_complex) * m_fftLength);
         fftFillKernelMatrix(kernel, m_kernelFFT);
 
-        // find out which channels need convolving
-        QList<KoChannelInfo*> convChannelList = this->convolvableChannelList(src);
-
         m_channelFFT.resize(convChannelList.count());
         for (auto i = m_channelFFT.begin(); i != m_channelFFT.end(); ++i) {
             *i = (fftw_complex *)fftw_malloc(sizeof(fftw_complex) * m_fftLength);
@@ -104,56 +255,91 @@ public:
         FFTInfo info (fftScale, convChannelList, kernel, this->m_painter->device()->colorSpace());
         int cacheRowStride = m_fftWidth + m_extraMem;
 
-        fillCacheFromDevice(src,
-                            QRect(srcPos.x() - halfKernelWidth,
-                                  srcPos.y() - halfKernelHeight,
-                                  m_fftWidth,
-                                  m_fftHeight),
-                            cacheRowStride,
-                            info, dataRect);
+        const int numThreads =
+            KisConvolutionWorkerFFTPlanCache::acquireThreads(m_threadLimit, m_fftLength);
+        auto releaseThreads = kismpl::finally([] () {
+            KisConvolutionWorkerFFTPlanCache::releaseThreads();
+        });
+
+        KisConvolutionWorkerFFTPlanCache::PlansSP plans =
+            KisConvolutionWorkerFFTPlanCache::plans(m_fftWidth, m_fftHeight, numThreads);
 
+        fftw_execute_dft_r2c(plans->forward, (double*)m_kernelFFT, m_kernelFFT);
         addToProgress(10);
         if (isInterrupted()) return;
 
-        // calculate number off fft operations required for progress reporting
-        const float progressPerFFT = (100 - 30) / (double)(convChannelList.count() * 2 + 1);
+        const bool isTiled = blockSize != areaSize;
 
-        // perform FFT
-        fftw_plan fftwPlanForward, fftwPlanBackward;
+        /**
+         * In the tiled mode the next blocks still need the original
+         * pixels in their margins. When the source is the destination
+         * device itself, the blocks are collected in a temporary device
+         * and written into the destination only when all of them are
+         * convolved.
+         *
+         * The source itself is still read through oldRawData(), so
+         * that the caller's transaction over it is respected. A copy
+         * of the source would have a memento manager of its own, whose
+         * "old" data is the current one.
+         */
+        KisPaintDeviceSP dst = this->m_painter->device();
+        KisPaintDeviceSP target = dst;
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftwPlanForward = fftw_plan_dft_r2c_2d(m_fftHeight, m_fftWidth, (double*)m_kernelFFT, m_kernelFFT, FFTW_ESTIMATE);
-        fftwPlanBackward = fftw_plan_dft_c2r_2d(m_fftHeight, m_fftWidth, m_kernelFFT, (double*)m_kernelFFT, FFTW_ESTIMATE);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+        if (isTiled && src == dst) {
+            target = new KisPaintDevice(dst->colorSpace());
+            target->setDefaultBounds(dst->defaultBounds());
+            target->moveTo(dst->x(), dst->y());
+        }
 
-        fftw_execute(fftwPlanForward);
-        addToProgress(progressPerFFT);
-        if (isInterrupted()) return;
+        const int numBlocks =
+            ((areaSize.width() + blockSize.width() - 1) / blockSize.width()) *
+            ((areaSize.height() + blockSize.height() - 1) / blockSize.height());
+        const float progressPerBlock = 80.0 / numBlocks;
 
-        for (auto k = m_channelFFT.begin(); k != m_channelFFT.end(); ++k)
-        {
-            fftw_execute_dft_r2c(fftwPlanForward, (double*)(*k), *k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
+        for (int blockY = 0; blockY < areaSize.height(); blockY += blockSize.height()) {
+            for (int blockX = 0; blockX < areaSize.width(); blockX += blockSize.width()) {
+                const QPoint blockOffset(blockX, blockY);
+                const QSize currentBlockSize(qMin(blockSize.width(), areaSize.width() - blockX),
+                                             qMin(blockSize.height(), areaSize.height() - blockY));
 
-            fftMultiply(*k, m_kernelFFT);
+                const QPoint blockSrcPos = srcPos + blockOffset;
+                const QPoint blockDstPos = dstPos + blockOffset;
 
-            fftw_execute_dft_c2r(fftwPlanBackward, *k, (double*)*k);
-            addToProgress(progressPerFFT);
-            if (isInterrupted()) return;
-        }
+                fillCacheFromDevice(src,
+                                    QRect(blockSrcPos.x() - halfKernelWidth,
+                                          blockSrcPos.y() - halfKernelHeight,
+                                          m_fftWidth,
+                                          m_fftHeight),
+                                    cacheRowStride,
+                                    info, dataRect);
 
-        KisConvolutionWorkerFFTLock::fftwMutex.lock();
-        fftw_destroy_plan(fftwPlanForward);
-        fftw_destroy_plan(fftwPlanBackward);
-        KisConvolutionWorkerFFTLock::fftwMutex.unlock();
+                if (isInterrupted()) return;
+
+                for (int channel = 0; channel < m_channelFFT.size(); ++channel) {
+                    fftw_complex *channelFFT = m_channelFFT[channel];
 
+                    fftw_execute_dft_r2c(plans->forward, (double*)channelFFT, channelFFT);
+                    fftMultiply(channelFFT, m_kernelFFT);
+                    fftw_execute_dft_c2r(plans->backward, channelFFT, (double*)channelFFT);
+                }
+
+                if (isInterrupted()) return;
+
+                writeResultToDevice(target,
+                                    QRect(blockDstPos, currentBlockSize),
+                                    cacheRowStride, halfKernelWidth, halfKernelHeight,
+                                    info, dataRect);
+
+                addToProgress(progressPerBlock);
+            }
+        }
 
-        writeResultToDevice(QRect(dstPos.x(), dstPos.y(), areaSize.width(), areaSize.height()),
-                            cacheRowStride, halfKernelWidth, halfKernelHeight,
-                            info, dataRect);
+        if (target != dst) {
+            const QRect dstRect(dstPos, areaSize);
+            KisPainter::copyAreaOptimized(dstRect.topLeft(), target, dst, dstRect);
+        }
 
-        addToProgress(20);
+        addToProgress(10);
         cleanUp();
     }
 
@@ -313,7 +499,8 @@ public:
         return channelPixelValue;
     }
 
-    void writeResultToDevice(const QRect &rect,
+    void writeResultToDevice(KisPaintDeviceSP dst,
+                             const QRect &rect,
                              const int cacheRowStride,
                              const int halfKernelWidth,
                              const int halfKernelHeight,
@@ -321,7 +508,7 @@ public:
                              const QRect &dataRect) {
 
         typename _IteratorFactory_::HLineIterator hitDst =
-            _IteratorFactory_::createHLineIterator(this->m_painter->device(),
+            _IteratorFactory_::createHLineIterator(dst,
                                                    rect.x(), rect.y(), rect.width(),
                                                    dataRect);
 
@@ -437,11 +624,11 @@ private:
         }
     }
 
-    void fftMultiply(fftw_complex* channel, fftw_complex* kernel)
+    void fftMultiply(fftw_complex* channel, const fftw_complex* kernel) const
     {
         // perform complex multiplication
         fftw_complex *channelPtr = channel;
-        fftw_complex *kernelPtr = kernel;
+        const fftw_complex *kernelPtr = kernel;
 
         fftw_complex tmp;
 
@@ -458,25 +645,58 @@ private:
         }
     }
 
-    void optimumDimensions(quint32& w, quint32& h)
+    QSize chooseBlockSize(const QSize &areaSize,
+                          quint32 halfKernelWidth, quint32 halfKernelHeight,
+                          int numChannels) const
     {
-        // FFTW is most efficient when array size is a factor of 2, 3, 5 or 7
-        quint32 optW = w, optH = h;
+        auto memoryForBlock = [=] (int width, int height) {
+            const qint64 fftWidth = optimumFFTSize(width + 4 * halfKernelWidth);
+            const qint64 fftHeight = optimumFFTSize(height + 2 * halfKernelHeight);
 
-        while ((optW % 2 != 0) || (optW % 3 != 0) || (optW % 5 != 0) || (optW % 7 != 0))
-            ++optW;
+            // the kernel and every channel have their own buffer
+            return fftHeight * (fftWidth / 2 + 1) * qint64(sizeof(fftw_complex)) * (numChannels + 1);
+        };
 
-        while ((optH % 2 != 0) || (optH % 3 != 0) || (optH % 5 != 0) || (optH % 7 != 0))
-            ++optH;
+        if (m_memoryLimit <= 0 ||
+            memoryForBlock(areaSize.width(), areaSize.height()) <= m_memoryLimit) {
 
-        quint32 optAreaW = optW * h;
-        quint32 optAreaH = optH * w;
+            return areaSize;
+        }
 
-        if (optAreaW < optAreaH) {
-            w = optW;
+        /**
+         * The blocks should be much bigger than the kernel, otherwise most
+         * of the work is spent on the margins, so the size is never reduced
+         * below the kernel size. For huge kernels the memory limit may be
+         * exceeded then, but the usage still doesn't depend on the image size.
+         */
+        const int minBlockSize = qMax(64, int(2 * qMax(halfKernelWidth, halfKernelHeight)));
+
+        int blockSize = qMax(areaSize.width(), areaSize.height());
+        while (blockSize > minBlockSize &&
+               memoryForBlock(blockSize, blockSize) > m_memoryLimit) {
+
+            blockSize = qMax(minBlockSize, blockSize / 2);
         }
-        else {
-            h = optH;
+
+        return QSize(qMin(blockSize, areaSize.width()), qMin(blockSize, areaSize.height()));
+    }
+
+    static quint32 optimumFFTSize(quint32 size)
+    {
+        // the smallest number not less than size that has no
+        // prime factors other than 2, 3, 5 and 7
+        for (quint32 candidate = size; ; ++candidate) {
+            quint32 value = candidate;
+
+            for (quint32 factor : {2, 3, 5, 7}) {
+                while (value % factor == 0) {
+                    value /= factor;
+                }
+            }
+
+            if (value == 1) {
+                return candidate;
+            }
         }
     }
 
@@ -542,6 +762,9 @@ private:
         m_channelFFT.clear();
     }
 private:
+    qint64 m_memoryLimit {0};
+    int m_threadLimit {1};
+
     quint32 m_fftWidth {0};
     quint32 m_fftHeight {0};
     quint32 m_fftLength {0};
@@ -0,0 +1,476 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_CONVOLUTION_WORKER_SPATIAL_VECTOR_H
+#define KIS_CONVOLUTION_WORKER_SPATIAL_VECTOR_H
+
+#include <QScopedPointer>
+#include <QVector>
+
+#include <KoChannelInfo.h>
+#include <KoColorSpace.h>
+
+#include "kis_convolution_worker.h"
+#include "kis_datamanager.h"
+#include "kis_math_toolbox.h"
+#include "kis_paint_device.h"
+#include "KisConvolutionRowProcessorBase.h"
+#include "KisConvolutionRowProcessorFactory.h"
+
+/**
+ * Spatial convolution worker that processes the area in blocks.
+ *
+ * The pixels of a block (with the margins needed for the kernel) are
+ * premultiplied and converted into planar float rows first, then the
+ * kernel is applied to whole rows with the vectorized
+ * KisConvolutionRowProcessorBase and the result is written back in the
+ * same way KisConvolutionWorkerSpatial does it.
+ *
+ * When the kernel is separable (its matrix is an outer product of a
+ * column and a row), it is applied as a horizontal pass followed by a
+ * vertical one, which costs kw + kh multiplications per channel instead
+ * of kw * kh.
+ *
+ * The buffers are in floats, which is enough for the channel types
+ * accepted by supportsColorSpace(); the others are handled by
+ * KisConvolutionWorkerSpatial.
+ */
+template <class _IteratorFactory_>
+class KisConvolutionWorkerSpatialVector : public KisConvolutionWorker<_IteratorFactory_>
+{
+public:
+    KisConvolutionWorkerSpatialVector(KisPainter *painter, KoUpdater *progress)
+        : KisConvolutionWorker<_IteratorFactory_>(painter, progress),
+          m_rowProcessor(KisConvolutionRowProcessorFactory::create())
+    {
+    }
+
+    /**
+     * Uses \p rowProcessor instead of the one for the best architecture
+     * and takes its ownership. Used by the benchmarks to compare the
+     * architectures.
+     */
+    KisConvolutionWorkerSpatialVector(KisPainter *painter, KoUpdater *progress,
+                                      KisConvolutionRowProcessorBase *rowProcessor)
+        : KisConvolutionWorker<_IteratorFactory_>(painter, progress),
+          m_rowProcessor(rowProcessor)
+    {
+    }
+
+    ~KisConvolutionWorkerSpatialVector() override
+    {
+    }
+
+    static bool supportsColorSpace(const KoColorSpace *cs)
+    {
+        Q_FOREACH (const KoChannelInfo *channel, cs->channels()) {
+            switch (channel->channelValueType()) {
+            case KoChannelInfo::UINT8:
+            case KoChannelInfo::UINT16:
+            case KoChannelInfo::FLOAT16:
+            case KoChannelInfo::FLOAT32:
+                break;
+            default:
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void execute(const KisConvolutionKernelSP kernel, const KisPaintDeviceSP src, QPoint srcPos, QPoint dstPos, QSize areaSize, const QRect& dataRect) override
+    {
+        // Make the area we cover as small as possible
+        if (this->m_painter->selection()) {
+            QRect r = this->m_painter->selection()->selectedRect().intersected(QRect(srcPos, areaSize));
+            dstPos += r.topLeft() - srcPos;
+            srcPos = r.topLeft();
+            areaSize = r.size();
+        }
+
+        if (areaSize.width() == 0 || areaSize.height() == 0)
+            return;
+
+        m_kw = kernel->width();
+        m_kh = kernel->height();
+        m_khalfWidth = (m_kw > 0) ? (m_kw - 1) / 2 : m_kw;
+        m_khalfHeight = (m_kh > 0) ? (m_kh - 1) / 2 : m_kh;
+        m_pixelSize = src->colorSpace()->pixelSize();
+
+        m_convChannelList = this->convolvableChannelList(src);
+        m_convolveChannelsNo = m_convChannelList.count();
+
+        m_alphaCachePos = -1;
+        m_alphaRealPos = -1;
+
+        for (int i = 0; i < m_convChannelList.size(); i++) {
+            if (m_convChannelList[i]->channelType() == KoChannelInfo::ALPHA) {
+                m_alphaCachePos = i;
+                m_alphaRealPos = m_convChannelList[i]->pos();
+            }
+        }
+
+        KisMathToolbox mathToolbox;
+        m_toDoubleFuncPtr = QVector<PtrToDouble>(m_convolveChannelsNo);
+        if (!mathToolbox.getToDoubleChannelPtr(m_convChannelList, m_toDoubleFuncPtr))
+            return;
+
+        m_fromDoubleFuncPtr = QVector<PtrFromDouble>(m_convolveChannelsNo);
+        if (!mathToolbox.getFromDoubleChannelPtr(m_convChannelList, m_fromDoubleFuncPtr))
+            return;
+
+        m_kernelFactor = kernel->factor() ? 1.0 / kernel->factor() : 1;
+        m_minClamp.resize(m_convolveChannelsNo);
+        m_maxClamp.resize(m_convolveChannelsNo);
+        m_absoluteOffset.resize(m_convolveChannelsNo);
+        for (int i = 0; i < m_convolveChannelsNo; ++i) {
+            m_minClamp[i] = mathToolbox.minChannelValue(m_convChannelList[i]);
+            m_maxClamp[i] = mathToolbox.maxChannelValue(m_convChannelList[i]);
+            m_absoluteOffset[i] = (m_maxClamp[i] - m_minClamp[i]) * kernel->offset();
+        }
+
+        prepareKernel(kernel);
+
+        /**
+         * The blocks are at least as high as the kernel, so the rows
+         * of the margins are not read more than twice.
+         */
+        const int blockWidth = qMax(minBlockWidth, m_kw);
+        const int blockHeight = qMax(minBlockHeight, m_kh);
+
+        const int numBlockColumns = (areaSize.width() + blockWidth - 1) / blockWidth;
+        const int numBlockRows = (areaSize.height() + blockHeight - 1) / blockHeight;
+
+        const bool hasProgressUpdater = this->m_progress;
+        if (hasProgressUpdater) {
+            this->m_progress->setRange(0, numBlockColumns * numBlockRows);
+            this->m_progress->setValue(0);
+        }
+
+        /**
+         * The blocks read their margins from the source, and some of
+         * those pixels may already be written by the previous blocks.
+         * When the caller has started a transaction over the source,
+         * the old pixels are read through oldRawData(). Otherwise, when
+         * the source is the destination device itself, the blocks are
+         * collected in a temporary device and written into the
+         * destination only when all of them are convolved.
+         * KisConvolutionWorkerSpatial needs neither, because it caches
+         * the rows of the kernel before it overwrites them.
+         */
+        KisPaintDeviceSP dst = this->m_painter->device();
+        KisPaintDeviceSP target = dst;
+
+        if (src == dst && !src->dataManager()->hasCurrentMemento()) {
+            target = new KisPaintDevice(dst->colorSpace());
+            target->setDefaultBounds(dst->defaultBounds());
+            target->moveTo(dst->x(), dst->y());
+        }
+
+        int blockIndex = 0;
+
+        for (int blockY = 0; blockY < areaSize.height(); blockY += blockHeight) {
+            for (int blockX = 0; blockX < areaSize.width(); blockX += blockWidth) {
+                const QRect block(blockX, blockY,
+                                  qMin(blockWidth, areaSize.width() - blockX),
+                                  qMin(blockHeight, areaSize.height() - blockY));
+
+                loadBlock(src, block.translated(srcPos), dataRect);
+                convolveBlock(block.size());
+                writeBlock(target, src, block.translated(srcPos), block.translated(dstPos), dataRect);
+
+                if (hasProgressUpdater) {
+                    this->m_progress->setValue(++blockIndex);
+
+                    if (this->m_progress->interrupted()) {
+                        return;
+                    }
+                }
+            }
+        }
+
+        if (target != dst) {
+            const QRect dstRect(dstPos, areaSize);
+            KisPainter::copyAreaOptimized(dstRect.topLeft(), target, dst, dstRect);
+        }
+    }
+
+private:
+    void prepareKernel(const KisConvolutionKernelSP kernel)
+    {
+        /**
+         * The weight of the source pixel (x - hw + c, y - hh + r) is
+         * stored in the flipped cell of the kernel matrix, see
+         * KisConvolutionWorkerSpatial::convolveOneChannelFromCache()
+         */
+        m_kernelData.resize(m_kw * m_kh);
+
+        int pivotRow = 0;
+        int pivotColumn = 0;
+        qreal maxValue = 0.0;
+
+        for (int r = 0; r < m_kh; r++) {
+            for (int c = 0; c < m_kw; c++) {
+                const qreal value = (*(kernel->data()))(m_kh - 1 - r, m_kw - 1 - c);
+                m_kernelData[r * m_kw + c] = value;
+
+                if (qAbs(value) > maxValue) {
+                    maxValue = qAbs(value);
+                    pivotRow = r;
+                    pivotColumn = c;
+                }
+            }
+        }
+
+        m_isSeparable = false;
+
+        if (m_kw == 1 || m_kh == 1 || maxValue == 0.0) return;
+
+        // the kernel is separable if every row is proportional to the pivot one
+        m_horizontalKernel.resize(m_kw);
+        m_verticalKernel.resize(m_kh);
+
+        for (int c = 0; c < m_kw; c++) {
+            m_horizontalKernel[c] = m_kernelData[pivotRow * m_kw + c];
+        }
+
+        const qreal pivotValue = m_kernelData[pivotRow * m_kw + pivotColumn];
+
+        for (int r = 0; r < m_kh; r++) {
+            m_verticalKernel[r] = m_kernelData[r * m_kw + pivotColumn] / pivotValue;
+        }
+
+        const qreal tolerance = 1e-6 * maxValue;
+
+        for (int r = 0; r < m_kh; r++) {
+            for (int c = 0; c < m_kw; c++) {
+                const qreal separableValue = qreal(m_verticalKernel[r]) * m_horizontalKernel[c];
+                if (qAbs(m_kernelData[r * m_kw + c] - separableValue) > tolerance) {
+                    return;
+                }
+            }
+        }
+
+        m_isSeparable = true;
+    }
+
+    void loadBlock(const KisPaintDeviceSP src, const QRect &srcBlock, const QRect &dataRect)
+    {
+        const int width = srcBlock.width() + m_kw - 1;
+        const int height = srcBlock.height() + m_kh - 1;
+
+        m_sourceRowStride = width;
+        m_sourcePlaneSize = width * height;
+        m_source.resize(m_sourcePlaneSize * m_convolveChannelsNo);
+
+        typename _IteratorFactory_::HLineConstIterator hitSrc =
+            _IteratorFactory_::createHLineConstIterator(src,
+                                                        srcBlock.x() - m_khalfWidth,
+                                                        srcBlock.y() - m_khalfHeight,
+                                                        width, dataRect);
+
+        float *buffer = m_source.data();
+
+        for (int row = 0; row < height; row++) {
+            int i = row * m_sourceRowStride;
+
+            do {
+                const quint8 *data = hitSrc->oldRawData();
+
+                // no alpha is rare case, so just multiply by 1.0 in that case
+                const qreal alphaValue = m_alphaRealPos >= 0 ?
+                    m_toDoubleFuncPtr[m_alphaCachePos](data, m_alphaRealPos) : 1.0;
+
+                for (int k = 0; k < m_convolveChannelsNo; ++k) {
+                    if (k != m_alphaCachePos) {
+                        const quint32 channelPos = m_convChannelList[k]->pos();
+                        buffer[k * m_sourcePlaneSize + i] = m_toDoubleFuncPtr[k](data, channelPos) * alphaValue;
+                    } else {
+                        buffer[k * m_sourcePlaneSize + i] = alphaValue;
+                    }
+                }
+
+                i++;
+            } while (hitSrc->nextPixel());
+
+            hitSrc->nextRow();
+        }
+    }
+
+    void convolveBlock(const QSize &size)
+    {
+        const int width = size.width();
+        const int height = size.height();
+        const int sourceHeight = height + m_kh - 1;
+
+        m_resultPlaneSize = width * height;
+        m_result.resize(m_resultPlaneSize * m_convolveChannelsNo);
+
+        QVector<const float*> rows(m_kh);
+
+        for (int k = 0; k < m_convolveChannelsNo; ++k) {
+            const float *source = m_source.constData() + k * m_sourcePlaneSize;
+            float *result = m_result.data() + k * m_resultPlaneSize;
+
+            if (m_isSeparable) {
+                m_intermediate.resize(width * sourceHeight);
+
+                for (int row = 0; row < sourceHeight; row++) {
+                    m_rowProcessor->convolveRow(source + row * m_sourceRowStride,
+                                                m_intermediate.data() + row * width,
+                                                width,
+                                                m_horizontalKernel.constData(), m_kw,
+                                                false);
+                }
+
+                for (int row = 0; row < height; row++) {
+                    for (int r = 0; r < m_kh; r++) {
+                        rows[r] = m_intermediate.constData() + (row + r) * width;
+                    }
+
+                    m_rowProcessor->combineRows(rows.constData(), m_verticalKernel.constData(), m_kh,
+                                                result + row * width, width,
+                                                false);
+                }
+            } else if (m_kw == 1) {
+                for (int row = 0; row < height; row++) {
+                    for (int r = 0; r < m_kh; r++) {
+                        rows[r] = source + (row + r) * m_sourceRowStride;
+                    }
+
+                    m_rowProcessor->combineRows(rows.constData(), m_kernelData.constData(), m_kh,
+                                                result + row * width, width,
+                                                false);
+                }
+            } else {
+                for (int row = 0; row < height; row++) {
+                    for (int r = 0; r < m_kh; r++) {
+                        m_rowProcessor->convolveRow(source + (row + r) * m_sourceRowStride,
+                                                    result + row * width,
+                                                    width,
+                                                    m_kernelData.constData() + r * m_kw, m_kw,
+                                                    r > 0);
+                    }
+                }
+            }
+        }
+    }
+
+    inline void limitValue(qreal *value, qreal lowBound, qreal highBound) {
+        if (*value > highBound) {
+            *value = highBound;
+        } else if (!(*value >= lowBound)) {  // value < lowBound or value == NaN
+            // IEEE compliant comparisons with NaN are always false
+            *value = lowBound;
+        }
+    }
+
+    inline qreal writeChannel(quint8 *dstPtr, int channel, int index, qreal multiplier)
+    {
+        qreal channelPixelValue = m_result[channel * m_resultPlaneSize + index] * multiplier + m_absoluteOffset[channel];
+        limitValue(&channelPixelValue, m_minClamp[channel], m_maxClamp[channel]);
+
+        const quint32 channelPos = m_convChannelList[channel]->pos();
+        m_fromDoubleFuncPtr[channel](dstPtr, channelPos, channelPixelValue);
+
+        return channelPixelValue;
+    }
+
+    void writeBlock(KisPaintDeviceSP dst, const KisPaintDeviceSP src, const QRect &srcBlock, const QRect &dstBlock, const QRect &dataRect)
+    {
+        typename _IteratorFactory_::HLineIterator hitDst =
+            _IteratorFactory_::createHLineIterator(dst,
+                                                   dstBlock.x(), dstBlock.y(), dstBlock.width(),
+                                                   dataRect);
+        typename _IteratorFactory_::HLineConstIterator hitSrc =
+            _IteratorFactory_::createHLineConstIterator(src,
+                                                        srcBlock.x(), srcBlock.y(), srcBlock.width(),
+                                                        dataRect);
+
+        int i = 0;
+
+        for (int row = 0; row < dstBlock.height(); row++) {
+            do {
+                quint8 *dstPtr = hitDst->rawData();
+
+                // write original channel values
+                memcpy(dstPtr, hitSrc->oldRawData(), m_pixelSize);
+
+                if (m_alphaCachePos >= 0) {
+                    const qreal alphaValue = writeChannel(dstPtr, m_alphaCachePos, i, m_kernelFactor);
+
+                    if (alphaValue != 0.0) {
+                        const qreal multiplier = m_kernelFactor / alphaValue;
+
+                        for (int k = 0; k < m_convolveChannelsNo; ++k) {
+                            if (k == m_alphaCachePos) continue;
+                            writeChannel(dstPtr, k, i, multiplier);
+                        }
+                    } else {
+                        for (int k = 0; k < m_convolveChannelsNo; ++k) {
+                            if (k == m_alphaCachePos) continue;
+
+                            const qreal zeroValue = 0.0;
+                            const quint32 channelPos = m_convChannelList[k]->pos();
+                            m_fromDoubleFuncPtr[k](dstPtr, channelPos, zeroValue);
+                        }
+                    }
+                } else {
+                    for (int k = 0; k < m_convolveChannelsNo; ++k) {
+                        writeChannel(dstPtr, k, i, m_kernelFactor);
+                    }
+                }
+
+                i++;
+                hitSrc->nextPixel();
+            } while (hitDst->nextPixel());
+
+            hitDst->nextRow();
+            hitSrc->nextRow();
+        }
+    }
+
+private:
+    static constexpr int minBlockWidth = 512;
+    static constexpr int minBlockHeight = 64;
+
+    QScopedPointer<KisConvolutionRowProcessorBase> m_rowProcessor;
+
+    int m_kw {0};
+    int m_kh {0};
+    int m_khalfWidth {0};
+    int m_khalfHeight {0};
+    int m_pixelSize {0};
+    int m_convolveChannelsNo {0};
+
+    int m_alphaCachePos {-1};
+    int m_alphaRealPos {-1};
+
+    QVector<float> m_kernelData;
+    QVector<float> m_horizontalKernel;
+    QVector<float> m_verticalKernel;
+    bool m_isSeparable {false};
+
+    QVector<float> m_source;
+    int m_sourceRowStride {0};
+    int m_sourcePlaneSize {0};
+
+    QVector<float> m_intermediate;
+
+    QVector<float> m_result;
+    int m_resultPlaneSize {0};
+
+    QVector<qreal> m_minClamp;
+    QVector<qreal> m_maxClamp;
+    QVector<qreal> m_absoluteOffset;
+
+    qreal m_kernelFactor {1.0};
+    QList<KoChannelInfo *> m_convChannelList;
+    QVector<PtrToDouble> m_toDoubleFuncPtr;
+    QVector<PtrFromDouble> m_fromDoubleFuncPtr;
+};
+
+#endif
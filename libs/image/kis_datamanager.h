@@ -334,6 +334,16 @@ public:
         return ACTUAL_DATAMGR::rowStride(x, y);
     }
 
+
+    /**
+     * Append the revisions of the tiles intersecting \p rect to
+     * \p revisions. Equal revisions and an equal default pixel
+     * mean unchanged pixels.
+     */
+    inline void tileDataRevisions(const QRect &rect, QVector<quint64> &revisions) const {
+        ACTUAL_DATAMGR::tileDataRevisions(rect, revisions);
+    }
+
 protected:
     friend class KisRectIterator;
     friend class KisHLineIterator;
@@ -47,6 +47,7 @@ QIcon KisFilterMask::icon() const
 void KisFilterMask::setFilter(KisFilterConfigurationSP  filterConfig, bool checkCompareConfig)
 {
     KisNodeFilterInterface::setFilter(filterConfig, checkCompareConfig);
+    m_resultCache.invalidate();
 }
 
 QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
@@ -83,7 +84,11 @@ QRect KisFilterMask::decorateRect(KisPaintDeviceSP &src,
     KIS_ASSERT_RECOVER_NOOP(this->busyProgressIndicator());
     this->busyProgressIndicator()->update();
 
-    filter->process(src, dst, 0, rc, filterConfig.data(), 0);
+    if (KisFilterResultCache::isEnabled()) {
+        m_resultCache.process(filter.data(), filterConfig, src, dst, rc);
+    } else {
+        filter->process(src, dst, 0, rc, filterConfig.data(), 0);
+    }
 
     QRect r = filter->changedRect(rc, filterConfig.data(), dst->defaultBounds()->currentLevelOfDetail());
     return r;
@@ -11,6 +11,7 @@
 
 #include "kis_node_filter_interface.h"
 #include "kis_filter_configuration.h"
+#include "KisFilterResultCache.h"
 
 
 /**
@@ -54,6 +55,9 @@ public:
 
     QRect changeRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
     QRect needRect(const QRect &rect, PositionToFilthy pos = N_FILTHY) const override;
+
+private:
+    mutable KisFilterResultCache m_resultCache;
 };
 
 #endif //_KIS_FILTER_MASK_
@@ -10,6 +10,7 @@
 #include "kis_convolution_kernel.h"
 #include <kis_convolution_painter.h>
 #include <kis_transaction.h>
+#include "KisRecursiveGaussianBlur.h"
 #include <QRect>
 
 
@@ -99,6 +100,58 @@ KisGaussianKernel::createUniform2DKernel(qreal xRadius, qreal yRadius)
 }
 
 
+namespace {
+
+/**
+ * Blurs one axis with the recursive filter and the other one with the
+ * explicit kernel. The recursive pass goes into a temporary device and
+ * covers the rows (or columns) the kernel reads around \p rect.
+ */
+bool applyMixedGaussian(KisPaintDeviceSP device,
+                        const QRect &rect,
+                        qreal xRadius, qreal yRadius,
+                        bool recursiveX,
+                        const QBitArray &channelFlags,
+                        KoUpdater *progressUpdater,
+                        KisConvolutionBorderOp borderOp)
+{
+    const qreal recursiveRadius = recursiveX ? xRadius : yRadius;
+    const int recursiveMargin = KisGaussianKernel::kernelSizeFromRadius(recursiveRadius) / 2;
+
+    KisConvolutionKernelSP kernel = recursiveX ?
+        KisGaussianKernel::createVerticalKernel(yRadius) :
+        KisGaussianKernel::createHorizontalKernel(xRadius);
+
+    const int kernelMargin = recursiveX ? kernel->height() / 2 : kernel->width() / 2;
+
+    const QRect intermRect = recursiveX ?
+        rect.adjusted(0, -kernelMargin, 0, kernelMargin) :
+        rect.adjusted(-kernelMargin, 0, kernelMargin, 0);
+
+    const QRect cloneRect = recursiveX ?
+        intermRect.adjusted(-recursiveMargin, 0, recursiveMargin, 0) :
+        intermRect.adjusted(0, -recursiveMargin, 0, recursiveMargin);
+
+    KisPaintDeviceSP interm = new KisPaintDevice(device->colorSpace());
+    interm->makeCloneFromRough(device, cloneRect);
+
+    if (!KisRecursiveGaussianBlur::apply(interm, intermRect,
+                                         recursiveX ? xRadius : 0.0,
+                                         recursiveX ? 0.0 : yRadius,
+                                         channelFlags, 0, borderOp)) {
+        return false;
+    }
+
+    KisConvolutionPainter painter(device);
+    painter.setChannelFlags(channelFlags);
+    painter.setProgress(progressUpdater);
+    painter.applyMatrix(kernel, interm, rect.topLeft(), rect.topLeft(), rect.size(), borderOp);
+
+    return true;
+}
+
+}
+
 void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
                                       const QRect& rect,
                                       qreal xRadius, qreal yRadius,
@@ -109,6 +162,29 @@ void KisGaussianKernel::applyGaussian(KisPaintDeviceSP device,
 {
     QPoint srcTopLeft = rect.topLeft();
 
+    /**
+     * The big kernels are too expensive both for the spatial and the
+     * FFT convolution, so use the recursive filter for them instead.
+     * It reads the whole source area before writing anything, so it
+     * doesn't need a transaction.
+     *
+     * The choice is made for every axis separately, the small axis of
+     * an anisotropic blur is still convolved with the explicit kernel.
+     */
+    const bool recursiveX = KisRecursiveGaussianBlur::isPreferredFor(xRadius);
+    const bool recursiveY = KisRecursiveGaussianBlur::isPreferredFor(yRadius);
+
+    if (recursiveX || recursiveY) {
+        if ((recursiveX || xRadius <= 0.0) && (recursiveY || yRadius <= 0.0)) {
+            if (KisRecursiveGaussianBlur::apply(device, rect, xRadius, yRadius,
+                                                channelFlags, progressUpdater, borderOp)) {
+                return;
+            }
+        } else if (applyMixedGaussian(device, rect, xRadius, yRadius, recursiveX,
+                                      channelFlags, progressUpdater, borderOp)) {
+            return;
+        }
+    }
 
     if (KisConvolutionPainter::supportsFFTW()) {
         KisConvolutionPainter painter(device, KisConvolutionPainter::FFTW);
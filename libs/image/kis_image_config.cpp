@@ -85,6 +85,28 @@ qreal KisImageConfig::transformMaskOffBoundsReadArea() const
     return m_config.readEntry("transformMaskOffBoundsReadArea", 0.5);
 }
 
+bool KisImageConfig::fuseColorAdjustmentMasks(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("fuseColorAdjustmentMasks", true) : true;
+}
+
+void KisImageConfig::setFuseColorAdjustmentMasks(bool value)
+{
+    m_config.writeEntry("fuseColorAdjustmentMasks", value);
+}
+
+bool KisImageConfig::cacheFilterResults(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("cacheFilterResults", true) : true;
+}
+
+void KisImageConfig::setCacheFilterResults(bool value)
+{
+    m_config.writeEntry("cacheFilterResults", value);
+}
+
 int KisImageConfig::updatePatchHeight() const
 {
     int patchHeight = m_config.readEntry("updatePatchHeight", 512);
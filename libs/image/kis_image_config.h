@@ -26,6 +26,12 @@ public:
 
     qreal transformMaskOffBoundsReadArea() const;
 
+    bool fuseColorAdjustmentMasks(bool requestDefault = false) const;
+    void setFuseColorAdjustmentMasks(bool value);
+
+    bool cacheFilterResults(bool requestDefault = false) const;
+    void setCacheFilterResults(bool value);
+
     int updatePatchHeight() const;
     void setUpdatePatchHeight(int value);
     int updatePatchWidth() const;
@@ -48,6 +48,7 @@
 #include "kis_layer_utils.h"
 #include "kis_projection_leaf.h"
 #include "KisSafeNodeProjectionStore.h"
+#include "KisColorAdjustmentMaskFusion.h"
 
 
 class KisCloneLayersList {
@@ -682,11 +683,39 @@ QRect KisLayer::applyMasks(const KisPaintDeviceSP source,
                 copyOriginalToProjection(source, destination, needRect);
             }
 
-            Q_FOREACH (const KisEffectMaskSP& mask, masks) {
+            const bool fuseMasks =
+                masks.size() > 1 && KisColorAdjustmentMaskFusion::isEnabled();
+
+            for (int i = 0; i < masks.size();) {
+                /**
+                 * Consecutive color adjustment masks are applied in
+                 * a single pass over the destination device
+                 */
+                if (fuseMasks) {
+                    KisColorAdjustmentMaskFusion fusion(destination);
+
+                    for (int j = i; j < masks.size(); j++) {
+                        if (!fusion.tryAddMask(masks[j])) break;
+                    }
+
+                    if (fusion.numMasks() > 1) {
+                        QRect maskApplyRect;
+                        for (int j = 0; j < fusion.numMasks(); j++) {
+                            maskApplyRect = applyRects.pop();
+                        }
+
+                        fusion.apply(maskApplyRect);
+                        i += fusion.numMasks();
+                        continue;
+                    }
+                }
+
+                const KisEffectMaskSP &mask = masks[i++];
+
                 const QRect maskApplyRect = applyRects.pop();
                 const QRect maskNeedRect =
                     applyRects.isEmpty() ? needRect : applyRects.top();
-                    
+
                 PositionToFilthy maskPosition = calculatePositionToFilthy(mask, filthyNode, const_cast<KisLayer*>(this));
                 mask->apply(destination, maskApplyRect, maskNeedRect, maskPosition, flags);
             }
@@ -16,11 +16,19 @@
 
 #include <QVector>
 #include <QGlobalStatic>
+#include <QAtomicInt>
+
+#include <cmath>
+#include <vector>
 
 #include <KoColorSpaceMaths.h>
+#include <KoUpdater.h>
 
 #include <kis_debug.h>
 #include "kis_iterator_ng.h"
+#include "kis_sequential_iterator.h"
+#include "KisHaarWaveletProcessorBase.h"
+#include "KisHaarWaveletProcessorFactory.h"
 
 #include "math.h"
 
@@ -346,3 +354,250 @@ void KisMathToolbox::fastWaveletUntransformation(KisPaintDeviceSP dst, const QRe
     waveuntrans(wav, buff, 1);
     transformFromFR(dst, wav, rect);
 }
+
+namespace {
+
+void planeFastWaveletTransformation(const KisHaarWaveletProcessorBase *processor, float *plane, float *buff, int size)
+{
+    for (int levelSize = size; levelSize >= 2; levelSize /= 2) {
+        processor->transformLevel(plane, buff, size, levelSize);
+    }
+}
+
+void planeFastWaveletUntransformation(const KisHaarWaveletProcessorBase *processor, float *plane, float *buff, int size)
+{
+    for (int levelSize = 2; levelSize <= size; levelSize *= 2) {
+        processor->untransformLevel(plane, buff, size, levelSize);
+    }
+}
+
+}
+
+struct KisMathToolbox::FastWaveletFilter::Private
+{
+    KisPaintDeviceSP device;
+    QRect rect;
+    std::function<void(float *coeffs, int numCoeffs)> detailFunctor;
+    KoUpdater *progressUpdater = 0;
+    QAtomicInt numProcessedRows;
+
+    int depth = 0;
+    QVector<PtrToDouble> toDoubleFuncs;
+    QVector<PtrFromDouble> fromDoubleFuncs;
+    QVector<int> positions;
+
+    int tileSize = 0;
+    int gridSize = 0;
+    int numTileColumns = 0;
+    int numTileRows = 0;
+    double averageScale = 1.0;
+
+    /**
+     * The averages of the tiles, one plane per channel. The rows of
+     * the tiles write into it concurrently, so it is not an implicitly
+     * shared container.
+     */
+    std::vector<float> averages;
+
+    QScopedPointer<KisHaarWaveletProcessorBase> processor;
+
+    QRect tileRect(int row, int column) const {
+        return QRect(rect.x() + column * tileSize, rect.y() + row * tileSize, tileSize, tileSize) & rect;
+    }
+};
+
+KisMathToolbox::FastWaveletFilter::FastWaveletFilter(KisPaintDeviceSP device, const QRect &rect,
+                                                     const std::function<void(float *coeffs, int numCoeffs)> &detailFunctor,
+                                                     KoUpdater *progressUpdater)
+    : m_d(new Private)
+{
+    if (rect.isEmpty()) return;
+
+    QList<KoChannelInfo *> cis = device->colorSpace()->channels();
+    // remove non-color channels
+    for (qint32 c = 0; c < cis.count(); ++c) {
+        if (cis[c]->channelType() != KoChannelInfo::COLOR)
+            cis.removeAt(c--);
+    }
+
+    m_d->depth = cis.count();
+    m_d->toDoubleFuncs.resize(m_d->depth);
+    m_d->fromDoubleFuncs.resize(m_d->depth);
+
+    KisMathToolbox mathToolbox;
+    if (!mathToolbox.getToDoubleChannelPtr(cis, m_d->toDoubleFuncs) ||
+        !mathToolbox.getFromDoubleChannelPtr(cis, m_d->fromDoubleFuncs))
+        return;
+
+    m_d->positions.resize(m_d->depth);
+    for (int k = 0; k < m_d->depth; k++) {
+        m_d->positions[k] = cis[k]->pos();
+    }
+
+    m_d->device = device;
+    m_d->rect = rect;
+    m_d->detailFunctor = detailFunctor;
+    m_d->progressUpdater = progressUpdater;
+    m_d->processor.reset(KisHaarWaveletProcessorFactory::create());
+
+    /**
+     * The coefficients of the first levels of the transform depend only
+     * on the pixels of the tile they are placed in, so the tiles are
+     * transformed separately. The averages of the tiles form a small
+     * image, that passes the remaining levels. The tiles are aligned to
+     * the padded power of two square, so the result is the same as the
+     * one of fastWaveletTransformation().
+     */
+    int size;
+    const int maxrectsize = qMax(rect.width(), rect.height());
+    for (size = 2; size < maxrectsize; size *= 2) ;
+
+    m_d->tileSize = qMin(size, 128);
+    m_d->gridSize = size / m_d->tileSize;
+    m_d->numTileColumns = (rect.width() + m_d->tileSize - 1) / m_d->tileSize;
+    m_d->numTileRows = (rect.height() + m_d->tileSize - 1) / m_d->tileSize;
+
+    int numTileLevels = 0;
+    for (int i = m_d->tileSize; i > 1; i /= 2) numTileLevels++;
+
+    // every level multiplies the sums of the 2x2 blocks by 1/sqrt(2)
+    m_d->averageScale = std::pow(M_SQRT1_2, numTileLevels);
+
+    // the tiles in the padding area are always zero, so they are skipped
+    m_d->averages.assign(m_d->depth * m_d->gridSize * m_d->gridSize, 0.0f);
+
+    if (progressUpdater) {
+        progressUpdater->setRange(0, 2 * m_d->numTileRows);
+    }
+}
+
+KisMathToolbox::FastWaveletFilter::~FastWaveletFilter()
+{
+}
+
+int KisMathToolbox::FastWaveletFilter::numTileRows() const
+{
+    return m_d->numTileRows;
+}
+
+void KisMathToolbox::FastWaveletFilter::reportProgress()
+{
+    const int numProcessedRows = m_d->numProcessedRows.fetchAndAddOrdered(1) + 1;
+
+    if (m_d->progressUpdater) {
+        m_d->progressUpdater->setValue(numProcessedRows);
+    }
+}
+
+void KisMathToolbox::FastWaveletFilter::computeTileAverages(int row)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(row >= 0 && row < m_d->numTileRows);
+
+    const int depth = m_d->depth;
+    const int gridSize = m_d->gridSize;
+    float *const averagesData = m_d->averages.data();
+
+    for (int column = 0; column < m_d->numTileColumns; column++) {
+        QVector<double> sums(depth, 0.0);
+
+        KisSequentialConstIterator it(m_d->device, m_d->tileRect(row, column));
+        while (it.nextPixel()) {
+            const quint8 *pixel = it.oldRawData();
+            for (int k = 0; k < depth; k++) {
+                sums[k] += m_d->toDoubleFuncs[k](pixel, m_d->positions[k]);
+            }
+        }
+
+        for (int k = 0; k < depth; k++) {
+            averagesData[(k * gridSize + row) * gridSize + column] = sums[k] * m_d->averageScale;
+        }
+    }
+
+    reportProgress();
+}
+
+void KisMathToolbox::FastWaveletFilter::filterTileAverages()
+{
+    const int gridSize = m_d->gridSize;
+    if (gridSize <= 1) return;
+
+    QVector<float> buff(gridSize * gridSize);
+
+    for (int k = 0; k < m_d->depth; k++) {
+        float *plane = m_d->averages.data() + k * gridSize * gridSize;
+
+        planeFastWaveletTransformation(m_d->processor.data(), plane, buff.data(), gridSize);
+        // the average of the whole rect is kept as it is
+        m_d->detailFunctor(plane + 1, gridSize * gridSize - 1);
+        planeFastWaveletUntransformation(m_d->processor.data(), plane, buff.data(), gridSize);
+    }
+}
+
+void KisMathToolbox::FastWaveletFilter::filterTiles(int row)
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(row >= 0 && row < m_d->numTileRows);
+
+    const int depth = m_d->depth;
+    const int tileSize = m_d->tileSize;
+    const int gridSize = m_d->gridSize;
+    const int planeSize = tileSize * tileSize;
+    const float *const averagesData = m_d->averages.data();
+
+    // every row has its own buffers, so that the rows could be filtered concurrently
+    QVector<float> planes(depth * planeSize);
+    QVector<float> buff(planeSize);
+
+    for (int column = 0; column < m_d->numTileColumns; column++) {
+        const QRect rc = m_d->tileRect(row, column);
+        const QPoint origin(m_d->rect.x() + column * tileSize, m_d->rect.y() + row * tileSize);
+
+        // the border tiles are padded with zeros
+        planes.fill(0.0f);
+
+        KisSequentialConstIterator srcIt(m_d->device, rc);
+        while (srcIt.nextPixel()) {
+            const quint8 *pixel = srcIt.oldRawData();
+            const int offset = (srcIt.y() - origin.y()) * tileSize + srcIt.x() - origin.x();
+            for (int k = 0; k < depth; k++) {
+                planes[k * planeSize + offset] = m_d->toDoubleFuncs[k](pixel, m_d->positions[k]);
+            }
+        }
+
+        for (int k = 0; k < depth; k++) {
+            float *plane = planes.data() + k * planeSize;
+
+            planeFastWaveletTransformation(m_d->processor.data(), plane, buff.data(), tileSize);
+            m_d->detailFunctor(plane + 1, planeSize - 1);
+            plane[0] = averagesData[(k * gridSize + row) * gridSize + column];
+            planeFastWaveletUntransformation(m_d->processor.data(), plane, buff.data(), tileSize);
+        }
+
+        KisSequentialIterator dstIt(m_d->device, rc);
+        while (dstIt.nextPixel()) {
+            quint8 *pixel = dstIt.rawData();
+            const int offset = (dstIt.y() - origin.y()) * tileSize + dstIt.x() - origin.x();
+            for (int k = 0; k < depth; k++) {
+                m_d->fromDoubleFuncs[k](pixel, m_d->positions[k], planes[k * planeSize + offset]);
+            }
+        }
+    }
+
+    reportProgress();
+}
+
+void KisMathToolbox::fastWaveletFilter(KisPaintDeviceSP device, const QRect &rect,
+                                       const std::function<void(float *coeffs, int numCoeffs)> &detailFunctor,
+                                       KoUpdater *progressUpdater)
+{
+    FastWaveletFilter filter(device, rect, detailFunctor, progressUpdater);
+
+    for (int row = 0; row < filter.numTileRows(); row++) {
+        filter.computeTileAverages(row);
+    }
+
+    filter.filterTileAverages();
+
+    for (int row = 0; row < filter.numTileRows(); row++) {
+        filter.filterTiles(row);
+    }
+}
@@ -11,8 +11,10 @@
 
 #include <QObject>
 #include <QRect>
+#include <QScopedPointer>
 
 #include <new>
+#include <functional>
 
 #include <KoColorSpace.h>
 
@@ -31,6 +33,8 @@ typedef double(*PtrToDouble)(const quint8*, int);
 typedef void (*PtrFromDouble)(quint8*, int, double);
 typedef void (*PtrFromDoubleCheckNull)(quint8*, int, double, bool*);
 
+class KoUpdater;
+
 class KRITAIMAGE_EXPORT KisMathToolbox
 {
 
@@ -91,6 +95,65 @@ public:
      */
     void fastWaveletUntransformation(KisPaintDeviceSP dst, const QRect&, KisWavelet* wav, KisWavelet* buff = 0);
 
+    /**
+     * Processes the detail coefficients of the wavelet transform of the
+     * color channels of \p rect and transforms the result back into
+     * \p device. The transform is the same as in
+     * fastWaveletTransformation(), including the zero padding of the
+     * rect to a power of two square.
+     *
+     * The rect is split into square tiles, every tile is transformed
+     * separately in a small buffer and then only the averages of the
+     * tiles are transformed together. Therefore the memory usage doesn't
+     * depend on the size of the rect.
+     *
+     * @param device the device to read and write
+     * @param rect the rect for the transformation
+     * @param detailFunctor is called with the chunks of the detail
+     *        coefficients, i.e. all of them except the average of the
+     *        whole rect, and may change them in place
+     * @param progressUpdater the progress of the operation, may be null
+     */
+    void fastWaveletFilter(KisPaintDeviceSP device, const QRect &rect,
+                           const std::function<void(float *coeffs, int numCoeffs)> &detailFunctor,
+                           KoUpdater *progressUpdater = 0);
+
+    /**
+     * The passes of fastWaveletFilter() split by the rows of the tiles,
+     * so that the rows could be processed by several threads, e.g. by
+     * the jobs of a stroke.
+     *
+     * computeTileAverages() should be called for every row before
+     * filterTileAverages(), and filterTileAverages() before any call to
+     * filterTiles(). The calls for different rows may run concurrently,
+     * in this case the detail functor should be thread-safe too.
+     */
+    class KRITAIMAGE_EXPORT FastWaveletFilter
+    {
+    public:
+        FastWaveletFilter(KisPaintDeviceSP device, const QRect &rect,
+                          const std::function<void(float *coeffs, int numCoeffs)> &detailFunctor,
+                          KoUpdater *progressUpdater = 0);
+        ~FastWaveletFilter();
+
+        /**
+         * The number of the rows of the tiles, zero when there is
+         * nothing to process
+         */
+        int numTileRows() const;
+
+        void computeTileAverages(int row);
+        void filterTileAverages();
+        void filterTiles(int row);
+
+    private:
+        void reportProgress();
+
+    private:
+        struct Private;
+        const QScopedPointer<Private> m_d;
+    };
+
     bool getToDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrToDouble>& f);
     bool getFromDoubleChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrFromDouble>& f);
     bool getFromDoubleCheckNullChannelPtr(QList<KoChannelInfo *> cis, QVector<PtrFromDoubleCheckNull>& f);
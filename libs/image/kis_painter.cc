@@ -610,31 +610,21 @@ void KisPainter::bitBltWithFixedSelection(qint32 dstX, qint32 dstY,
 
         d->selection->projection()->readBytes(mergedSelectionBytes, dstX, dstY, srcWidth, srcHeight);
 
-        KoCompositeOp::ParameterInfo multiplyParamInfo;
-        multiplyParamInfo.opacity = 1.0f;
-        multiplyParamInfo.flow = 1.0f;
-
-        // Merge selections here by multiplying them - compositeOP(COMPOSITE_MULT)
-        multiplyParamInfo.dstRowStart   = mergedSelectionBytes;
-        multiplyParamInfo.dstRowStride  = srcWidth * selection->pixelSize();
-        multiplyParamInfo.srcRowStart   = selRowStart;
-        multiplyParamInfo.srcRowStride  = selBounds.width() * selection->pixelSize();
-        multiplyParamInfo.maskRowStart  = 0;
-        multiplyParamInfo.maskRowStride = 0;
-        multiplyParamInfo.rows          = srcHeight;
-        multiplyParamInfo.cols          = srcWidth;
-        KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT)->composite(multiplyParamInfo);
-
-        // Blit to dstBytes (intermediary bit array)
+        /* Blit to dstBytes (intermediary bit array). Both selections are
+        multiplied together by the composite op in the same pass */
         d->paramInfo.dstRowStart   = dstBytes;
         d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
         d->paramInfo.srcRowStart   = srcBytes;
         d->paramInfo.srcRowStride  = srcWidth * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = mergedSelectionBytes;
-        d->paramInfo.maskRowStride = srcWidth * selection->pixelSize();
+        d->paramInfo.maskRowStart  = selRowStart;
+        d->paramInfo.maskRowStride = selBounds.width() * selection->pixelSize();
+        d->paramInfo.selectionRowStart  = mergedSelectionBytes;
+        d->paramInfo.selectionRowStride = srcWidth * selection->pixelSize();
         d->paramInfo.rows          = srcHeight;
         d->paramInfo.cols          = srcWidth;
         d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
+        d->paramInfo.selectionRowStart  = 0;
+        d->paramInfo.selectionRowStride = 0;
         delete[] mergedSelectionBytes;
     }
 
@@ -1101,31 +1091,21 @@ void KisPainter::bltFixedWithFixedSelection(qint32 dstX, qint32 dstY,
         }
         d->selection->projection()->readBytes(mergedSelectionBytes, dstX, dstY, srcWidth, srcHeight);
 
-        KoCompositeOp::ParameterInfo multiplyParamInfo;
-        multiplyParamInfo.opacity = 1.0f;
-        multiplyParamInfo.flow = 1.0f;
-
-        // Merge selections here by multiplying them - compositeOp(COMPOSITE_MULT)
-        multiplyParamInfo.dstRowStart   = mergedSelectionBytes;
-        multiplyParamInfo.dstRowStride  = srcWidth * selection->pixelSize();
-        multiplyParamInfo.srcRowStart   = selRowStart;
-        multiplyParamInfo.srcRowStride  = selBounds.width() * selection->pixelSize();
-        multiplyParamInfo.maskRowStart  = 0;
-        multiplyParamInfo.maskRowStride = 0;
-        multiplyParamInfo.rows          = srcHeight;
-        multiplyParamInfo.cols          = srcWidth;
-        KoColorSpaceRegistry::instance()->alpha8()->compositeOp(COMPOSITE_MULT)->composite(multiplyParamInfo);
-
-        // Blit to dstBytes (intermediary bit array)
+        /* Blit to dstBytes (intermediary bit array). Both selections are
+        multiplied together by the composite op in the same pass */
         d->paramInfo.dstRowStart   = dstBytes;
         d->paramInfo.dstRowStride  = srcWidth * d->device->pixelSize();
         d->paramInfo.srcRowStart   = srcRowStart;
         d->paramInfo.srcRowStride  = srcBounds.width() * srcDev->pixelSize();
-        d->paramInfo.maskRowStart  = mergedSelectionBytes;
-        d->paramInfo.maskRowStride = srcWidth * selection->pixelSize();
+        d->paramInfo.maskRowStart  = selRowStart;
+        d->paramInfo.maskRowStride = selBounds.width() * selection->pixelSize();
+        d->paramInfo.selectionRowStart  = mergedSelectionBytes;
+        d->paramInfo.selectionRowStride = srcWidth * selection->pixelSize();
         d->paramInfo.rows          = srcHeight;
         d->paramInfo.cols          = srcWidth;
         d->colorSpace->bitBlt(srcDev->colorSpace(), d->paramInfo, compositeOp, d->renderingIntent, d->conversionFlags);
+        d->paramInfo.selectionRowStart  = 0;
+        d->paramInfo.selectionRowStride = 0;
 
         delete[] mergedSelectionBytes;
     }
@@ -72,7 +72,7 @@ void KisRectangleMaskGenerator::setSoftness(qreal softness)
 
 bool KisRectangleMaskGenerator::shouldVectorize() const
 {
-    return !shouldSupersample() && spikes() == 2;
+    return spikes() == 2;
 }
 
 KisBrushMaskApplicatorBase *KisRectangleMaskGenerator::applicator() const
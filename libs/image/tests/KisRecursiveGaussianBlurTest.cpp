@@ -0,0 +1,252 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisRecursiveGaussianBlurTest.h"
+
+#include <QBitArray>
+#include <QRandomGenerator>
+#include <QtMath>
+
+#include <KoColor.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_global.h"
+#include "kis_paint_device.h"
+#include "kis_convolution_kernel.h"
+#include "kis_convolution_painter.h"
+#include "kis_gaussian_kernel.h"
+#include "KisRecursiveGaussianBlur.h"
+
+#include <testutil.h>
+#include "testing_timed_default_bounds.h"
+
+namespace {
+
+KisPaintDeviceSP createNoiseDevice(const QRect &rect)
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(rect));
+
+    QRandomGenerator random(42);
+
+    // big blobs of color with some noise, the shapes are
+    // what the big blurs are usually applied to
+    QVector<quint8> bytes(rect.width() * rect.height() * dev->pixelSize());
+    quint8 *ptr = bytes.data();
+
+    for (int y = 0; y < rect.height(); y++) {
+        for (int x = 0; x < rect.width(); x++) {
+            const bool inside = (x / 40 + y / 40) % 2;
+
+            ptr[0] = quint8(inside ? 200 : 20) + quint8(random.bounded(40));
+            ptr[1] = quint8(x * 255 / rect.width());
+            ptr[2] = quint8(y * 255 / rect.height());
+            ptr[3] = 255;
+            ptr += 4;
+        }
+    }
+
+    dev->writeBytes(bytes.constData(), rect);
+    return dev;
+}
+
+void applyReferenceGaussian(KisPaintDeviceSP dev, const QRect &rect,
+                            qreal xRadius, qreal yRadius, const QBitArray &channelFlags)
+{
+    KisPaintDeviceSP interm = new KisPaintDevice(dev->colorSpace());
+    interm->setDefaultBounds(dev->defaultBounds());
+
+    KisConvolutionKernelSP kernelHoriz = KisGaussianKernel::createHorizontalKernel(xRadius);
+    KisConvolutionKernelSP kernelVertical = KisGaussianKernel::createVerticalKernel(yRadius);
+
+    const int verticalCenter = kernelVertical->height() / 2;
+
+    KisConvolutionPainter horizPainter(interm, KisConvolutionPainter::SPATIAL);
+    horizPainter.setChannelFlags(channelFlags);
+    horizPainter.applyMatrix(kernelHoriz, dev,
+                             rect.topLeft() - QPoint(0, verticalCenter),
+                             rect.topLeft() - QPoint(0, verticalCenter),
+                             rect.size() + QSize(0, 2 * verticalCenter),
+                             BORDER_REPEAT);
+
+    KisConvolutionPainter verticalPainter(dev, KisConvolutionPainter::SPATIAL);
+    verticalPainter.setChannelFlags(channelFlags);
+    verticalPainter.applyMatrix(kernelVertical, interm,
+                                rect.topLeft(), rect.topLeft(),
+                                rect.size(), BORDER_REPEAT);
+}
+
+int maxByteDifference(KisPaintDeviceSP dev1, KisPaintDeviceSP dev2, const QRect &rect)
+{
+    const int numBytes = rect.width() * rect.height() * dev1->pixelSize();
+
+    QVector<quint8> bytes1(numBytes);
+    QVector<quint8> bytes2(numBytes);
+    dev1->readBytes(bytes1.data(), rect);
+    dev2->readBytes(bytes2.data(), rect);
+
+    int maxDifference = 0;
+    for (int i = 0; i < numBytes; i++) {
+        maxDifference = qMax(maxDifference, qAbs(int(bytes1[i]) - int(bytes2[i])));
+    }
+    return maxDifference;
+}
+
+}
+
+void KisRecursiveGaussianBlurTest::testImpulseResponse_data()
+{
+    QTest::addColumn<qreal>("sigma");
+
+    QTest::newRow("2") << 2.0;
+    QTest::newRow("5") << 5.0;
+    QTest::newRow("30") << 30.0;
+    QTest::newRow("90") << 90.0;
+}
+
+void KisRecursiveGaussianBlurTest::testImpulseResponse()
+{
+    QFETCH(qreal, sigma);
+
+    const int size = qCeil(12 * sigma) + 1;
+    const int center = size / 2;
+
+    // two channels to check that they are filtered independently
+    QVector<float> buffer(size * size * 2, 0.0f);
+    buffer[(center * size + center) * 2] = 1.0f;
+
+    KisRecursiveGaussianBlur::blurBuffer(buffer.data(), size, size, 2, sigma, sigma);
+
+    qreal sum = 0.0;
+    qreal variance = 0.0;
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const qreal value = buffer[(y * size + x) * 2];
+            sum += value;
+            variance += value * pow2(x - center);
+
+            QCOMPARE(buffer[(y * size + x) * 2 + 1], 0.0f);
+        }
+    }
+
+    QVERIFY(qAbs(sum - 1.0) < 1e-3);
+    QVERIFY(qAbs(std::sqrt(variance / sum) - sigma) < 0.02 * sigma);
+}
+
+void KisRecursiveGaussianBlurTest::testCompareWithKernel_data()
+{
+    QTest::addColumn<qreal>("radius");
+
+    QTest::newRow("10") << 10.0;
+    QTest::newRow("30") << 30.0;
+    QTest::newRow("100") << 100.0;
+}
+
+void KisRecursiveGaussianBlurTest::testCompareWithKernel()
+{
+    QFETCH(qreal, radius);
+
+    const QRect imageRect(0, 0, 320, 240);
+    const QRect applyRect(20, 10, 250, 200);
+
+    KisPaintDeviceSP reference = createNoiseDevice(imageRect);
+    KisPaintDeviceSP dev = new KisPaintDevice(*reference);
+
+    const QBitArray channelFlags = dev->colorSpace()->channelFlags(true, true);
+
+    QVERIFY(KisRecursiveGaussianBlur::isPreferredFor(radius));
+    QVERIFY(KisRecursiveGaussianBlur::apply(dev, applyRect, radius, radius, channelFlags, nullptr));
+
+    applyReferenceGaussian(reference, applyRect, radius, radius, channelFlags);
+
+    QVERIFY(maxByteDifference(dev, reference, imageRect) <= 2);
+}
+
+void KisRecursiveGaussianBlurTest::testAnisotropicGaussian_data()
+{
+    QTest::addColumn<qreal>("xRadius");
+    QTest::addColumn<qreal>("yRadius");
+
+    QTest::newRow("big-x") << 40.0 << 0.6;
+    QTest::newRow("big-y") << 2.0 << 40.0;
+}
+
+void KisRecursiveGaussianBlurTest::testAnisotropicGaussian()
+{
+    QFETCH(qreal, xRadius);
+    QFETCH(qreal, yRadius);
+
+    // only one axis is big enough for the recursive filter
+    QVERIFY(KisRecursiveGaussianBlur::isPreferredFor(xRadius) !=
+            KisRecursiveGaussianBlur::isPreferredFor(yRadius));
+
+    const QRect imageRect(0, 0, 320, 240);
+    const QRect applyRect(20, 10, 250, 200);
+
+    KisPaintDeviceSP reference = createNoiseDevice(imageRect);
+    KisPaintDeviceSP dev = new KisPaintDevice(*reference);
+
+    const QBitArray channelFlags = dev->colorSpace()->channelFlags(true, true);
+
+    KisGaussianKernel::applyGaussian(dev, applyRect, xRadius, yRadius, channelFlags, nullptr);
+    applyReferenceGaussian(reference, applyRect, xRadius, yRadius, channelFlags);
+
+    QVERIFY(maxByteDifference(dev, reference, imageRect) <= 2);
+}
+
+void KisRecursiveGaussianBlurTest::testAlphaOnlyDevice()
+{
+    // the layer styles blur the selections
+
+    const QRect imageRect(0, 0, 300, 300);
+    const qreal radius = 40.0;
+
+    KisPaintDeviceSP reference = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    reference->setDefaultBounds(new TestUtil::TestingTimedDefaultBounds(imageRect));
+    reference->fill(QRect(100, 80, 100, 120), KoColor(Qt::white, reference->colorSpace()));
+
+    KisPaintDeviceSP dev = new KisPaintDevice(*reference);
+
+    const QBitArray channelFlags = dev->colorSpace()->channelFlags(true, true);
+
+    QVERIFY(KisRecursiveGaussianBlur::apply(dev, imageRect, radius, radius, channelFlags, nullptr));
+    applyReferenceGaussian(reference, imageRect, radius, radius, channelFlags);
+
+    QVERIFY(maxByteDifference(dev, reference, imageRect) <= 2);
+}
+
+void KisRecursiveGaussianBlurTest::testChannelFlags()
+{
+    const QRect imageRect(0, 0, 200, 200);
+
+    KisPaintDeviceSP original = createNoiseDevice(imageRect);
+    KisPaintDeviceSP dev = new KisPaintDevice(*original);
+
+    // blur everything except the red channel (the third one in BGRA)
+    QBitArray channelFlags = dev->colorSpace()->channelFlags(true, true);
+    channelFlags.clearBit(2);
+
+    QVERIFY(KisRecursiveGaussianBlur::apply(dev, imageRect, 30.0, 30.0, channelFlags, nullptr));
+
+    const int numPixels = imageRect.width() * imageRect.height();
+    QVector<quint8> originalBytes(numPixels * 4);
+    QVector<quint8> bytes(numPixels * 4);
+    original->readBytes(originalBytes.data(), imageRect);
+    dev->readBytes(bytes.data(), imageRect);
+
+    bool blueChanged = false;
+
+    for (int i = 0; i < numPixels; i++) {
+        QCOMPARE(bytes[i * 4 + 2], originalBytes[i * 4 + 2]);
+        blueChanged |= bytes[i * 4] != originalBytes[i * 4];
+    }
+
+    QVERIFY(blueChanged);
+}
+
+SIMPLE_TEST_MAIN(KisRecursiveGaussianBlurTest)
@@ -0,0 +1,29 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISRECURSIVEGAUSSIANBLURTEST_H
+#define KISRECURSIVEGAUSSIANBLURTEST_H
+
+#include <simpletest.h>
+
+class KisRecursiveGaussianBlurTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testImpulseResponse_data();
+    void testImpulseResponse();
+
+    void testCompareWithKernel_data();
+    void testCompareWithKernel();
+
+    void testAnisotropicGaussian_data();
+    void testAnisotropicGaussian();
+
+    void testAlphaOnlyDevice();
+    void testChannelFlags();
+};
+
+#endif // KISRECURSIVEGAUSSIANBLURTEST_H
@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSlidingWindowHistogramTest.h"
+
+#include <simpletest.h>
+
+#include <algorithm>
+
+#include <QRandomGenerator>
+
+#include "KisSlidingWindowHistogram.h"
+
+
+void KisSlidingWindowHistogramTest::testAgainstBruteForce_data()
+{
+    QTest::addColumn<int>("radius");
+    QTest::addColumn<int>("numBins");
+
+    QTest::newRow("r1-bins8") << 1 << 8;
+    QTest::newRow("r2-bins31") << 2 << 31;
+    QTest::newRow("r5-bins256") << 5 << 256;
+}
+
+void KisSlidingWindowHistogramTest::testAgainstBruteForce()
+{
+    QFETCH(int, radius);
+    QFETCH(int, numBins);
+
+    const int width = 23;
+    const int height = 17;
+    const int srcWidth = width + 2 * radius;
+    const int srcHeight = height + 2 * radius;
+
+    QRandomGenerator random(31337);
+
+    // every 5th pixel is skipped, the payload is the bin itself
+    QVector<int> bins(srcWidth * srcHeight);
+    QVector<float> payload(bins.size());
+
+    for (int i = 0; i < bins.size(); i++) {
+        bins[i] = random.bounded(5) ? random.bounded(numBins) : -1;
+        payload[i] = bins[i];
+    }
+
+    KisSlidingWindowHistogram hist(numBins, 1, srcWidth, radius);
+
+    for (int row = 0; row < 2 * radius + 1; row++) {
+        hist.addRow(bins.constData() + row * srcWidth, payload.constData() + row * srcWidth);
+    }
+
+    for (int y = 0; y < height; y++) {
+        if (y > 0) {
+            hist.removeRow(bins.constData() + (y - 1) * srcWidth, payload.constData() + (y - 1) * srcWidth);
+            hist.addRow(bins.constData() + (y + 2 * radius) * srcWidth, payload.constData() + (y + 2 * radius) * srcWidth);
+        }
+
+        hist.resetKernel();
+
+        for (int x = 0; x < width; x++) {
+            if (x > 0) {
+                hist.moveKernel();
+            }
+
+            QVector<int> counts(numBins);
+            QVector<int> values;
+
+            for (int j = y; j < y + 2 * radius + 1; j++) {
+                for (int i = x; i < x + 2 * radius + 1; i++) {
+                    const int bin = bins[j * srcWidth + i];
+                    if (bin < 0) continue;
+
+                    counts[bin]++;
+                    values << bin;
+                }
+            }
+
+            std::sort(values.begin(), values.end());
+
+            QCOMPARE(hist.totalCount(), values.size());
+
+            for (int i = 0; i < numBins; i++) {
+                QCOMPARE(hist.counts()[i], counts[i]);
+                QCOMPARE(qRound(*hist.payload(i)), counts[i] * i);
+            }
+
+            const int expectedMostFrequent =
+                values.isEmpty() ? -1 : int(std::max_element(counts.begin(), counts.end()) - counts.begin());
+            QCOMPARE(hist.mostFrequentBin(), expectedMostFrequent);
+
+            const int expectedMedian =
+                values.isEmpty() ? -1 : values[qRound(0.5 * (values.size() - 1))];
+            QCOMPARE(hist.percentileBin(0.5), expectedMedian);
+
+            const int expectedMinimum = values.isEmpty() ? -1 : values.first();
+            QCOMPARE(hist.percentileBin(0.0), expectedMinimum);
+
+            const int expectedMaximum = values.isEmpty() ? -1 : values.last();
+            QCOMPARE(hist.percentileBin(1.0), expectedMaximum);
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSlidingWindowHistogramTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSLIDINGWINDOWHISTOGRAMTEST_H
+#define KISSLIDINGWINDOWHISTOGRAMTEST_H
+
+#include <simpletest.h>
+
+class KisSlidingWindowHistogramTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testAgainstBruteForce_data();
+    void testAgainstBruteForce();
+};
+
+#endif // KISSLIDINGWINDOWHISTOGRAMTEST_H
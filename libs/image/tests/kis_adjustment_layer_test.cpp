@@ -9,6 +9,7 @@
 #include <simpletest.h>
 
 
+#include <KoColor.h>
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
 
@@ -21,6 +22,9 @@
 #include "kis_types.h"
 #include "kis_datamanager.h"
 #include "kis_pixel_selection.h"
+#include "kis_paint_layer.h"
+#include "kis_image_config.h"
+#include "KisImageConfigNotifier.h"
 #include <testutil.h>
 #include <KisGlobalResourcesInterface.h>
 
@@ -103,4 +107,86 @@ void KisAdjustmentLayerTest::testSelectionParent()
     }
 }
 
+void KisAdjustmentLayerTest::testFusedLayers_data()
+{
+    QTest::addColumn<bool>("transparentHole");
+    QTest::addColumn<int>("selectedLayer");
+    QTest::addColumn<int>("translucentLayer");
+
+    QTest::newRow("opaque") << false << -1 << -1;
+    QTest::newRow("transparent") << true << -1 << -1;
+    QTest::newRow("selection") << false << 2 << -1;
+    QTest::newRow("opacity") << true << -1 << 1;
+}
+
+void KisAdjustmentLayerTest::testFusedLayers()
+{
+    QFETCH(bool, transparentHole);
+    QFETCH(int, selectedLayer);
+    QFETCH(int, translucentLayer);
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    const QRect rc = qimage.rect();
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(0, rc.width(), rc.height(), cs, "adj layer test");
+
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint", OPACITY_OPAQUE_U8, cs);
+    layer->paintDevice()->convertFromQImage(qimage, 0, 0, 0);
+    if (transparentHole) {
+        layer->paintDevice()->clear(QRect(100, 100, 200, 150));
+    }
+    image->addNode(layer, image->root());
+
+    const QStringList filterIds({"invert", "desaturate", "invert", "hsvadjustment"});
+
+    for (int i = 0; i < filterIds.size(); i++) {
+        KisFilterSP f = KisFilterRegistry::instance()->value(filterIds[i]);
+        QVERIFY(f);
+
+        KisSelectionSP selection;
+        if (i == selectedLayer) {
+            selection = new KisSelection();
+            selection->pixelSelection()->select(QRect(50, 50, 300, 200), 128);
+        }
+
+        KisAdjustmentLayerSP adjLayer =
+            new KisAdjustmentLayer(image, QString("adj %1").arg(i),
+                                   f->defaultConfiguration(KisGlobalResourcesInterface::instance())->cloneWithResourcesSnapshot(),
+                                   selection);
+        if (i == translucentLayer) {
+            adjLayer->setOpacity(128);
+        }
+        image->addNode(adjLayer, image->root());
+    }
+
+    auto renderProjection = [&] (bool fuseLayers) {
+        KisImageConfig(false).setFuseColorAdjustmentMasks(fuseLayers);
+        KisImageConfigNotifier::instance()->notifyConfigChanged();
+
+        // the full refresh recalculates all the layers as filthy ones
+        image->refreshGraphAsync();
+        image->waitForDone();
+
+        // and the update of the paint layer as the ones above the filthy one
+        layer->paintDevice()->fill(QRect(20, 300, 150, 100), KoColor(Qt::red, cs));
+        layer->setDirty(QRect(20, 300, 150, 100));
+        image->waitForDone();
+
+        return image->projection()->convertToQImage(0, rc);
+    };
+
+    const QImage separateImage = renderProjection(false);
+    const QImage fusedImage = renderProjection(true);
+
+    KisImageConfig(false).setFuseColorAdjustmentMasks(KisImageConfig(true).fuseColorAdjustmentMasks(true));
+    KisImageConfigNotifier::instance()->notifyConfigChanged();
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint, separateImage, fusedImage)) {
+        fusedImage.save("adjustment_layers_fused.png");
+        QFAIL(QString("Fused layers differ from the separate ones, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
 SIMPLE_TEST_MAIN(KisAdjustmentLayerTest)
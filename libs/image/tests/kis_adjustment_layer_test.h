@@ -18,6 +18,9 @@ private Q_SLOTS:
     void testSetSelection();
     void testInverted();
     void testSelectionParent();
+
+    void testFusedLayers_data();
+    void testFusedLayers();
 };
 
 #endif
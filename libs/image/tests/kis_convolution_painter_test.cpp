@@ -17,8 +17,11 @@
 #include <KoColorSpaceTraits.h>
 
 #include "kis_paint_device.h"
+#include "kis_transaction.h"
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
+#include "kis_convolution_worker_spatial.h"
+#include "kis_convolution_worker_spatial_vector.h"
 #include <kis_gaussian_kernel.h>
 #include <kis_mask_generator.h>
 #include <kistest.h>
@@ -581,4 +584,241 @@ void KisConvolutionPainterTest::testNormalMapFFTW()
     testNormalMap(true);
 }
 
+void KisConvolutionPainterTest::testFFTWTiled()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    QImage referenceImage(TestUtil::fetchDataFileLazy("resolution_test.png"));
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(referenceImage, 0, 0, 0);
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(dev->exactBounds());
+    dev->setDefaultBounds(bounds);
+
+    const QRect applyRect = dev->exactBounds();
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createHorizontalKernel(15);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+    {
+        KisConvolutionPainter gc(refDev, KisConvolutionPainter::FFTW);
+        gc.setFFTMemoryLimit(0);
+        gc.applyMatrix(kernel, refDev, applyRect.topLeft(), applyRect.topLeft(), applyRect.size());
+    }
+
+    // convolve in place to check that the blocks don't read each other's results
+    {
+        KisConvolutionPainter gc(dev, KisConvolutionPainter::FFTW);
+        gc.setFFTMemoryLimit(1);
+        gc.applyMatrix(kernel, dev, applyRect.topLeft(), applyRect.topLeft(), applyRect.size());
+    }
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, applyRect),
+                                     dev->convertToQImage(0, applyRect), 1, 1));
+}
+
+void KisConvolutionPainterTest::testFFTWTiledTransaction()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    QImage referenceImage(TestUtil::fetchDataFileLazy("resolution_test.png"));
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(referenceImage, 0, 0, 0);
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(dev->exactBounds());
+    dev->setDefaultBounds(bounds);
+
+    const QRect applyRect = dev->exactBounds();
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createHorizontalKernel(15);
+
+    // the reference convolves the pixels the transaction has started with
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+    {
+        KisConvolutionPainter gc(refDev, KisConvolutionPainter::FFTW);
+        gc.setFFTMemoryLimit(0);
+        gc.applyMatrix(kernel, refDev, applyRect.topLeft(), applyRect.topLeft(), applyRect.size());
+    }
+
+    KisTransaction transaction(dev);
+
+    /**
+     * Change the pixels inside the transaction, like the other patches
+     * of a filter stroke do. The blocks should still read the old
+     * pixels of their margins.
+     */
+    const QRect changedRect(applyRect.x(), applyRect.center().y(),
+                            applyRect.width(), applyRect.height() / 2);
+    dev->fill(changedRect, KoColor(Qt::green, dev->colorSpace()));
+
+    {
+        KisConvolutionPainter gc(dev, KisConvolutionPainter::FFTW);
+        gc.setFFTMemoryLimit(1);
+        gc.applyMatrix(kernel, dev, applyRect.topLeft(), applyRect.topLeft(), applyRect.size());
+    }
+
+    transaction.end();
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, applyRect),
+                                     dev->convertToQImage(0, applyRect), 1, 1));
+}
+
+void KisConvolutionPainterTest::benchmarkFFTWThreads_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    for (int numThreads : {1, 2, 4, 8}) {
+        QTest::addRow("%d-threads", numThreads) << numThreads;
+    }
+}
+
+void KisConvolutionPainterTest::benchmarkFFTWThreads()
+{
+    if (!KisConvolutionPainter::supportsFFTW()) {
+        QSKIP("FFTW is not available");
+    }
+
+    QFETCH(int, numThreads);
+
+    QImage referenceImage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    // a single transform must be big enough to be split into threads
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 2; x++) {
+            dev->convertFromQImage(referenceImage, 0,
+                                   x * referenceImage.width(),
+                                   y * referenceImage.height());
+        }
+    }
+
+    const QRect applyRect = dev->exactBounds();
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(applyRect);
+    dev->setDefaultBounds(bounds);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createHorizontalKernel(25);
+
+    KisPaintDeviceSP dst = new KisPaintDevice(dev->colorSpace());
+    dst->setDefaultBounds(bounds);
+
+    QBENCHMARK {
+        KisConvolutionPainter gc(dst, KisConvolutionPainter::FFTW);
+        gc.setFFTThreadLimit(numThreads);
+        gc.applyMatrix(kernel, dev, applyRect.topLeft(), applyRect.topLeft(), applyRect.size());
+    }
+}
+
+void KisConvolutionPainterTest::testSpatialVectorWorker_data()
+{
+    QTest::addColumn<bool>("useRgb16");
+    QTest::addColumn<int>("kernelWidth");
+    QTest::addColumn<int>("kernelHeight");
+    QTest::addColumn<bool>("separable");
+
+    for (bool useRgb16 : {false, true}) {
+        const char *depth = useRgb16 ? "u16" : "u8";
+        QTest::addRow("%s-separable-5x5", depth) << useRgb16 << 5 << 5 << true;
+        QTest::addRow("%s-generic-5x3", depth) << useRgb16 << 5 << 3 << false;
+        QTest::addRow("%s-horizontal-9x1", depth) << useRgb16 << 9 << 1 << true;
+        QTest::addRow("%s-vertical-1x9", depth) << useRgb16 << 1 << 9 << true;
+    }
+}
+
+void KisConvolutionPainterTest::testSpatialVectorWorker()
+{
+    QFETCH(bool, useRgb16);
+    QFETCH(int, kernelWidth);
+    QFETCH(int, kernelHeight);
+    QFETCH(bool, separable);
+
+    const KoColorSpace *cs = useRgb16 ?
+        KoColorSpaceRegistry::instance()->rgb16() :
+        KoColorSpaceRegistry::instance()->rgb8();
+    QVERIFY(KisConvolutionWorkerSpatialVector<RepeatIteratorFactory>::supportsColorSpace(cs));
+
+    QImage referenceImage(TestUtil::fetchDataFileLazy("resolution_test.png"));
+    KisPaintDeviceSP src = new KisPaintDevice(cs);
+    src->convertFromQImage(referenceImage, 0, 0, 0);
+
+    // semi-transparent areas check premultiplication
+    src->fill(QRect(10, 10, 40, 40), KoColor(QColor(255, 0, 0, 100), cs));
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(src->exactBounds());
+    src->setDefaultBounds(bounds);
+
+    Eigen::Matrix<qreal, Eigen::Dynamic, Eigen::Dynamic> matrix(kernelHeight, kernelWidth);
+    for (int r = 0; r < kernelHeight; r++) {
+        for (int c = 0; c < kernelWidth; c++) {
+            matrix(r, c) = separable ? (r + 1) * (kernelWidth - c) : (r * kernelWidth + c) % 7 - 2;
+        }
+    }
+    KisConvolutionKernelSP kernel = KisConvolutionKernel::fromMatrix(matrix, 0.1, matrix.sum());
+
+    const QRect rect = src->exactBounds();
+
+    KisPaintDeviceSP scalarDst = new KisPaintDevice(cs);
+    {
+        KisPainter gc(scalarDst);
+        KisConvolutionWorkerSpatial<RepeatIteratorFactory> worker(&gc, 0);
+        worker.execute(kernel, src, rect.topLeft(), rect.topLeft(), rect.size(), rect);
+    }
+
+    KisPaintDeviceSP vectorDst = new KisPaintDevice(cs);
+    {
+        KisPainter gc(vectorDst);
+        KisConvolutionWorkerSpatialVector<RepeatIteratorFactory> worker(&gc, 0);
+        worker.execute(kernel, src, rect.topLeft(), rect.topLeft(), rect.size(), rect);
+    }
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     scalarDst->convertToQImage(0, rect),
+                                     vectorDst->convertToQImage(0, rect), 1, 1));
+}
+
+void KisConvolutionPainterTest::testSpatialVectorWorkerInPlace()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage referenceImage(TestUtil::fetchDataFileLazy("resolution_test.png"));
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+    dev->convertFromQImage(referenceImage, 0, 0, 0);
+
+    KisDefaultBoundsBaseSP bounds = new TestUtil::TestingTimedDefaultBounds(dev->exactBounds());
+    dev->setDefaultBounds(bounds);
+
+    const QRect rect = dev->exactBounds();
+
+    // the rect should be split into several blocks
+    QVERIFY(rect.height() > 64);
+
+    KisConvolutionKernelSP kernel = KisGaussianKernel::createUniform2DKernel(4, 4);
+
+    KisPaintDeviceSP refDst = new KisPaintDevice(cs);
+    {
+        KisPainter gc(refDst);
+        KisConvolutionWorkerSpatialVector<RepeatIteratorFactory> worker(&gc, 0);
+        worker.execute(kernel, dev, rect.topLeft(), rect.topLeft(), rect.size(), rect);
+    }
+
+    // no transaction, the margins of the blocks are read from the device itself
+    {
+        KisPainter gc(dev);
+        KisConvolutionWorkerSpatialVector<RepeatIteratorFactory> worker(&gc, 0);
+        worker.execute(kernel, dev, rect.topLeft(), rect.topLeft(), rect.size(), rect);
+    }
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDst->convertToQImage(0, rect),
+                                     dev->convertToQImage(0, rect)));
+}
+
 KISTEST_MAIN(KisConvolutionPainterTest)
@@ -52,6 +52,16 @@ private Q_SLOTS:
 
     void testNormalMapSpatial();
     void testNormalMapFFTW();
+
+    void testFFTWTiled();
+    void testFFTWTiledTransaction();
+
+    void benchmarkFFTWThreads_data();
+    void benchmarkFFTWThreads();
+
+    void testSpatialVectorWorker_data();
+    void testSpatialVectorWorker();
+    void testSpatialVectorWorkerInPlace();
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include "kis_filter_mask_test.h"
 #include <simpletest.h>
 
+#include <KoColor.h>
 #include <KoColorSpaceRegistry.h>
 
 #include "kis_selection.h"
@@ -15,10 +16,15 @@
 #include "kis_filter_mask.h"
 #include "filter/kis_filter_registry.h"
 #include "kis_group_layer.h"
+#include "kis_layer_projection_plane.h"
 #include "kis_paint_device.h"
 #include "kis_paint_layer.h"
 #include "kis_types.h"
 #include "kis_image.h"
+#include "KisColorAdjustmentMaskFusion.h"
+#include "KisFilterResultCache.h"
+#include "kis_datamanager.h"
+#include "krita_utils.h"
 #include <KisGlobalResourcesInterface.h>
 
 
@@ -97,5 +103,200 @@ void KisFilterMaskTest::testProjectionSelected()
     }
 
 }
+void KisFilterMaskTest::testColorAdjustmentFusion_data()
+{
+    QTest::addColumn<bool>("useGrayscale");
+    QTest::addColumn<bool>("useSelection");
+
+    QTest::newRow("rgba8") << false << false;
+    QTest::newRow("rgba8-selection") << false << true;
+    QTest::newRow("graya8") << true << false;
+    QTest::newRow("graya8-selection") << true << true;
+}
+
+void KisFilterMaskTest::testColorAdjustmentFusion()
+{
+    QFETCH(bool, useGrayscale);
+    QFETCH(bool, useSelection);
+
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+
+    const KoColorSpace *cs = useGrayscale ?
+        KoColorSpaceRegistry::instance()->graya8() :
+        KoColorSpaceRegistry::instance()->rgb8();
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    const QRect rc = qimage.rect();
+
+    KisPaintDeviceSP separateDevice = new KisPaintDevice(cs);
+    separateDevice->convertFromQImage(qimage, 0, 0, 0);
+    KisPaintDeviceSP fusedDevice = new KisPaintDevice(*separateDevice);
+
+    QList<KisFilterMaskSP> masks;
+
+    for (int i = 0; i < 3; i++) {
+        KisFilterSP f = KisFilterRegistry::instance()->value("invert");
+        QVERIFY(f);
+        KisFilterConfigurationSP kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+        QVERIFY(kfc);
+
+        KisFilterMaskSP mask = new KisFilterMask(image, QString("mask %1").arg(i));
+        image->addNode(mask, layer);
+        mask->setFilter(kfc->cloneWithResourcesSnapshot());
+        mask->createNodeProgressProxy();
+
+        masks.append(mask);
+    }
+
+    if (useSelection) {
+        masks[1]->initSelection(layer);
+        masks[1]->select(rc, MIN_SELECTED);
+        masks[1]->select(QRect(100, 100, 200, 150), 128);
+        masks[1]->select(QRect(250, 200, 200, 150), MAX_SELECTED);
+    }
+
+    Q_FOREACH (KisFilterMaskSP mask, masks) {
+        mask->apply(separateDevice, rc, rc, KisNode::N_FILTHY, KisRenderPassFlag::None);
+    }
+
+    KisColorAdjustmentMaskFusion fusion(fusedDevice);
+    Q_FOREACH (KisFilterMaskSP mask, masks) {
+        QVERIFY(fusion.tryAddMask(mask));
+    }
+    QCOMPARE(fusion.numMasks(), masks.size());
+    fusion.apply(rc);
+
+    QPoint errpoint;
+    if (!TestUtil::compareQImages(errpoint,
+                                  separateDevice->convertToQImage(0, 0, 0, rc.width(), rc.height()),
+                                  fusedDevice->convertToQImage(0, 0, 0, rc.width(), rc.height()))) {
+        fusedDevice->convertToQImage(0, 0, 0, rc.width(), rc.height()).save("filtermasktest_fused.png");
+        QFAIL(QString("Fused masks differ from the separate ones, first different pixel: %1,%2 ").arg(errpoint.x()).arg(errpoint.y()).toLatin1());
+    }
+}
+
+void KisFilterMaskTest::testResultCache()
+{
+    QVERIFY(KisFilterResultCache::isEnabled());
+
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+    KisPaintDeviceSP original = layer->paintDevice();
+    const KoColorSpace *cs = original->colorSpace();
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    original->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("blur");
+    QVERIFY(f);
+    KisFilterConfigurationSP kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    QVERIFY(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+    image->waitForDone();
+
+    /**
+     * The rect is aligned to the tiles, so the source of the mask
+     * shares all the tiles inside it with the layer original. The
+     * tiles outside are copied pixel by pixel on every update.
+     */
+    const QRect updateRect(0, 0, 640, 512);
+    const QVector<QRect> cells = KritaUtils::splitRectIntoPatches(updateRect, QSize(64, 64));
+
+    auto updateProjection = [&] () {
+        layer->projectionPlane()->recalculate(updateRect, layer, KisRenderPassFlag::None);
+
+        KisPaintDeviceSP reference = new KisPaintDevice(cs);
+        f->process(original, reference, 0, updateRect, mask->filter(), 0);
+
+        QPoint errpoint;
+        if (!TestUtil::compareQImages(errpoint,
+                                      reference->convertToQImage(0, updateRect),
+                                      layer->projection()->convertToQImage(0, updateRect))) {
+            layer->projection()->convertToQImage(0, updateRect).save("filtermasktest_cache.png");
+            qWarning() << "First different pixel:" << errpoint;
+            return false;
+        }
+        return true;
+    };
+
+    /**
+     * The cached tiles are shared with the projection, so a tile
+     * taken from the cache keeps the revision it had in the previous
+     * update, and a filtered one gets a new one
+     */
+    auto cellsReused = [&] (const QVector<QVector<quint64>> &lastRevisions,
+                            QVector<QVector<quint64>> &revisions) {
+        QVector<bool> result;
+        revisions.clear();
+
+        for (int i = 0; i < cells.size(); i++) {
+            QVector<quint64> cellRevisions;
+            layer->projection()->dataManager()->tileDataRevisions(cells[i], cellRevisions);
+
+            result << (!lastRevisions.isEmpty() && cellRevisions == lastRevisions[i]);
+            revisions << cellRevisions;
+        }
+        return result;
+    };
+
+    QVector<QVector<quint64>> revisions1;
+    QVector<QVector<quint64>> revisions2;
+    QVector<QVector<quint64>> revisions3;
+    QVector<QVector<quint64>> revisions4;
+
+    QVERIFY(updateProjection());
+    cellsReused({}, revisions1);
+
+    // nothing has changed, only the cells reading the border tiles are filtered
+    QVERIFY(updateProjection());
+    QVector<bool> reused = cellsReused(revisions1, revisions2);
+
+    int numReused = 0;
+    for (int i = 0; i < cells.size(); i++) {
+        const bool expectReused = updateRect.contains(mask->needRect(cells[i]));
+        QCOMPARE(reused[i], expectReused);
+        numReused += reused[i];
+    }
+    QVERIFY(numReused >= cells.size() / 2);
+
+    /**
+     * The change lies in a single tile, but the blur spreads it
+     * to the neighbouring cells, which should be filtered again
+     */
+    const QRect changedTile(192, 192, 64, 64);
+    original->fill(QRect(200, 200, 2, 2), KoColor(Qt::red, cs));
+
+    QVERIFY(updateProjection());
+    reused = cellsReused(revisions2, revisions3);
+
+    int numInvalidated = 0;
+    for (int i = 0; i < cells.size(); i++) {
+        const QRect needRect = mask->needRect(cells[i]);
+        const bool needsChangedTile = needRect.intersects(changedTile);
+
+        // every cell the change can reach is filtered again
+        if (mask->changeRect(changedTile).intersects(cells[i])) {
+            QVERIFY(!reused[i]);
+        }
+
+        QCOMPARE(reused[i], updateRect.contains(needRect) && !needsChangedTile);
+        numInvalidated += updateRect.contains(needRect) && needsChangedTile;
+    }
+    QVERIFY(numInvalidated > 1);
+
+    // a new filter drops all the cached cells
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+
+    QVERIFY(updateProjection());
+    reused = cellsReused(revisions3, revisions4);
+    QVERIFY(!reused.contains(true));
+}
 
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
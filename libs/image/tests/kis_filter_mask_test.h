@@ -20,6 +20,11 @@ private Q_SLOTS:
     void testProjectionNotSelected();
     void testProjectionSelected();
 
+    void testColorAdjustmentFusion_data();
+    void testColorAdjustmentFusion();
+
+    void testResultCache();
+
 };
 
 #endif
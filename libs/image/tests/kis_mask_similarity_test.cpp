@@ -158,9 +158,9 @@ public:
     }
 
     template <typename MaskGenerator>
-    static void runMaskGenTest(MaskGenerator& generator, MaskType type) {
-        QRect bounds(0,0,700,700);
-        generator.setDiameter(499.5);
+    static void runMaskGenTest(MaskGenerator& generator, MaskType type,
+                               qreal diameter = 499.5, QRect bounds = QRect(0,0,700,700)) {
+        generator.setDiameter(diameter);
         MaskGenerator scalarGenerator(generator);
 
         scalarGenerator
@@ -249,4 +249,43 @@ void KisMaskSimilarityTest::testSoftRectMask()
     KisMaskSimilarityTester::runMaskGenTest(generator,RECT_SOFT);
 }
 
+void KisMaskSimilarityTest::testSupersampledMasks()
+{
+    // the dabs smaller than 10px with antialiased edges are supersampled
+    const qreal diameter = 6.5;
+    const QRect bounds(0,0,10,10);
+    const KisCubicCurve pointsCurve(QString("0,1;1,0"));
+
+    {
+        KisCircleMaskGenerator generator(diameter, 0.8, 0.5, 0.5, 2, true);
+        QVERIFY(generator.shouldSupersample());
+        KisMaskSimilarityTester::runMaskGenTest(generator, DEFAULT, diameter, bounds);
+    }
+
+    {
+        KisGaussCircleMaskGenerator generator(diameter, 0.8, 1, 1, 2, true);
+        KisMaskSimilarityTester::runMaskGenTest(generator, CIRC_GAUSS, diameter, bounds);
+    }
+
+    {
+        KisCurveCircleMaskGenerator generator(diameter, 0.8, 0.5, 0.5, 2, pointsCurve, true);
+        KisMaskSimilarityTester::runMaskGenTest(generator, CIRC_SOFT, diameter, bounds);
+    }
+
+    {
+        KisRectangleMaskGenerator generator(diameter, 0.8, 0.5, 0.5, 2, true);
+        KisMaskSimilarityTester::runMaskGenTest(generator, RECT, diameter, bounds);
+    }
+
+    {
+        KisGaussRectangleMaskGenerator generator(diameter, 0.8, 0.5, 0.2, 2, true);
+        KisMaskSimilarityTester::runMaskGenTest(generator, RECT_GAUSS, diameter, bounds);
+    }
+
+    {
+        KisCurveRectangleMaskGenerator generator(diameter, 0.8, 0.5, 0.2, 2, pointsCurve, true);
+        KisMaskSimilarityTester::runMaskGenTest(generator, RECT_SOFT, diameter, bounds);
+    }
+}
+
 SIMPLE_TEST_MAIN(KisMaskSimilarityTest)
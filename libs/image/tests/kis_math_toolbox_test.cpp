@@ -9,11 +9,171 @@
 #include <simpletest.h>
 #include "kis_math_toolbox.h"
 
+#include <QRandomGenerator>
+
+#include <KoColorSpaceRegistry.h>
+#include <testutil.h>
+
+#include "KisHaarWaveletProcessorBase.h"
+#include "KisHaarWaveletProcessorFactory.h"
+
 void KisMathToolboxTest::testCreation()
 {
     KisMathToolbox tb;
     Q_UNUSED(tb);
 }
 
+void KisMathToolboxTest::testTiledWaveletFilter_data()
+{
+    QTest::addColumn<QRect>("rect");
+
+    QTest::newRow("single-tile") << QRect(0, 0, 100, 60);
+    QTest::newRow("several-tiles") << QRect(0, 0, 300, 200);
+}
+
+void KisMathToolboxTest::testTiledWaveletFilter()
+{
+    QFETCH(QRect, rect);
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP dev = new KisPaintDevice(cs);
+
+    QRandomGenerator random(31337);
+    QImage image(rect.size(), QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            // a gradient with some noise over it, away from the limits
+            // of the channels, because the results are not clamped
+            const int value = qBound(32, 32 + x / 2 + y / 2 + int(random.bounded(32)) - 16, 223);
+            image.setPixel(x, y, qRgba(value, 255 - value, 128, 255));
+        }
+    }
+    dev->convertFromQImage(image, 0, rect.x(), rect.y());
+
+    const float threshold = 7.0f;
+    auto softThreshold = [threshold] (float &value) {
+        value =
+            value > threshold ? value - threshold :
+            value < -threshold ? value + threshold : 0.0f;
+    };
+
+    KisMathToolbox mathToolbox;
+
+    // the reference: the whole rect is transformed at once
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+    KisMathToolbox::KisWavelet *buff = mathToolbox.initWavelet(refDev, rect);
+    KisMathToolbox::KisWavelet *wav = mathToolbox.fastWaveletTransformation(refDev, rect, buff);
+    for (uint i = wav->depth; i < wav->depth * wav->size * wav->size; i++) {
+        softThreshold(wav->coeffs[i]);
+    }
+    mathToolbox.fastWaveletUntransformation(refDev, rect, wav, buff);
+    delete wav;
+    delete buff;
+
+    mathToolbox.fastWaveletFilter(dev, rect,
+        [softThreshold] (float *coeffs, int numCoeffs) {
+            for (int i = 0; i < numCoeffs; i++) {
+                softThreshold(coeffs[i]);
+            }
+        });
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, rect),
+                                     dev->convertToQImage(0, rect),
+                                     1));
+}
+
+void KisMathToolboxTest::testHaarWaveletProcessor_data()
+{
+    QTest::addColumn<int>("size");
+
+    // the small sizes are processed by the scalar tail only
+    QTest::newRow("2") << 2;
+    QTest::newRow("4") << 4;
+    QTest::newRow("8") << 8;
+    QTest::newRow("16") << 16;
+    QTest::newRow("128") << 128;
+}
+
+void KisMathToolboxTest::testHaarWaveletProcessor()
+{
+    QFETCH(int, size);
+
+    QScopedPointer<KisHaarWaveletProcessorBase> optimized(KisHaarWaveletProcessorFactory::create());
+    QScopedPointer<KisHaarWaveletProcessorBase> scalar(KisHaarWaveletProcessorFactory::createScalar());
+
+    QRandomGenerator random(1234);
+
+    // the plane is wider than the transformed area, like the ones of the tiles
+    const int stride = 2 * size;
+    QVector<float> plane(stride * stride);
+    for (float &value : plane) {
+        value = random.bounded(256.0);
+    }
+
+    QVector<float> optimizedPlane = plane;
+    QVector<float> scalarPlane = plane;
+    QVector<float> buff(stride * stride);
+
+    for (int levelSize = size; levelSize >= 2; levelSize /= 2) {
+        optimized->transformLevel(optimizedPlane.data(), buff.data(), stride, levelSize);
+        scalar->transformLevel(scalarPlane.data(), buff.data(), stride, levelSize);
+    }
+
+    // the vector and the scalar versions add the values in the same order
+    QCOMPARE(optimizedPlane, scalarPlane);
+
+    for (int levelSize = 2; levelSize <= size; levelSize *= 2) {
+        optimized->untransformLevel(optimizedPlane.data(), buff.data(), stride, levelSize);
+        scalar->untransformLevel(scalarPlane.data(), buff.data(), stride, levelSize);
+    }
+
+    QCOMPARE(optimizedPlane, scalarPlane);
+
+    for (int i = 0; i < plane.size(); i++) {
+        QVERIFY(qAbs(optimizedPlane[i] - plane[i]) < 1e-2);
+    }
+}
+
+void KisMathToolboxTest::testWaveletFilterStages()
+{
+    const QRect rect(10, 20, 300, 400);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    QImage image(TestUtil::fetchDataFileLazy("hakonepa.png"));
+    dev->convertFromQImage(image, 0);
+
+    KisPaintDeviceSP refDev = new KisPaintDevice(*dev);
+
+    auto functor = [] (float *coeffs, int numCoeffs) {
+        for (int i = 0; i < numCoeffs; i++) {
+            coeffs[i] = qAbs(coeffs[i]) > 7.0f ? coeffs[i] : 0.0f;
+        }
+    };
+
+    KisMathToolbox mathToolbox;
+    mathToolbox.fastWaveletFilter(refDev, rect, functor);
+
+    // the rows may be processed in any order, like the concurrent jobs do
+    KisMathToolbox::FastWaveletFilter filter(dev, rect, functor);
+    QCOMPARE(filter.numTileRows(), 4);
+
+    for (int row = filter.numTileRows() - 1; row >= 0; row--) {
+        filter.computeTileAverages(row);
+    }
+
+    filter.filterTileAverages();
+
+    for (int row = filter.numTileRows() - 1; row >= 0; row--) {
+        filter.filterTiles(row);
+    }
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     refDev->convertToQImage(0, rect),
+                                     dev->convertToQImage(0, rect)));
+}
 
 SIMPLE_TEST_MAIN(KisMathToolboxTest)
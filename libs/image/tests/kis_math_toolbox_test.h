@@ -15,6 +15,11 @@ class KisMathToolboxTest : public QObject
 private Q_SLOTS:
 
     void testCreation();
+    void testTiledWaveletFilter_data();
+    void testTiledWaveletFilter();
+    void testHaarWaveletProcessor_data();
+    void testHaarWaveletProcessor();
+    void testWaveletFilterStages();
 
 };
 
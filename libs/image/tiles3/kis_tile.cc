@@ -262,6 +262,7 @@ void KisTile::lockForWrite()
 
 void KisTile::unlockForWrite()
 {
+    m_tileData->bumpRevision();
     unblockSwapping();
     DEBUG_LOG_ACTION("unlock [W]");
 
@@ -121,5 +121,15 @@ inline qint32 KisTileData::numUsers() const {
     return m_usersCount;
 }
 
+inline quint64 KisTileData::serial() const {
+    return m_serial;
+}
+inline quint32 KisTileData::revision() const {
+    return m_revision.loadAcquire();
+}
+inline void KisTileData::bumpRevision() {
+    m_revision.fetchAndAddRelease(1);
+}
+
 #endif /* KIS_TILE_DATA_H_ */
 
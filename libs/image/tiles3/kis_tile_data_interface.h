@@ -180,6 +180,21 @@ public:
      */
     inline bool historical() const;
 
+    /**
+     * A number identifying the tile data object. It is taken from
+     * a global counter on creation, so it is never reused, even if
+     * the tile data is recreated at the same address.
+     */
+    inline quint64 serial() const;
+
+    /**
+     * A number that changes every time the pixels of the tile data
+     * are modified through a tile. Equal serial() and revision()
+     * always mean the same pixels.
+     */
+    inline quint32 revision() const;
+    inline void bumpRevision();
+
     /**
      * Used for swapping purposes only.
      * Frees the memory occupied by the tile data.
@@ -300,6 +315,12 @@ private:
      */
     mutable QAtomicInt m_refCount;
 
+    /**
+     * \see serial(), revision()
+     */
+    const quint64 m_serial;
+    QAtomicInteger<quint32> m_revision;
+    static QAtomicInteger<quint64> m_lastSerial;
 
     qint32 m_pixelSize;
     //qint32 m_timeStamp;
@@ -776,6 +776,34 @@ qint32 KisTiledDataManager::rowStride(qint32 x, qint32 y) const
     return KisTileData::WIDTH * pixelSize();
 }
 
+void KisTiledDataManager::tileDataRevisions(const QRect &rect, QVector<quint64> &revisions) const
+{
+    if (rect.isEmpty()) return;
+
+    QReadLocker locker(&m_lock);
+
+    const qint32 firstColumn = xToCol(rect.left());
+    const qint32 firstRow = yToRow(rect.top());
+    const qint32 lastColumn = xToCol(rect.right());
+    const qint32 lastRow = yToRow(rect.bottom());
+
+    for (qint32 row = firstRow; row <= lastRow; row++) {
+        for (qint32 column = firstColumn; column <= lastColumn; column++) {
+            bool tileExists = false;
+            KisTileSP tile = m_hashTable->getReadOnlyTileLazy(column, row, tileExists);
+
+            if (tileExists) {
+                KisTileData *tileData = tile->tileData();
+                revisions.append(tileData->serial());
+                revisions.append(tileData->revision());
+            } else {
+                revisions.append(0);
+                revisions.append(0);
+            }
+        }
+    }
+}
+
 void KisTiledDataManager::releaseInternalPools()
 {
     KisTileData::releaseInternalPools();
@@ -331,6 +331,19 @@ public:
      */
     qint32 rowStride(qint32 x, qint32 y) const;
 
+    /**
+     * Appends the serial and the revision of the tile data of all the
+     * tiles intersecting \p rect to \p revisions, row by row. The
+     * tiles that don't exist report zeros, they have the default pixel.
+     *
+     * If two calls return the same revisions and the default pixel
+     * is the same, the pixels of the rect have not changed between
+     * them.
+     *
+     * \see KisTileData::serial(), KisTileData::revision()
+     */
+    void tileDataRevisions(const QRect &rect, QVector<quint64> &revisions) const;
+
 private:
     KisTileHashTable *m_hashTable;
     KisMementoManager *m_mementoManager;
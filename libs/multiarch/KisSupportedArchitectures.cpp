@@ -132,3 +132,51 @@ QString KisSupportedArchitectures::supportedInstructionSets()
     }();
     return archs;
 }
+
+QStringList KisSupportedArchitectures::availableArchNames()
+{
+    QStringList names;
+    names << QStringLiteral("generic");
+
+#ifdef HAVE_XSIMD
+    bool useVectorization = true;
+    bool disableAVXOptimizations = false;
+
+    std::tie(useVectorization, disableAVXOptimizations) =
+        vectorizationConfiguration();
+
+    if (!useVectorization) {
+        return names;
+    }
+
+#ifdef Q_PROCESSOR_X86
+    const auto available = xsimd::available_architectures();
+
+    if (available.sse2) {
+        names << xsimd::sse2::name();
+    }
+    if (available.ssse3) {
+        names << xsimd::ssse3::name();
+    }
+    if (available.sse4_1) {
+        names << xsimd::sse4_1::name();
+    }
+    if (!disableAVXOptimizations && available.avx) {
+        names << xsimd::avx::name();
+    }
+    if (!disableAVXOptimizations && available.fma3_avx2) {
+        names << xsimd::fma3<xsimd::avx2>::name();
+    }
+#elif XSIMD_WITH_NEON64
+    if (xsimd::available_architectures().neon64) {
+        names << xsimd::neon64::name();
+    }
+#elif XSIMD_WITH_NEON
+    if (xsimd::available_architectures().neon) {
+        names << xsimd::neon::name();
+    }
+#endif
+#endif // HAVE_XSIMD
+
+    return names;
+}
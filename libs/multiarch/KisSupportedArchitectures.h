@@ -10,6 +10,7 @@
 #include "kritamultiarch_export.h"
 
 #include <QString>
+#include <QStringList>
 
 class KRITAMULTIARCH_EXPORT KisSupportedArchitectures
 {
@@ -21,6 +22,12 @@ public:
     static unsigned int bestArch();
 
     static QString supportedInstructionSets();
+
+    /**
+     * @return names of all the architectures the optimized classes can be
+     * created for on this CPU, from "generic" to the best one
+     */
+    static QStringList availableArchNames();
 };
 
 #endif // KIS_SUPPORTED_ARCHITECTURES_H
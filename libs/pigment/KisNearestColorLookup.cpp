@@ -0,0 +1,274 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisNearestColorLookup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int leafSize = 8;
+constexpr int cacheBits = 15;
+constexpr int cacheSize = 1 << cacheBits;
+
+inline int cacheIndex(const quint16 *color)
+{
+    const quint64 key =
+        quint64(color[0]) |
+        quint64(color[1]) << 16 |
+        quint64(color[2]) << 32;
+
+    return int((key * 0x9E3779B97F4A7C15ULL) >> (64 - cacheBits));
+}
+
+/**
+ * Distances are compared as squared ones, equal distances are
+ * resolved by the palette index
+ */
+inline bool isNearer(float distance, int index, const KisNearestColorLookup::Match &match)
+{
+    return match.index < 0 ||
+        distance < match.distance ||
+        (distance == match.distance && index < match.index);
+}
+
+inline void insertMatch(float distance, int index, KisNearestColorLookup::Match *matches)
+{
+    if (isNearer(distance, index, matches[0])) {
+        matches[1] = matches[0];
+        matches[0] = {index, distance};
+    } else if (isNearer(distance, index, matches[1])) {
+        matches[1] = {index, distance};
+    }
+}
+
+}
+
+struct KisNearestColorLookup::Point {
+    float coords[3];
+    int index;
+};
+
+KisNearestColorLookup::KisNearestColorLookup(const QVector<Color> &colors, const Weights &weights)
+    : m_weights(weights),
+      m_colors(colors)
+{
+    std::vector<int> order(colors.size());
+    for (int i = 0; i < colors.size(); i++) {
+        order[i] = i;
+    }
+
+    // stable sorting keeps the lowest index first among the equal colors
+    std::stable_sort(order.begin(), order.end(),
+                     [&colors] (int lhs, int rhs) { return colors[lhs] < colors[rhs]; });
+    order.erase(std::unique(order.begin(), order.end(),
+                            [&colors] (int lhs, int rhs) { return colors[lhs] == colors[rhs]; }),
+                order.end());
+
+    if (order.empty()) return;
+
+    std::vector<Point> points;
+    points.reserve(order.size());
+
+    for (int index : order) {
+        Point point;
+        for (int i = 0; i < 3; i++) {
+            point.coords[i] = colors[index][i] * m_weights[i];
+        }
+        point.index = index;
+        points.push_back(point);
+    }
+
+    buildNode(points, 0, int(points.size()));
+
+    m_x.reserve(points.size());
+    m_y.reserve(points.size());
+    m_z.reserve(points.size());
+    m_indexes.reserve(points.size());
+
+    for (const Point &point : points) {
+        m_x.push_back(point.coords[0]);
+        m_y.push_back(point.coords[1]);
+        m_z.push_back(point.coords[2]);
+        m_indexes.push_back(point.index);
+    }
+}
+
+int KisNearestColorLookup::buildNode(std::vector<Point> &points, int begin, int end)
+{
+    const int nodeIndex = int(m_nodes.size());
+    m_nodes.emplace_back();
+    m_nodes[nodeIndex].begin = begin;
+    m_nodes[nodeIndex].end = end;
+
+    if (end - begin <= leafSize) {
+        return nodeIndex;
+    }
+
+    int axis = 0;
+    float maxSpread = -1.0f;
+
+    for (int i = 0; i < 3; i++) {
+        auto minmax = std::minmax_element(points.begin() + begin, points.begin() + end,
+                                          [i] (const Point &lhs, const Point &rhs) {
+                                              return lhs.coords[i] < rhs.coords[i];
+                                          });
+
+        const float spread = minmax.second->coords[i] - minmax.first->coords[i];
+        if (spread > maxSpread) {
+            axis = i;
+            maxSpread = spread;
+        }
+    }
+
+    const int middle = (begin + end) / 2;
+    std::nth_element(points.begin() + begin, points.begin() + middle, points.begin() + end,
+                     [axis] (const Point &lhs, const Point &rhs) {
+                         return lhs.coords[axis] < rhs.coords[axis];
+                     });
+
+    const float split = points[middle].coords[axis];
+    const int left = buildNode(points, begin, middle);
+    const int right = buildNode(points, middle, end);
+
+    // m_nodes might have been reallocated by the children
+    Node &node = m_nodes[nodeIndex];
+    node.axis = axis;
+    node.split = split;
+    node.children[0] = left;
+    node.children[1] = right;
+
+    return nodeIndex;
+}
+
+bool KisNearestColorLookup::isEmpty() const
+{
+    return m_nodes.empty();
+}
+
+void KisNearestColorLookup::searchNode(int nodeIndex, const float *point, Match *matches) const
+{
+    const Node &node = m_nodes[nodeIndex];
+
+    if (node.axis < 0) {
+        const int size = node.end - node.begin;
+        const float *x = m_x.data() + node.begin;
+        const float *y = m_y.data() + node.begin;
+        const float *z = m_z.data() + node.begin;
+
+        // a separate loop without branches, so the compiler
+        // could vectorize the distance computation
+        float distances[leafSize];
+        for (int i = 0; i < size; i++) {
+            const float dx = x[i] - point[0];
+            const float dy = y[i] - point[1];
+            const float dz = z[i] - point[2];
+            distances[i] = dx * dx + dy * dy + dz * dz;
+        }
+
+        for (int i = 0; i < size; i++) {
+            insertMatch(distances[i], m_indexes[node.begin + i], matches);
+        }
+
+        return;
+    }
+
+    const float diff = point[node.axis] - node.split;
+    const int nearChild = diff < 0 ? 0 : 1;
+
+    searchNode(node.children[nearChild], point, matches);
+
+    // the points exactly at the split may be in both
+    // children, so the equal distance is checked as well
+    if (matches[1].index < 0 || diff * diff <= matches[1].distance) {
+        searchNode(node.children[1 - nearChild], point, matches);
+    }
+}
+
+float KisNearestColorLookup::distance(int index, const quint16 *color) const
+{
+    float result = 0.0f;
+
+    for (int i = 0; i < 3; i++) {
+        const float diff = m_colors[index][i] * m_weights[i] - color[i] * m_weights[i];
+        result += diff * diff;
+    }
+
+    return std::sqrt(result);
+}
+
+void KisNearestColorLookup::searchTwo(const quint16 *color, Match *matches) const
+{
+    matches[0] = Match();
+    matches[1] = Match();
+
+    // the cache entries keep the indexes as qint16
+    const bool useCache = m_colors.size() <= std::numeric_limits<qint16>::max();
+
+    CacheEntry *entry = nullptr;
+
+    if (useCache) {
+        if (m_cache.empty()) {
+            m_cache.resize(cacheSize);
+        }
+
+        entry = &m_cache[cacheIndex(color)];
+
+        if (entry->first >= 0 &&
+            entry->color[0] == color[0] &&
+            entry->color[1] == color[1] &&
+            entry->color[2] == color[2]) {
+
+            matches[0] = {entry->first, distance(entry->first, color)};
+            if (entry->second >= 0) {
+                matches[1] = {entry->second, distance(entry->second, color)};
+            }
+            return;
+        }
+    }
+
+    float point[3];
+    for (int i = 0; i < 3; i++) {
+        point[i] = color[i] * m_weights[i];
+    }
+
+    searchNode(0, point, matches);
+
+    for (int i = 0; i < 2; i++) {
+        if (matches[i].index >= 0) {
+            matches[i].distance = std::sqrt(matches[i].distance);
+        }
+    }
+
+    if (entry) {
+        entry->color = {color[0], color[1], color[2]};
+        entry->first = qint16(matches[0].index);
+        entry->second = qint16(matches[1].index);
+    }
+}
+
+KisNearestColorLookup::Match KisNearestColorLookup::nearest(const quint16 *color) const
+{
+    if (isEmpty()) return Match();
+
+    Match matches[2];
+    searchTwo(color, matches);
+    return matches[0];
+}
+
+int KisNearestColorLookup::nearestTwo(const quint16 *color, Match *matches) const
+{
+    if (isEmpty()) {
+        matches[0] = Match();
+        matches[1] = Match();
+        return 0;
+    }
+
+    searchTwo(color, matches);
+    return matches[1].index >= 0 ? 2 : 1;
+}
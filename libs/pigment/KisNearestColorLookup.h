@@ -0,0 +1,114 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISNEARESTCOLORLOOKUP_H
+#define KISNEARESTCOLORLOOKUP_H
+
+#include <array>
+#include <vector>
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "kritapigment_export.h"
+
+/**
+ * @brief Finds the nearest colors of a palette
+ *
+ * The colors are points with three 16-bit coordinates, e.g. the L, a
+ * and b channels of a Lab16 pixel, and the distance between them is
+ * the Euclidean one, with every coordinate multiplied by its weight.
+ *
+ * The palette colors are kept in a k-d tree with small buckets of
+ * colors in the leaves. The results of the lookups are additionally
+ * stored in a direct-mapped cache indexed by a hash of the searched
+ * color, so the images with many repeated colors are handled with
+ * a single comparison per pixel most of the time.
+ *
+ * The colors with the same coordinates are stored only once and the
+ * lowest index of them is returned. If two colors are at the same
+ * distance, the one with the lower index is considered nearer.
+ *
+ * The cache is updated by the lookups, so every thread should have
+ * its own copy of the object.
+ */
+class KRITAPIGMENT_EXPORT KisNearestColorLookup
+{
+public:
+    using Color = std::array<quint16, 3>;
+    using Weights = std::array<float, 3>;
+
+    struct Match {
+        int index = -1;
+        float distance = 0.0f;
+    };
+
+    /**
+     * @param colors the palette, the position of a color in it is
+     *               the index returned by the lookups
+     * @param weights the multipliers of the coordinates
+     */
+    KisNearestColorLookup(const QVector<Color> &colors,
+                          const Weights &weights = {1.0f, 1.0f, 1.0f});
+
+    bool isEmpty() const;
+
+    /**
+     * @return the palette color nearest to \p color, or a match with
+     *         a negative index if the palette is empty
+     */
+    Match nearest(const quint16 *color) const;
+
+    /**
+     * Finds two nearest palette colors, e.g. for dithering between them.
+     *
+     * @param matches at least two elements, the nearest color is placed
+     *                first
+     * @return the number of the found colors, less than two only if
+     *         the palette has less than two distinct colors
+     */
+    int nearestTwo(const quint16 *color, Match *matches) const;
+
+private:
+    struct Point;
+
+    struct Node {
+        // a negative axis means a leaf with the points [begin, end)
+        int axis = -1;
+        float split = 0.0f;
+        int begin = 0;
+        int end = 0;
+        int children[2] = {-1, -1};
+    };
+
+    struct CacheEntry {
+        Color color = {0, 0, 0};
+        qint16 first = -1;
+        qint16 second = -1;
+    };
+
+    int buildNode(std::vector<Point> &points, int begin, int end);
+    void searchNode(int nodeIndex, const float *point, Match *matches) const;
+    void searchTwo(const quint16 *color, Match *matches) const;
+    float distance(int index, const quint16 *color) const;
+
+private:
+    Weights m_weights;
+    QVector<Color> m_colors;
+
+    // the points of the tree in the structure-of-arrays
+    // layout, ordered by the leaves they belong to
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+    std::vector<int> m_indexes;
+
+    std::vector<Node> m_nodes;
+
+    mutable std::vector<CacheEntry> m_cache;
+};
+
+#endif // KISNEARESTCOLORLOOKUP_H
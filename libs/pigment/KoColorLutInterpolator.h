@@ -0,0 +1,280 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORLUTINTERPOLATOR_H
+#define KOCOLORLUTINTERPOLATOR_H
+
+#include "KoColorLutInterpolatorBase.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#include "KoMultiArchBuildSupport.h"
+
+#include <xsimd_extensions/xsimd.hpp>
+
+namespace KoColorLutInterpolatorDetail
+{
+
+/**
+ * Tetrahedral interpolation of a single pixel. Used for the scalar
+ * version and for the tail of the rows in the vectorized one.
+ *
+ * The kernel is templated by the architecture only to keep the copies
+ * compiled with different instruction sets apart.
+ */
+template<typename _impl>
+struct ScalarKernel {
+    static inline void locate(float value, int gridSize, int &index, float &fraction)
+    {
+        const float maxIndex = gridSize - 1;
+        const float v = qBound(0.0f, value * maxIndex, maxIndex);
+        index = std::min(static_cast<int>(v), gridSize - 2);
+        fraction = v - index;
+    }
+
+    static inline void interpolate(const float *table, int gridSize,
+                                   float x, float y, float z,
+                                   float *result, int numOutputChannels)
+    {
+        const int sz = KoColorLutInterpolatorBase::nodeStride;
+        const int sy = sz * gridSize;
+        const int sx = sy * gridSize;
+
+        int ix, iy, iz;
+        float fx, fy, fz;
+        locate(x, gridSize, ix, fx);
+        locate(y, gridSize, iy, fy);
+        locate(z, gridSize, iz, fz);
+
+        // the tetrahedron is chosen by sorting the fractions; the
+        // path from the base node to the opposite one goes along
+        // the axis with the largest fraction first
+        const int maxStride = fx >= fy && fx >= fz ? sx : (fy >= fz ? sy : sz);
+        const int minStride = fx < fy && fx < fz ? sx : (fy < fz ? sy : sz);
+
+        const float a = std::max(fx, std::max(fy, fz));
+        const float c = std::min(fx, std::min(fy, fz));
+        const float b = fx + fy + fz - a - c;
+
+        const float *n0 = table + ix * sx + iy * sy + iz * sz;
+        const float *n1 = n0 + maxStride;
+        const float *n2 = n0 + sx + sy + sz - minStride;
+        const float *n3 = n0 + sx + sy + sz;
+
+        for (int i = 0; i < numOutputChannels; i++) {
+            result[i] = (1.0f - a) * n0[i] + (a - b) * n1[i] + (b - c) * n2[i] + c * n3[i];
+        }
+    }
+
+    static void interpolate3D(const float *table, int gridSize,
+                              const float *const *src, float *const *dst,
+                              int numOutputChannels, int offset, int numPixels)
+    {
+        float result[KoColorLutInterpolatorBase::nodeStride];
+
+        for (int i = offset; i < numPixels; i++) {
+            interpolate(table, gridSize, src[0][i], src[1][i], src[2][i], result, numOutputChannels);
+
+            for (int ch = 0; ch < numOutputChannels; ch++) {
+                dst[ch][i] = result[ch];
+            }
+        }
+    }
+
+    static void interpolate4D(const float *table, int gridSize,
+                              const float *const *src, float *const *dst,
+                              int numOutputChannels, int offset, int numPixels)
+    {
+        const int sliceStride = KoColorLutInterpolatorBase::nodeStride * gridSize * gridSize * gridSize;
+
+        float result0[KoColorLutInterpolatorBase::nodeStride];
+        float result1[KoColorLutInterpolatorBase::nodeStride];
+
+        for (int i = offset; i < numPixels; i++) {
+            int iw;
+            float fw;
+            locate(src[3][i], gridSize, iw, fw);
+
+            const float *slice = table + iw * sliceStride;
+            interpolate(slice, gridSize, src[0][i], src[1][i], src[2][i], result0, numOutputChannels);
+            interpolate(slice + sliceStride, gridSize, src[0][i], src[1][i], src[2][i], result1, numOutputChannels);
+
+            for (int ch = 0; ch < numOutputChannels; ch++) {
+                dst[ch][i] = result0[ch] + fw * (result1[ch] - result0[ch]);
+            }
+        }
+    }
+};
+
+/**
+ * Interpolates float_v::size pixels at once. The table nodes are
+ * fetched with gathers, all the index and weight computations are
+ * done in vector registers.
+ */
+template<typename _impl>
+struct VectorKernel {
+    using float_v = xsimd::batch<float, _impl>;
+    using int_v = xsimd::batch<int, _impl>;
+    using float_m = typename float_v::batch_bool_type;
+
+    struct Tetrahedron {
+        int_v n0;
+        int_v n1;
+        int_v n2;
+        int_v n3;
+        float_v w0;
+        float_v w1;
+        float_v w2;
+        float_v w3;
+    };
+
+    static inline void locate(const float_v &value, const float_v &maxIndex, float_v &index, float_v &fraction)
+    {
+        const float_v v = xsimd::clip(value * maxIndex, float_v(0.0f), maxIndex);
+        index = xsimd::min(xsimd::floor(v), maxIndex - float_v(1.0f));
+        fraction = v - index;
+    }
+
+    static inline Tetrahedron tetrahedron(const float_v &x, const float_v &y, const float_v &z, int gridSize)
+    {
+        const float_v maxIndex(static_cast<float>(gridSize - 1));
+
+        // offsets are computed in floats, they are exact up to 2^24
+        const float_v sz(static_cast<float>(KoColorLutInterpolatorBase::nodeStride));
+        const float_v sy = sz * float_v(static_cast<float>(gridSize));
+        const float_v sx = sy * float_v(static_cast<float>(gridSize));
+
+        float_v ix, iy, iz, fx, fy, fz;
+        locate(x, maxIndex, ix, fx);
+        locate(y, maxIndex, iy, fy);
+        locate(z, maxIndex, iz, fz);
+
+        const float_m xIsMax = (fx >= fy) && (fx >= fz);
+        const float_m xIsMin = (fx < fy) && (fx < fz);
+
+        const float_v maxStride = xsimd::select(xIsMax, sx, xsimd::select(fy >= fz, sy, sz));
+        const float_v minStride = xsimd::select(xIsMin, sx, xsimd::select(fy < fz, sy, sz));
+
+        const float_v a = xsimd::max(fx, xsimd::max(fy, fz));
+        const float_v c = xsimd::min(fx, xsimd::min(fy, fz));
+        const float_v b = fx + fy + fz - a - c;
+
+        const float_v base = ix * sx + iy * sy + iz * sz;
+        const float_v opposite = base + sx + sy + sz;
+
+        Tetrahedron t;
+        t.n0 = xsimd::to_int(base);
+        t.n1 = xsimd::to_int(base + maxStride);
+        t.n2 = xsimd::to_int(opposite - minStride);
+        t.n3 = xsimd::to_int(opposite);
+        t.w0 = float_v(1.0f) - a;
+        t.w1 = a - b;
+        t.w2 = b - c;
+        t.w3 = c;
+        return t;
+    }
+
+    static inline float_v sample(const float *table, const Tetrahedron &t)
+    {
+        return t.w0 * float_v::gather(table, t.n0) +
+               t.w1 * float_v::gather(table, t.n1) +
+               t.w2 * float_v::gather(table, t.n2) +
+               t.w3 * float_v::gather(table, t.n3);
+    }
+
+    static int interpolate3D(const float *table, int gridSize,
+                             const float *const *src, float *const *dst,
+                             int numOutputChannels, int numPixels)
+    {
+        const int numBlocks = numPixels / static_cast<int>(float_v::size);
+
+        for (int i = 0; i < numBlocks; i++) {
+            const int offset = i * static_cast<int>(float_v::size);
+
+            const Tetrahedron t = tetrahedron(float_v::load_unaligned(src[0] + offset),
+                                              float_v::load_unaligned(src[1] + offset),
+                                              float_v::load_unaligned(src[2] + offset),
+                                              gridSize);
+
+            for (int ch = 0; ch < numOutputChannels; ch++) {
+                sample(table + ch, t).store_unaligned(dst[ch] + offset);
+            }
+        }
+
+        return numBlocks * static_cast<int>(float_v::size);
+    }
+
+    static int interpolate4D(const float *table, int gridSize,
+                             const float *const *src, float *const *dst,
+                             int numOutputChannels, int numPixels)
+    {
+        const int numBlocks = numPixels / static_cast<int>(float_v::size);
+        const int sliceStride = KoColorLutInterpolatorBase::nodeStride * gridSize * gridSize * gridSize;
+        const float_v maxIndex(static_cast<float>(gridSize - 1));
+
+        for (int i = 0; i < numBlocks; i++) {
+            const int offset = i * static_cast<int>(float_v::size);
+
+            float_v iw, fw;
+            locate(float_v::load_unaligned(src[3] + offset), maxIndex, iw, fw);
+
+            Tetrahedron t = tetrahedron(float_v::load_unaligned(src[0] + offset),
+                                        float_v::load_unaligned(src[1] + offset),
+                                        float_v::load_unaligned(src[2] + offset),
+                                        gridSize);
+
+            const int_v slice = xsimd::to_int(iw * float_v(static_cast<float>(sliceStride)));
+            t.n0 += slice;
+            t.n1 += slice;
+            t.n2 += slice;
+            t.n3 += slice;
+
+            for (int ch = 0; ch < numOutputChannels; ch++) {
+                const float_v r0 = sample(table + ch, t);
+                const float_v r1 = sample(table + ch + sliceStride, t);
+                (r0 + fw * (r1 - r0)).store_unaligned(dst[ch] + offset);
+            }
+        }
+
+        return numBlocks * static_cast<int>(float_v::size);
+    }
+};
+
+} // namespace KoColorLutInterpolatorDetail
+
+template<typename _impl = xsimd::current_arch>
+class KoColorLutInterpolator : public KoColorLutInterpolatorBase
+{
+public:
+    void interpolate3D(const float *table, int gridSize,
+                       const float *const *src, float *const *dst,
+                       int numOutputChannels, int numPixels) const override
+    {
+        int offset = 0;
+
+        if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+            offset = KoColorLutInterpolatorDetail::VectorKernel<_impl>::interpolate3D(table, gridSize, src, dst, numOutputChannels, numPixels);
+        }
+
+        KoColorLutInterpolatorDetail::ScalarKernel<_impl>::interpolate3D(table, gridSize, src, dst, numOutputChannels, offset, numPixels);
+    }
+
+    void interpolate4D(const float *table, int gridSize,
+                       const float *const *src, float *const *dst,
+                       int numOutputChannels, int numPixels) const override
+    {
+        int offset = 0;
+
+        if constexpr (!std::is_same<_impl, xsimd::generic>::value) {
+            offset = KoColorLutInterpolatorDetail::VectorKernel<_impl>::interpolate4D(table, gridSize, src, dst, numOutputChannels, numPixels);
+        }
+
+        KoColorLutInterpolatorDetail::ScalarKernel<_impl>::interpolate4D(table, gridSize, src, dst, numOutputChannels, offset, numPixels);
+    }
+};
+
+#endif // KOCOLORLUTINTERPOLATOR_H
@@ -0,0 +1,11 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoColorLutInterpolatorBase.h"
+
+KoColorLutInterpolatorBase::~KoColorLutInterpolatorBase()
+{
+}
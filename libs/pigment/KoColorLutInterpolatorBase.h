@@ -0,0 +1,48 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORLUTINTERPOLATORBASE_H
+#define KOCOLORLUTINTERPOLATORBASE_H
+
+#include <QtGlobal>
+#include "kritapigment_export.h"
+
+/**
+ * @brief Samples a precomputed color conversion LUT with tetrahedral
+ * interpolation
+ *
+ * The table is a regular grid with `gridSize` nodes per input axis.
+ * Every node stores `nodeStride` floats, unused output channels are
+ * padding. For 3D tables the first input channel is the outermost
+ * axis and the third one varies fastest. 4D tables are `gridSize`
+ * 3D tables stacked along the fourth input channel (e.g. the K
+ * channel of CMYK); the slices are interpolated tetrahedrally and
+ * then blended linearly.
+ *
+ * Input and output pixels are planar: one array per channel,
+ * normalized to the [0, 1] range.
+ *
+ * The actual implementation is placed in `KoColorLutInterpolator`,
+ * create it with `KoColorLutInterpolatorFactory::create()` to get
+ * a version optimized for the current CPU.
+ */
+class KRITAPIGMENT_EXPORT KoColorLutInterpolatorBase
+{
+public:
+    static constexpr int nodeStride = 4;
+
+    virtual ~KoColorLutInterpolatorBase();
+
+    virtual void interpolate3D(const float *table, int gridSize,
+                               const float *const *src, float *const *dst,
+                               int numOutputChannels, int numPixels) const = 0;
+
+    virtual void interpolate4D(const float *table, int gridSize,
+                               const float *const *src, float *const *dst,
+                               int numOutputChannels, int numPixels) const = 0;
+};
+
+#endif // KOCOLORLUTINTERPOLATORBASE_H
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KoColorLutInterpolatorFactory.h"
+
+#include "KoColorLutInterpolatorFactoryImpl.h"
+
+KoColorLutInterpolatorBase *KoColorLutInterpolatorFactory::create()
+{
+    return createOptimizedClass<KoColorLutInterpolatorFactoryImpl>();
+}
+
+KoColorLutInterpolatorBase *KoColorLutInterpolatorFactory::createScalar()
+{
+    return createScalarClass<KoColorLutInterpolatorFactoryImpl>();
+}
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORLUTINTERPOLATORFACTORY_H
+#define KOCOLORLUTINTERPOLATORFACTORY_H
+
+#include "kritapigment_export.h"
+
+class KoColorLutInterpolatorBase;
+
+class KRITAPIGMENT_EXPORT KoColorLutInterpolatorFactory
+{
+public:
+    static KoColorLutInterpolatorBase* create();
+    static KoColorLutInterpolatorBase* createScalar();
+};
+
+#endif // KOCOLORLUTINTERPOLATORFACTORY_H
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KOCOLORLUTINTERPOLATORFACTORYIMPL_H
+#define KOCOLORLUTINTERPOLATORFACTORYIMPL_H
+
+#include <KoColorLutInterpolatorBase.h>
+#include <KoMultiArchBuildSupport.h>
+
+class KRITAPIGMENT_EXPORT KoColorLutInterpolatorFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KoColorLutInterpolatorBase* create();
+};
+
+#endif // KOCOLORLUTINTERPOLATORFACTORYIMPL_H
@@ -507,6 +507,35 @@ void KoColorSpace::bitBlt(const KoColorSpace* srcSpace, const KoCompositeOp::Par
     if(params.rows <= 0 || params.cols <= 0)
         return;
 
+    if (params.selectionRowStart &&
+        (!params.maskRowStart || !(*this == *srcSpace) || !op->supportsSelectionMask())) {
+
+        KoCompositeOp::ParameterInfo paramInfo(params);
+        paramInfo.selectionRowStart  = 0;
+        paramInfo.selectionRowStride = 0;
+
+        if (params.maskRowStart) {
+            QVector<quint8> * selectionMergeCache = d->selectionMergeCache.get(params.rows * params.cols);
+            quint8*           selectionMergeData  = selectionMergeCache->data();
+
+            for(qint32 row=0; row<params.rows; row++) {
+                KoCompositeOp::mergeSelectionMaskRow(selectionMergeData      + row * params.cols,
+                                                     params.maskRowStart      + row * params.maskRowStride,
+                                                     params.selectionRowStart + row * params.selectionRowStride,
+                                                     params.cols);
+            }
+
+            paramInfo.maskRowStart  = selectionMergeData;
+            paramInfo.maskRowStride = params.cols;
+        } else {
+            paramInfo.maskRowStart  = params.selectionRowStart;
+            paramInfo.maskRowStride = params.selectionRowStride;
+        }
+
+        bitBlt(srcSpace, paramInfo, op, renderingIntent, conversionFlags);
+        return;
+    }
+
     if(!(*this == *srcSpace)) {
         if (preferCompositionInSourceColorSpace() &&
                 (*op->colorSpace() == *srcSpace || srcSpace->hasCompositeOp(op->id()))) {
@@ -50,6 +50,7 @@ struct Q_DECL_HIDDEN KoColorSpace::Private {
 
     mutable ThreadLocalCache conversionCache;
     mutable ThreadLocalCache channelFlagsApplicationCache;
+    mutable ThreadLocalCache selectionMergeCache;
 
     mutable KoColorConversionTransformation* transfoToRGBA16;
     mutable KoColorConversionTransformation* transfoFromRGBA16;
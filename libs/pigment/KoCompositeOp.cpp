@@ -82,6 +82,8 @@ void KoCompositeOp::ParameterInfo::copy(const ParameterInfo &rhs)
     srcRowStride = rhs.srcRowStride;
     maskRowStart = rhs.maskRowStart;
     maskRowStride = rhs.maskRowStride;
+    selectionRowStart = rhs.selectionRowStart;
+    selectionRowStride = rhs.selectionRowStride;
     rows = rhs.rows;
     cols = rhs.cols;
     opacity = rhs.opacity;
@@ -169,6 +171,11 @@ void KoCompositeOp::composite(const KoCompositeOp::ParameterInfo& params) const
               params.opacity, params.channelFlags );
 }
 
+bool KoCompositeOp::supportsSelectionMask() const
+{
+    return false;
+}
+
 QString KoCompositeOp::category() const
 {
     return d->category;
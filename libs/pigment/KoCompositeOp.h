@@ -15,6 +15,7 @@
 #include <boost/optional.hpp>
 
 #include "kritapigment_export.h"
+#include "KoIntegerMaths.h"
 
 class KoColorSpace;
 
@@ -52,6 +53,15 @@ public:
         qint32        srcRowStride {0};
         const quint8* maskRowStart {0};
         qint32        maskRowStride {0};
+        /**
+         * Optional secondary 8-bit mask (usually the painter's selection),
+         * which is multiplied into maskRowStart on the fly. It is taken
+         * into account only when maskRowStart is also set and the op
+         * reports supportsSelectionMask(). KoColorSpace::bitBlt() merges
+         * the two masks itself for all the other ops.
+         */
+        const quint8* selectionRowStart {0};
+        qint32        selectionRowStride {0};
         qint32        rows {0};
         qint32        cols {0};
         float         opacity {0.0};
@@ -123,6 +133,24 @@ public:
     */
     virtual void composite(const ParameterInfo& params) const;
 
+    /**
+     * @return true if the op can apply ParameterInfo::selectionRowStart
+     * in the same pass as the main mask, without the caller merging both
+     * masks into a temporary buffer first
+     */
+    virtual bool supportsSelectionMask() const;
+
+    /**
+     * Multiplies \p numColumns values of the 8-bit \p mask by \p selection
+     * and writes the result into \p dst
+     */
+    static inline void mergeSelectionMaskRow(quint8 *dst, const quint8 *mask, const quint8 *selection, qint32 numColumns)
+    {
+        for (qint32 i = 0; i < numColumns; i++) {
+            dst[i] = UINT8_MULT(mask[i], selection[i]);
+        }
+    }
+
 private:
     KoCompositeOp();
     struct Private;
@@ -0,0 +1,231 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDitherOpBenchmark.h"
+
+#include <QRandomGenerator>
+
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+#include <KoConfig.h>
+#include <KisDitherOpImpl.h>
+#include <dithering/KisOptimizedDitherOpFactory.h>
+
+#include <simpletest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const int IMG_WIDTH = 4096;
+const int IMG_HEIGHT = 1024;
+
+// the canvas converts the image in tiles
+const int TILE_WIDTH = 64;
+const int TILE_HEIGHT = 64;
+
+enum Implementation {
+    Generic,
+    Scalar,
+    Optimized
+};
+
+struct DitherTestCase {
+    std::unique_ptr<KisDitherOp> op;
+    int srcPixelSize = 0;
+    int dstPixelSize = 0;
+};
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+DitherTestCase createTestCase(Implementation impl, const KoID &srcDepth, const KoID &dstDepth)
+{
+    DitherTestCase result;
+    result.srcPixelSize = srcCSTraits::pixelSize;
+    result.dstPixelSize = dstCSTraits::pixelSize;
+
+    switch (impl) {
+    case Generic:
+        result.op.reset(new KisDitherOpImpl<srcCSTraits, dstCSTraits, dType>(srcDepth, dstDepth));
+        break;
+    case Scalar:
+        result.op.reset(KisOptimizedDitherOpFactory::createScalar<srcCSTraits, dstCSTraits, dType>(srcDepth, dstDepth));
+        break;
+    case Optimized:
+        result.op.reset(KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, dType>(srcDepth, dstDepth));
+        break;
+    }
+
+    return result;
+}
+
+template<DitherType dType>
+DitherTestCase createTestCase(Implementation impl, const QString &srcDepth)
+{
+    if (srcDepth == Integer16BitsColorDepthID.id()) {
+        return createTestCase<KoBgrU16Traits, KoBgrU8Traits, dType>(impl, Integer16BitsColorDepthID, Integer8BitsColorDepthID);
+#ifdef HAVE_OPENEXR
+    } else if (srcDepth == Float16BitsColorDepthID.id()) {
+        return createTestCase<KoRgbF16Traits, KoBgrU8Traits, dType>(impl, Float16BitsColorDepthID, Integer8BitsColorDepthID);
+#endif
+    } else {
+        return createTestCase<KoRgbF32Traits, KoBgrU8Traits, dType>(impl, Float32BitsColorDepthID, Integer8BitsColorDepthID);
+    }
+}
+
+DitherTestCase createTestCase(Implementation impl, const QString &srcDepth, DitherType dType)
+{
+    return dType == DITHER_BAYER ? createTestCase<DITHER_BAYER>(impl, srcDepth) : createTestCase<DITHER_BLUE_NOISE>(impl, srcDepth);
+}
+
+std::vector<quint8> generateSource(const QString &srcDepth, int numPixels)
+{
+    QRandomGenerator rng(42);
+
+    const int channels = numPixels * 4;
+    std::vector<quint8> result;
+
+    if (srcDepth == Integer16BitsColorDepthID.id()) {
+        result.resize(channels * sizeof(quint16));
+        quint16 *ptr = reinterpret_cast<quint16 *>(result.data());
+        for (int i = 0; i < channels; i++) {
+            ptr[i] = static_cast<quint16>(rng.bounded(0x10000));
+        }
+#ifdef HAVE_OPENEXR
+    } else if (srcDepth == Float16BitsColorDepthID.id()) {
+        result.resize(channels * sizeof(half));
+        half *ptr = reinterpret_cast<half *>(result.data());
+        for (int i = 0; i < channels; i++) {
+            ptr[i] = static_cast<half>(rng.generateDouble());
+        }
+#endif
+    } else {
+        result.resize(channels * sizeof(float));
+        float *ptr = reinterpret_cast<float *>(result.data());
+        for (int i = 0; i < channels; i++) {
+            ptr[i] = static_cast<float>(rng.generateDouble());
+        }
+    }
+
+    return result;
+}
+
+void addSourceDepthRows(bool withImplementations)
+{
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<int>("ditherType");
+    if (withImplementations) {
+        QTest::addColumn<int>("implementation");
+    }
+
+    QList<KoID> depths {Integer16BitsColorDepthID, Float32BitsColorDepthID};
+#ifdef HAVE_OPENEXR
+    depths << Float16BitsColorDepthID;
+#endif
+
+    const QVector<QPair<QString, Implementation>> implementations {
+        {"generic", Generic},
+        {"scalar", Scalar},
+        {"optimized", Optimized}
+    };
+
+    Q_FOREACH (const KoID &depth, depths) {
+        for (const auto type : {DITHER_BAYER, DITHER_BLUE_NOISE}) {
+            const QString typeName = type == DITHER_BAYER ? "bayer" : "blue-noise";
+
+            if (withImplementations) {
+                for (const auto &impl : implementations) {
+                    QTest::addRow("%s-%s-%s", qPrintable(depth.id()), qPrintable(typeName), qPrintable(impl.first))
+                        << depth.id() << int(type) << int(impl.second);
+                }
+            } else {
+                QTest::addRow("%s-%s", qPrintable(depth.id()), qPrintable(typeName))
+                    << depth.id() << int(type);
+            }
+        }
+    }
+}
+
+} // namespace
+
+void KisDitherOpBenchmark::testOptimizedMatchesGeneric_data()
+{
+    addSourceDepthRows(false);
+}
+
+void KisDitherOpBenchmark::testOptimizedMatchesGeneric()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(int, ditherType);
+
+    // odd sizes and offsets to exercise the tails and the pattern wrapping
+    const int width = 211;
+    const int height = 67;
+    const int x = -13;
+    const int y = 29;
+
+    const DitherTestCase generic = createTestCase(Generic, srcDepth, DitherType(ditherType));
+    const DitherTestCase optimized = createTestCase(Optimized, srcDepth, DitherType(ditherType));
+
+    const std::vector<quint8> src = generateSource(srcDepth, width * height);
+    std::vector<quint8> dstGeneric(width * height * generic.dstPixelSize);
+    std::vector<quint8> dstOptimized(width * height * optimized.dstPixelSize);
+
+    generic.op->dither(src.data(), width * generic.srcPixelSize,
+                       dstGeneric.data(), width * generic.dstPixelSize,
+                       x, y, width, height);
+
+    optimized.op->dither(src.data(), width * optimized.srcPixelSize,
+                         dstOptimized.data(), width * optimized.dstPixelSize,
+                         x, y, width, height);
+
+    // the optimized version multiplies by a reciprocal instead of
+    // dividing, so allow a rounding difference of 1
+    int maxDifference = 0;
+    for (size_t i = 0; i < dstGeneric.size(); i++) {
+        maxDifference = qMax(maxDifference, qAbs(int(dstGeneric[i]) - int(dstOptimized[i])));
+    }
+
+    QVERIFY2(maxDifference <= 1, qPrintable(QString("max difference is %1").arg(maxDifference)));
+
+    // the single-pixel version should agree with the row version
+    std::vector<quint8> pixel(optimized.dstPixelSize);
+    optimized.op->dither(src.data() + (3 * width + 5) * optimized.srcPixelSize, pixel.data(), x + 5, y + 3);
+    QVERIFY(std::equal(pixel.begin(), pixel.end(), dstOptimized.begin() + (3 * width + 5) * optimized.dstPixelSize));
+}
+
+void KisDitherOpBenchmark::benchmarkDither_data()
+{
+    addSourceDepthRows(true);
+}
+
+void KisDitherOpBenchmark::benchmarkDither()
+{
+    QFETCH(QString, srcDepth);
+    QFETCH(int, ditherType);
+    QFETCH(int, implementation);
+
+    const DitherTestCase testCase = createTestCase(Implementation(implementation), srcDepth, DitherType(ditherType));
+
+    const std::vector<quint8> src = generateSource(srcDepth, IMG_WIDTH * IMG_HEIGHT);
+    std::vector<quint8> dst(IMG_WIDTH * IMG_HEIGHT * testCase.dstPixelSize);
+
+    const int srcRowStride = IMG_WIDTH * testCase.srcPixelSize;
+    const int dstRowStride = IMG_WIDTH * testCase.dstPixelSize;
+
+    QBENCHMARK {
+        for (int y = 0; y < IMG_HEIGHT; y += TILE_HEIGHT) {
+            for (int x = 0; x < IMG_WIDTH; x += TILE_WIDTH) {
+                testCase.op->dither(src.data() + y * srcRowStride + x * testCase.srcPixelSize, srcRowStride,
+                                    dst.data() + y * dstRowStride + x * testCase.dstPixelSize, dstRowStride,
+                                    x, y, TILE_WIDTH, TILE_HEIGHT);
+            }
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisDitherOpBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_DITHER_OP_BENCHMARK_H
+#define KIS_DITHER_OP_BENCHMARK_H
+
+#include <QObject>
+
+class KisDitherOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testOptimizedMatchesGeneric_data();
+    void testOptimizedMatchesGeneric();
+
+    void benchmarkDither_data();
+    void benchmarkDither();
+};
+
+#endif // KIS_DITHER_OP_BENCHMARK_H
@@ -8,12 +8,20 @@
 
 #include "../compositeops/KoCompositeOpAlphaDarken.h"
 #include "../compositeops/KoCompositeOpOver.h"
+#include "../compositeops/KoCompositeOpCopy2.h"
+#include "../compositeops/KoCompositeOpGeneric.h"
+#include "../compositeops/KoColorSpaceBlendingPolicy.h"
+#include "../compositeops/KoAlphaDarkenParamsWrapper.h"
 #include <KoOptimizedCompositeOpFactory.h>
+#include <KoCompositeOpRegistry.h>
 
 #include <KoColorSpaceTraits.h>
 #include <KoColorSpaceRegistry.h>
 
 #include <QRandomGenerator>
+#include <QScopedPointer>
+
+#include <vector>
 
 #include <simpletest.h>
 
@@ -98,5 +106,101 @@ void KoCompositeOpsBenchmark::benchmarkCompositeAlphaDarkenCreamy()
     }
 }
 
+#ifdef HAVE_OPENEXR
+
+template<half compositeFunc(half, half)>
+KoCompositeOp* createGenericF16Op(const KoColorSpace *cs, const QString &id)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, compositeFunc, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(cs, id, KoCompositeOp::categoryMix());
+}
+
+KoCompositeOp* createF16CompositeOp(const QString &id, bool useOptimized, const KoColorSpace *cs)
+{
+    if (id == COMPOSITE_OVER) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createOverOpF16(cs) :
+            new KoCompositeOpOver<KoRgbF16Traits>(cs);
+    } else if (id == COMPOSITE_ALPHA_DARKEN) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(cs) :
+            new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(cs);
+    } else if (id == COMPOSITE_COPY) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createCopyOpF16(cs) :
+            new KoCompositeOpCopy2<KoRgbF16Traits>(cs);
+    } else if (id == COMPOSITE_MULT) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createMultiplyOpF16(cs) :
+            createGenericF16Op<&cfMultiply<half>>(cs, id);
+    } else if (id == COMPOSITE_SCREEN) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createScreenOpF16(cs) :
+            createGenericF16Op<&cfScreen<half>>(cs, id);
+    } else if (id == COMPOSITE_ADD) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createAdditionOpF16(cs) :
+            createGenericF16Op<&cfAddition<half>>(cs, id);
+    } else if (id == COMPOSITE_DARKEN) {
+        return useOptimized ?
+            KoOptimizedCompositeOpFactory::createDarkenOpF16(cs) :
+            createGenericF16Op<&cfDarkenOnly<half>>(cs, id);
+    }
+
+    return nullptr;
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeF16_data()
+{
+    QTest::addColumn<QString>("compositeOpId");
+    QTest::addColumn<bool>("useOptimized");
+
+    const QStringList ids = {COMPOSITE_OVER, COMPOSITE_ALPHA_DARKEN, COMPOSITE_COPY,
+                             COMPOSITE_MULT, COMPOSITE_SCREEN, COMPOSITE_ADD, COMPOSITE_DARKEN};
+
+    Q_FOREACH (const QString &id, ids) {
+        QTest::addRow("%s-generic", id.toLatin1().data()) << id << false;
+        QTest::addRow("%s-optimized", id.toLatin1().data()) << id << true;
+    }
+}
+
+void KoCompositeOpsBenchmark::benchmarkCompositeF16()
+{
+    QFETCH(QString, compositeOpId);
+    QFETCH(bool, useOptimized);
+
+    QScopedPointer<KoCompositeOp> compositeOp(
+        createF16CompositeOp(compositeOpId, useOptimized, KoColorSpaceRegistry::instance()->rgb16()));
+    QVERIFY(compositeOp);
+
+    const int numChannels = KoRgbF16Traits::channels_nb;
+    std::vector<half> srcBuffer(IMG_WIDTH * IMG_HEIGHT * numChannels);
+    std::vector<half> dstBuffer(IMG_WIDTH * IMG_HEIGHT * numChannels);
+
+    for (size_t i = 0; i < srcBuffer.size(); i++) {
+        srcBuffer[i] = half(m_srcBuffer[i] / 255.0f);
+        dstBuffer[i] = half(m_dstBuffer[i] / 255.0f);
+    }
+
+    const int pixelSize = KoRgbF16Traits::pixelSize;
+    const int rowStride = IMG_WIDTH * pixelSize;
+    quint8 *dstBytes = reinterpret_cast<quint8*>(dstBuffer.data());
+    const quint8 *srcBytes = reinterpret_cast<const quint8*>(srcBuffer.data());
+
+    QBENCHMARK{
+        for (int y = 0; y < TILES_IN_HEIGHT; y++) {
+            for (int x = 0; x < TILES_IN_WIDTH; x++) {
+                const int bufOffset = y * TILE_HEIGHT * rowStride + x * TILE_WIDTH * pixelSize;
+                const int mskOffset = y * TILE_HEIGHT * IMG_WIDTH + x * TILE_WIDTH;
+                compositeOp->composite(dstBytes + bufOffset, rowStride,
+                                       srcBytes + bufOffset, rowStride,
+                                       m_mskBuffer + mskOffset, IMG_WIDTH,
+                                       TILE_HEIGHT, TILE_WIDTH,
+                                       OPACITY_HALF);
+            }
+        }
+    }
+}
+
+#endif
 
 QTEST_GUILESS_MAIN(KoCompositeOpsBenchmark)
@@ -8,6 +8,7 @@
 #define KO_COMPOSITEOPS_BENCHMARK_H_
 
 #include <QObject>
+#include <KoConfig.h>
 
 class KoCompositeOpsBenchmark : public QObject
 {
@@ -22,6 +23,11 @@ private Q_SLOTS:
     void benchmarkCompositeAlphaDarkenHard();
     void benchmarkCompositeAlphaDarkenCreamy();
 
+#ifdef HAVE_OPENEXR
+    void benchmarkCompositeF16_data();
+    void benchmarkCompositeF16();
+#endif
+
 private:
     quint8 * m_dstBuffer;
     quint8 * m_srcBuffer;
@@ -0,0 +1,260 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoCompositeOpsMatrixBenchmark.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <KisSupportedArchitectures.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOp.h>
+
+#include <simpletest.h>
+#include <multiarch_test_util.h>
+
+#include "KoCompositeOpsMatrixFactoryPerArch.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// the ops are usually applied to a single tile at a time
+const int TILE_SIZE = 64;
+const int NUM_PIXELS = TILE_SIZE * TILE_SIZE;
+
+const float OPACITY = 0.5f;
+
+const int MIN_ITERATIONS = 8;
+const int MAX_ITERATIONS = 4096;
+const qint64 MIN_TIME_NS = 20 * 1000 * 1000;
+
+struct TestBuffers {
+    std::vector<quint8> src;
+    std::vector<quint8> dst;
+    std::vector<quint8> dstOriginal;
+    std::vector<quint8> mask;
+};
+
+TestBuffers createBuffers(const KoColorSpace *cs)
+{
+    QRandomGenerator random(42);
+
+    TestBuffers buffers;
+    buffers.src.resize(NUM_PIXELS * cs->pixelSize());
+    buffers.dstOriginal.resize(NUM_PIXELS * cs->pixelSize());
+    buffers.mask.resize(NUM_PIXELS);
+
+    // random bytes would be NaNs and denormals in the floating
+    // point color spaces, so generate proper normalized values
+    QVector<float> channels(int(cs->channelCount()));
+
+    for (int i = 0; i < NUM_PIXELS; i++) {
+        for (float &value : channels) {
+            value = float(random.generateDouble());
+        }
+        cs->fromNormalisedChannelsValue(buffers.src.data() + i * cs->pixelSize(), channels);
+
+        for (float &value : channels) {
+            value = float(random.generateDouble());
+        }
+        cs->fromNormalisedChannelsValue(buffers.dstOriginal.data() + i * cs->pixelSize(), channels);
+
+        buffers.mask[i] = quint8(random.bounded(256));
+    }
+
+    buffers.dst = buffers.dstOriginal;
+
+    return buffers;
+}
+
+qreal measureThroughput(const KoCompositeOp *op, const KoColorSpace *cs, TestBuffers &buffers)
+{
+    const int rowStride = TILE_SIZE * cs->pixelSize();
+
+    QElapsedTimer timer;
+    qint64 totalTime = 0;
+    int iterations = 0;
+
+    while (iterations < MIN_ITERATIONS ||
+           (totalTime < MIN_TIME_NS && iterations < MAX_ITERATIONS)) {
+
+        // some ops converge to a constant color, which may be
+        // faster to compose, so restore the destination every time
+        std::memcpy(buffers.dst.data(), buffers.dstOriginal.data(), buffers.dst.size());
+
+        timer.start();
+        op->composite(buffers.dst.data(), rowStride,
+                      buffers.src.data(), rowStride,
+                      buffers.mask.data(), TILE_SIZE,
+                      TILE_SIZE, TILE_SIZE,
+                      OPACITY);
+        totalTime += timer.nsecsElapsed();
+        iterations++;
+    }
+
+    // pixels per nanosecond * 1000 == megapixels per second
+    return qreal(NUM_PIXELS) * iterations / qMax(totalTime, qint64(1)) * 1000.0;
+}
+
+QRegularExpression benchmarkFilter()
+{
+    return QRegularExpression(qEnvironmentVariable("KRITA_BENCHMARK_FILTER"));
+}
+
+QList<const KoColorSpace*> allColorSpaces()
+{
+    return KoColorSpaceRegistry::instance()->allColorSpaces(KoColorSpaceRegistry::AllColorSpaces,
+                                                            KoColorSpaceRegistry::OnlyDefaultProfile);
+}
+
+QString outputDir()
+{
+    const QString dir = qEnvironmentVariable("KRITA_BENCHMARK_OUTPUT_DIR");
+    return dir.isEmpty() ? QDir::currentPath() : dir;
+}
+
+}
+
+void KoCompositeOpsMatrixBenchmark::cleanupTestCase()
+{
+    writeResults();
+}
+
+void KoCompositeOpsMatrixBenchmark::benchmarkRegisteredOps()
+{
+    QVERIFY(benchmarkFilter().isValid());
+
+    Q_FOREACH (const KoColorSpace *cs, allColorSpaces()) {
+        measureOps(QStringLiteral("registered"), cs, cs->compositeOps().toVector());
+    }
+}
+
+void KoCompositeOpsMatrixBenchmark::benchmarkMatrix_data()
+{
+    QTest::addColumn<QString>("arch");
+
+    Q_FOREACH (const QString &arch, KisSupportedArchitectures::availableArchNames()) {
+        QTest::addRow("%s", arch.toLatin1().data()) << arch;
+    }
+}
+
+void KoCompositeOpsMatrixBenchmark::benchmarkMatrix()
+{
+    QFETCH(QString, arch);
+
+    QVERIFY(benchmarkFilter().isValid());
+
+    Q_FOREACH (const KoColorSpace *cs, allColorSpaces()) {
+        // the architecture is chosen explicitly, the ops of the
+        // color space itself are always built for the best one
+        const QVector<KoCompositeOp*> ops =
+            TestUtil::createClassForArch<KoCompositeOpsMatrixFactoryPerArch>(arch, cs);
+
+        measureOps(arch, cs, ops);
+        qDeleteAll(ops);
+    }
+}
+
+void KoCompositeOpsMatrixBenchmark::measureOps(const QString &arch, const KoColorSpace *cs, const QVector<KoCompositeOp*> &ops)
+{
+    const QRegularExpression filter = benchmarkFilter();
+
+    TestBuffers buffers;
+    bool buffersInitialized = false;
+
+    Q_FOREACH (const KoCompositeOp *op, ops) {
+        if (!filter.match(cs->id() + QLatin1Char('/') + op->id()).hasMatch()) continue;
+
+        if (!buffersInitialized) {
+            buffers = createBuffers(cs);
+            buffersInitialized = true;
+        }
+
+        Result result;
+        result.arch = arch;
+        result.colorSpaceId = cs->id();
+        result.compositeOpId = op->id();
+        result.megapixelsPerSecond = measureThroughput(op, cs, buffers);
+
+        m_results.append(result);
+    }
+}
+
+void KoCompositeOpsMatrixBenchmark::writeResults()
+{
+    if (m_results.isEmpty()) return;
+
+    QHash<QString, qreal> genericThroughput;
+    for (const Result &result : qAsConst(m_results)) {
+        if (result.arch == QLatin1String("generic")) {
+            genericThroughput.insert(result.colorSpaceId + QLatin1Char('/') + result.compositeOpId,
+                                     result.megapixelsPerSecond);
+        }
+    }
+
+    // the speedup over the legacy ops; the registered ops that have
+    // no optimized version don't have a generic row and get zero
+    for (Result &result : m_results) {
+        const qreal generic = genericThroughput.value(result.colorSpaceId + QLatin1Char('/') + result.compositeOpId, 0.0);
+        result.speedupVsGeneric = generic > 0.0 ? result.megapixelsPerSecond / generic : 0.0;
+    }
+
+    const QString baseName = outputDir() + QStringLiteral("/KoCompositeOpsMatrixBenchmark");
+
+    QFile csvFile(baseName + QStringLiteral(".csv"));
+    if (csvFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream stream(&csvFile);
+        stream << "arch,colorspace,compositeop,mpix_per_s,speedup_vs_generic\n";
+
+        for (const Result &result : qAsConst(m_results)) {
+            stream << result.arch << ','
+                   << result.colorSpaceId << ','
+                   << result.compositeOpId << ','
+                   << QString::number(result.megapixelsPerSecond, 'f', 2) << ','
+                   << QString::number(result.speedupVsGeneric, 'f', 3) << '\n';
+        }
+    } else {
+        qWarning() << "Failed to write" << csvFile.fileName();
+    }
+
+    QJsonArray rows;
+    for (const Result &result : qAsConst(m_results)) {
+        QJsonObject row;
+        row["arch"] = result.arch;
+        row["colorspace"] = result.colorSpaceId;
+        row["compositeop"] = result.compositeOpId;
+        row["mpix_per_s"] = result.megapixelsPerSecond;
+        row["speedup_vs_generic"] = result.speedupVsGeneric;
+        rows.append(row);
+    }
+
+    QJsonObject root;
+    root["tile_size"] = TILE_SIZE;
+    root["best_arch"] = KisSupportedArchitectures::bestArchName();
+    root["results"] = rows;
+
+    QFile jsonFile(baseName + QStringLiteral(".json"));
+    if (jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        jsonFile.write(QJsonDocument(root).toJson());
+    } else {
+        qWarning() << "Failed to write" << jsonFile.fileName();
+    }
+
+    qDebug() << "Composite ops matrix written to" << baseName + QStringLiteral(".{csv,json}");
+}
+
+SIMPLE_TEST_MAIN(KoCompositeOpsMatrixBenchmark)
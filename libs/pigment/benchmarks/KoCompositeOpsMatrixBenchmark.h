@@ -0,0 +1,57 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KO_COMPOSITEOPS_MATRIX_BENCHMARK_H
+#define KO_COMPOSITEOPS_MATRIX_BENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+
+class KoColorSpace;
+class KoCompositeOp;
+
+/**
+ * Measures the throughput of every composite op of every registered
+ * color space as it is registered, that is built for the best SIMD
+ * architecture ("registered" rows). The ops that have optimized
+ * versions are then measured once for every architecture available
+ * on the CPU, with the legacy ops they replace as "generic".
+ *
+ * The results are written in megapixels per second to
+ * KoCompositeOpsMatrixBenchmark.csv and KoCompositeOpsMatrixBenchmark.json
+ * in the directory set by KRITA_BENCHMARK_OUTPUT_DIR (the current
+ * directory by default). KRITA_BENCHMARK_FILTER limits the run to the
+ * "colorSpaceId/compositeOpId" pairs matching the regular expression.
+ */
+class KoCompositeOpsMatrixBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    struct Result {
+        QString arch;
+        QString colorSpaceId;
+        QString compositeOpId;
+        qreal megapixelsPerSecond = 0.0;
+        qreal speedupVsGeneric = 0.0;
+    };
+
+private Q_SLOTS:
+    void cleanupTestCase();
+
+    void benchmarkRegisteredOps();
+
+    void benchmarkMatrix_data();
+    void benchmarkMatrix();
+
+private:
+    void measureOps(const QString &arch, const KoColorSpace *cs, const QVector<KoCompositeOp*> &ops);
+    void writeResults();
+
+private:
+    QVector<Result> m_results;
+};
+
+#endif // KO_COMPOSITEOPS_MATRIX_BENCHMARK_H
@@ -0,0 +1,87 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoCompositeOpsMatrixFactoryPerArch.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include <KoConfig.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+
+#include <KoAlphaDarkenParamsWrapper.h>
+#include <KoOptimizedCompositeOpAlphaDarken32.h>
+#include <KoOptimizedCompositeOpAlphaDarken128.h>
+#include <KoOptimizedCompositeOpOver32.h>
+#include <KoOptimizedCompositeOpOver128.h>
+#include <KoOptimizedCompositeOpCopy128.h>
+#include <KoOptimizedCompositeOpGenericSC128.h>
+
+template<>
+QVector<KoCompositeOp*>
+KoCompositeOpsMatrixFactoryPerArch::create<xsimd::current_arch>(const KoColorSpace *cs)
+{
+    using _impl = xsimd::current_arch;
+
+    const KoID model = cs->colorModelId();
+    const KoID depth = cs->colorDepthId();
+    const bool creamy = useCreamyAlphaDarken();
+
+    QVector<KoCompositeOp*> ops;
+
+    if ((model == RGBAColorModelID || model == LABAColorModelID) &&
+        depth == Integer8BitsColorDepthID) {
+
+        if (creamy) {
+            ops << new KoOptimizedCompositeOpAlphaDarkenCreamy32<_impl>(cs);
+        } else {
+            ops << new KoOptimizedCompositeOpAlphaDarkenHard32<_impl>(cs);
+        }
+        ops << new KoOptimizedCompositeOpOver32<_impl>(cs);
+        ops << new KoOptimizedCompositeOpCopy32<_impl>(cs);
+
+    } else if (model == RGBAColorModelID && depth == Integer16BitsColorDepthID) {
+
+        if (creamy) {
+            ops << new KoOptimizedCompositeOpAlphaDarkenCreamyU64<_impl>(cs);
+        } else {
+            ops << new KoOptimizedCompositeOpAlphaDarkenHardU64<_impl>(cs);
+        }
+        ops << new KoOptimizedCompositeOpOverU64<_impl>(cs);
+        ops << new KoOptimizedCompositeOpCopyU64<_impl>(cs);
+
+    } else if (model == RGBAColorModelID && depth == Float32BitsColorDepthID) {
+
+        if (creamy) {
+            ops << new KoOptimizedCompositeOpAlphaDarkenCreamy128<_impl>(cs);
+        } else {
+            ops << new KoOptimizedCompositeOpAlphaDarkenHard128<_impl>(cs);
+        }
+        ops << new KoOptimizedCompositeOpOver128<_impl>(cs);
+        ops << new KoOptimizedCompositeOpCopy128<_impl>(cs);
+
+#ifdef HAVE_OPENEXR
+    } else if (model == RGBAColorModelID && depth == Float16BitsColorDepthID) {
+
+        if (creamy) {
+            ops << new KoOptimizedCompositeOpAlphaDarkenCreamyF16<_impl>(cs);
+        } else {
+            ops << new KoOptimizedCompositeOpAlphaDarkenHardF16<_impl>(cs);
+        }
+        ops << new KoOptimizedCompositeOpOverF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpCopyF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpMultiplyF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpScreenF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpAdditionF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpSubtractF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpDarkenF16<_impl>(cs);
+        ops << new KoOptimizedCompositeOpLightenF16<_impl>(cs);
+#endif
+    }
+
+    return ops;
+}
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,32 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KO_COMPOSITEOPS_MATRIX_FACTORY_PER_ARCH_H
+#define KO_COMPOSITEOPS_MATRIX_FACTORY_PER_ARCH_H
+
+#include <QVector>
+
+#include <KoMultiArchBuildSupport.h>
+
+class KoCompositeOp;
+class KoColorSpace;
+
+/**
+ * Creates the composite ops of \p cs that have optimized versions
+ * (see _Private::OptimizedOpsSelector), built for the architecture
+ * _impl. The generic version creates the legacy ops the optimized
+ * ones replace. The list is empty for the color spaces without
+ * optimized ops; the caller owns the created ops.
+ *
+ * The optimized ops of kritapigment are created only for the best
+ * architecture, so the benchmark compiles its own copies of them.
+ */
+struct KoCompositeOpsMatrixFactoryPerArch {
+    template<typename _impl>
+    static QVector<KoCompositeOp*> create(const KoColorSpace *cs);
+};
+
+#endif // KO_COMPOSITEOPS_MATRIX_FACTORY_PER_ARCH_H
@@ -0,0 +1,76 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "KoCompositeOpsMatrixFactoryPerArch.h"
+
+#include <KoConfig.h>
+#include <KoColorSpace.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceTraits.h>
+#include <KoCompositeOpRegistry.h>
+
+#include <KoAlphaDarkenParamsWrapper.h>
+#include <KoColorSpaceBlendingPolicy.h>
+#include <KoCompositeOpAlphaDarken.h>
+#include <KoCompositeOpCopy2.h>
+#include <KoCompositeOpGeneric.h>
+#include <KoCompositeOpOver.h>
+
+namespace {
+
+template<class Traits>
+void addLegacyOps(QVector<KoCompositeOp*> &ops, const KoColorSpace *cs)
+{
+    if (useCreamyAlphaDarken()) {
+        ops << new KoCompositeOpAlphaDarken<Traits, KoAlphaDarkenParamsWrapperCreamy>(cs);
+    } else {
+        ops << new KoCompositeOpAlphaDarken<Traits, KoAlphaDarkenParamsWrapperHard>(cs);
+    }
+    ops << new KoCompositeOpOver<Traits>(cs);
+    ops << new KoCompositeOpCopy2<Traits>(cs);
+}
+
+}
+
+template<>
+QVector<KoCompositeOp*>
+KoCompositeOpsMatrixFactoryPerArch::create<xsimd::generic>(const KoColorSpace *cs)
+{
+    const KoID model = cs->colorModelId();
+    const KoID depth = cs->colorDepthId();
+
+    QVector<KoCompositeOp*> ops;
+
+    if ((model == RGBAColorModelID || model == LABAColorModelID) &&
+        depth == Integer8BitsColorDepthID) {
+
+        addLegacyOps<KoBgrU8Traits>(ops, cs);
+
+    } else if (model == RGBAColorModelID && depth == Integer16BitsColorDepthID) {
+
+        addLegacyOps<KoBgrU16Traits>(ops, cs);
+
+    } else if (model == RGBAColorModelID && depth == Float32BitsColorDepthID) {
+
+        addLegacyOps<KoRgbF32Traits>(ops, cs);
+
+#ifdef HAVE_OPENEXR
+    } else if (model == RGBAColorModelID && depth == Float16BitsColorDepthID) {
+
+        using Policy = KoAdditiveBlendingPolicy<KoRgbF16Traits>;
+
+        addLegacyOps<KoRgbF16Traits>(ops, cs);
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfMultiply<half>, Policy>(cs, COMPOSITE_MULT, KoCompositeOp::categoryArithmetic());
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfScreen<half>, Policy>(cs, COMPOSITE_SCREEN, KoCompositeOp::categoryLight());
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfAddition<half>, Policy>(cs, COMPOSITE_ADD, KoCompositeOp::categoryArithmetic());
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfSubtract<half>, Policy>(cs, COMPOSITE_SUBTRACT, KoCompositeOp::categoryArithmetic());
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfDarkenOnly<half>, Policy>(cs, COMPOSITE_DARKEN, KoCompositeOp::categoryDark());
+        ops << new KoCompositeOpGenericSC<KoRgbF16Traits, &cfLightenOnly<half>, Policy>(cs, COMPOSITE_LIGHTEN, KoCompositeOp::categoryLight());
+#endif
+    }
+
+    return ops;
+}
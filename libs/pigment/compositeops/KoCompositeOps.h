@@ -123,6 +123,62 @@ struct OptimizedOpsSelector<KoBgrU16Traits>
     }
 };
 
+#ifdef HAVE_OPENEXR
+template<>
+struct OptimizedOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createAlphaDarkenOp(const KoColorSpace *cs) {
+        return useCreamyAlphaDarken() ?
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpCreamyF16(cs) :
+            KoOptimizedCompositeOpFactory::createAlphaDarkenOpHardF16(cs);
+
+    }
+    static KoCompositeOp* createOverOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createOverOpF16(cs);
+    }
+    static KoCompositeOp* createCopyOp(const KoColorSpace *cs) {
+        return KoOptimizedCompositeOpFactory::createCopyOpF16(cs);
+    }
+};
+#endif
+
+/**
+ * Returns an optimized version of a separable blending mode with
+ * \p id, if there is one for the color space, otherwise returns null
+ */
+template<class Traits>
+struct OptimizedGenericSCOpsSelector
+{
+    static KoCompositeOp* createOp(const KoColorSpace *cs, const QString &id) {
+        Q_UNUSED(cs);
+        Q_UNUSED(id);
+        return nullptr;
+    }
+};
+
+#ifdef HAVE_OPENEXR
+template<>
+struct OptimizedGenericSCOpsSelector<KoRgbF16Traits>
+{
+    static KoCompositeOp* createOp(const KoColorSpace *cs, const QString &id) {
+        if (id == COMPOSITE_MULT) {
+            return KoOptimizedCompositeOpFactory::createMultiplyOpF16(cs);
+        } else if (id == COMPOSITE_SCREEN) {
+            return KoOptimizedCompositeOpFactory::createScreenOpF16(cs);
+        } else if (id == COMPOSITE_ADD) {
+            return KoOptimizedCompositeOpFactory::createAdditionOpF16(cs);
+        } else if (id == COMPOSITE_SUBTRACT) {
+            return KoOptimizedCompositeOpFactory::createSubtractOpF16(cs);
+        } else if (id == COMPOSITE_DARKEN) {
+            return KoOptimizedCompositeOpFactory::createDarkenOpF16(cs);
+        } else if (id == COMPOSITE_LIGHTEN) {
+            return KoOptimizedCompositeOpFactory::createLightenOpF16(cs);
+        }
+
+        return nullptr;
+    }
+};
+#endif
 
 template<class Traits>
 struct AddGeneralOps<Traits, true>
@@ -133,6 +189,11 @@ struct AddGeneralOps<Traits, true>
 
      template<CompositeFunc func>
      static void add(KoColorSpace* cs, const QString& id, const QString& category) {
+        if (KoCompositeOp *op = OptimizedGenericSCOpsSelector<Traits>::createOp(cs, id)) {
+            cs->addCompositeOp(op);
+            return;
+        }
+
         if constexpr (std::is_base_of_v<KoCmykTraits<typename Traits::channels_type>, Traits>) {
             if (useSubtractiveBlendingForCmykColorSpaces()) {
                 cs->addCompositeOp(new KoCompositeOpGenericSC<Traits, func, KoSubtractiveBlendingPolicy<Traits>>(cs, id, category));
@@ -227,6 +227,11 @@ public:
 
     using KoCompositeOp::composite;
 
+    bool supportsSelectionMask() const override
+    {
+        return true;
+    }
+
     void composite(const KoCompositeOp::ParameterInfo& params) const override
     {
         if(params.maskRowStart) {
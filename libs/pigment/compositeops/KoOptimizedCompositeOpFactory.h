@@ -8,6 +8,7 @@
 #define KOOPTIMIZEDCOMPOSITEOPFACTORY_H
 
 #include "kritapigment_export.h"
+#include <KoConfig.h>
 
 class KoCompositeOp;
 class KoColorSpace;
@@ -39,6 +40,19 @@ public:
     static KoCompositeOp* createCopyOp32(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpHardU64(const KoColorSpace *cs);
     static KoCompositeOp* createAlphaDarkenOpCreamyU64(const KoColorSpace *cs);
+
+#ifdef HAVE_OPENEXR
+    static KoCompositeOp* createAlphaDarkenOpHardF16(const KoColorSpace *cs);
+    static KoCompositeOp* createAlphaDarkenOpCreamyF16(const KoColorSpace *cs);
+    static KoCompositeOp* createOverOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createCopyOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createMultiplyOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createScreenOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createAdditionOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createSubtractOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createDarkenOpF16(const KoColorSpace *cs);
+    static KoCompositeOp* createLightenOpF16(const KoColorSpace *cs);
+#endif
 };
 
 #endif /* KOOPTIMIZEDCOMPOSITEOPFACTORY_H */
@@ -12,6 +12,9 @@
 #include "KoAlphaDarkenParamsWrapper.h"
 #include "KoCompositeOpOver.h"
 #include "KoCompositeOpCopy2.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoColorSpaceBlendingPolicy.h"
+#include "KoCompositeOpRegistry.h"
 
 template<>
 template<>
@@ -121,3 +124,94 @@ KoCompositeOp *KoOptimizedCompositeOpFactoryPerArch<
     return new KoCompositeOpAlphaDarken<KoBgrU16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
 }
 
+#ifdef HAVE_OPENEXR
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenHardF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperHard>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAlphaDarkenCreamyF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpAlphaDarken<KoRgbF16Traits, KoAlphaDarkenParamsWrapperCreamy>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpOverF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpOver<KoRgbF16Traits>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpCopyF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpCopy2<KoRgbF16Traits>(param);
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpMultiplyF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfMultiply<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_MULT, KoCompositeOp::categoryArithmetic());
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpScreenF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfScreen<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_SCREEN, KoCompositeOp::categoryLight());
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpAdditionF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfAddition<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_ADD, KoCompositeOp::categoryArithmetic());
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpSubtractF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfSubtract<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_SUBTRACT, KoCompositeOp::categoryArithmetic());
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpDarkenF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfDarkenOnly<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_DARKEN, KoCompositeOp::categoryDark());
+}
+
+template<>
+template<>
+KoCompositeOp *
+KoOptimizedCompositeOpFactoryPerArch<KoOptimizedCompositeOpLightenF16>::create<
+    xsimd::generic>(const KoColorSpace *param)
+{
+    return new KoCompositeOpGenericSC<KoRgbF16Traits, &cfLightenOnly<half>, KoAdditiveBlendingPolicy<KoRgbF16Traits>>(param, COMPOSITE_LIGHTEN, KoCompositeOp::categoryLight());
+}
+#endif // HAVE_OPENEXR
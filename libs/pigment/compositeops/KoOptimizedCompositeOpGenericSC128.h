@@ -0,0 +1,295 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+#define KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
+
+#include <KoConfig.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "KoColorSpaceTraits.h"
+#include "KoCompositeOpBase.h"
+#include "KoCompositeOpGeneric.h"
+#include "KoCompositeOpRegistry.h"
+#include "KoColorSpaceBlendingPolicy.h"
+#include "KoStreamedMath.h"
+
+/**
+ * Vectorized versions of the separable blending functions from
+ * KoCompositeOpFunctions.h. Each of them works on both scalar floats
+ * and float batches, so the same code is used for the unaligned
+ * pixels at the borders of the rows.
+ *
+ * The functions are written for the floating point color spaces, where
+ * Arithmetic::clamp() is a no-op.
+ */
+namespace KoStreamedBlendFunctions
+{
+struct Multiply {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        return src * dst;
+    }
+};
+
+struct Screen {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        return src + dst - src * dst;
+    }
+};
+
+struct Addition {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        return src + dst;
+    }
+};
+
+struct Subtract {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        return dst - src;
+    }
+};
+
+struct DarkenOnly {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        if constexpr (std::is_floating_point<T>::value) {
+            return std::min(src, dst);
+        } else {
+            return xsimd::min(src, dst);
+        }
+    }
+};
+
+struct LightenOnly {
+    template<typename T>
+    static ALWAYS_INLINE T compose(const T &src, const T &dst)
+    {
+        if constexpr (std::is_floating_point<T>::value) {
+            return std::max(src, dst);
+        } else {
+            return xsimd::max(src, dst);
+        }
+    }
+};
+} // namespace KoStreamedBlendFunctions
+
+/**
+ * A streamed version of KoCompositeOpGenericSC for RGBA floating point
+ * pixels. Only handles the case when all the channels are enabled and
+ * the alpha channel is not locked.
+ */
+template<typename channels_type, class BlendFunction>
+struct GenericSCCompositor128 {
+    struct ParamsWrapper {
+        ParamsWrapper(const KoCompositeOp::ParameterInfo& params)
+        {
+            Q_UNUSED(params);
+        }
+    };
+
+    struct Pixel {
+        channels_type red;
+        channels_type green;
+        channels_type blue;
+        channels_type alpha;
+    };
+
+    template<typename T>
+    static ALWAYS_INLINE T blendChannel(const T &src, const T &srcAlpha, const T &dst, const T &dstAlpha, const T &oneValue)
+    {
+        // \see Arithmetic::blend()
+        return (oneValue - srcAlpha) * dstAlpha * dst +
+               (oneValue - dstAlpha) * srcAlpha * src +
+               srcAlpha * dstAlpha * BlendFunction::compose(src, dst);
+    }
+
+    template<bool haveMask, bool src_aligned, typename _impl>
+    static ALWAYS_INLINE void compositeVector(const quint8 *src, quint8 *dst, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        using float_v = typename KoStreamedMath<_impl>::float_v;
+        using float_m = typename float_v::batch_bool_type;
+
+        float_v src_c1;
+        float_v src_c2;
+        float_v src_c3;
+        float_v src_alpha;
+
+        PixelWrapper<channels_type, _impl> dataWrapper;
+        dataWrapper.read(src, src_c1, src_c2, src_c3, src_alpha);
+
+        src_alpha *= float_v(opacity);
+
+        if (haveMask) {
+            const float_v uint8MaxRec1(1.0f / 255.0f);
+            src_alpha *= KoStreamedMath<_impl>::fetch_mask_8(mask) * uint8MaxRec1;
+        }
+
+        const float_v zeroValue(0.0f);
+        const float_v oneValue(1.0f);
+
+        // fully transparent source doesn't change the destination
+        if (xsimd::all(src_alpha == zeroValue)) {
+            return;
+        }
+
+        float_v dst_c1;
+        float_v dst_c2;
+        float_v dst_c3;
+        float_v dst_alpha;
+
+        dataWrapper.read(dst, dst_c1, dst_c2, dst_c3, dst_alpha);
+
+        const float_v new_alpha = src_alpha + dst_alpha - src_alpha * dst_alpha;
+        const float_m new_alpha_is_null = new_alpha == zeroValue;
+
+        const float_v c1 = blendChannel(src_c1, src_alpha, dst_c1, dst_alpha, oneValue) / new_alpha;
+        const float_v c2 = blendChannel(src_c2, src_alpha, dst_c2, dst_alpha, oneValue) / new_alpha;
+        const float_v c3 = blendChannel(src_c3, src_alpha, dst_c3, dst_alpha, oneValue) / new_alpha;
+
+        dst_c1 = xsimd::select(new_alpha_is_null, dst_c1, c1);
+        dst_c2 = xsimd::select(new_alpha_is_null, dst_c2, c2);
+        dst_c3 = xsimd::select(new_alpha_is_null, dst_c3, c3);
+
+        dataWrapper.write(dst, dst_c1, dst_c2, dst_c3, new_alpha);
+    }
+
+    template<bool haveMask, typename _impl>
+    static ALWAYS_INLINE void compositeOnePixelScalar(const quint8 *s, quint8 *d, const quint8 *mask, float opacity, const ParamsWrapper &oparams)
+    {
+        Q_UNUSED(oparams);
+
+        const qint32 alpha_pos = 3;
+
+        const auto *src = reinterpret_cast<const channels_type*>(s);
+        auto *dst = reinterpret_cast<channels_type*>(d);
+
+        float srcAlpha = float(src[alpha_pos]) * opacity;
+
+        if (haveMask) {
+            const float uint8Rec1 = 1.0f / 255.0f;
+            srcAlpha *= float(*mask) * uint8Rec1;
+        }
+
+        if (srcAlpha == 0.0f) {
+            return;
+        }
+
+        const float dstAlpha = dst[alpha_pos];
+        const float newAlpha = srcAlpha + dstAlpha - srcAlpha * dstAlpha;
+
+        if (newAlpha != 0.0f) {
+            for (int i = 0; i < 3; i++) {
+                const float result = blendChannel<float>(src[i], srcAlpha, dst[i], dstAlpha, 1.0f);
+                dst[i] = PixelWrapper<channels_type, _impl>::roundFloatToUint(result / newAlpha);
+            }
+        }
+
+        dst[alpha_pos] = PixelWrapper<channels_type, _impl>::roundFloatToUint(newAlpha);
+    }
+};
+
+#ifdef HAVE_OPENEXR
+/**
+ * An optimized version of KoCompositeOpGenericSC for RGBA F16 color
+ * spaces. Cases with channel flags fall back to the generic version.
+ */
+template<typename _impl, half compositeFunc(half, half), class BlendFunction>
+class KoOptimizedCompositeOpGenericSCF16
+    : public KoCompositeOpGenericSC<KoRgbF16Traits, compositeFunc, KoAdditiveBlendingPolicy<KoRgbF16Traits>>
+{
+    using base_class = KoCompositeOpGenericSC<KoRgbF16Traits, compositeFunc, KoAdditiveBlendingPolicy<KoRgbF16Traits>>;
+
+public:
+    KoOptimizedCompositeOpGenericSCF16(const KoColorSpace* cs, const QString& id, const QString& category)
+        : base_class(cs, id, category) {}
+
+    using base_class::composite;
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            if (params.maskRowStart) {
+                KoStreamedMath<_impl>::template genericComposite64<true, false, GenericSCCompositor128<half, BlendFunction> >(params);
+            } else {
+                KoStreamedMath<_impl>::template genericComposite64<false, false, GenericSCCompositor128<half, BlendFunction> >(params);
+            }
+        } else {
+            base_class::composite(params);
+        }
+    }
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpMultiplyF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfMultiply<half>, KoStreamedBlendFunctions::Multiply>
+{
+public:
+    KoOptimizedCompositeOpMultiplyF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfMultiply<half>, KoStreamedBlendFunctions::Multiply>(cs, COMPOSITE_MULT, KoCompositeOp::categoryArithmetic()) {}
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpScreenF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfScreen<half>, KoStreamedBlendFunctions::Screen>
+{
+public:
+    KoOptimizedCompositeOpScreenF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfScreen<half>, KoStreamedBlendFunctions::Screen>(cs, COMPOSITE_SCREEN, KoCompositeOp::categoryLight()) {}
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpAdditionF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfAddition<half>, KoStreamedBlendFunctions::Addition>
+{
+public:
+    KoOptimizedCompositeOpAdditionF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfAddition<half>, KoStreamedBlendFunctions::Addition>(cs, COMPOSITE_ADD, KoCompositeOp::categoryArithmetic()) {}
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpSubtractF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfSubtract<half>, KoStreamedBlendFunctions::Subtract>
+{
+public:
+    KoOptimizedCompositeOpSubtractF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfSubtract<half>, KoStreamedBlendFunctions::Subtract>(cs, COMPOSITE_SUBTRACT, KoCompositeOp::categoryArithmetic()) {}
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpDarkenF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfDarkenOnly<half>, KoStreamedBlendFunctions::DarkenOnly>
+{
+public:
+    KoOptimizedCompositeOpDarkenF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfDarkenOnly<half>, KoStreamedBlendFunctions::DarkenOnly>(cs, COMPOSITE_DARKEN, KoCompositeOp::categoryDark()) {}
+};
+
+template<typename _impl>
+class KoOptimizedCompositeOpLightenF16
+    : public KoOptimizedCompositeOpGenericSCF16<_impl, &cfLightenOnly<half>, KoStreamedBlendFunctions::LightenOnly>
+{
+public:
+    KoOptimizedCompositeOpLightenF16(const KoColorSpace* cs)
+        : KoOptimizedCompositeOpGenericSCF16<_impl, &cfLightenOnly<half>, KoStreamedBlendFunctions::LightenOnly>(cs, COMPOSITE_LIGHTEN, KoCompositeOp::categoryLight()) {}
+};
+#endif
+
+#endif // KOOPTIMIZEDCOMPOSITEOPGENERICSC128_H_
@@ -246,6 +246,11 @@ public:
 
     using KoCompositeOp::composite;
 
+    bool supportsSelectionMask() const override
+    {
+        return true;
+    }
+
     void composite(const KoCompositeOp::ParameterInfo& params) const override
     {
         if(params.maskRowStart) {
@@ -290,6 +295,11 @@ public:
 
     using KoCompositeOp::composite;
 
+    bool supportsSelectionMask() const override
+    {
+        return true;
+    }
+
     void composite(const KoCompositeOp::ParameterInfo& params) const override
     {
         if(params.maskRowStart) {
@@ -325,4 +335,60 @@ public:
     }
 };
 
+#ifdef HAVE_OPENEXR
+/**
+ * A version of the Over op for RGBA F16 color spaces. The pixels are
+ * batch-converted into floats instead of going through the generic
+ * per-channel templates.
+ */
+template<typename _impl>
+class KoOptimizedCompositeOpOverF16 : public KoCompositeOp
+{
+public:
+    KoOptimizedCompositeOpOverF16(const KoColorSpace* cs)
+        : KoCompositeOp(cs, COMPOSITE_OVER, KoCompositeOp::categoryMix()) {}
+
+    using KoCompositeOp::composite;
+
+    bool supportsSelectionMask() const override
+    {
+        return true;
+    }
+
+    void composite(const KoCompositeOp::ParameterInfo& params) const override
+    {
+        if(params.maskRowStart) {
+            composite<true>(params);
+        } else {
+            composite<false>(params);
+        }
+    }
+
+    template <bool haveMask>
+    inline void composite(const KoCompositeOp::ParameterInfo& params) const {
+        if (params.channelFlags.isEmpty() ||
+            params.channelFlags == QBitArray(4, true)) {
+
+            KoStreamedMath<_impl>::template genericComposite64<haveMask, false, OverCompositor128<half, false, true> >(params);
+        } else {
+            const bool allChannelsFlag =
+                params.channelFlags.at(0) &&
+                params.channelFlags.at(1) &&
+                params.channelFlags.at(2);
+
+            const bool alphaLocked =
+                !params.channelFlags.at(3);
+
+            if (allChannelsFlag && alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<half, true, true> >(params);
+            } else if (!allChannelsFlag && !alphaLocked) {
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<half, false, false> >(params);
+            } else /*if (!allChannelsFlag && alphaLocked) */{
+                KoStreamedMath<_impl>::template genericComposite64_novector<haveMask, false, OverCompositor128<half, true, false> >(params);
+            }
+        }
+    }
+};
+#endif
+
 #endif // KOOPTIMIZEDCOMPOSITEOPOVER128_H_
@@ -17,8 +17,13 @@
 #include <cstring>
 #include <iostream>
 #include <type_traits>
+#include <vector>
 #include <xsimd_extensions/xsimd.hpp>
 
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
 #if XSIMD_VERSION_MAJOR < 10
 #include <KoRgbaInterleavers.h>
 #endif
@@ -159,6 +164,55 @@ struct KoStreamedMath {
     static_assert(int_v::size == uint_v::size, "the selected architecture does not guarantee vector size equality!");
     static_assert(uint_v::size == float_v::size, "the selected architecture does not guarantee vector size equality!");
 
+    /**
+     * Iterates over the rows of the mask of \p params. When the params
+     * carry a selection mask, it is multiplied into each mask row right
+     * before the row is composited, so the merged row stays in cache and
+     * no separate pass over the whole rect is needed.
+     */
+    template<bool useMask>
+    struct MaskRowIterator {
+        MaskRowIterator(const KoCompositeOp::ParameterInfo &params)
+            : m_maskRow(params.maskRowStart)
+            , m_maskRowStride(params.maskRowStride)
+            , m_selectionRow(useMask ? params.selectionRowStart : nullptr)
+            , m_selectionRowStride(params.selectionRowStride)
+            , m_cols(params.cols)
+        {
+            if (m_selectionRow) {
+                m_mergedRow.resize(static_cast<size_t>(m_cols));
+            }
+        }
+
+        ALWAYS_INLINE const quint8 *row()
+        {
+            if (!useMask) return nullptr;
+            if (!m_selectionRow) return m_maskRow;
+
+            KoCompositeOp::mergeSelectionMaskRow(m_mergedRow.data(), m_maskRow, m_selectionRow, m_cols);
+            return m_mergedRow.data();
+        }
+
+        ALWAYS_INLINE void next()
+        {
+            if (!useMask) return;
+
+            m_maskRow += m_maskRowStride;
+
+            if (m_selectionRow) {
+                m_selectionRow += m_selectionRowStride;
+            }
+        }
+
+    private:
+        const quint8 *m_maskRow;
+        qint32 m_maskRowStride;
+        const quint8 *m_selectionRow;
+        qint32 m_selectionRowStride;
+        qint32 m_cols;
+        std::vector<quint8> m_mergedRow;
+    };
+
     /**
      * Composes src into dst without using vector instructions
      */
@@ -171,12 +225,12 @@ struct KoStreamedMath {
         qint32 srcLinearInc = params.srcRowStride ? pixelSize : 0;
 
         quint8 *dstRowStart = params.dstRowStart;
-        const quint8 *maskRowStart = params.maskRowStart;
+        MaskRowIterator<useMask> maskRows(params);
         const quint8 *srcRowStart = params.srcRowStart;
         typename Compositor::ParamsWrapper paramsWrapper(params);
 
         for (qint32 r = params.rows; r > 0; --r) {
-            const quint8 *mask = maskRowStart;
+            const quint8 *mask = maskRows.row();
             const quint8 *src = srcRowStart;
             quint8 *dst = dstRowStart;
 
@@ -198,10 +252,7 @@ struct KoStreamedMath {
 
             srcRowStart += params.srcRowStride;
             dstRowStart += params.dstRowStride;
-
-            if (useMask) {
-                maskRowStart += params.maskRowStride;
-            }
+            maskRows.next();
         }
     }
 
@@ -337,7 +388,7 @@ struct KoStreamedMath {
         qint32 srcLinearInc = pixelSize;
 
         quint8 *dstRowStart = params.dstRowStart;
-        const quint8 *maskRowStart = params.maskRowStart;
+        MaskRowIterator<useMask> maskRows(params);
         const quint8 *srcRowStart = params.srcRowStart;
         typename Compositor::ParamsWrapper paramsWrapper(params);
 
@@ -371,7 +422,7 @@ struct KoStreamedMath {
 
         for (qint32 r = params.rows; r > 0; --r) {
             // Hint: Mask is allowed to be unaligned
-            const quint8 *mask = maskRowStart;
+            const quint8 *mask = maskRows.row();
 
             const quint8 *src = srcRowStart;
             quint8 *dst = dstRowStart;
@@ -475,10 +526,7 @@ struct KoStreamedMath {
 
             srcRowStart += params.srcRowStride;
             dstRowStart += params.dstRowStride;
-
-            if (useMask) {
-                maskRowStart += params.maskRowStride;
-            }
+            maskRows.next();
         }
 
 #if BLOCKDEBUG
@@ -562,6 +610,66 @@ private:
     const float_v m_orig_c3;
 };
 
+#ifdef HAVE_OPENEXR
+template<class _impl>
+struct PixelStateRecoverHelper<half, _impl> : public PixelStateRecoverHelper<float, _impl> {
+    using PixelStateRecoverHelper<float, _impl>::PixelStateRecoverHelper;
+};
+
+/**
+ * Converts blocks of half values into floats and back. Uses F16C
+ * instructions when the current build pass has them enabled, and
+ * falls back to Imath's lookup tables otherwise.
+ *
+ * The converter is templated by the architecture only to keep each
+ * build pass' version in a separate symbol.
+ */
+template<typename _impl>
+struct KoHalfBatchConverter {
+    static ALWAYS_INLINE void toFloat(const half *src, float *dst, int numValues)
+    {
+        int i = 0;
+
+#if defined(__F16C__)
+        for (; i + 8 <= numValues; i += 8) {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+        }
+
+        for (; i + 4 <= numValues; i += 4) {
+            const __m128i h = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i));
+            _mm_storeu_ps(dst + i, _mm_cvtph_ps(h));
+        }
+#endif
+
+        for (; i < numValues; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    static ALWAYS_INLINE void fromFloat(const float *src, half *dst, int numValues)
+    {
+        int i = 0;
+
+#if defined(__F16C__)
+        for (; i + 8 <= numValues; i += 8) {
+            const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), h);
+        }
+
+        for (; i + 4 <= numValues; i += 4) {
+            const __m128i h = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), h);
+        }
+#endif
+
+        for (; i < numValues; i++) {
+            dst[i] = half(src[i]);
+        }
+    }
+};
+#endif
+
 template<typename channels_type, class _impl>
 struct PixelWrapper
 {
@@ -846,6 +954,74 @@ struct PixelWrapper<float, _impl> {
     }
 };
 
+#ifdef HAVE_OPENEXR
+/**
+ * Half-float pixels are converted into floats as a whole block of
+ * float_v::size pixels and then handled exactly like RGBA F32 pixels
+ */
+template<typename _impl>
+struct PixelWrapper<half, _impl> {
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr int valuesCount = static_cast<int>(float_v::size) * 4;
+
+    ALWAYS_INLINE
+    static half lerpMixedUintFloat(half a, half b, float alpha)
+    {
+        return half(Arithmetic::lerp(float(a), float(b), alpha));
+    }
+
+    ALWAYS_INLINE
+    static half roundFloatToUint(float x)
+    {
+        return half(x);
+    }
+
+    ALWAYS_INLINE
+    static void normalizeAlpha(float &alpha)
+    {
+        Q_UNUSED(alpha);
+    }
+
+    ALWAYS_INLINE
+    static void denormalizeAlpha(float &alpha)
+    {
+        Q_UNUSED(alpha);
+    }
+
+    PixelWrapper() = default;
+
+    ALWAYS_INLINE void read(const void *src, float_v &dst_c1, float_v &dst_c2, float_v &dst_c3, float_v &dst_alpha)
+    {
+        KoHalfBatchConverter<_impl>::toFloat(static_cast<const half *>(src), m_buffer, valuesCount);
+        m_floatWrapper.read(m_buffer, dst_c1, dst_c2, dst_c3, dst_alpha);
+    }
+
+    ALWAYS_INLINE void
+    write(void *dst, const float_v &src_c1, const float_v &src_c2, const float_v &src_c3, const float_v &src_alpha)
+    {
+        m_floatWrapper.write(m_buffer, src_c1, src_c2, src_c3, src_alpha);
+        KoHalfBatchConverter<_impl>::fromFloat(m_buffer, static_cast<half *>(dst), valuesCount);
+    }
+
+    ALWAYS_INLINE
+    void clearPixels(quint8 *dataDst)
+    {
+        memset(dataDst, 0, float_v::size * sizeof(half) * 4);
+    }
+
+    ALWAYS_INLINE
+    void copyPixels(const quint8 *dataSrc, quint8 *dataDst)
+    {
+        memcpy(dataDst, dataSrc, float_v::size * sizeof(half) * 4);
+    }
+
+private:
+    PixelWrapper<float, _impl> m_floatWrapper;
+    alignas(64) float m_buffer[valuesCount];
+};
+#endif
+
 namespace KoStreamedMathFunctions
 {
 template<int pixelSize>
@@ -7,6 +7,7 @@
  */
 
 #include "KisDitherOpImpl.h"
+#include "KisOptimizedDitherOpFactory.h"
 
 /**
  * THIS CLASS OVERRIDES THE STANDARD FACTORY.
@@ -224,6 +225,14 @@ template<typename srcCSTraits, typename dstCSTraits> inline void addCmykDitherOp
     cs->addDitherOp(new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
 }
 
+template<typename srcCSTraits, typename dstCSTraits> inline void addOptimizedCmykDitherOpsByDepth(KoColorSpace *cs, const KoID &dstDepth)
+{
+    const KoID &srcDepth {cs->colorDepthId()};
+    cs->addDitherOp(new KisCmykDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_NONE>(srcDepth, dstDepth));
+    cs->addDitherOp(KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
+    cs->addDitherOp(KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
+}
+
 template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
 {
     static_assert(std::is_same<srcCSTraits, KoCmykU8Traits>::value || std::is_same<srcCSTraits, KoCmykU16Traits>::value ||
@@ -235,8 +244,8 @@ template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
 
     KIS_ASSERT(cs->pixelSize() == srcCSTraits::pixelSize);
 
-    addCmykDitherOpsByDepth<srcCSTraits, KoCmykU8Traits>(cs, Integer8BitsColorDepthID);
-    addCmykDitherOpsByDepth<srcCSTraits, KoCmykU16Traits>(cs, Integer16BitsColorDepthID);
+    addOptimizedCmykDitherOpsByDepth<srcCSTraits, KoCmykU8Traits>(cs, Integer8BitsColorDepthID);
+    addOptimizedCmykDitherOpsByDepth<srcCSTraits, KoCmykU16Traits>(cs, Integer16BitsColorDepthID);
 #ifdef HAVE_OPENEXR
     addCmykDitherOpsByDepth<srcCSTraits, KoCmykF16Traits>(cs, Float16BitsColorDepthID);
 #endif
@@ -7,6 +7,7 @@
  */
 
 #include "KisDitherOpImpl.h"
+#include "KisOptimizedDitherOpFactory.h"
 
 template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
 {
@@ -17,8 +18,8 @@ template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
                       std::is_same<srcCSTraits, KoGrayF32Traits>::value,
                   "Missing colorspace, add a transform case!");
 
-    addDitherOpsByDepth<srcCSTraits, KoGrayU8Traits>(cs, Integer8BitsColorDepthID);
-    addDitherOpsByDepth<srcCSTraits, KoGrayU16Traits>(cs, Integer16BitsColorDepthID);
+    addOptimizedDitherOpsByDepth<srcCSTraits, KoGrayU8Traits>(cs, Integer8BitsColorDepthID);
+    addOptimizedDitherOpsByDepth<srcCSTraits, KoGrayU16Traits>(cs, Integer16BitsColorDepthID);
 #ifdef HAVE_OPENEXR
     addDitherOpsByDepth<srcCSTraits, KoGrayF16Traits>(cs, Float16BitsColorDepthID);
 #endif
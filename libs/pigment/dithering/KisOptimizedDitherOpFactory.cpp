@@ -0,0 +1,32 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisOptimizedDitherOpFactory.h"
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisOptimizedDitherOpFactoryImpl.h"
+#include "KisOptimizedDitherOpTypes.h"
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+KisDitherOp *KisOptimizedDitherOpFactory::create(const KoID &srcId, const KoID &dstId)
+{
+    return createOptimizedClass<KisOptimizedDitherOpFactoryImpl<srcCSTraits, dstCSTraits, dType>>(srcId, dstId);
+}
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+KisDitherOp *KisOptimizedDitherOpFactory::createScalar(const KoID &srcId, const KoID &dstId)
+{
+    return createScalarClass<KisOptimizedDitherOpFactoryImpl<srcCSTraits, dstCSTraits, dType>>(srcId, dstId);
+}
+
+#define INSTANTIATE_DITHER_OP_FACTORY(srcCSTraits, dstCSTraits, dType) \
+    template KisDitherOp *KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, dType>(const KoID &, const KoID &); \
+    template KisDitherOp *KisOptimizedDitherOpFactory::createScalar<srcCSTraits, dstCSTraits, dType>(const KoID &, const KoID &);
+
+KIS_FOREACH_OPTIMIZED_DITHER_OP(INSTANTIATE_DITHER_OP_FACTORY)
@@ -0,0 +1,52 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_OPTIMIZED_DITHER_OP_FACTORY_H
+#define KIS_OPTIMIZED_DITHER_OP_FACTORY_H
+
+#include <KoColorSpace.h>
+
+#include "KisDitherOp.h"
+#include "KisDitherOpImpl.h"
+#include "kritapigment_export.h"
+
+/**
+ * Creates the ordered and blue noise dither ops optimized for the
+ * current CPU architecture. Only the combinations listed in
+ * KisOptimizedDitherOpTypes.h are available.
+ *
+ * \see KisOptimizedDitherOpImpl
+ */
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactory
+{
+public:
+    template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+    static KisDitherOp *create(const KoID &srcId, const KoID &dstId);
+
+    /**
+     * Creates the unvectorized version of the op, used as
+     * a reference in tests and benchmarks
+     */
+    template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+    static KisDitherOp *createScalar(const KoID &srcId, const KoID &dstId);
+};
+
+/**
+ * Same as addDitherOpsByDepth(), but uses the optimized implementation
+ * for the ordered and blue noise ops. The destination depth must be an
+ * integer one.
+ */
+template<typename srcCSTraits, class dstCSTraits> inline void addOptimizedDitherOpsByDepth(KoColorSpace *cs, const KoID &dstDepth)
+{
+    const KoID &srcDepth {cs->colorDepthId()};
+    cs->addDitherOp(new KisDitherOpImpl<srcCSTraits, dstCSTraits, DITHER_NONE>(srcDepth, dstDepth));
+    cs->addDitherOp(KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, DITHER_BAYER>(srcDepth, dstDepth));
+    cs->addDitherOp(KisOptimizedDitherOpFactory::create<srcCSTraits, dstCSTraits, DITHER_BLUE_NOISE>(srcDepth, dstDepth));
+}
+
+#endif // KIS_OPTIMIZED_DITHER_OP_FACTORY_H
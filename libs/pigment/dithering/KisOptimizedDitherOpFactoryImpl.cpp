@@ -0,0 +1,27 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dithering/KisOptimizedDitherOpFactoryImpl.h"
+
+#if XSIMD_UNIVERSAL_BUILD_PASS
+#include "dithering/KisOptimizedDitherOpImpl.h"
+#include "dithering/KisOptimizedDitherOpTypes.h"
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+template<typename _impl>
+KisDitherOp *KisOptimizedDitherOpFactoryImpl<srcCSTraits, dstCSTraits, dType>::create(const KoID &srcId, const KoID &dstId)
+{
+    return new KisOptimizedDitherOpImpl<srcCSTraits, dstCSTraits, dType, _impl>(srcId, dstId);
+}
+
+#define INSTANTIATE_DITHER_OP_FACTORY(srcCSTraits, dstCSTraits, dType) \
+    template KisDitherOp *KisOptimizedDitherOpFactoryImpl<srcCSTraits, dstCSTraits, dType>::create<xsimd::current_arch>(const KoID &, const KoID &);
+
+KIS_FOREACH_OPTIMIZED_DITHER_OP(INSTANTIATE_DITHER_OP_FACTORY)
+
+#endif // XSIMD_UNIVERSAL_BUILD_PASS
@@ -0,0 +1,25 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_OPTIMIZED_DITHER_OP_FACTORY_IMPL_H
+#define KIS_OPTIMIZED_DITHER_OP_FACTORY_IMPL_H
+
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisDitherOp.h"
+#include "kritapigment_export.h"
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+class KRITAPIGMENT_EXPORT KisOptimizedDitherOpFactoryImpl
+{
+public:
+    template<typename _impl>
+    static KisDitherOp *create(const KoID &srcId, const KoID &dstId);
+};
+
+#endif // KIS_OPTIMIZED_DITHER_OP_FACTORY_IMPL_H
@@ -0,0 +1,391 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_OPTIMIZED_DITHER_OP_IMPL_H
+#define KIS_OPTIMIZED_DITHER_OP_IMPL_H
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <QtGlobal>
+
+#include <KoConfig.h>
+#ifdef HAVE_OPENEXR
+#include <half.h>
+#endif
+
+#include <KoCmykColorSpaceMaths.h>
+#include <KoColorSpaceTraits.h>
+#include <KoID.h>
+#include <KoMultiArchBuildSupport.h>
+
+#include "KisDitherMaths.h"
+#include "KisDitherOp.h"
+
+namespace KisOptimizedDitherOpDetail
+{
+/**
+ * Both dither matrices we support tile the plane with a period
+ * of 64 pixels (the Bayer matrix repeats every 8 pixels, which
+ * divides 64), so any row of the pattern can be fetched as one
+ * contiguous chunk of at most 64 pixels.
+ */
+static constexpr int patternSize = 64;
+static constexpr int patternMask = patternSize - 1;
+
+/**
+ * Dither factors for every pixel of the 64x64 pattern, with each
+ * factor replicated for all the channels of the pixel. Thanks to
+ * that the kernels can treat a row of interleaved pixels as a flat
+ * array of channels and fetch the factors with plain vector loads.
+ *
+ * The table is shared between all the ops with the same pattern
+ * and number of channels and is initialized on first use.
+ */
+template<DitherType dType, int channels_nb>
+struct DitherPattern {
+    static const float *row(int y)
+    {
+        static const std::vector<float> table = generate();
+        return table.data() + (y & patternMask) * patternSize * channels_nb;
+    }
+
+private:
+    static float factor(int x, int y)
+    {
+        if (dType == DITHER_BAYER) {
+            return KisDitherMaths::dither_factor_bayer_8(x, y);
+        } else {
+            return KisDitherMaths::dither_factor_blue_noise_64(x, y);
+        }
+    }
+
+    static std::vector<float> generate()
+    {
+        std::vector<float> table(patternSize * patternSize * channels_nb);
+
+        auto it = table.begin();
+        for (int y = 0; y < patternSize; y++) {
+            for (int x = 0; x < patternSize; x++) {
+                const float f = factor(x, y);
+                for (int ch = 0; ch < channels_nb; ch++) {
+                    *it++ = f;
+                }
+            }
+        }
+
+        return table;
+    }
+};
+
+/**
+ * Per-channel normalization of a channel of \p traits into the [0, 1]
+ * range. CMYK color spaces in floating point use a different range for
+ * the color channels (see KisCmykDitherOpImpl), everything else uses
+ * the standard unit value.
+ */
+template<typename traits>
+inline float channelUnitValue(int channel)
+{
+    using channels_type = typename traits::channels_type;
+    Q_UNUSED(channel);
+
+    if constexpr (!std::numeric_limits<channels_type>::is_integer
+                  && std::is_base_of<KoCmykTraits<channels_type>, traits>::value) {
+        if (channel != traits::alpha_pos) {
+            return static_cast<float>(KoCmykColorSpaceMathsTraits<channels_type>::unitValueCMYK);
+        }
+    }
+
+    return static_cast<float>(KoColorSpaceMathsTraits<channels_type>::unitValue);
+}
+
+/**
+ * The scalar ops round when converting to an integer destination,
+ * except for the color channels of CMYK that are truncated (see
+ * KisCmykDitherOpImpl::denormalize()). We keep this behavior to
+ * produce the same output.
+ */
+template<typename traits>
+inline float channelRoundingBias(int channel)
+{
+    using channels_type = typename traits::channels_type;
+
+    if (std::is_base_of<KoCmykTraits<channels_type>, traits>::value && channel != traits::alpha_pos) {
+        return 0.0f;
+    }
+
+    return 0.5f;
+}
+} // namespace KisOptimizedDitherOpDetail
+
+/**
+ * Ordered (Bayer) and blue noise dither op for conversions into
+ * integer color depths, i.e. all the 16/32-bit -> 8-bit conversions
+ * used by the canvas and export.
+ *
+ * Instead of going through the traits pixel-by-pixel, a row of pixels
+ * is handled as a flat array of channels. The dither factors and the
+ * per-channel normalization values are prepared in tables laid out
+ * the same way, so the dithering boils down to a couple of
+ * multiply-adds per channel.
+ *
+ * This is the scalar implementation of the algorithm, used as a fallback
+ * when vectorization is not available. The vectorized version is
+ * implemented in KisOptimizedDitherOpImpl.
+ */
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType>
+class KisOptimizedDitherOpBase : public KisDitherOp
+{
+protected:
+    using srcChannelsType = typename srcCSTraits::channels_type;
+    using dstChannelsType = typename dstCSTraits::channels_type;
+    using Pattern = KisOptimizedDitherOpDetail::DitherPattern<dType, srcCSTraits::channels_nb>;
+
+    static_assert(srcCSTraits::channels_nb == dstCSTraits::channels_nb, "the color models of the source and destination must match!");
+    static_assert(std::numeric_limits<dstChannelsType>::is_integer, "dithering into floating point depths is a no-op, use KisDitherOpImpl!");
+    static_assert(dType == DITHER_BAYER || dType == DITHER_BLUE_NOISE, "unsupported dither type!");
+
+    static constexpr int channels_nb = srcCSTraits::channels_nb;
+    static constexpr int elementsPerPattern = KisOptimizedDitherOpDetail::patternSize * channels_nb;
+
+    /**
+     * Normalization values expanded to one full row of the pattern
+     */
+    struct ChannelTables {
+        ChannelTables()
+        {
+            for (int i = 0; i < elementsPerPattern; i++) {
+                const int channel = i % channels_nb;
+                srcNorm[i] = 1.0f / KisOptimizedDitherOpDetail::channelUnitValue<srcCSTraits>(channel);
+                dstUnit[i] = KisOptimizedDitherOpDetail::channelUnitValue<dstCSTraits>(channel);
+                dstBias[i] = KisOptimizedDitherOpDetail::channelRoundingBias<dstCSTraits>(channel);
+            }
+        }
+
+        std::array<float, elementsPerPattern> srcNorm;
+        std::array<float, elementsPerPattern> dstUnit;
+        std::array<float, elementsPerPattern> dstBias;
+    };
+
+public:
+    KisOptimizedDitherOpBase(const KoID &srcId, const KoID &dstId)
+        : m_srcDepthId(srcId)
+        , m_dstDepthId(dstId)
+    {
+    }
+
+    void dither(const quint8 *src, quint8 *dst, int x, int y) const override
+    {
+        const int offset = (x & KisOptimizedDitherOpDetail::patternMask) * channels_nb;
+
+        ditherElementsScalar(srcCSTraits::nativeArray(src),
+                             dstCSTraits::nativeArray(dst),
+                             Pattern::row(y) + offset,
+                             offset,
+                             channels_nb);
+    }
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        ditherRows(srcRowStart, srcRowStride, dstRowStart, dstRowStride, x, y, columns, rows,
+                   &KisOptimizedDitherOpBase::ditherElementsScalar);
+    }
+
+    KoID sourceDepthId() const override
+    {
+        return m_srcDepthId;
+    }
+
+    KoID destinationDepthId() const override
+    {
+        return m_dstDepthId;
+    }
+
+    DitherType type() const override
+    {
+        return dType;
+    }
+
+protected:
+    static const ChannelTables &channelTables()
+    {
+        static const ChannelTables tables;
+        return tables;
+    }
+
+    static constexpr float scale()
+    {
+        return 1.f / static_cast<float>(1 << dstCSTraits::depth);
+    }
+
+    static inline dstChannelsType ditherElement(srcChannelsType src, float factor, float srcNorm, float dstUnit, float dstBias)
+    {
+        float c = static_cast<float>(src) * srcNorm;
+        c = KisDitherMaths::apply_dither(c, factor, scale());
+        c = qBound(0.0f, c * dstUnit + dstBias, static_cast<float>(KoColorSpaceMathsTraits<dstChannelsType>::max));
+        return static_cast<dstChannelsType>(c);
+    }
+
+    /**
+     * Dither \p numElements channels. \p factors and \p tableOffset
+     * should point to the same pixel of the pattern as \p src.
+     */
+    static void ditherElementsScalar(const srcChannelsType *src, dstChannelsType *dst, const float *factors, int tableOffset, int numElements)
+    {
+        const ChannelTables &tables = channelTables();
+
+        for (int i = 0; i < numElements; i++) {
+            dst[i] = ditherElement(src[i],
+                                   factors[i],
+                                   tables.srcNorm[tableOffset + i],
+                                   tables.dstUnit[tableOffset + i],
+                                   tables.dstBias[tableOffset + i]);
+        }
+    }
+
+    /**
+     * Walk through the rows splitting them into chunks that don't cross
+     * the boundary of the pattern and pass them to \p ditherElements
+     */
+    template<typename Func>
+    static void ditherRows(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows, Func ditherElements)
+    {
+        using namespace KisOptimizedDitherOpDetail;
+
+        for (int row = 0; row < rows; row++) {
+            const srcChannelsType *srcPtr = srcCSTraits::nativeArray(srcRowStart);
+            dstChannelsType *dstPtr = dstCSTraits::nativeArray(dstRowStart);
+            const float *patternRow = Pattern::row(y + row);
+
+            int column = 0;
+            while (column < columns) {
+                const int patternX = (x + column) & patternMask;
+                const int chunkSize = qMin(patternSize - patternX, columns - column);
+                const int tableOffset = patternX * channels_nb;
+                const int numElements = chunkSize * channels_nb;
+
+                ditherElements(srcPtr, dstPtr, patternRow + tableOffset, tableOffset, numElements);
+
+                srcPtr += numElements;
+                dstPtr += numElements;
+                column += chunkSize;
+            }
+
+            srcRowStart += srcRowStride;
+            dstRowStart += dstRowStride;
+        }
+    }
+
+private:
+    const KoID m_srcDepthId, m_dstDepthId;
+};
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType, typename _impl, typename EnableDummyType = void>
+class KisOptimizedDitherOpImpl : public KisOptimizedDitherOpBase<srcCSTraits, dstCSTraits, dType>
+{
+public:
+    using KisOptimizedDitherOpBase<srcCSTraits, dstCSTraits, dType>::KisOptimizedDitherOpBase;
+};
+
+#if defined(HAVE_XSIMD) && !defined(XSIMD_NO_SUPPORTED_ARCHITECTURE)
+
+template<typename srcCSTraits, typename dstCSTraits, DitherType dType, typename _impl>
+class KisOptimizedDitherOpImpl<srcCSTraits, dstCSTraits, dType, _impl, typename std::enable_if<!std::is_same<_impl, xsimd::generic>::value>::type>
+    : public KisOptimizedDitherOpBase<srcCSTraits, dstCSTraits, dType>
+{
+    using base_class = KisOptimizedDitherOpBase<srcCSTraits, dstCSTraits, dType>;
+    using srcChannelsType = typename base_class::srcChannelsType;
+    using dstChannelsType = typename base_class::dstChannelsType;
+    using ChannelTables = typename base_class::ChannelTables;
+
+    using int_v = xsimd::batch<int, _impl>;
+    using float_v = xsimd::batch<float, _impl>;
+
+    static constexpr int vectorSize = static_cast<int>(float_v::size);
+
+public:
+    using base_class::base_class;
+    using base_class::dither;
+
+    void dither(const quint8 *srcRowStart, int srcRowStride, quint8 *dstRowStart, int dstRowStride, int x, int y, int columns, int rows) const override
+    {
+        base_class::ditherRows(srcRowStart, srcRowStride, dstRowStart, dstRowStride, x, y, columns, rows,
+                               &KisOptimizedDitherOpImpl::ditherElements);
+    }
+
+private:
+    static inline float_v loadAsFloat(const srcChannelsType *src)
+    {
+        if constexpr (std::is_same<srcChannelsType, float>::value) {
+            return float_v::load_unaligned(src);
+        } else if constexpr (std::numeric_limits<srcChannelsType>::is_integer) {
+            return xsimd::batch_cast<float>(xsimd::load_and_extend<int_v>(src));
+        } else {
+            // half: there is no portable vector conversion, so unpack
+            // the values into a temporary buffer first
+            alignas(float_v::arch_type::alignment()) std::array<float, vectorSize> buf;
+            for (int i = 0; i < vectorSize; i++) {
+                buf[i] = static_cast<float>(src[i]);
+            }
+            return float_v::load_aligned(buf.data());
+        }
+    }
+
+    static inline void storeFromInt(dstChannelsType *dst, const int_v &value)
+    {
+        alignas(int_v::arch_type::alignment()) std::array<int, vectorSize> buf;
+        value.store_aligned(buf.data());
+        for (int i = 0; i < vectorSize; i++) {
+            dst[i] = static_cast<dstChannelsType>(buf[i]);
+        }
+    }
+
+    static void ditherElements(const srcChannelsType *src, dstChannelsType *dst, const float *factors, int tableOffset, int numElements)
+    {
+        const ChannelTables &tables = base_class::channelTables();
+        const float *srcNorm = tables.srcNorm.data() + tableOffset;
+        const float *dstUnit = tables.dstUnit.data() + tableOffset;
+        const float *dstBias = tables.dstBias.data() + tableOffset;
+
+        const float_v s(base_class::scale());
+        const float_v zero(0.0f);
+        const float_v maxValue(static_cast<float>(KoColorSpaceMathsTraits<dstChannelsType>::max));
+
+        const int numVectors = numElements / vectorSize;
+
+        for (int i = 0; i < numVectors; i++) {
+            const float_v f = float_v::load_unaligned(factors);
+
+            float_v c = loadAsFloat(src) * float_v::load_unaligned(srcNorm);
+            c = c + (f - c) * s;
+            c = c * float_v::load_unaligned(dstUnit) + float_v::load_unaligned(dstBias);
+            c = xsimd::min(xsimd::max(c, zero), maxValue);
+
+            storeFromInt(dst, xsimd::batch_cast<int>(c));
+
+            src += vectorSize;
+            dst += vectorSize;
+            factors += vectorSize;
+            srcNorm += vectorSize;
+            dstUnit += vectorSize;
+            dstBias += vectorSize;
+        }
+
+        const int rest = numElements - numVectors * vectorSize;
+        if (rest) {
+            base_class::ditherElementsScalar(src, dst, factors, tableOffset + numVectors * vectorSize, rest);
+        }
+    }
+};
+
+#endif /* HAVE_XSIMD */
+
+#endif // KIS_OPTIMIZED_DITHER_OP_IMPL_H
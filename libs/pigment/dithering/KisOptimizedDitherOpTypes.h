@@ -0,0 +1,52 @@
+/*
+ * This file is part of Krita
+ *
+ * SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_OPTIMIZED_DITHER_OP_TYPES_H
+#define KIS_OPTIMIZED_DITHER_OP_TYPES_H
+
+#include <KoConfig.h>
+#include <KoColorSpaceTraits.h>
+
+#include "KisDitherOp.h"
+
+/**
+ * The list of (source traits, destination traits, dither type) triplets
+ * that have an optimized implementation. Dithering into floating point
+ * depths is a no-op conversion, so only integer destinations are listed.
+ *
+ * Both the per-arch factories and the dispatcher are instantiated from
+ * this list, so that they never go out of sync.
+ */
+
+#define KIS_OPTIMIZED_DITHER_OP_TYPES(MACRO, src, dst) \
+    MACRO(src, dst, DITHER_BAYER) \
+    MACRO(src, dst, DITHER_BLUE_NOISE)
+
+#define KIS_OPTIMIZED_DITHER_OP_DEPTHS(MACRO, src, dstU8, dstU16) \
+    KIS_OPTIMIZED_DITHER_OP_TYPES(MACRO, src, dstU8) \
+    KIS_OPTIMIZED_DITHER_OP_TYPES(MACRO, src, dstU16)
+
+#ifdef HAVE_OPENEXR
+#define KIS_OPTIMIZED_DITHER_OP_DEPTHS_F16(MACRO, src, dstU8, dstU16) \
+    KIS_OPTIMIZED_DITHER_OP_DEPTHS(MACRO, src, dstU8, dstU16)
+#else
+#define KIS_OPTIMIZED_DITHER_OP_DEPTHS_F16(MACRO, src, dstU8, dstU16)
+#endif
+
+#define KIS_OPTIMIZED_DITHER_OP_MODEL(MACRO, U8, U16, F16, F32) \
+    KIS_OPTIMIZED_DITHER_OP_DEPTHS(MACRO, U8, U8, U16) \
+    KIS_OPTIMIZED_DITHER_OP_DEPTHS(MACRO, U16, U8, U16) \
+    KIS_OPTIMIZED_DITHER_OP_DEPTHS_F16(MACRO, F16, U8, U16) \
+    KIS_OPTIMIZED_DITHER_OP_DEPTHS(MACRO, F32, U8, U16)
+
+#define KIS_FOREACH_OPTIMIZED_DITHER_OP(MACRO) \
+    KIS_OPTIMIZED_DITHER_OP_MODEL(MACRO, KoBgrU8Traits, KoBgrU16Traits, KoRgbF16Traits, KoRgbF32Traits) \
+    KIS_OPTIMIZED_DITHER_OP_MODEL(MACRO, KoGrayU8Traits, KoGrayU16Traits, KoGrayF16Traits, KoGrayF32Traits) \
+    KIS_OPTIMIZED_DITHER_OP_MODEL(MACRO, KoCmykU8Traits, KoCmykU16Traits, KoCmykF16Traits, KoCmykF32Traits)
+
+#endif // KIS_OPTIMIZED_DITHER_OP_TYPES_H
@@ -7,6 +7,7 @@
  */
 
 #include "KisDitherOpImpl.h"
+#include "KisOptimizedDitherOpFactory.h"
 
 
 template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
@@ -18,8 +19,8 @@ template<class srcCSTraits> inline void addStandardDitherOps(KoColorSpace *cs)
                       std::is_same<srcCSTraits, KoRgbF32Traits>::value,
                   "Missing colorspace, add a transform case!");
 
-    addDitherOpsByDepth<srcCSTraits, KoBgrU8Traits>(cs, Integer8BitsColorDepthID);
-    addDitherOpsByDepth<srcCSTraits, KoBgrU16Traits>(cs, Integer16BitsColorDepthID);
+    addOptimizedDitherOpsByDepth<srcCSTraits, KoBgrU8Traits>(cs, Integer8BitsColorDepthID);
+    addOptimizedDitherOpsByDepth<srcCSTraits, KoBgrU16Traits>(cs, Integer16BitsColorDepthID);
 #ifdef HAVE_OPENEXR
     addDitherOpsByDepth<srcCSTraits, KoRgbF16Traits>(cs, Float16BitsColorDepthID);
 #endif
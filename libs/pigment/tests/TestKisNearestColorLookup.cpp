@@ -0,0 +1,141 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "TestKisNearestColorLookup.h"
+
+#include <simpletest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <QRandomGenerator>
+
+#include "KisNearestColorLookup.h"
+
+using Color = KisNearestColorLookup::Color;
+using Match = KisNearestColorLookup::Match;
+
+
+void TestKisNearestColorLookup::testEmptyPalette()
+{
+    KisNearestColorLookup lookup((QVector<Color>()));
+    QVERIFY(lookup.isEmpty());
+
+    const Color color = {100, 200, 300};
+    QCOMPARE(lookup.nearest(color.data()).index, -1);
+
+    Match matches[2];
+    QCOMPARE(lookup.nearestTwo(color.data(), matches), 0);
+}
+
+void TestKisNearestColorLookup::testDuplicates()
+{
+    const QVector<Color> colors = {
+        {1000, 1000, 1000},
+        {5000, 5000, 5000},
+        {1000, 1000, 1000},
+        {5000, 5000, 5000},
+    };
+
+    KisNearestColorLookup lookup(colors);
+
+    // the duplicates are skipped, the lowest index is kept
+    Match matches[2];
+    QCOMPARE(lookup.nearestTwo(colors[2].data(), matches), 2);
+    QCOMPARE(matches[0].index, 0);
+    QCOMPARE(matches[0].distance, 0.0f);
+    QCOMPARE(matches[1].index, 1);
+
+    // the same, but from the cache
+    QCOMPARE(lookup.nearestTwo(colors[2].data(), matches), 2);
+    QCOMPARE(matches[0].index, 0);
+    QCOMPARE(matches[1].index, 1);
+
+    KisNearestColorLookup singleColor({colors[0], colors[2]});
+    QCOMPARE(singleColor.nearestTwo(colors[1].data(), matches), 1);
+    QCOMPARE(matches[0].index, 0);
+}
+
+void TestKisNearestColorLookup::testAgainstBruteForce_data()
+{
+    QTest::addColumn<int>("numColors");
+    QTest::addColumn<float>("weightB");
+
+    QTest::newRow("3") << 3 << 1.0f;
+    QTest::newRow("16") << 16 << 1.0f;
+    QTest::newRow("256") << 256 << 1.0f;
+    QTest::newRow("256-weighted") << 256 << 0.25f;
+    QTest::newRow("256-zero-weight") << 256 << 0.0f;
+}
+
+void TestKisNearestColorLookup::testAgainstBruteForce()
+{
+    QFETCH(int, numColors);
+    QFETCH(float, weightB);
+
+    QRandomGenerator random(31337);
+
+    auto randomColor = [&random] () {
+        // a coarse grid makes equal distances quite probable
+        return Color{quint16(random.bounded(64) * 1024),
+                     quint16(random.bounded(64) * 1024),
+                     quint16(random.bounded(64) * 1024)};
+    };
+
+    QVector<Color> colors;
+    for (int i = 0; i < numColors; i++) {
+        colors << randomColor();
+    }
+
+    const KisNearestColorLookup::Weights weights = {1.0f, 0.5f, weightB};
+    KisNearestColorLookup lookup(colors, weights);
+
+    auto distance = [&weights] (const Color &lhs, const Color &rhs) {
+        float result = 0.0f;
+        for (int i = 0; i < 3; i++) {
+            const float diff = lhs[i] * weights[i] - rhs[i] * weights[i];
+            result += diff * diff;
+        }
+        return std::sqrt(result);
+    };
+
+    // the colors are repeated to check the cached results as well
+    QVector<Color> searched;
+    for (int i = 0; i < 2000; i++) {
+        searched << randomColor();
+    }
+    searched += searched;
+
+    for (const Color &color : searched) {
+        Match expected[2];
+
+        for (int i = 0; i < colors.size(); i++) {
+            const float d = distance(colors[i], color);
+
+            // only the first of the equal colors takes part in the search
+            if (std::find(colors.begin(), colors.begin() + i, colors[i]) != colors.begin() + i) continue;
+
+            if (expected[0].index < 0 || d < expected[0].distance) {
+                expected[1] = expected[0];
+                expected[0] = {i, d};
+            } else if (expected[1].index < 0 || d < expected[1].distance) {
+                expected[1] = {i, d};
+            }
+        }
+
+        Match matches[2];
+        QCOMPARE(lookup.nearestTwo(color.data(), matches), 2);
+
+        QCOMPARE(matches[0].index, expected[0].index);
+        QCOMPARE(matches[0].distance, expected[0].distance);
+        QCOMPARE(matches[1].index, expected[1].index);
+        QCOMPARE(matches[1].distance, expected[1].distance);
+
+        QCOMPARE(lookup.nearest(color.data()).index, expected[0].index);
+    }
+}
+
+SIMPLE_TEST_MAIN(TestKisNearestColorLookup)
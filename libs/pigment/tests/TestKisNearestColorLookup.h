@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef TESTKISNEARESTCOLORLOOKUP_H
+#define TESTKISNEARESTCOLORLOOKUP_H
+
+#include <QObject>
+
+class TestKisNearestColorLookup : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testEmptyPalette();
+    void testDuplicates();
+    void testAgainstBruteForce_data();
+    void testAgainstBruteForce();
+};
+
+#endif
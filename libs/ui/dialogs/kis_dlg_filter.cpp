@@ -38,6 +38,7 @@ struct KisDlgFilter::Private {
             , filterManager(_filterManager)
             , blockModifyingActionsGuard(new KisInputActionGroupsMaskGuard(view->canvasBase()->inputActionGroupsMaskInterface(), ViewTransformActionGroup))
             , updateCompressor(200, KisSignalCompressor::FIRST_ACTIVE)
+            , refineCompressor(1000, KisSignalCompressor::POSTPONE)
     {
         updateCompressor.setDelay(
             [this] () {
@@ -57,6 +58,10 @@ struct KisDlgFilter::Private {
     // dialog is open
     QScopedPointer<KisInputActionGroupsMaskGuard> blockModifyingActionsGuard;
     KisSignalCompressor updateCompressor;
+
+    // restarts the LoD preview in full resolution when the user
+    // stops changing the parameters of the filter
+    KisSignalCompressor refineCompressor;
 };
 
 KisDlgFilter::KisDlgFilter(KisViewManager *view, KisNodeSP node, KisFilterManager *filterManager, QWidget *parent) :
@@ -115,6 +120,7 @@ KisDlgFilter::KisDlgFilter(KisViewManager *view, KisNodeSP node, KisFilterManage
 
     restoreGeometry(KisConfig(true).readEntry("filterdialog/geometry", QByteArray()));
     connect(&d->updateCompressor, SIGNAL(timeout()), this, SLOT(updatePreview()));
+    connect(&d->refineCompressor, SIGNAL(timeout()), this, SLOT(slotRefinePreview()));
 
 }
 
@@ -163,11 +169,33 @@ void KisDlgFilter::updatePreview()
     if (d->uiFilterDialog.checkBoxPreview->isChecked()) {
         KisFilterConfigurationSP config(d->uiFilterDialog.filterSelection->configuration());
         startApplyingFilter(config);
+
+        KConfigGroup group( KSharedConfig::openConfig(), "filterdialog");
+        if (group.readEntry("refineLodPreview", true)) {
+            d->refineCompressor.start();
+        }
     }
 
     d->uiFilterDialog.buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
 }
 
+void KisDlgFilter::slotRefinePreview()
+{
+    if (!d->uiFilterDialog.checkBoxPreview->isChecked() ||
+        d->updateCompressor.isActive()) {
+
+        return;
+    }
+
+    // wait until the LoD preview is shown
+    if (!d->filterManager->isIdle()) {
+        d->refineCompressor.start();
+        return;
+    }
+
+    d->filterManager->refinePreview();
+}
+
 void KisDlgFilter::adjustSize()
 {
     QWidget::adjustSize();
@@ -49,6 +49,7 @@ private:
 private Q_SLOTS:
     void slotFilterWidgetSizeChanged();
     void updatePreview();
+    void slotRefinePreview();
 
 private:
     struct Private;
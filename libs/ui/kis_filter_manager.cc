@@ -33,6 +33,7 @@
 // krita/ui
 #include "KisViewManager.h"
 #include "kis_canvas2.h"
+#include "kis_coordinates_converter.h"
 #include <kis_bookmarked_configuration_manager.h>
 
 #include "kis_action.h"
@@ -57,6 +58,7 @@ struct KisFilterManager::Private {
     KisFilterConfigurationSP lastConfiguration;
     KisFilterConfigurationSP currentlyAppliedConfiguration;
     KisStrokeId currentStrokeId;
+    bool currentStrokeIsLodPreview = false;
     KisFilterStrokeStrategy::ExternalCancelUpdatesStorageSP externalCancelUpdatesStorage;
     KisFilterStrokeStrategy::IdleBarrierData::IdleBarrierCookie idleBarrierCookie;
 
@@ -268,8 +270,29 @@ void KisFilterManager::showFilterDialog(const QString &filterId, KisFilterConfig
 
 void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
 {
-    KisFilterConfigurationSP filterConfig = _filterConfig->cloneWithResourcesSnapshot();
+    startFilterStroke(_filterConfig->cloneWithResourcesSnapshot(), false);
+}
+
+void KisFilterManager::refinePreview()
+{
+    if (!d->currentStrokeId || !d->currentStrokeIsLodPreview) return;
 
+    /**
+     * The LoD preview is cancelled without any updates, because the
+     * cancellation updates are disabled while the dialog is open, and
+     * its transaction is reverted with dirty requests disabled. So the
+     * canvas keeps showing the preview until the full-resolution patches
+     * replace it, and the area of the preview is updated only at the end
+     * of the refinement.
+     */
+    KIS_SAFE_ASSERT_RECOVER_NOOP(!d->externalCancelUpdatesStorage ||
+                                 !d->externalCancelUpdatesStorage->shouldIssueCancellationUpdates);
+
+    startFilterStroke(d->currentlyAppliedConfiguration, true);
+}
+
+void KisFilterManager::startFilterStroke(KisFilterConfigurationSP filterConfig, bool progressiveRefinement)
+{
     KisFilterSP filter = KisFilterRegistry::instance()->value(filterConfig->name());
     KisImageWSP image = d->view->image();
 
@@ -306,9 +329,20 @@ void KisFilterManager::apply(KisFilterConfigurationSP _filterConfig)
         strategy->setForceLodModeIfPossible(group.readEntry("forceLodMode", true));
     }
 
+    strategy->setProgressiveRefinement(progressiveRefinement);
+
+    if (d->view->canvasBase()) {
+        strategy->setPriorityRect(
+            d->view->canvasBase()->coordinatesConverter()->widgetRectInImagePixels().toAlignedRect());
+    }
+
     d->currentStrokeId =
         image->startStroke(strategy);
 
+    // the strategy is owned by the stroke now, but the stroke cannot
+    // end before finish() or cancelRunningStroke() are called
+    d->currentStrokeIsLodPreview = strategy->hasBeenLodCloned();
+
     // Apply filter preview to active, visible frame only.
     KisImageConfig imgConf(true);
     image->addJob(d->currentStrokeId, new KisFilterStrokeStrategy::FilterJobData());
@@ -356,6 +390,7 @@ void KisFilterManager::finish()
 
     d->idleBarrierCookie.clear();
     d->currentlyAppliedConfiguration.clear();
+    d->currentStrokeIsLodPreview = false;
 }
 
 void KisFilterManager::cancelRunningStroke()
@@ -369,6 +404,7 @@ void KisFilterManager::cancelRunningStroke()
     d->currentStrokeId.clear();
     d->idleBarrierCookie.clear();
     d->currentlyAppliedConfiguration.clear();
+    d->currentStrokeIsLodPreview = false;
     d->externalCancelUpdatesStorage.clear();
 }
 
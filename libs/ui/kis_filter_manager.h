@@ -35,6 +35,14 @@ public:
     void updateGUI();
 
     void apply(KisFilterConfigurationSP filterConfig);
+
+    /**
+     * If the preview of the currently applied configuration has been
+     * shown in LoD mode, restarts it in full resolution. The patches
+     * around the visible area are filtered and shown first.
+     */
+    void refinePreview();
+
     void finish();
     //! Cancel current running stroke
     void cancelRunningStroke();
@@ -60,6 +68,9 @@ private Q_SLOTS:
     //! Clean up after filter dialog has been accepted / rejected / closed
     void filterDialogHasFinished(int);
 
+private:
+    void startFilterStroke(KisFilterConfigurationSP filterConfig, bool progressiveRefinement);
+
 private:
     struct Private;
     QScopedPointer<Private> d;
@@ -14,7 +14,12 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_registry.h"
 #include "filter/kis_filter_configuration.h"
+#include "kis_paint_device.h"
+#include "kis_undo_stores.h"
 #include <KisGlobalResourcesInterface.h>
+#include <KisRunnableStrokeJobData.h>
+
+#include <atomic>
 
 class FilterStrokeTester : public utils::StrokeTester
 {
@@ -72,4 +77,117 @@ void FilterStrokeTest::testBlurFilter()
     tester.test();
 }
 
+namespace {
+
+bool devicesAreEqual(KisPaintDeviceSP dev1, KisPaintDeviceSP dev2)
+{
+    const QRect rect = dev1->exactBounds() | dev2->exactBounds();
+
+    QVector<quint8> bytes1(rect.width() * rect.height() * dev1->pixelSize());
+    QVector<quint8> bytes2(bytes1.size());
+
+    dev1->readBytes(bytes1.data(), rect);
+    dev2->readBytes(bytes2.data(), rect);
+
+    return bytes1 == bytes2;
+}
+
+class ProgressiveFilterTester
+{
+public:
+    ProgressiveFilterTester()
+        : m_image(utils::createImage(new KisSurrogateUndoStore(), QSize(500, 500))),
+          m_manager(utils::createResourceManager(m_image, 0, ""))
+    {
+        m_node = m_image->rootLayer()->firstChild();
+
+        QImage src(QString(FILES_DATA_DIR) + '/' + "carrot.png");
+        m_node->original()->convertFromQImage(src, 0);
+        m_image->initialRefreshGraph();
+    }
+
+    KisPaintDeviceSP device() const {
+        return m_node->paintDevice();
+    }
+
+    void runStroke(bool progressiveRefinement, bool cancel, bool waitForPatches) {
+        KisResourcesSnapshotSP resources =
+            new KisResourcesSnapshot(m_image, m_node, m_manager.data());
+
+        KisFilterSP filter = KisFilterRegistry::instance()->value("blur");
+        KisFilterConfigurationSP filterConfig =
+            filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+        KisFilterStrokeStrategy *strategy = new KisFilterStrokeStrategy(filter, filterConfig, resources);
+        strategy->setProgressiveRefinement(progressiveRefinement);
+
+        KisStrokeId strokeId = m_image->startStroke(strategy);
+        m_image->addJob(strokeId, new KisFilterStrokeStrategy::FilterJobData());
+
+        if (waitForPatches) {
+            /**
+             * The jobs of the patches are added in front of this one, so
+             * when it is executed, all the patches are already written
+             */
+            std::atomic<bool> patchesDone(false);
+            m_image->addJob(strokeId,
+                            new KisRunnableStrokeJobData([&patchesDone] () {
+                                patchesDone = true;
+                            }));
+
+            while (!patchesDone) {
+                QTest::qWait(10);
+            }
+        }
+
+        if (cancel) {
+            m_image->cancelStroke(strokeId);
+        } else {
+            m_image->endStroke(strokeId);
+        }
+
+        m_image->waitForDone();
+    }
+
+private:
+    KisImageSP m_image;
+    QScopedPointer<KoCanvasResourceProvider> m_manager;
+    KisNodeSP m_node;
+};
+
+}
+
+void FilterStrokeTest::testProgressiveRefinementCancelled_data()
+{
+    QTest::addColumn<bool>("waitForPatches");
+
+    QTest::newRow("cancel-immediately") << false;
+    QTest::newRow("cancel-after-patches") << true;
+}
+
+void FilterStrokeTest::testProgressiveRefinementCancelled()
+{
+    QFETCH(bool, waitForPatches);
+
+    ProgressiveFilterTester tester;
+    KisPaintDeviceSP original = new KisPaintDevice(*tester.device());
+
+    tester.runStroke(true, true, waitForPatches);
+
+    QVERIFY(devicesAreEqual(tester.device(), original));
+}
+
+void FilterStrokeTest::testProgressiveRefinementFinished()
+{
+    ProgressiveFilterTester progressiveTester;
+    KisPaintDeviceSP original = new KisPaintDevice(*progressiveTester.device());
+    progressiveTester.runStroke(true, false, false);
+
+    ProgressiveFilterTester referenceTester;
+    referenceTester.runStroke(false, false, false);
+
+    QVERIFY(!devicesAreEqual(referenceTester.device(), original));
+    QVERIFY(devicesAreEqual(progressiveTester.device(), referenceTester.device()));
+}
+
 SIMPLE_TEST_MAIN(FilterStrokeTest)
@@ -16,6 +16,9 @@ class FilterStrokeTest : public QObject
 
 private Q_SLOTS:
     void testBlurFilter();
+    void testProgressiveRefinementCancelled_data();
+    void testProgressiveRefinementCancelled();
+    void testProgressiveRefinementFinished();
 };
 
 #endif /* __FILTER_STROKE_TEST_H */
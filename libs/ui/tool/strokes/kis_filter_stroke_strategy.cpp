@@ -6,6 +6,12 @@
 
 #include "kis_filter_stroke_strategy.h"
 
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
 #include <filter/kis_filter.h>
 #include <filter/kis_filter_configuration.h>
 #include <krita_utils.h>
@@ -16,6 +22,7 @@
 #include <KisRunnableStrokeJobUtils.h>
 #include <KisRunnableStrokeJobsInterface.h>
 #include <KoCompositeOpRegistry.h>
+#include <kis_global.h>
 #include "kis_image_config.h"
 #include "kis_image_animation_interface.h"
 #include "kis_painter.h"
@@ -40,7 +47,8 @@ struct KisFilterStrokeStrategy::Private {
         , updatesFacade(rhs.updatesFacade)
         , levelOfDetail(0)
         , cancelledUpdates(rhs.cancelledUpdates)
-
+        , priorityRect(rhs.priorityRect)
+        , progressiveRefinement(rhs.progressiveRefinement)
     {
         KIS_ASSERT_RECOVER_RETURN(!rhs.levelOfDetail);
     }
@@ -57,8 +65,26 @@ struct KisFilterStrokeStrategy::Private {
     ExternalCancelUpdatesStorageSP cancelledUpdates;
     QRect nextExternalUpdateRect;
     bool hasBeenLodCloned = false;
+
+    QRect priorityRect;
+    bool progressiveRefinement = false;
+
+    // the transaction over the patches that have already been
+    // written into the target device in the progressive mode
+    QSharedPointer<KisTransaction> progressiveTransaction;
+    QRect progressiveUpdateRect;
+    QMutex progressiveUpdateRectLock;
+
+    // the written patches are updated in batches, not more often
+    // than once in progressiveUpdatePeriod
+    QVector<QRect> pendingProgressiveUpdates;
+    QElapsedTimer progressiveUpdateTimer;
 };
 
+namespace {
+const int progressiveUpdatePeriod = 40; // ms
+}
+
 struct SubTaskSharedData {
 
     SubTaskSharedData(KisImageSP image, KisNodeSP node, int levelOfDetail,
@@ -111,6 +137,8 @@ public:
     QRect filterDeviceBounds;
     QSharedPointer<KisTransaction> filterDeviceTransaction;
     QRect processRect;
+    bool writePatchesProgressively = false;
+    QSharedPointer<KisProcessingVisitor::ProgressHelper> progress;
 
 private:
     KisImageSP m_image;
@@ -241,6 +269,18 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             // Filter device needs a transaction to prevent grid-patch artifacts from multithreaded read/write.
             shared->filterDeviceTransaction.reset(new KisTransaction(shared->filterDevice));
 
+            shared->writePatchesProgressively =
+                m_d->progressiveRefinement &&
+                shared->shouldRedraw() &&
+                !shared->shouldSwitchTime() &&
+                shared->filter()->supportsThreading() &&
+                shared->filterDeviceBounds.intersects(
+                    shared->filter()->neededRect(shared->processRect, shared->filterConfig().data(), shared->levelOfDetail()));
+
+            if (shared->writePatchesProgressively) {
+                m_d->progressiveTransaction.reset(new KisTransaction(shared->targetDevice()));
+                m_d->progressiveUpdateTimer.start();
+            }
 
             // Actually process the device
 
@@ -251,22 +291,64 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
                 QSize size = KritaUtils::optimalPatchSize();
                 QVector<QRect> patches = KritaUtils::splitRectIntoPatches(shared->processRect, size);
 
+                if (!m_d->priorityRect.isEmpty()) {
+                    KisLodTransform t(shared->levelOfDetail());
+                    const QRect priorityRect = t.map(m_d->priorityRect);
+                    const QPointF priorityCenter = QRectF(priorityRect).center();
+
+                    std::stable_sort(patches.begin(), patches.end(),
+                        [priorityRect, priorityCenter] (const QRect &lhs, const QRect &rhs) {
+                            const bool lhsVisible = lhs.intersects(priorityRect);
+                            const bool rhsVisible = rhs.intersects(priorityRect);
+
+                            if (lhsVisible != rhsVisible) {
+                                return lhsVisible;
+                            }
+
+                            return kisSquareDistance(QRectF(lhs).center(), priorityCenter) <
+                                kisSquareDistance(QRectF(rhs).center(), priorityCenter);
+                        });
+                }
+
                 Q_FOREACH (const QRect &patch, patches) {
                     if (!patch.isEmpty()) {
-                        addJobConcurrent(processJobs, [patch, shared, progress](){
+                        addJobConcurrent(processJobs, [this, patch, shared, progress](){
                             shared->filter()->processImpl(shared->filterDevice, patch,
                                                           shared->filterConfig().data(),
                                                           progress->updater());
+
+                            if (shared->writePatchesProgressively) {
+                                KisPainter::copyAreaOptimized(patch.topLeft(), shared->filterDevice, shared->targetDevice(), patch, shared->selection());
+
+                                QVector<QRect> updateRects;
+
+                                {
+                                    QMutexLocker l(&m_d->progressiveUpdateRectLock);
+                                    m_d->progressiveUpdateRect |= patch;
+                                    m_d->pendingProgressiveUpdates.append(patch);
+
+                                    if (m_d->progressiveUpdateTimer.elapsed() >= progressiveUpdatePeriod) {
+                                        updateRects.swap(m_d->pendingProgressiveUpdates);
+                                        m_d->progressiveUpdateTimer.restart();
+                                    }
+                                }
+
+                                if (!updateRects.isEmpty()) {
+                                    shared->node()->setDirty(updateRects);
+                                }
+                            }
                         });
                     }
                 }
             } else {
                 if (!shared->processRect.isEmpty()) {
-                    addJobSequential(processJobs, [shared, progress](){
-                        shared->filter()->processImpl(shared->filterDevice, shared->processRect,
-                                                      shared->filterConfig().data(),
-                                                      progress->updater());
-                    });
+                    // the filter may still split the work into its own stages
+                    shared->filter()->addProcessJobs(processJobs, shared->filterDevice, shared->processRect,
+                                                     shared->filterConfig().data(),
+                                                     progress->updater());
+
+                    // the jobs refer to the updater, so it should outlive them
+                    shared->progress = progress;
                 }
             }
 
@@ -279,6 +361,34 @@ void KisFilterStrokeStrategy::doStrokeCallback(KisStrokeJobData *data)
             runAndSaveCommand(toQShared(shared->filterDeviceTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::NORMAL);
             shared->filterDeviceTransaction.reset();
 
+            if (shared->writePatchesProgressively) {
+                // the patches have already been written, and most of them updated
+                runAndSaveCommand(toQShared(m_d->progressiveTransaction->endAndTake()), KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
+                m_d->progressiveTransaction.reset();
+                m_d->progressiveUpdateRect = QRect();
+
+                QVector<QRect> updateRects;
+                updateRects.swap(m_d->pendingProgressiveUpdates);
+
+                /**
+                 * The cancelled LoD preview has left its pixels on the
+                 * canvas, they are replaced only now
+                 */
+                QRect extraUpdateRect;
+                qSwap(extraUpdateRect, m_d->nextExternalUpdateRect);
+
+                if (!extraUpdateRect.isEmpty()) {
+                    updateRects.append(extraUpdateRect);
+                }
+
+                if (!updateRects.isEmpty()) {
+                    shared->node()->setDirty(updateRects);
+                }
+
+                m_d->nextExternalUpdateRect = shared->processRect;
+                return;
+            }
+
             if (!shared->filterDeviceBounds.intersects(
                     shared->filter()->neededRect(shared->processRect, shared->filterConfig().data(), shared->levelOfDetail()))) {
                 return;
@@ -333,6 +443,24 @@ void KisFilterStrokeStrategy::cancelStrokeCallback()
     QVector<KisStrokeJobData *> jobs;
 
     jobs << new Data(toQShared(new KisDisableDirtyRequestsCommand(m_d->updatesFacade, KisDisableDirtyRequestsCommand::INITIALIZING)));
+
+    if (m_d->progressiveTransaction) {
+        /**
+         * The stroke has been cancelled in the middle of the progressive
+         * refinement, so some patches are already written into the layer
+         */
+        QSharedPointer<KisTransaction> transaction = m_d->progressiveTransaction;
+        m_d->progressiveTransaction.clear();
+
+        addJobSequential(jobs, [transaction] () {
+            transaction->revert();
+        });
+
+        QMutexLocker l(&m_d->progressiveUpdateRectLock);
+        m_d->nextExternalUpdateRect |= m_d->progressiveUpdateRect;
+        m_d->progressiveUpdateRect = QRect();
+        m_d->pendingProgressiveUpdates.clear();
+    }
     KisStrokeStrategyUndoCommandBased::cancelStrokeCallbackImpl(jobs);
     jobs << new Data(toQShared(new KisDisableDirtyRequestsCommand(m_d->updatesFacade, KisDisableDirtyRequestsCommand::FINALIZING)));
 
@@ -370,6 +498,7 @@ void KisFilterStrokeStrategy::finishStrokeCallback()
 
 KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
 {
+    if (m_d->progressiveRefinement) return 0;
     if (!m_d->filter->supportsLevelOfDetail(m_d->filterConfig.data(), levelOfDetail)) return 0;
     if (!m_d->node->supportsLodPainting()) return 0;
 
@@ -377,3 +506,18 @@ KisStrokeStrategy* KisFilterStrokeStrategy::createLodClone(int levelOfDetail)
     m_d->hasBeenLodCloned = true;
     return clone;
 }
+
+void KisFilterStrokeStrategy::setPriorityRect(const QRect &rect)
+{
+    m_d->priorityRect = rect;
+}
+
+void KisFilterStrokeStrategy::setProgressiveRefinement(bool value)
+{
+    m_d->progressiveRefinement = value;
+}
+
+bool KisFilterStrokeStrategy::hasBeenLodCloned() const
+{
+    return m_d->hasBeenLodCloned;
+}
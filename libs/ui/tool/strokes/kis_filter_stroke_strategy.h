@@ -97,6 +97,34 @@ public:
 
     KisStrokeStrategy* createLodClone(int levelOfDetail) override;
 
+    /**
+     * Patches intersecting \p rect (in image coordinates) are filtered
+     * first, the rest of them are sorted by the distance to its center.
+     * Usually, it is the visible area of the canvas.
+     */
+    void setPriorityRect(const QRect &rect);
+
+    /**
+     * Marks the stroke as a full-resolution refinement of a preview
+     * that has already been shown in LoD mode. Such stroke is never
+     * cloned into LoD and every patch is written into the layer right
+     * after it has been filtered, so the preview is refined
+     * progressively instead of appearing all at once. The written
+     * patches are updated in batches, not more often than every 40 ms.
+     *
+     * The cancelled LoD preview stays on the canvas until the patches
+     * replace it, as long as the cancellation updates are disabled in
+     * ExternalCancelUpdatesStorage. Its area is updated at the end of
+     * the refinement.
+     */
+    void setProgressiveRefinement(bool value);
+
+    /**
+     * \return true if the strokes queue has created a LoD clone of the
+     *         stroke, i.e. its preview is shown in LoD mode
+     */
+    bool hasBeenLodCloned() const;
+
 private:
     struct Private;
     Private* const m_d;
@@ -7,12 +7,36 @@
 
 #include "IccColorSpaceEngine.h"
 
+#include <QDataStream>
+
 #include <klocalizedstring.h>
 
 #include <KoColorModelStandardIds.h>
 #include <kis_assert.h>
 
 #include "LcmsColorSpace.h"
+#include "LcmsColorLut.h"
+
+namespace {
+/**
+ * The on-disk LUT cache is keyed by the profile ids, so the description
+ * is dropped if any of the profiles has no id
+ */
+QByteArray lutDescription(const QByteArray &description,
+                          const LcmsColorProfileContainer *srcProfile,
+                          const LcmsColorProfileContainer *dstProfile,
+                          const LcmsColorProfileContainer *proofingProfile = nullptr)
+{
+    if (srcProfile->getProfileUniqueId().isEmpty() ||
+        dstProfile->getProfileUniqueId().isEmpty() ||
+        (proofingProfile && proofingProfile->getProfileUniqueId().isEmpty())) {
+
+        return QByteArray();
+    }
+
+    return description;
+}
+}
 
 // -- KoLcmsColorConversionTransformation --
 
@@ -37,25 +61,52 @@ public:
         }
         conversionFlags |= KoColorConversionTransformation::CopyAlpha;
 
-        m_transform = cmsCreateTransform(srcProfile->lcmsProfile(),
-                                         srcColorSpaceType,
-                                         dstProfile->lcmsProfile(),
-                                         dstColorSpaceType,
-                                         renderingIntent,
-                                         conversionFlags);
+        const bool usePrecomputedLut = conversionFlags.testFlag(KoColorConversionTransformation::PrecomputedLut);
+        conversionFlags.setFlag(KoColorConversionTransformation::PrecomputedLut, false);
+
+        if (usePrecomputedLut) {
+            QByteArray description;
+            QDataStream stream(&description, QIODevice::WriteOnly);
+            stream << srcProfile->getProfileUniqueId() << dstProfile->getProfileUniqueId()
+                   << quint32(renderingIntent) << quint32(conversionFlags);
+
+            m_lut = LcmsColorLut::fetch(srcCs, srcColorSpaceType, dstCs, dstColorSpaceType,
+                                        conversionFlags, lutDescription(description, srcProfile, dstProfile),
+                                        [&] (quint32 srcType16, quint32 dstType16) {
+                                            return cmsCreateTransform(srcProfile->lcmsProfile(), srcType16,
+                                                                      dstProfile->lcmsProfile(), dstType16,
+                                                                      renderingIntent, conversionFlags);
+                                        });
+        }
+
+        if (!m_lut) {
+            m_transform = cmsCreateTransform(srcProfile->lcmsProfile(),
+                                             srcColorSpaceType,
+                                             dstProfile->lcmsProfile(),
+                                             dstColorSpaceType,
+                                             renderingIntent,
+                                             conversionFlags);
 
-        Q_ASSERT(m_transform);
+            Q_ASSERT(m_transform);
+        }
     }
 
     ~KoLcmsColorConversionTransformation() override
     {
-        cmsDeleteTransform(m_transform);
+        if (m_transform) {
+            cmsDeleteTransform(m_transform);
+        }
     }
 
 public:
 
     void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override
     {
+        if (m_lut) {
+            m_lut->transform(src, dst, numPixels);
+            return;
+        }
+
         Q_ASSERT(m_transform);
 
         cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
@@ -63,6 +114,7 @@ public:
     }
 private:
     mutable cmsHTRANSFORM m_transform;
+    QSharedPointer<LcmsColorLut> m_lut;
 };
 
 class KoLcmsColorProofingConversionTransformation : public KoColorProofingConversionTransformation
@@ -95,6 +147,9 @@ public:
         }
         conversionFlags |= KoColorConversionTransformation::CopyAlpha;
 
+        const bool usePrecomputedLut = conversionFlags.testFlag(KoColorConversionTransformation::PrecomputedLut);
+        conversionFlags.setFlag(KoColorConversionTransformation::PrecomputedLut, false);
+
         quint16 alarm[cmsMAXCHANNELS];//this seems to be bgr???
         alarm[0] = (cmsUInt16Number)gamutWarning[2]*256;
         alarm[1] = (cmsUInt16Number)gamutWarning[1]*256;
@@ -103,28 +158,58 @@ public:
         cmsSetAdaptationState(adaptationState);
 
         KIS_ASSERT(dynamic_cast<const IccColorProfile *>(proofingSpace->profile()));
-        m_transform = cmsCreateProofingTransform(srcProfile->lcmsProfile(),
-                                                 srcColorSpaceType,
-                                                 dstProfile->lcmsProfile(),
-                                                 dstColorSpaceType,
-                                                 dynamic_cast<const IccColorProfile *>(proofingSpace->profile())->asLcms()->lcmsProfile(),
-                                                 renderingIntent,
-                                                 proofingIntent,
-                                                 conversionFlags);
-        cmsSetAdaptationState(1);
+        LcmsColorProfileContainer *proofingProfile = dynamic_cast<const IccColorProfile *>(proofingSpace->profile())->asLcms();
+
+        if (usePrecomputedLut) {
+            QByteArray description;
+            QDataStream stream(&description, QIODevice::WriteOnly);
+            stream << srcProfile->getProfileUniqueId() << dstProfile->getProfileUniqueId()
+                   << proofingProfile->getProfileUniqueId()
+                   << quint32(renderingIntent) << quint32(proofingIntent) << quint32(conversionFlags)
+                   << alarm[0] << alarm[1] << alarm[2] << adaptationState;
+
+            m_lut = LcmsColorLut::fetch(srcCs, srcColorSpaceType, dstCs, dstColorSpaceType,
+                                        conversionFlags, lutDescription(description, srcProfile, dstProfile, proofingProfile),
+                                        [&] (quint32 srcType16, quint32 dstType16) {
+                                            return cmsCreateProofingTransform(srcProfile->lcmsProfile(), srcType16,
+                                                                              dstProfile->lcmsProfile(), dstType16,
+                                                                              proofingProfile->lcmsProfile(),
+                                                                              renderingIntent, proofingIntent,
+                                                                              conversionFlags);
+                                        });
+        }
 
-        Q_ASSERT(m_transform);
+        if (!m_lut) {
+            m_transform = cmsCreateProofingTransform(srcProfile->lcmsProfile(),
+                                                     srcColorSpaceType,
+                                                     dstProfile->lcmsProfile(),
+                                                     dstColorSpaceType,
+                                                     proofingProfile->lcmsProfile(),
+                                                     renderingIntent,
+                                                     proofingIntent,
+                                                     conversionFlags);
+
+            Q_ASSERT(m_transform);
+        }
+        cmsSetAdaptationState(1);
     }
 
     ~KoLcmsColorProofingConversionTransformation() override
     {
-        cmsDeleteTransform(m_transform);
+        if (m_transform) {
+            cmsDeleteTransform(m_transform);
+        }
     }
 
 public:
 
     void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const override
     {
+        if (m_lut) {
+            m_lut->transform(src, dst, numPixels);
+            return;
+        }
+
         Q_ASSERT(m_transform);
 
         cmsDoTransform(m_transform, const_cast<quint8 *>(src), dst, numPixels);
@@ -132,6 +217,7 @@ public:
     }
 private:
     mutable cmsHTRANSFORM m_transform;
+    QSharedPointer<LcmsColorLut> m_lut;
 };
 
 struct IccColorSpaceEngine::Private {
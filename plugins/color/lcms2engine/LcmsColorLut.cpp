@@ -0,0 +1,414 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include "LcmsColorLut.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QWeakPointer>
+
+#include <KoChannelInfo.h>
+#include <KoColorLutInterpolatorBase.h>
+#include <KoColorLutInterpolatorFactory.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <DebugPigment.h>
+#include <kis_assert.h>
+
+namespace {
+const quint32 lutFileMagic = 0x4B4C5554; // "KLUT"
+const quint32 lutFileVersion = 1;
+
+// number of pixels converted in one pass of the interpolator,
+// the planar buffers for them fit into L1 cache
+const int lutChunkSize = 256;
+
+quint32 toType16(quint32 type)
+{
+    return (type & ~quint32(0x7)) | BYTES_SH(2);
+}
+
+QMutex s_lutCacheMutex;
+QHash<QByteArray, QWeakPointer<LcmsColorLut>> s_lutCache;
+}
+
+LcmsColorLut::ChannelLayout LcmsColorLut::ChannelLayout::fromColorSpace(const KoColorSpace *cs)
+{
+    ChannelLayout layout;
+
+    const QList<KoChannelInfo *> channels = cs->channels();
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(!channels.isEmpty(), layout);
+
+    layout.pixelSize = cs->pixelSize();
+    layout.channelSize = channels.first()->size();
+
+    Q_FOREACH (const KoChannelInfo *channel, channels) {
+        const int index = channel->pos() / channel->size();
+
+        if (channel->channelType() == KoChannelInfo::ALPHA) {
+            layout.alphaPos = index;
+        } else {
+            layout.colorPos.push_back(index);
+        }
+    }
+
+    std::sort(layout.colorPos.begin(), layout.colorPos.end());
+
+    return layout;
+}
+
+LcmsColorLut::LcmsColorLut(const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, int gridSize)
+    : m_srcLayout(srcLayout)
+    , m_dstLayout(dstLayout)
+    , m_gridSize(gridSize)
+    , m_interpolator(KoColorLutInterpolatorFactory::create())
+{
+}
+
+LcmsColorLut::~LcmsColorLut()
+{
+}
+
+bool LcmsColorLut::isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs)
+{
+    auto isIntegerDepth = [] (const KoColorSpace *cs) {
+        return cs->colorDepthId() == Integer8BitsColorDepthID ||
+               cs->colorDepthId() == Integer16BitsColorDepthID;
+    };
+
+    if (!isIntegerDepth(srcCs) || !isIntegerDepth(dstCs)) {
+        return false;
+    }
+
+    const ChannelLayout srcLayout = ChannelLayout::fromColorSpace(srcCs);
+    const ChannelLayout dstLayout = ChannelLayout::fromColorSpace(dstCs);
+
+    return (srcLayout.colorPos.size() == 3 || srcLayout.colorPos.size() == 4) &&
+           !dstLayout.colorPos.empty() &&
+           dstLayout.colorPos.size() <= size_t(KoColorLutInterpolatorBase::nodeStride);
+}
+
+int LcmsColorLut::gridSizeFor(int numInputChannels, KoColorConversionTransformation::ConversionFlags flags)
+{
+    // the defaults are close to the grids LCMS picks for its own optimized
+    // pipelines, the 4D tables grow too fast to go much higher
+    if (numInputChannels == 4) {
+        return flags.testFlag(KoColorConversionTransformation::HighQuality) ? 25 :
+               flags.testFlag(KoColorConversionTransformation::LowQuality) ? 9 : 17;
+    }
+
+    return flags.testFlag(KoColorConversionTransformation::HighQuality) ? 65 :
+           flags.testFlag(KoColorConversionTransformation::LowQuality) ? 17 : 33;
+}
+
+QString LcmsColorLut::cacheLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/colorluts");
+}
+
+QSharedPointer<LcmsColorLut> LcmsColorLut::fetch(const KoColorSpace *srcCs, quint32 srcType,
+                                                 const KoColorSpace *dstCs, quint32 dstType,
+                                                 KoColorConversionTransformation::ConversionFlags flags,
+                                                 const QByteArray &description,
+                                                 TransformFactory createTransform)
+{
+    if (!isSupported(srcCs, dstCs)) {
+        return QSharedPointer<LcmsColorLut>();
+    }
+
+    const ChannelLayout srcLayout = ChannelLayout::fromColorSpace(srcCs);
+    const ChannelLayout dstLayout = ChannelLayout::fromColorSpace(dstCs);
+    const int gridSize = gridSizeFor(int(srcLayout.colorPos.size()), flags);
+
+    const quint32 srcType16 = toType16(srcType);
+    const quint32 dstType16 = toType16(dstType);
+
+    QByteArray key;
+
+    if (!description.isEmpty()) {
+        QByteArray fullDescription;
+        QDataStream stream(&fullDescription, QIODevice::WriteOnly);
+        stream << lutFileVersion << description << srcType16 << dstType16 << gridSize;
+
+        key = QCryptographicHash::hash(fullDescription, QCryptographicHash::Md5).toHex();
+    }
+
+    if (!key.isEmpty()) {
+        QMutexLocker l(&s_lutCacheMutex);
+
+        QSharedPointer<LcmsColorLut> cachedLut = s_lutCache.value(key).toStrongRef();
+        if (cachedLut) {
+            return cachedLut;
+        }
+    }
+
+    /**
+     * Baking a 4D table takes a noticeable time, so it is done without
+     * holding the mutex; otherwise all the conversions in the process
+     * would wait for it. Two threads may bake the same table at the same
+     * time, then the table of the first one to finish is shared.
+     */
+    QSharedPointer<LcmsColorLut> lut(new LcmsColorLut(srcLayout, dstLayout, gridSize));
+
+    const QString fileName = !key.isEmpty() ?
+        cacheLocation() + QLatin1Char('/') + QString::fromLatin1(key) + QStringLiteral(".lut") :
+        QString();
+
+    if (fileName.isEmpty() || !lut->load(fileName)) {
+        cmsHTRANSFORM transform16 = createTransform(srcType16, dstType16);
+        if (!transform16) {
+            return QSharedPointer<LcmsColorLut>();
+        }
+
+        const bool result = lut->bake(transform16);
+        cmsDeleteTransform(transform16);
+
+        if (!result) {
+            return QSharedPointer<LcmsColorLut>();
+        }
+
+        if (!fileName.isEmpty()) {
+            lut->save(fileName);
+        }
+    }
+
+    if (!key.isEmpty()) {
+        QMutexLocker l(&s_lutCacheMutex);
+
+        QSharedPointer<LcmsColorLut> cachedLut = s_lutCache.value(key).toStrongRef();
+        if (cachedLut) {
+            return cachedLut;
+        }
+
+        s_lutCache.insert(key, lut);
+    }
+
+    return lut;
+}
+
+bool LcmsColorLut::bake(cmsHTRANSFORM transform16)
+{
+    const int numInputs = numInputChannels();
+    const int numOutputs = numOutputChannels();
+    const int numSrcChannels = m_srcLayout.pixelSize / m_srcLayout.channelSize;
+    const int numDstChannels = m_dstLayout.pixelSize / m_dstLayout.channelSize;
+
+    int numNodes = 1;
+    for (int i = 0; i < numInputs; i++) {
+        numNodes *= m_gridSize;
+    }
+
+    std::vector<quint16> srcPixels(size_t(numNodes) * numSrcChannels, 0);
+    std::vector<quint16> dstPixels(size_t(numNodes) * numDstChannels, 0);
+
+    // the first input is the outermost axis of a 3D slice, 4D tables
+    // are stacked along the fourth input, see KoColorLutInterpolatorBase
+    const int axisOrder3D[] = {2, 1, 0};
+    const int axisOrder4D[] = {2, 1, 0, 3};
+    const int *axisOrder = numInputs == 4 ? axisOrder4D : axisOrder3D;
+
+    for (int node = 0; node < numNodes; node++) {
+        quint16 *pixel = srcPixels.data() + size_t(node) * numSrcChannels;
+
+        int rest = node;
+        for (int i = 0; i < numInputs; i++) {
+            const int index = rest % m_gridSize;
+            rest /= m_gridSize;
+
+            pixel[m_srcLayout.colorPos[axisOrder[i]]] = quint16(qRound(index * 65535.0 / (m_gridSize - 1)));
+        }
+
+        if (m_srcLayout.alphaPos >= 0) {
+            pixel[m_srcLayout.alphaPos] = 0xFFFF;
+        }
+    }
+
+    cmsDoTransform(transform16, srcPixels.data(), dstPixels.data(), cmsUInt32Number(numNodes));
+
+    m_table.assign(size_t(numNodes) * KoColorLutInterpolatorBase::nodeStride, 0.0f);
+
+    for (int node = 0; node < numNodes; node++) {
+        const quint16 *pixel = dstPixels.data() + size_t(node) * numDstChannels;
+        float *tableNode = m_table.data() + size_t(node) * KoColorLutInterpolatorBase::nodeStride;
+
+        for (int i = 0; i < numOutputs; i++) {
+            tableNode[i] = pixel[m_dstLayout.colorPos[i]] / 65535.0f;
+        }
+    }
+
+    return true;
+}
+
+bool LcmsColorLut::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 gridSize = 0;
+    qint32 numInputs = 0;
+    qint32 numOutputs = 0;
+    quint32 tableSize = 0;
+
+    stream >> magic >> version >> gridSize >> numInputs >> numOutputs >> tableSize;
+
+    if (stream.status() != QDataStream::Ok ||
+        magic != lutFileMagic || version != lutFileVersion ||
+        gridSize != m_gridSize ||
+        numInputs != numInputChannels() ||
+        numOutputs != numOutputChannels()) {
+
+        warnPigment << "LcmsColorLut: ignoring incompatible cached LUT" << fileName;
+        return false;
+    }
+
+    size_t expectedSize = KoColorLutInterpolatorBase::nodeStride;
+    for (int i = 0; i < numInputs; i++) {
+        expectedSize *= size_t(gridSize);
+    }
+
+    if (tableSize != expectedSize) {
+        warnPigment << "LcmsColorLut: ignoring corrupted cached LUT" << fileName;
+        return false;
+    }
+
+    std::vector<float> table(expectedSize);
+    const int numBytes = int(expectedSize * sizeof(float));
+
+    if (stream.readRawData(reinterpret_cast<char*>(table.data()), numBytes) != numBytes) {
+        warnPigment << "LcmsColorLut: ignoring truncated cached LUT" << fileName;
+        return false;
+    }
+
+    m_table.swap(table);
+    return true;
+}
+
+void LcmsColorLut::save(const QString &fileName) const
+{
+    if (!QDir().mkpath(cacheLocation())) {
+        return;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << lutFileMagic << lutFileVersion
+           << qint32(m_gridSize)
+           << qint32(numInputChannels())
+           << qint32(numOutputChannels())
+           << quint32(m_table.size());
+
+    stream.writeRawData(reinterpret_cast<const char*>(m_table.data()), int(m_table.size() * sizeof(float)));
+
+    if (!file.commit()) {
+        warnPigment << "LcmsColorLut: failed to save LUT to the cache" << fileName;
+    }
+}
+
+template<typename src_channel_type, typename dst_channel_type>
+void LcmsColorLut::transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    const int numInputs = numInputChannels();
+    const int numOutputs = numOutputChannels();
+    const int numSrcChannels = m_srcLayout.pixelSize / int(sizeof(src_channel_type));
+    const int numDstChannels = m_dstLayout.pixelSize / int(sizeof(dst_channel_type));
+
+    const float srcScale = 1.0f / std::numeric_limits<src_channel_type>::max();
+    const float dstUnit = std::numeric_limits<dst_channel_type>::max();
+
+    alignas(64) float input[KoColorLutInterpolatorBase::nodeStride][lutChunkSize];
+    alignas(64) float output[KoColorLutInterpolatorBase::nodeStride][lutChunkSize];
+
+    const float *srcPlanes[] = {input[0], input[1], input[2], input[3]};
+    float *dstPlanes[] = {output[0], output[1], output[2], output[3]};
+
+    const src_channel_type *srcPtr = reinterpret_cast<const src_channel_type*>(src);
+    dst_channel_type *dstPtr = reinterpret_cast<dst_channel_type*>(dst);
+
+    for (qint32 offset = 0; offset < numPixels; offset += lutChunkSize) {
+        const int chunkSize = std::min(lutChunkSize, int(numPixels - offset));
+
+        for (int i = 0; i < chunkSize; i++) {
+            for (int ch = 0; ch < numInputs; ch++) {
+                input[ch][i] = srcPtr[i * numSrcChannels + m_srcLayout.colorPos[ch]] * srcScale;
+            }
+        }
+
+        if (numInputs == 4) {
+            m_interpolator->interpolate4D(m_table.data(), m_gridSize, srcPlanes, dstPlanes, numOutputs, chunkSize);
+        } else {
+            m_interpolator->interpolate3D(m_table.data(), m_gridSize, srcPlanes, dstPlanes, numOutputs, chunkSize);
+        }
+
+        for (int i = 0; i < chunkSize; i++) {
+            dst_channel_type *pixel = dstPtr + i * numDstChannels;
+
+            for (int ch = 0; ch < numOutputs; ch++) {
+                pixel[m_dstLayout.colorPos[ch]] = dst_channel_type(qBound(0.0f, output[ch][i], 1.0f) * dstUnit + 0.5f);
+            }
+
+            if (m_dstLayout.alphaPos >= 0) {
+                pixel[m_dstLayout.alphaPos] = m_srcLayout.alphaPos >= 0 ?
+                    dst_channel_type(srcPtr[i * numSrcChannels + m_srcLayout.alphaPos] * srcScale * dstUnit + 0.5f) :
+                    std::numeric_limits<dst_channel_type>::max();
+            }
+        }
+
+        srcPtr += chunkSize * numSrcChannels;
+        dstPtr += chunkSize * numDstChannels;
+    }
+}
+
+void LcmsColorLut::transform(const quint8 *src, quint8 *dst, qint32 numPixels) const
+{
+    if (m_srcLayout.channelSize == 1) {
+        if (m_dstLayout.channelSize == 1) {
+            transformImpl<quint8, quint8>(src, dst, numPixels);
+        } else {
+            transformImpl<quint8, quint16>(src, dst, numPixels);
+        }
+    } else {
+        if (m_dstLayout.channelSize == 1) {
+            transformImpl<quint16, quint8>(src, dst, numPixels);
+        } else {
+            transformImpl<quint16, quint16>(src, dst, numPixels);
+        }
+    }
+}
+
+int LcmsColorLut::gridSize() const
+{
+    return m_gridSize;
+}
+
+int LcmsColorLut::numInputChannels() const
+{
+    return int(m_srcLayout.colorPos.size());
+}
+
+int LcmsColorLut::numOutputChannels() const
+{
+    return int(m_dstLayout.colorPos.size());
+}
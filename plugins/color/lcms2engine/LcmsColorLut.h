@@ -0,0 +1,116 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef LCMSCOLORLUT_H
+#define LCMSCOLORLUT_H
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+#include <lcms2.h>
+
+#include <KoColorConversionTransformation.h>
+
+class KoColorSpace;
+class KoColorLutInterpolatorBase;
+
+/**
+ * A color conversion baked into a 3D (or 4D for four-channel sources,
+ * like CMYK) lookup table.
+ *
+ * CMYK and LUT-based ICC profiles make LCMS transforms very slow. For such
+ * profile pairs the conversion can be sampled once on a regular grid and
+ * then evaluated with tetrahedral interpolation by a SIMD kernel. The
+ * table is sampled with a 16-bit LCMS transform that has the same
+ * profiles, intents and flags as the original one, so soft-proofing
+ * transforms can be baked exactly the same way.
+ *
+ * Baked tables are shared between all the transformations in the process
+ * and are cached on disk, keyed by the MD5 of the description of the
+ * transform (which includes the MD5 ids of the profiles).
+ *
+ * Only 8- and 16-bit integer color spaces with three or four color
+ * channels in the source and at most four color channels in the
+ * destination are supported, use isSupported() to check it.
+ */
+class LcmsColorLut
+{
+public:
+    /**
+     * Creates an LCMS transform for the given 16-bit pixel formats
+     */
+    using TransformFactory = std::function<cmsHTRANSFORM(quint32 srcType16, quint32 dstType16)>;
+
+    ~LcmsColorLut();
+
+    static bool isSupported(const KoColorSpace *srcCs, const KoColorSpace *dstCs);
+
+    /**
+     * @return the number of grid nodes per input axis that is used for
+     * \p numInputChannels inputs and the quality requested by \p flags
+     */
+    static int gridSizeFor(int numInputChannels, KoColorConversionTransformation::ConversionFlags flags);
+
+    /**
+     * Returns a LUT for the conversion. The table is looked up in the
+     * in-memory and on-disk caches first; if it is not found there, it
+     * is baked with a transform created by \p createTransform.
+     *
+     * \p description should identify the transform uniquely: profile ids,
+     * intents, flags, proofing parameters. If it is empty, the on-disk
+     * cache is not used.
+     *
+     * @return null if the conversion cannot be baked
+     */
+    static QSharedPointer<LcmsColorLut> fetch(const KoColorSpace *srcCs, quint32 srcType,
+                                              const KoColorSpace *dstCs, quint32 dstType,
+                                              KoColorConversionTransformation::ConversionFlags flags,
+                                              const QByteArray &description,
+                                              TransformFactory createTransform);
+
+    void transform(const quint8 *src, quint8 *dst, qint32 numPixels) const;
+
+    int gridSize() const;
+    int numInputChannels() const;
+    int numOutputChannels() const;
+
+    /**
+     * The location of the on-disk cache
+     */
+    static QString cacheLocation();
+
+private:
+    struct ChannelLayout {
+        int pixelSize = 0;
+        int channelSize = 0;
+        int alphaPos = -1;
+        std::vector<int> colorPos;
+
+        static ChannelLayout fromColorSpace(const KoColorSpace *cs);
+    };
+
+    LcmsColorLut(const ChannelLayout &srcLayout, const ChannelLayout &dstLayout, int gridSize);
+
+    bool bake(cmsHTRANSFORM transform16);
+    bool load(const QString &fileName);
+    void save(const QString &fileName) const;
+
+    template<typename src_channel_type, typename dst_channel_type>
+    void transformImpl(const quint8 *src, quint8 *dst, qint32 numPixels) const;
+
+private:
+    ChannelLayout m_srcLayout;
+    ChannelLayout m_dstLayout;
+    int m_gridSize;
+    std::vector<float> m_table;
+    QScopedPointer<KoColorLutInterpolatorBase> m_interpolator;
+};
+
+#endif // LCMSCOLORLUT_H
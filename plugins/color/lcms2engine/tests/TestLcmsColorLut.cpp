@@ -0,0 +1,276 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "TestLcmsColorLut.h"
+
+#include <cmath>
+#include <vector>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QStandardPaths>
+
+#include <KoChannelInfo.h>
+#include <KoColorConversionTransformation.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <kis_global.h>
+#include <simpletest.h>
+
+namespace {
+const int numTestPixels = 64 * 1024;
+
+std::vector<quint8> randomPixels(const KoColorSpace *cs, int numPixels)
+{
+    QRandomGenerator random(1234);
+
+    std::vector<quint8> pixels(size_t(numPixels) * cs->pixelSize());
+    for (quint8 &byte : pixels) {
+        byte = quint8(random.bounded(256));
+    }
+
+    // keep alpha opaque, so that the colors are compared fairly
+    for (int i = 0; i < numPixels; i++) {
+        cs->setOpacity(pixels.data() + i * cs->pixelSize(), OPACITY_OPAQUE_U8, 1);
+    }
+
+    return pixels;
+}
+
+/**
+ * Max and mean CIE76 deltaE between two buffers in \p cs
+ */
+QPair<qreal, qreal> deltaE(const KoColorSpace *cs, const quint8 *first, const quint8 *second, int numPixels)
+{
+    const KoColorSpace *lab = KoColorSpaceRegistry::instance()->colorSpace(LABAColorModelID.id(), Float32BitsColorDepthID.id(), 0);
+
+    std::vector<float> firstLab(size_t(numPixels) * 4);
+    std::vector<float> secondLab(size_t(numPixels) * 4);
+
+    cs->convertPixelsTo(first, reinterpret_cast<quint8*>(firstLab.data()), lab, numPixels,
+                        KoColorConversionTransformation::IntentAbsoluteColorimetric,
+                        KoColorConversionTransformation::NoOptimization);
+    cs->convertPixelsTo(second, reinterpret_cast<quint8*>(secondLab.data()), lab, numPixels,
+                        KoColorConversionTransformation::IntentAbsoluteColorimetric,
+                        KoColorConversionTransformation::NoOptimization);
+
+    qreal maxDeltaE = 0.0;
+    qreal sumDeltaE = 0.0;
+
+    for (int i = 0; i < numPixels; i++) {
+        const float *f = firstLab.data() + i * 4;
+        const float *s = secondLab.data() + i * 4;
+
+        const qreal value = std::sqrt(pow2(f[0] - s[0]) + pow2(f[1] - s[1]) + pow2(f[2] - s[2]));
+        maxDeltaE = qMax(maxDeltaE, value);
+        sumDeltaE += value;
+    }
+
+    return qMakePair(maxDeltaE, sumDeltaE / numPixels);
+}
+
+/**
+ * The location of the on-disk cache of LcmsColorLut, the test
+ * cannot call into the plugin directly
+ */
+QString lutCacheLocation()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/colorluts");
+}
+
+QStringList cachedLutFiles()
+{
+    return QDir(lutCacheLocation()).entryList({QStringLiteral("*.lut")}, QDir::Files);
+}
+}
+
+void TestLcmsColorLut::initTestCase()
+{
+    // the baked tables are cached on disk
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(lutCacheLocation()).removeRecursively();
+}
+
+void TestLcmsColorLut::testLutAccuracy_data()
+{
+    QTest::addColumn<QString>("srcModel");
+    QTest::addColumn<QString>("srcDepth");
+    QTest::addColumn<QString>("dstModel");
+    QTest::addColumn<QString>("dstDepth");
+    QTest::addColumn<qreal>("maxDeltaE");
+    QTest::addColumn<qreal>("meanDeltaE");
+
+    // the 4D tables of CMYK sources have a much coarser grid
+    QTest::addRow("rgb8-cmyk8") << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << CMYKAColorModelID.id() << Integer8BitsColorDepthID.id() << 2.0 << 0.3;
+    QTest::addRow("cmyk8-rgb8") << CMYKAColorModelID.id() << Integer8BitsColorDepthID.id() << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << 3.0 << 0.5;
+    QTest::addRow("rgb16-cmyk16") << RGBAColorModelID.id() << Integer16BitsColorDepthID.id() << CMYKAColorModelID.id() << Integer16BitsColorDepthID.id() << 2.0 << 0.3;
+    QTest::addRow("cmyk16-rgb8") << CMYKAColorModelID.id() << Integer16BitsColorDepthID.id() << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << 3.0 << 0.5;
+    QTest::addRow("rgb8-lab16") << RGBAColorModelID.id() << Integer8BitsColorDepthID.id() << LABAColorModelID.id() << Integer16BitsColorDepthID.id() << 1.0 << 0.2;
+}
+
+void TestLcmsColorLut::testLutAccuracy()
+{
+    QFETCH(QString, srcModel);
+    QFETCH(QString, srcDepth);
+    QFETCH(QString, dstModel);
+    QFETCH(QString, dstDepth);
+    QFETCH(qreal, maxDeltaE);
+    QFETCH(qreal, meanDeltaE);
+
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->colorSpace(srcModel, srcDepth, 0);
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(dstModel, dstDepth, 0);
+    QVERIFY(srcCs);
+    QVERIFY(dstCs);
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::IntentPerceptual;
+    const KoColorConversionTransformation::ConversionFlags flags = KoColorConversionTransformation::BlackpointCompensation;
+
+    QScopedPointer<KoColorConversionTransformation> lcmsTransform(
+        srcCs->createColorConverter(dstCs, intent, flags));
+    const int numCachedLuts = cachedLutFiles().size();
+
+    QScopedPointer<KoColorConversionTransformation> lutTransform(
+        srcCs->createColorConverter(dstCs, intent, flags | KoColorConversionTransformation::PrecomputedLut));
+
+    // the conversion is supported, so it must have been baked
+    QCOMPARE(cachedLutFiles().size(), numCachedLuts + 1);
+
+    const std::vector<quint8> src = randomPixels(srcCs, numTestPixels);
+    std::vector<quint8> lcmsResult(size_t(numTestPixels) * dstCs->pixelSize());
+    std::vector<quint8> lutResult(size_t(numTestPixels) * dstCs->pixelSize());
+
+    lcmsTransform->transform(src.data(), lcmsResult.data(), numTestPixels);
+    lutTransform->transform(src.data(), lutResult.data(), numTestPixels);
+
+    const QPair<qreal, qreal> error = deltaE(dstCs, lcmsResult.data(), lutResult.data(), numTestPixels);
+    qDebug() << "max deltaE:" << error.first << "mean deltaE:" << error.second;
+
+    QVERIFY(error.first < maxDeltaE);
+    QVERIFY(error.second < meanDeltaE);
+
+    // the second transformation reuses the baked table
+    QScopedPointer<KoColorConversionTransformation> cachedLutTransform(
+        srcCs->createColorConverter(dstCs, intent, flags | KoColorConversionTransformation::PrecomputedLut));
+
+    std::vector<quint8> cachedLutResult(size_t(numTestPixels) * dstCs->pixelSize());
+    cachedLutTransform->transform(src.data(), cachedLutResult.data(), numTestPixels);
+
+    QVERIFY(cachedLutResult == lutResult);
+}
+
+void TestLcmsColorLut::testProofingLutAccuracy()
+{
+    const KoColorSpace *rgbCs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *proofingCs = KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+    QVERIFY(proofingCs);
+
+    quint8 gamutWarning[] = {0, 255, 0, 255};
+
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::IntentRelativeColorimetric;
+    const KoColorConversionTransformation::ConversionFlags flags =
+        KoColorConversionTransformation::SoftProofing | KoColorConversionTransformation::BlackpointCompensation;
+
+    QScopedPointer<KoColorConversionTransformation> lcmsTransform(
+        rgbCs->createProofingTransform(rgbCs, proofingCs, intent, intent, flags, gamutWarning, 1.0));
+    QScopedPointer<KoColorConversionTransformation> lutTransform(
+        rgbCs->createProofingTransform(rgbCs, proofingCs, intent, intent,
+                                       flags | KoColorConversionTransformation::PrecomputedLut,
+                                       gamutWarning, 1.0));
+
+    const std::vector<quint8> src = randomPixels(rgbCs, numTestPixels);
+    std::vector<quint8> lcmsResult(size_t(numTestPixels) * rgbCs->pixelSize());
+    std::vector<quint8> lutResult(size_t(numTestPixels) * rgbCs->pixelSize());
+
+    lcmsTransform->transform(src.data(), lcmsResult.data(), numTestPixels);
+    lutTransform->transform(src.data(), lutResult.data(), numTestPixels);
+
+    const QPair<qreal, qreal> error = deltaE(rgbCs, lcmsResult.data(), lutResult.data(), numTestPixels);
+    qDebug() << "max deltaE:" << error.first << "mean deltaE:" << error.second;
+
+    QVERIFY(error.first < 3.0);
+    QVERIFY(error.second < 0.5);
+}
+
+void TestLcmsColorLut::testLutIsUsed()
+{
+    const KoColorSpace *srcCs = KoColorSpaceRegistry::instance()->rgb8();
+    const KoColorSpace *dstCs = KoColorSpaceRegistry::instance()->colorSpace(CMYKAColorModelID.id(), Integer8BitsColorDepthID.id(), 0);
+    QVERIFY(dstCs);
+
+    // the intent is not used by the other tests, so the table is baked anew
+    const KoColorConversionTransformation::Intent intent = KoColorConversionTransformation::IntentSaturation;
+    const KoColorConversionTransformation::ConversionFlags flags =
+        KoColorConversionTransformation::BlackpointCompensation | KoColorConversionTransformation::PrecomputedLut;
+
+    const QStringList oldFiles = cachedLutFiles();
+
+    // bake the table and drop it from the in-memory cache
+    delete srcCs->createColorConverter(dstCs, intent, flags);
+
+    QStringList newFiles = cachedLutFiles();
+    Q_FOREACH (const QString &fileName, oldFiles) {
+        newFiles.removeOne(fileName);
+    }
+    QCOMPARE(newFiles.size(), 1);
+
+    /**
+     * Zero the nodes of the cached table: if the transformation really
+     * goes through the table, all the color channels of the result are
+     * zero, which LCMS would never produce for random colors
+     */
+    {
+        QFile file(lutCacheLocation() + QLatin1Char('/') + newFiles.first());
+        QVERIFY(file.open(QIODevice::ReadWrite));
+
+        QDataStream stream(&file);
+
+        quint32 magic = 0;
+        quint32 version = 0;
+        qint32 gridSize = 0;
+        qint32 numInputs = 0;
+        qint32 numOutputs = 0;
+        quint32 tableSize = 0;
+
+        stream >> magic >> version >> gridSize >> numInputs >> numOutputs >> tableSize;
+        QCOMPARE(stream.status(), QDataStream::Ok);
+        QCOMPARE(numInputs, 3);
+        QCOMPARE(numOutputs, 4);
+
+        const QByteArray zeroes(int(tableSize * sizeof(float)), 0);
+        QVERIFY(file.seek(file.pos()));
+        QCOMPARE(file.write(zeroes), qint64(zeroes.size()));
+    }
+
+    QScopedPointer<KoColorConversionTransformation> lutTransform(
+        srcCs->createColorConverter(dstCs, intent, flags));
+
+    const std::vector<quint8> src = randomPixels(srcCs, numTestPixels);
+    std::vector<quint8> lutResult(size_t(numTestPixels) * dstCs->pixelSize(), 0xFF);
+
+    lutTransform->transform(src.data(), lutResult.data(), numTestPixels);
+
+    for (int i = 0; i < numTestPixels; i++) {
+        const quint8 *pixel = lutResult.data() + i * dstCs->pixelSize();
+
+        Q_FOREACH (const KoChannelInfo *channel, dstCs->channels()) {
+            if (channel->channelType() == KoChannelInfo::COLOR) {
+                QCOMPARE(pixel[channel->pos()], quint8(0));
+            } else {
+                QCOMPARE(pixel[channel->pos()], OPACITY_OPAQUE_U8);
+            }
+        }
+    }
+
+    // the poisoned table must not leak into the other tests
+    lutTransform.reset();
+    QFile::remove(lutCacheLocation() + QLatin1Char('/') + newFiles.first());
+}
+
+SIMPLE_TEST_MAIN(TestLcmsColorLut)
@@ -0,0 +1,26 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef TESTLCMSCOLORLUT_H
+#define TESTLCMSCOLORLUT_H
+
+#include <QObject>
+
+class TestLcmsColorLut : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void testLutAccuracy_data();
+    void testLutAccuracy();
+
+    void testProofingLutAccuracy();
+
+    void testLutIsUsed();
+};
+
+#endif
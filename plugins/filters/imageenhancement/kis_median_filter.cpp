@@ -0,0 +1,202 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_median_filter.h"
+
+#include <KoColorSpace.h>
+#include <KoUpdater.h>
+
+#include <kis_global.h>
+#include <widgets/kis_multi_integer_filter_widget.h>
+#include <filter/kis_filter_category_ids.h>
+#include <filter/kis_filter_configuration.h>
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+#include <krita_utils.h>
+#include <KisSlidingWindowHistogram.h>
+#include "kis_lod_transform.h"
+
+
+namespace {
+
+int scaledRadius(const KisFilterConfigurationSP config, int lod)
+{
+    KisLodTransformScalar t(lod);
+    const int radius = config ? config->getInt("radius", 2) : 2;
+    return qMax(1, qRound(t.scale(qreal(radius))));
+}
+
+}
+
+KisMedianFilter::KisMedianFilter()
+    : KisFilter(id(), FiltersCategoryEnhanceId, i18n("&Median..."))
+{
+    setSupportsPainting(true);
+    setSupportsAdjustmentLayers(true);
+    setSupportsThreading(true);
+    setSupportsLevelOfDetail(true);
+}
+
+KisConfigWidget * KisMedianFilter::createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool) const
+{
+    Q_UNUSED(dev);
+    vKisIntegerWidgetParam param;
+    param.push_back(KisIntegerWidgetParam(1, 50, 2, i18n("Radius"), "radius"));
+    param.push_back(KisIntegerWidgetParam(0, 100, 50, i18nc("the percentile of the pixels in the median filter, 50% is the median", "Percentile"), "percentile"));
+    return new KisMultiIntegerFilterWidget(id().id(), parent, id().id(), param);
+}
+
+KisFilterConfigurationSP KisMedianFilter::defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const
+{
+    KisFilterConfigurationSP config = factoryConfiguration(resourcesInterface);
+    config->setProperty("radius", 2);
+    config->setProperty("percentile", 50);
+    return config;
+}
+
+void KisMedianFilter::processImpl(KisPaintDeviceSP device,
+                                  const QRect& applyRect,
+                                  const KisFilterConfigurationSP config,
+                                  KoUpdater* progressUpdater
+                                  ) const
+{
+    Q_ASSERT(device);
+    KIS_SAFE_ASSERT_RECOVER_RETURN(config);
+
+    const int radius = scaledRadius(config, device->defaultBounds()->currentLevelOfDetail());
+    const qreal percentile = config->getInt("percentile", 50) / 100.0;
+
+    const KoColorSpace* cs = device->colorSpace();
+    const int numChannels = cs->channelCount();
+    const int alphaPos = cs->alphaPos() < quint32(numChannels) ? int(cs->alphaPos()) : -1;
+    const int numBins = 256;
+
+    /**
+     * Every channel has its own histogram sliding over the image, so
+     * the cost per pixel doesn't depend on the radius. The blocks limit
+     * the memory taken by the histograms of the columns.
+     */
+    const QSize blockSize(qMax(256, 4 * radius), qMax(64, 4 * radius));
+    const QVector<QRect> blocks = KritaUtils::splitRectIntoPatchesTight(applyRect, blockSize);
+
+    if (progressUpdater) {
+        progressUpdater->setRange(0, blocks.size());
+    }
+
+    QVector<float> channel(numChannels);
+    QVector<QVector<int>> bins(numChannels);
+    QVector<QVector<float>> values(numChannels);
+
+    for (int i = 0; i < blocks.size(); i++) {
+        const QRect &block = blocks[i];
+        const QRect srcRect = kisGrowRect(block, radius);
+        const int srcWidth = srcRect.width();
+        const int numSrcPixels = srcWidth * srcRect.height();
+
+        for (int c = 0; c < numChannels; c++) {
+            bins[c].resize(numSrcPixels);
+            values[c].resize(numSrcPixels);
+        }
+
+        /**
+         * The source and the destination may be the same device, so
+         * the pixels are read from the old data
+         */
+        KisSequentialConstIterator srcIt(device, srcRect);
+        for (int index = 0; srcIt.nextPixel(); index++) {
+            const quint8 *pixel = srcIt.oldRawData();
+            const bool isTransparent = cs->opacityU8(pixel) == 0;
+
+            cs->normalisedChannelsValue(pixel, channel);
+
+            for (int c = 0; c < numChannels; c++) {
+                values[c][index] = channel[c];
+                bins[c][index] =
+                    isTransparent || c == alphaPos ? -1 :
+                    qBound(0, int(channel[c] * (numBins - 1) + 0.5f), numBins - 1);
+            }
+        }
+
+        /**
+         * Every bin also sums the values of its pixels, so that the
+         * result is the mean of the pixels in the selected bin rather
+         * than the level of the bin. It keeps the precision of the
+         * deeper color spaces and the values outside [0, 1] of the
+         * HDR ones, which all fall into the first or the last bin.
+         */
+        std::vector<KisSlidingWindowHistogram> histograms;
+        histograms.reserve(numChannels);
+
+        for (int c = 0; c < numChannels; c++) {
+            histograms.emplace_back(c != alphaPos ? numBins : 1, c != alphaPos ? 1 : 0, srcWidth, radius);
+
+            if (c == alphaPos) continue;
+
+            for (int row = 0; row < 2 * radius + 1; row++) {
+                histograms[c].addRow(bins[c].constData() + row * srcWidth,
+                                     values[c].constData() + row * srcWidth);
+            }
+        }
+
+        KisSequentialIterator dstIt(device, block);
+
+        for (int y = 0; y < block.height(); y++) {
+            for (int c = 0; c < numChannels; c++) {
+                if (c == alphaPos) continue;
+
+                if (y > 0) {
+                    const int removedRow = (y - 1) * srcWidth;
+                    const int addedRow = (y + 2 * radius) * srcWidth;
+
+                    histograms[c].removeRow(bins[c].constData() + removedRow,
+                                            values[c].constData() + removedRow);
+                    histograms[c].addRow(bins[c].constData() + addedRow,
+                                         values[c].constData() + addedRow);
+                }
+
+                histograms[c].resetKernel();
+            }
+
+            for (int x = 0; x < block.width(); x++) {
+                const int middleIndex = (y + radius) * srcWidth + x + radius;
+
+                for (int c = 0; c < numChannels; c++) {
+                    channel[c] = values[c][middleIndex];
+
+                    if (c == alphaPos) continue;
+
+                    if (x > 0) {
+                        histograms[c].moveKernel();
+                    }
+
+                    const int bin = histograms[c].percentileBin(percentile);
+
+                    // all the pixels around are transparent
+                    if (bin < 0) continue;
+
+                    channel[c] = *histograms[c].payload(bin) / histograms[c].counts()[bin];
+                }
+
+                dstIt.nextPixel();
+                cs->fromNormalisedChannelsValue(dstIt.rawData(), channel);
+            }
+        }
+
+        if (progressUpdater) {
+            progressUpdater->setValue(i + 1);
+        }
+    }
+}
+
+QRect KisMedianFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    return kisGrowRect(rect, scaledRadius(_config, lod));
+}
+
+QRect KisMedianFilter::changedRect(const QRect & rect, const KisFilterConfigurationSP _config, int lod) const
+{
+    return neededRect(rect, _config, lod);
+}
@@ -0,0 +1,47 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_MEDIAN_FILTER_H
+#define KIS_MEDIAN_FILTER_H
+
+#include <filter/kis_filter.h>
+#include "kis_config_widget.h"
+
+/**
+ * Replaces every color channel of a pixel with the given percentile
+ * of this channel in a square window around the pixel, e.g. with the
+ * median for 50%. The alpha channel is kept as it is and transparent
+ * pixels are skipped.
+ *
+ * The percentile is searched in a histogram of 256 levels of the
+ * normalized range of the channel, and the result is the mean of the
+ * pixels falling into the found level. Therefore the result is exact
+ * for 8-bit color spaces, and deeper ones are neither posterized nor
+ * clipped to [0, 1].
+ */
+class KisMedianFilter : public KisFilter
+{
+public:
+    KisMedianFilter();
+
+    void processImpl(KisPaintDeviceSP device,
+                     const QRect& applyRect,
+                     const KisFilterConfigurationSP config,
+                     KoUpdater* progressUpdater
+                     ) const override;
+    KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
+
+    static inline KoID id() {
+        return KoID("median", i18n("Median"));
+    }
+
+    QRect changedRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+    QRect neededRect(const QRect &rect, const KisFilterConfigurationSP _config, int lod) const override;
+
+    KisFilterConfigurationSP defaultConfiguration(KisResourcesInterfaceSP resourcesInterface) const override;
+};
+
+#endif
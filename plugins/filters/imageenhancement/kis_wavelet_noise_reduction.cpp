@@ -7,8 +7,7 @@
 
 #include "kis_wavelet_noise_reduction.h"
 
-
-#include <cmath>
+#include <QSharedPointer>
 
 #include <KoUpdater.h>
 
@@ -20,6 +19,7 @@
 #include <filter/kis_filter_category_ids.h>
 #include <filter/kis_filter_configuration.h>
 #include <kis_processing_information.h>
+#include <KisRunnableStrokeJobUtils.h>
 #include "kis_global.h"
 
 KisWaveletNoiseReduction::KisWaveletNoiseReduction()
@@ -48,6 +48,24 @@ KisFilterConfigurationSP KisWaveletNoiseReduction::defaultConfiguration(KisResou
     return config;
 }
 
+namespace {
+
+std::function<void(float *coeffs, int numCoeffs)> softThresholdFunctor(const KisFilterConfigurationSP config)
+{
+    const float threshold = config->getDouble("threshold", BEST_WAVELET_THRESHOLD_VALUE);
+
+    return [threshold] (float *coeffs, int numCoeffs) {
+        for (int i = 0; i < numCoeffs; i++) {
+            const float value = coeffs[i];
+            coeffs[i] =
+                value > threshold ? value - threshold :
+                value < -threshold ? value + threshold : 0.0f;
+        }
+    };
+}
+
+}
+
 void KisWaveletNoiseReduction::processImpl(KisPaintDeviceSP device,
                                            const QRect& applyRect,
                                            const KisFilterConfigurationSP config,
@@ -57,57 +75,44 @@ void KisWaveletNoiseReduction::processImpl(KisPaintDeviceSP device,
     Q_ASSERT(device);
 
     KIS_SAFE_ASSERT_RECOVER_RETURN(config);
-    const float threshold = config->getDouble("threshold", BEST_WAVELET_THRESHOLD_VALUE);
 
     KisMathToolbox mathToolbox;
+    mathToolbox.fastWaveletFilter(device, applyRect, softThresholdFunctor(config), progressUpdater);
+}
 
-    //     dbgFilters << size <<"" << maxrectsize <<"" << srcTopLeft.x() <<"" << srcTopLeft.y();
+void KisWaveletNoiseReduction::addProcessJobs(QVector<KisRunnableStrokeJobData*> &jobs,
+                                              KisPaintDeviceSP device,
+                                              const QRect& applyRect,
+                                              const KisFilterConfigurationSP config,
+                                              KoUpdater* progressUpdater
+                                              ) const
+{
+    Q_ASSERT(device);
 
-    //     dbgFilters <<"Transforming...";
-    KisMathToolbox::KisWavelet* buff = 0;
-    KisMathToolbox::KisWavelet* wav = 0;
+    KIS_SAFE_ASSERT_RECOVER_RETURN(config);
 
-    try {
-        buff = mathToolbox.initWavelet(device, applyRect);
-    } catch (const std::bad_alloc&) {
-        if (buff) delete buff;
-        return;
+    /**
+     * The transform is global, so the filter cannot be split into
+     * patches. But the tiles of the transform are independent, except
+     * for their averages, so the rows of the tiles are processed by
+     * concurrent jobs, with one sequential job for the averages.
+     */
+    QSharedPointer<KisMathToolbox::FastWaveletFilter> filter(
+        new KisMathToolbox::FastWaveletFilter(device, applyRect, softThresholdFunctor(config), progressUpdater));
+
+    for (int row = 0; row < filter->numTileRows(); row++) {
+        KritaUtils::addJobConcurrent(jobs, [filter, row] () {
+            filter->computeTileAverages(row);
+        });
     }
-    try {
-        wav = mathToolbox.fastWaveletTransformation(device, applyRect, buff);
-    } catch (const std::bad_alloc&) {
-        if (wav) delete wav;
-        return;
-    }
-
-    float* const fin = wav->coeffs + wav->depth * pow2(wav->size);
-    float* const begin = wav->coeffs + wav->depth;
-
-    const int size = fin - begin;
-    const int progressOffset = int(std::ceil(std::log2(size / 100)));
-    const int progressMask = (1 << progressOffset) - 1;
-    const int numProgressSteps = size >> progressOffset;
-    int pointsProcessed = 0;
 
-    progressUpdater->setRange(0, numProgressSteps);
+    KritaUtils::addJobSequential(jobs, [filter] () {
+        filter->filterTileAverages();
+    });
 
-    for (float* it = begin; it < fin; it++) {
-        if (*it > threshold) {
-            *it -= threshold;
-        } else if (*it < -threshold) {
-            *it += threshold;
-        } else {
-            *it = 0.;
-        }
-
-        if (!(pointsProcessed & progressMask)) {
-            progressUpdater->setValue(pointsProcessed >> progressOffset);
-        }
-        pointsProcessed++;
+    for (int row = 0; row < filter->numTileRows(); row++) {
+        KritaUtils::addJobConcurrent(jobs, [filter, row] () {
+            filter->filterTiles(row);
+        });
     }
-
-    mathToolbox.fastWaveletUntransformation(device, applyRect, wav, buff);
-
-    delete wav;
-    delete buff;
 }
@@ -31,6 +31,12 @@ public:
                      const KisFilterConfigurationSP config,
                      KoUpdater* progressUpdater
                      ) const override;
+    void addProcessJobs(QVector<KisRunnableStrokeJobData*> &jobs,
+                        KisPaintDeviceSP device,
+                        const QRect& applyRect,
+                        const KisFilterConfigurationSP config,
+                        KoUpdater* progressUpdater
+                        ) const override;
     KisConfigWidget * createConfigurationWidget(QWidget* parent, const KisPaintDeviceSP dev, bool useForMasks) const override;
 
     static inline KoID id() {
@@ -37,31 +37,20 @@ int IndexColorPalette::numColors() const
     return colors.size();
 }
 
-LabColor IndexColorPalette::getNearestIndex(LabColor clr) const
+KisNearestColorLookup IndexColorPalette::createLookup() const
 {
-    QVector<float> diffs;
-    diffs.resize(numColors());
-    for(int i = 0; i < numColors(); ++i)
-        diffs[i] = similarity(colors[i], clr);
+    static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
 
-    int primaryColor = -1;
-    float maxDiff = std::numeric_limits<float>::min();
+    QVector<KisNearestColorLookup::Color> lookupColors;
+    lookupColors.reserve(numColors());
     for(int i = 0; i < numColors(); ++i)
-        if(diffs[i] > maxDiff) {
-            primaryColor = i;
-            maxDiff = diffs[primaryColor];
-        }
-
-    KIS_SAFE_ASSERT_RECOVER (primaryColor >= 0) {
-        LabColor color;
-        color.L = 0;
-        color.a = 0;
-        color.b = 0;
-
-        return color;
-    }
+        lookupColors.append({colors[i].L, colors[i].a, colors[i].b});
 
-    return colors[primaryColor];
+    // the nearest color has the highest similarity()
+    return KisNearestColorLookup(lookupColors,
+                                 {float(similarityFactors.L / max),
+                                  float(similarityFactors.a / max),
+                                  float(similarityFactors.b / max)});
 }
 
 QPair<int, int> IndexColorPalette::getNeighbours(int mainClr) const
@@ -11,6 +11,7 @@
 #include <QColor>
 #include <QPair>
 #include <KoColor.h>
+#include <KisNearestColorLookup.h>
 
 struct LabColor
 {
@@ -41,7 +42,7 @@ struct IndexColorPalette
     
     void mergeMostRedundantColors();
     
-    LabColor getNearestIndex(LabColor clr) const;
+    KisNearestColorLookup createLookup() const;
     int numColors() const;
     float similarity(LabColor c0, LabColor c1) const;
     QPair< int, int > getNeighbours(int mainClr) const;
@@ -87,10 +87,10 @@ KisFilterConfigurationSP KisFilterIndexColors::defaultConfiguration(KisResources
 
 KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palette, const KoColorSpace* cs, int alphaSteps)
     : m_colorSpace(cs),
-      m_psize(cs->pixelSize())
+      m_psize(cs->pixelSize()),
+      m_palette(palette),
+      m_lookup(palette.createLookup())
 {
-    m_palette = palette;
-
     static const qreal max = KoColorSpaceMathsTraits<quint16>::max;
     if(alphaSteps > 0)
     {
@@ -107,28 +107,28 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
 void KisIndexColorTransformation::transform(const quint8* src, quint8* dst, qint32 nPixels) const
 {
     if (m_palette.numColors() <= 0) {
-        memcpy(dst, src, nPixels * m_colorSpace->pixelSize());
+        memcpy(dst, src, nPixels * m_psize);
         return;
     }
 
-    union
-    {
-        quint16 laba[4];
-        LabColor lab;
-    } clr;
-    while (nPixels--)
+    m_labBuffer.resize(nPixels * 4);
+    m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(m_labBuffer.data()), nPixels);
+
+    for (qint32 i = 0; i < nPixels; ++i)
     {
-        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clr.laba), 1);
-        clr.lab = m_palette.getNearestIndex(clr.lab);
+        quint16 *laba = m_labBuffer.data() + i * 4;
+        const LabColor &clr = m_palette.colors[m_lookup.nearest(laba).index];
+        laba[0] = clr.L;
+        laba[1] = clr.a;
+        laba[2] = clr.b;
         if(m_alphaStep)
         {
-            quint16 amod = clr.laba[3] % m_alphaStep;
-            clr.laba[3] = clr.laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
+            quint16 amod = laba[3] % m_alphaStep;
+            laba[3] = laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
         }
-        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(clr.laba), dst, 1);
-        src += m_psize;
-        dst += m_psize;
     }
+
+    m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(m_labBuffer.data()), dst, nPixels);
 }
 
 #include "indexcolors.moc"
@@ -46,8 +46,10 @@ private:
     const KoColorSpace* m_colorSpace;
     quint32 m_psize;
     IndexColorPalette m_palette;
+    KisNearestColorLookup m_lookup;
     quint16 m_alphaStep;
     quint16 m_alphaHalfStep;
+    mutable QVector<quint16> m_labBuffer;
 };
 
 #endif
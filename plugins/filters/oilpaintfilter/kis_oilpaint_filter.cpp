@@ -14,6 +14,7 @@
 #include "kis_oilpaint_filter.h"
 
 #include <stdlib.h>
+#include <algorithm>
 #include <vector>
 
 #include <QPoint>
@@ -24,6 +25,7 @@
 #include <kis_debug.h>
 #include <kpluginfactory.h>
 
+#include <KoColorSpace.h>
 #include <KoUpdater.h>
 
 #include <KisDocument.h>
@@ -37,6 +39,8 @@
 #include <filter/kis_filter_configuration.h>
 #include <kis_processing_information.h>
 #include <kis_paint_device.h>
+#include <krita_utils.h>
+#include <KisSlidingWindowHistogram.h>
 #include "widgets/kis_multi_integer_filter_widget.h"
 #include <KisGlobalResourcesInterface.h>
 
@@ -44,7 +48,7 @@
 KisOilPaintFilter::KisOilPaintFilter() : KisFilter(id(), FiltersCategoryArtisticId, i18n("&Oilpaint..."))
 {
     setSupportsPainting(true);
-    setSupportsThreading(false);
+    setSupportsThreading(true);
     setSupportsAdjustmentLayers(true);
 }
 
@@ -73,116 +77,128 @@ void KisOilPaintFilter::processImpl(KisPaintDeviceSP device,
  * BrushSize        => Brush size.
  * Smoothness       => Smooth value.
  *
- * Theory           => Using MostFrequentColor function we take the main color in
- *                     a matrix and simply write at the original position.
+ * Theory           => Every pixel takes the average color of the most frequent
+ *                     intensity in a matrix with the pixel in its center.
  */
 
 void KisOilPaintFilter::OilPaint(const KisPaintDeviceSP src, KisPaintDeviceSP dst, const QRect &applyRect,
                                  int BrushSize, int Smoothness, KoUpdater* progressUpdater) const
 {
-    KisSequentialConstIteratorProgress it(src, applyRect, progressUpdater);
-    KisSequentialIterator dstIt(dst, applyRect);
-
-    while (it.nextPixel() && dstIt.nextPixel()) {
-        MostFrequentColor(src, dstIt.rawData(), applyRect, it.x(), it.y(), BrushSize, Smoothness);
+    const KoColorSpace* cs = src->colorSpace();
+    const int numChannels = cs->channelCount();
+    const int pixelSize = cs->pixelSize();
+
+    const int radius = BrushSize;
+    const int numBins = Smoothness + 1;
+    const double scale = Smoothness / 255.0;
+
+    /**
+     * The intensity histograms of the matrices are not rebuilt for every
+     * pixel, the matrix slides over the image instead, see
+     * KisSlidingWindowHistogram. The blocks limit the memory taken by
+     * the histograms of the columns.
+     */
+    const QVector<QRect> blocks = KritaUtils::splitRectIntoPatchesTight(applyRect, QSize(256, 64));
+
+    if (progressUpdater) {
+        progressUpdater->setRange(0, blocks.size());
     }
-}
 
-// This method has been ported from Pieter Z. Voloshyn's algorithm code in Digikam.
-
-/* Function to determine the most frequent color in a matrix
- *
- * Bits             => Bits array
- * Width            => Image width
- * Height           => Image height
- * X                => Position horizontal
- * Y                => Position vertical
- * Radius           => Is the radius of the matrix to be analyzed
- * Intensity        => Intensity to calculate
- *
- * Theory           => This function creates a matrix with the analyzed pixel in
- *                     the center of this matrix and find the most frequent color
- */
+    QVector<float> channel(numChannels);
+    QVector<int> intensities;
+    QVector<float> channels;
+    QVector<qreal> opacities;
+
+    for (int i = 0; i < blocks.size(); i++) {
+        const QRect &block = blocks[i];
+        const QRect srcRect = kisGrowRect(block, radius);
+        const int srcWidth = srcRect.width();
+        const int numSrcPixels = srcWidth * srcRect.height();
+
+        intensities.resize(numSrcPixels);
+        channels.resize(numSrcPixels * numChannels);
+        opacities.resize(numSrcPixels);
+
+        /**
+         * The source and the destination may be the same device, so
+         * the pixels are read from the old data
+         */
+        KisSequentialConstIterator srcIt(src, srcRect);
+        for (int index = 0; srcIt.nextPixel(); index++) {
+            const quint8 *pixel = srcIt.oldRawData();
+
+            opacities[index] = cs->opacityF(pixel);
+
+            if (cs->opacityU8(pixel) == 0) {
+                // if the pixel is transparent, it's not going to provide any useful information
+                intensities[index] = -1;
+                continue;
+            }
 
-void KisOilPaintFilter::MostFrequentColor(KisPaintDeviceSP src, quint8* dst, const QRect& /*bounds*/, int X, int Y, int Radius, int Intensity) const
-{
-    uint I;
+            intensities[index] = (uint)(cs->intensity8(pixel) * scale);
 
-    double Scale = Intensity / 255.0;
+            cs->normalisedChannelsValue(pixel, channel);
+            std::copy(channel.begin(), channel.end(), channels.begin() + index * numChannels);
+        }
 
-    // Alloc some arrays to be used
-    uchar *IntensityCount = new uchar[(Intensity + 1)];
+        KisSlidingWindowHistogram histogram(numBins, numChannels, srcWidth, radius);
 
-    const KoColorSpace* cs = src->colorSpace();
+        for (int row = 0; row < 2 * radius + 1; row++) {
+            histogram.addRow(intensities.constData() + row * srcWidth,
+                             channels.constData() + row * srcWidth * numChannels);
+        }
 
-    QVector<float> channel(cs->channelCount());
-    QVector<float>* AverageChannels = new QVector<float>[(Intensity + 1)];
+        KisSequentialIterator dstIt(dst, block);
 
-    // Erase the array
-    memset(IntensityCount, 0, (Intensity + 1) * sizeof(uchar));
+        for (int y = 0; y < block.height(); y++) {
+            if (y > 0) {
+                const int removedRow = y - 1;
+                const int addedRow = y + 2 * radius;
 
-    int startx = X - Radius;
-    int starty = Y - Radius;
-    int width = (2 * Radius) + 1;
-    int height = (2 * Radius) + 1;
+                histogram.removeRow(intensities.constData() + removedRow * srcWidth,
+                                    channels.constData() + removedRow * srcWidth * numChannels);
+                histogram.addRow(intensities.constData() + addedRow * srcWidth,
+                                 channels.constData() + addedRow * srcWidth * numChannels);
+            }
 
-    qreal middlePointAlpha = 1;
-    {
-        // if the current pixel is transparent, the result must be transparent, too.
-        KisSequentialConstIterator middlePointIt(src, QRect(X, Y, 1, 1));
-        middlePointIt.nextPixel();
-        middlePointAlpha = cs->opacityF(middlePointIt.oldRawData());
-    }
+            histogram.resetKernel();
 
+            for (int x = 0; x < block.width(); x++) {
+                if (x > 0) {
+                    histogram.moveKernel();
+                }
 
-    KisSequentialConstIterator srcIt(src, QRect(startx, starty, width, height));
-    while (middlePointAlpha > 0 && srcIt.nextPixel()) {
+                dstIt.nextPixel();
+                quint8 *dst = dstIt.rawData();
 
-        cs->normalisedChannelsValue(srcIt.oldRawData(), channel);
+                // if the current pixel is transparent, the result must be transparent, too.
+                const qreal middlePointAlpha = opacities[(y + radius) * srcWidth + x + radius];
+                const int mostFrequent = middlePointAlpha > 0 ? histogram.mostFrequentBin() : -1;
 
-        if (cs->opacityU8(srcIt.oldRawData()) == 0) {
-            // if the pixel is transparent, it's not going to provide any useful information
-            continue;
-        }
+                if (mostFrequent >= 0) {
+                    const float *sums = histogram.payload(mostFrequent);
+                    const int count = histogram.counts()[mostFrequent];
 
-        I = (uint)(cs->intensity8(srcIt.oldRawData()) * Scale);
+                    for (int c = 0; c < numChannels; c++) {
+                        channel[c] = sums[c] / count;
+                    }
 
-        IntensityCount[I]++;
+                    cs->fromNormalisedChannelsValue(dst, channel);
 
-        if (IntensityCount[I] == 1) {
-            AverageChannels[I] = channel;
-        } else {
-            for (int i = 0; i < channel.size(); i++) {
-                AverageChannels[I][i] += channel[i];
+                    // the alpha channel is averaged as well, but opaque pixels stay opaque
+                    if (middlePointAlpha == 1.0) {
+                        cs->setOpacity(dst, OPACITY_OPAQUE_U8, 1);
+                    }
+                } else {
+                    memset(dst, 0, pixelSize);
+                }
             }
         }
-    }
-
-    I = 0;
-    int MaxInstance = 0;
 
-    for (int i = 0 ; i <= Intensity ; ++i) {
-        if (IntensityCount[i] > MaxInstance) {
-            I = i;
-            MaxInstance = IntensityCount[i];
+        if (progressUpdater) {
+            progressUpdater->setValue(i + 1);
         }
     }
-
-    if (MaxInstance != 0) {
-        channel = AverageChannels[I];
-        for (int i = 0; i < channel.size(); i++) {
-            channel[i] /= MaxInstance;
-        }
-        cs->fromNormalisedChannelsValue(dst, channel);
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    } else {
-        memset(dst, 0, cs->pixelSize());
-        cs->setOpacity(dst, OPACITY_OPAQUE_U8, middlePointAlpha);
-    }
-
-
-    delete [] IntensityCount;        // free all the arrays
-    delete [] AverageChannels;
 }
 
 QRect KisOilPaintFilter::neededRect(const QRect & rect, const KisFilterConfigurationSP _config, int /*lod*/) const
@@ -23,6 +23,7 @@
 #include <KisDitherUtil.h>
 #include <KisGlobalResourcesInterface.h>
 #include <KoResourceLoadResult.h>
+#include <KisNearestColorLookup.h>
 
 K_PLUGIN_FACTORY_WITH_JSON(PalettizeFactory, "kritapalettize.json", registerPlugin<Palettize>();)
 
@@ -243,17 +244,18 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
 
     const quint8 colorCount = ditherEnabled && colorMode == ColorMode::NearestColors ? 2 : 1;
 
-    using SearchColor = boost::geometry::model::point<quint16, 3, boost::geometry::cs::cartesian>;
     struct ColorCandidate {
         KoColor color;
         quint16 index;
         double distance;
     };
-    using SearchEntry = std::pair<SearchColor, ColorCandidate>;
-    boost::geometry::index::rtree<SearchEntry, boost::geometry::index::quadratic<16>> rtree;
 
     if (palette) {
-        // Add palette colors to search tree
+        // Collect palette colors for the search, the lookup skips the
+        // duplicates, so won't dither between identical colors
+        QVector<KisNearestColorLookup::Color> searchColors;
+        QVector<ColorCandidate> candidates;
+
         quint16 index = 0;
         for (int row = 0; row < palette->rowCount(); ++row) {
             for (int column = 0; column < palette->columnCount(); ++column) {
@@ -261,87 +263,112 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
                 if (swatch.isValid()) {
                     KoColor color = swatch.color().convertedTo(colorspace);
                     KoColor workColor = swatch.color().convertedTo(workColorspace);
-                    SearchColor searchColor;
-                    memcpy(&searchColor, workColor.data(), sizeof(SearchColor));
-                    // Don't add duplicates so won't dither between identical colors
-                    std::vector<SearchEntry> result;
-                    rtree.query(boost::geometry::index::contains(searchColor), std::back_inserter(result));
-                    if (result.empty()) rtree.insert(SearchEntry(searchColor, {color, index, 0.0}));
+                    KisNearestColorLookup::Color searchColor;
+                    memcpy(searchColor.data(), workColor.data(), sizeof(searchColor));
+                    searchColors.append(searchColor);
+                    candidates.append({color, index, 0.0});
                 }
                 ++index;
             }
         }
 
+        const KisNearestColorLookup lookup(searchColors);
+        if (lookup.isEmpty()) return;
+
         KisDitherUtil ditherUtil;
         if (ditherEnabled) ditherUtil.setConfiguration(*config, "dither/");
 
         KisDitherUtil alphaDitherUtil;
         if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
 
+        const int pixelSize = colorspace->pixelSize();
+        const int workPixelSize = workColorspace->pixelSize();
+        QVector<quint8> workPixels;
+        QVector<float> normalized(int(workColorspace->channelCount()));
+
         KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
-        while (pixel.nextPixel()) {
-            KoColor workColor(pixel.oldRawData(), colorspace);
-            workColor.convertTo(workColorspace);
-
-            // Find dither threshold
-            double threshold = 0.5;
-            if (ditherEnabled) {
-                threshold = ditherUtil.threshold(QPoint(pixel.x(), pixel.y()));
-
-                // Traditional per-channel ordered dithering
-                if (colorMode == ColorMode::PerChannelOffset) {
-                    QVector<float> normalized(int(workColorspace->channelCount()));
-                    workColorspace->normalisedChannelsValue(workColor.data(), normalized);
-                    for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
-                        normalized[channel] += (threshold - 0.5) * offsetScale;
+
+        int numConseqPixels = pixel.nConseqPixels();
+        while (pixel.nextPixels(numConseqPixels)) {
+            numConseqPixels = pixel.nConseqPixels();
+
+            // Convert the whole run of pixels at once, converting them
+            // one by one is much slower than the search itself
+            workPixels.resize(numConseqPixels * workPixelSize);
+            colorspace->convertPixelsTo(pixel.oldRawData(), workPixels.data(), workColorspace, numConseqPixels,
+                                        KoColorConversionTransformation::internalRenderingIntent(),
+                                        KoColorConversionTransformation::internalConversionFlags());
+
+            for (int i = 0; i < numConseqPixels; ++i) {
+                const QPoint position(pixel.x() + i, pixel.y());
+                const quint8 *oldPixel = pixel.oldRawData() + i * pixelSize;
+                quint8 *workPixel = workPixels.data() + i * workPixelSize;
+
+                // Find dither threshold
+                double threshold = 0.5;
+                if (ditherEnabled) {
+                    threshold = ditherUtil.threshold(position);
+
+                    // Traditional per-channel ordered dithering
+                    if (colorMode == ColorMode::PerChannelOffset) {
+                        workColorspace->normalisedChannelsValue(workPixel, normalized);
+                        for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
+                            normalized[channel] += (threshold - 0.5) * offsetScale;
+                        }
+                        workColorspace->fromNormalisedChannelsValue(workPixel, normalized);
                     }
-                    workColorspace->fromNormalisedChannelsValue(workColor.data(), normalized);
                 }
-            }
 
-            // Get candidate colors and their distances
-            SearchColor searchColor;
-            memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor.data(), sizeof(SearchColor));
-            std::vector<ColorCandidate> candidateColors;
-            candidateColors.reserve(size_t(colorCount));
-            double distanceSum = 0.0;
-            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
-                ColorCandidate candidate = it->second;
-                candidate.distance = boost::geometry::distance(searchColor, it->first);
-                candidateColors.push_back(candidate);
-                distanceSum += candidate.distance;
-            }
+                // Get candidate colors and their distances
+                KisNearestColorLookup::Color searchColor;
+                memcpy(searchColor.data(), workPixel, sizeof(searchColor));
+                KisNearestColorLookup::Match matches[2];
+                int numMatches = 1;
+                if (colorCount > 1) {
+                    numMatches = lookup.nearestTwo(searchColor.data(), matches);
+                } else {
+                    matches[0] = lookup.nearest(searchColor.data());
+                }
 
-            // Select color candidate
-            quint16 selected;
-            if (ditherEnabled && colorMode == ColorMode::NearestColors) {
-                // Sort candidates by palette order for stable dither color ordering
-                const bool swap = candidateColors[0].index > candidateColors[1].index;
-                selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
-            }
-            else {
-                selected = 0;
-            }
-            ColorCandidate &candidate = candidateColors[selected];
-
-            // Set alpha
-            const double oldAlpha = colorspace->opacityF(pixel.oldRawData());
-            double newAlpha = oldAlpha;
-            if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
-                if (alphaMode == AlphaMode::Clip) {
-                    newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                ColorCandidate candidateColors[2];
+                double distanceSum = 0.0;
+                for (int j = 0; j < numMatches; ++j) {
+                    candidateColors[j] = candidates[matches[j].index];
+                    candidateColors[j].distance = matches[j].distance;
+                    distanceSum += candidateColors[j].distance;
                 }
-                else if (alphaMode == AlphaMode::Index) {
-                    newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+
+                // Select color candidate
+                quint16 selected;
+                if (ditherEnabled && colorMode == ColorMode::NearestColors && numMatches > 1) {
+                    // Sort candidates by palette order for stable dither color ordering
+                    const bool swap = candidateColors[0].index > candidateColors[1].index;
+                    selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
                 }
-                else if (alphaMode == AlphaMode::Dither) {
-                    newAlpha = oldAlpha < alphaDitherUtil.threshold(QPoint(pixel.x(), pixel.y())) ? 0.0 : 1.0;
+                else {
+                    selected = 0;
                 }
-            }
-            colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
+                ColorCandidate &candidate = candidateColors[selected];
+
+                // Set alpha
+                const double oldAlpha = colorspace->opacityF(oldPixel);
+                double newAlpha = oldAlpha;
+                if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
+                    if (alphaMode == AlphaMode::Clip) {
+                        newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                    }
+                    else if (alphaMode == AlphaMode::Index) {
+                        newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                    }
+                    else if (alphaMode == AlphaMode::Dither) {
+                        newAlpha = oldAlpha < alphaDitherUtil.threshold(position) ? 0.0 : 1.0;
+                    }
+                }
+                colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
 
-            // Copy color to pixel
-            memcpy(pixel.rawData(), candidate.color.data(), colorspace->pixelSize());
+                // Copy color to pixel
+                memcpy(pixel.rawData() + i * pixelSize, candidate.color.data(), pixelSize);
+            }
         }
     }
 }
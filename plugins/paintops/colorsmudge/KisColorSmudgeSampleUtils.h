@@ -60,6 +60,12 @@ struct WeightedSampleWrapper
         return m_mixer->currentWeightsSum() < 128;
     }
 
+    static qreal maxSampleRadiusValue(qreal sampleRadiusValue) {
+        // the radius may grow up to 1.0 on restarts
+        Q_UNUSED(sampleRadiusValue);
+        return 1.0;
+    }
+
     KoMixColorsOp::Mixer *m_mixer;
     const QRect m_maskRect;
     quint8 *m_maskPtr;
@@ -98,6 +104,10 @@ struct AveragedSampleWrapper
         return false;
     }
 
+    static qreal maxSampleRadiusValue(qreal sampleRadiusValue) {
+        return sampleRadiusValue;
+    }
+
     KoMixColorsOp::Mixer *m_mixer;
     int m_samplePixelSize;
     const QRect m_sampleRect;
@@ -105,6 +115,28 @@ struct AveragedSampleWrapper
     const int m_sampleStride;
 };
 
+/**
+ * The rect that is sampled for \p srcRect and \p sampleRadiusValue
+ */
+inline QRect sampleRect(const QRect &srcRect, qreal sampleRadiusValue)
+{
+    const QRect minimalRect = QRect(srcRect.center(), QSize(1,1));
+
+    return sampleRadiusValue > 0 ?
+        KisAlgebra2D::blowRect(srcRect, 0.5 * (sampleRadiusValue - 1.0)) | minimalRect :
+        minimalRect;
+}
+
+/**
+ * The biggest rect sampleColor() may read for \p srcRect, including the
+ * restarts with a bigger radius
+ */
+template<class WeightingModeWrapper>
+QRect maxSampleRect(const QRect &srcRect, qreal sampleRadiusValue)
+{
+    return sampleRect(srcRect, WeightingModeWrapper::maxSampleRadiusValue(sampleRadiusValue));
+}
+
 /**
  * Sample color from \p srcRect in weighted way
  *
@@ -145,12 +177,8 @@ void sampleColor(const QRect &srcRect,
     KIS_ASSERT_RECOVER_RETURN(*resultColor->colorSpace() == *sourceDevice->colorSpace());
     KIS_ASSERT_RECOVER_RETURN(*tempFixedDevice->colorSpace() == *sourceDevice->colorSpace());
 
-    const QRect minimalRect = QRect(srcRect.center(), QSize(1,1));
-
     do {
-        const QRect sampleRect = sampleRadiusValue > 0 ?
-                    KisAlgebra2D::blowRect(srcRect, 0.5 * (sampleRadiusValue - 1.0)) | minimalRect :
-                    minimalRect;
+        const QRect sampleRect = KisColorSmudgeSampleUtils::sampleRect(srcRect, sampleRadiusValue);
 
         tempFixedDevice->setRect(sampleRect);
         tempFixedDevice->lazyGrowBufferWithoutInitialization();
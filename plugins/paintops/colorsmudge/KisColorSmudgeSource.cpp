@@ -61,3 +61,26 @@ void KisColorSmudgeSourceImage::readBytes(quint8 *dstPtr, const QRect &rect)
 const KoColorSpace *KisColorSmudgeSourceImage::colorSpace() const {
     return m_overlayDevice.overlayColorSpace();
 }
+
+/**********************************************************************************/
+/*                 KisColorSmudgeSourcePrefetched                                 */
+/**********************************************************************************/
+
+KisColorSmudgeSourcePrefetched::KisColorSmudgeSourcePrefetched(KisColorSmudgeSourceSP source)
+    : m_source(source)
+{
+}
+
+void KisColorSmudgeSourcePrefetched::readRects(const QVector<QRect> &rects)
+{
+    Q_UNUSED(rects);
+}
+
+void KisColorSmudgeSourcePrefetched::readBytes(quint8 *dstPtr, const QRect &rect)
+{
+    m_source->readBytes(dstPtr, rect);
+}
+
+const KoColorSpace *KisColorSmudgeSourcePrefetched::colorSpace() const {
+    return m_source->colorSpace();
+}
@@ -54,5 +54,24 @@ private:
     KisOverlayPaintDeviceWrapper &m_overlayDevice;
 };
 
+/**
+ * A source for the dabs painted from the worker threads. All the
+ * rects are expected to be read into \p source in advance, so
+ * readRects() does nothing and doesn't touch the (thread-unsafe)
+ * state of the overlay devices.
+ */
+struct KisColorSmudgeSourcePrefetched : public KisColorSmudgeSource
+{
+    KisColorSmudgeSourcePrefetched(KisColorSmudgeSourceSP source);
+
+    void readRects(const QVector<QRect> &rects) override;
+
+    void readBytes(quint8 *dstPtr, const QRect &rect) override;
+    const KoColorSpace* colorSpace() const override;
+
+private:
+    KisColorSmudgeSourceSP m_source;
+};
+
 
 #endif //KRITA_KISCOLORSMUDGESOURCE_H
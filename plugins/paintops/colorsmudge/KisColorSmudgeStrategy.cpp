@@ -6,7 +6,51 @@
 
 #include "KisColorSmudgeStrategy.h"
 
+#include <kis_assert.h>
+
 KisColorSmudgeStrategy::KisColorSmudgeStrategy()
         : m_memoryAllocator(new KisOptimizedByteArray::PooledMemoryAllocator())
 {
 }
+
+bool KisColorSmudgeStrategy::supportsDetachedDabs() const
+{
+    return false;
+}
+
+KisColorSmudgeStrategy::DetachedDabSP
+KisColorSmudgeStrategy::detachDab(const QRect &srcRect, const QRect &dstRect,
+                                  const KoColor &currentPaintColor,
+                                  qreal opacity,
+                                  qreal colorRateValue,
+                                  qreal smudgeRateValue,
+                                  qreal maxPossibleSmudgeRateValue,
+                                  qreal lightnessStrengthValue,
+                                  qreal smudgeRadiusValue)
+{
+    Q_UNUSED(srcRect);
+    Q_UNUSED(dstRect);
+    Q_UNUSED(currentPaintColor);
+    Q_UNUSED(opacity);
+    Q_UNUSED(colorRateValue);
+    Q_UNUSED(smudgeRateValue);
+    Q_UNUSED(maxPossibleSmudgeRateValue);
+    Q_UNUSED(lightnessStrengthValue);
+    Q_UNUSED(smudgeRadiusValue);
+
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "detached dabs are not supported by the strategy");
+    return DetachedDabSP();
+}
+
+void KisColorSmudgeStrategy::prepareDetachedDabs(const QVector<DetachedDabSP> &dabs)
+{
+    Q_UNUSED(dabs);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "detached dabs are not supported by the strategy");
+}
+
+QVector<QRect> KisColorSmudgeStrategy::paintDetachedDab(DetachedDabSP dab)
+{
+    Q_UNUSED(dab);
+    KIS_SAFE_ASSERT_RECOVER_NOOP(0 && "detached dabs are not supported by the strategy");
+    return QVector<QRect>();
+}
@@ -10,6 +10,8 @@
 #include <KisOptimizedByteArray.h>
 #include <kis_dab_cache.h>
 
+#include <QSharedPointer>
+
 class KisColorSmudgeStrategy
 {
 public:
@@ -37,6 +39,56 @@ public:
 
     virtual const KoColorSpace* preciseColorSpace() const = 0;
 
+    /**
+     * A dab that has been prepared by updateMask() and can be painted
+     * later, probably from a worker thread, with paintDetachedDab().
+     * The strategies extend it with their own data.
+     */
+    struct DetachedDab
+    {
+        virtual ~DetachedDab() = default;
+
+        /// all the rects the dab reads from or writes into, the dabs with
+        /// non-intersecting footprints can be painted concurrently
+        QVector<QRect> footprint;
+    };
+    using DetachedDabSP = QSharedPointer<DetachedDab>;
+
+    /**
+     * @return true if the strategy supports deferred painting of the dabs
+     * via detachDab()/prepareDetachedDabs()/paintDetachedDab()
+     */
+    virtual bool supportsDetachedDabs() const;
+
+    /**
+     * Takes a snapshot of the mask prepared by the last updateMask() call
+     * and the parameters of the dab. The arguments are the same as in
+     * paintDab().
+     */
+    virtual DetachedDabSP detachDab(const QRect &srcRect, const QRect &dstRect,
+                                    const KoColor &currentPaintColor,
+                                    qreal opacity,
+                                    qreal colorRateValue,
+                                    qreal smudgeRateValue,
+                                    qreal maxPossibleSmudgeRateValue,
+                                    qreal lightnessStrengthValue,
+                                    qreal smudgeRadiusValue);
+
+    /**
+     * Reads all the data that \p dabs are going to sample. Should be
+     * called sequentially, before any of \p dabs is painted.
+     */
+    virtual void prepareDetachedDabs(const QVector<DetachedDabSP> &dabs);
+
+    /**
+     * Paints a dab created by detachDab(). The method is thread-safe for
+     * the dabs with non-intersecting footprints, which have already been
+     * passed to prepareDetachedDabs().
+     *
+     * @return the dirty rects
+     */
+    virtual QVector<QRect> paintDetachedDab(DetachedDabSP dab);
+
 protected:
     KisOptimizedByteArray::MemoryAllocatorSP m_memoryAllocator;
 };
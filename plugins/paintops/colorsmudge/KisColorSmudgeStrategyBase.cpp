@@ -180,30 +180,49 @@ void KisColorSmudgeStrategyBase::sampleDullingColor(const QRect &srcRect, qreal
                                        maskDab, resultColor);
 }
 
+QRect KisColorSmudgeStrategyBase::dullingSampleRect(const QRect &srcRect, qreal sampleRadiusValue) const
+{
+    using namespace KisColorSmudgeSampleUtils;
+    return maxSampleRect<WeightedSampleWrapper>(srcRect, sampleRadiusValue);
+}
+
 void
 KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters, KisColorSmudgeSourceSP srcSampleDevice,
                                        KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect,
                                        const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
                                        qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue, qreal colorRateValue,
                                        qreal smudgeRadiusValue)
+{
+    blendBrush(dstPainters, srcSampleDevice, maskDab, preserveMaskDab, srcRect, dstRect,
+               currentPaintColor, opacity, smudgeRateValue, maxPossibleSmudgeRateValue,
+               colorRateValue, smudgeRadiusValue,
+               this->coloringStrategy(), m_blendDevice, &m_preparedDullingColor);
+}
+
+void
+KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters, KisColorSmudgeSourceSP srcSampleDevice,
+                                       KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect,
+                                       const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
+                                       qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue, qreal colorRateValue,
+                                       qreal smudgeRadiusValue,
+                                       DabColoringStrategy &coloringStrategy, KisFixedPaintDeviceSP blendDevice,
+                                       KoColor *preparedDullingColor)
 {
     const qreal colorRateOpacity = this->colorRateOpacity(opacity, smudgeRateValue, colorRateValue, maxPossibleSmudgeRateValue);
 
     if (m_useDullingMode) {
         this->sampleDullingColor(srcRect,
                                  smudgeRadiusValue,
-                                 srcSampleDevice, m_blendDevice,
-                                 maskDab, &m_preparedDullingColor);
+                                 srcSampleDevice, blendDevice,
+                                 maskDab, preparedDullingColor);
 
-        KIS_SAFE_ASSERT_RECOVER(*m_preparedDullingColor.colorSpace() == *m_colorRateOp->colorSpace()) {
-            m_preparedDullingColor.convertTo(m_colorRateOp->colorSpace());
+        KIS_SAFE_ASSERT_RECOVER(*preparedDullingColor->colorSpace() == *m_colorRateOp->colorSpace()) {
+            preparedDullingColor->convertTo(m_colorRateOp->colorSpace());
         }
     }
 
-    m_blendDevice->setRect(dstRect);
-    m_blendDevice->lazyGrowBufferWithoutInitialization();
-
-    DabColoringStrategy &coloringStrategy = this->coloringStrategy();
+    blendDevice->setRect(dstRect);
+    blendDevice->lazyGrowBufferWithoutInitialization();
 
     const qreal dullingRateOpacity = this->dullingRateOpacity(opacity, smudgeRateValue);
 
@@ -215,34 +234,34 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
          (m_smearOp->id() == COMPOSITE_COPY &&
           qFuzzyCompare(dullingRateOpacity, OPACITY_OPAQUE_F)))) {
 
-        coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(m_blendDevice,
+        coloringStrategy.blendInFusedBackgroundAndColorRateWithDulling(blendDevice,
                                                                        srcSampleDevice,
                                                                        dstRect,
-                                                                       m_preparedDullingColor,
+                                                                       *preparedDullingColor,
                                                                        m_smearOp,
                                                                        dullingRateOpacity,
                                                                        currentPaintColor.convertedTo(
-                                                                               m_preparedDullingColor.colorSpace()),
+                                                                               preparedDullingColor->colorSpace()),
                                                                        m_colorRateOp,
                                                                        colorRateOpacity);
 
     } else {
         if (!m_useDullingMode) {
             const qreal smudgeRateOpacity = this->smearRateOpacity(opacity, smudgeRateValue);
-            blendInBackgroundWithSmearing(m_blendDevice, srcSampleDevice,
+            blendInBackgroundWithSmearing(blendDevice, srcSampleDevice,
                                           srcRect, dstRect, smudgeRateOpacity);
         } else {
-            blendInBackgroundWithDulling(m_blendDevice, srcSampleDevice,
+            blendInBackgroundWithDulling(blendDevice, srcSampleDevice,
                                          dstRect,
-                                         m_preparedDullingColor, dullingRateOpacity);
+                                         *preparedDullingColor, dullingRateOpacity);
         }
 
         if (colorRateOpacity > 0) {
             coloringStrategy.blendInColorRate(
-                    currentPaintColor.convertedTo(m_preparedDullingColor.colorSpace()),
+                    currentPaintColor.convertedTo(preparedDullingColor->colorSpace()),
                     m_colorRateOp,
                     colorRateOpacity,
-                    m_blendDevice, dstRect);
+                    blendDevice, dstRect);
         }
     }
 
@@ -252,11 +271,11 @@ KisColorSmudgeStrategyBase::blendBrush(const QVector<KisPainter *> dstPainters,
         dstPainter->setOpacityF(finalPainterOpacity(opacity, smudgeRateValue));
 
         dstPainter->bltFixedWithFixedSelection(dstRect.x(), dstRect.y(),
-                                               m_blendDevice, maskDab,
+                                               blendDevice, maskDab,
                                                maskDab->bounds().x(), maskDab->bounds().y(),
-                                               m_blendDevice->bounds().x(), m_blendDevice->bounds().y(),
+                                               blendDevice->bounds().x(), blendDevice->bounds().y(),
                                                dstRect.width(), dstRect.height());
-        dstPainter->renderMirrorMaskSafe(dstRect, m_blendDevice, maskDab, preserveDab);
+        dstPainter->renderMirrorMaskSafe(dstRect, blendDevice, maskDab, preserveDab);
     }
 
 }
@@ -287,14 +306,12 @@ void KisColorSmudgeStrategyBase::blendInBackgroundWithDulling(KisFixedPaintDevic
                                                               const QRect &dstRect, const KoColor &preparedDullingColor,
                                                               const qreal smudgeRateOpacity)
 {
-    Q_UNUSED(preparedDullingColor);
-
     if (m_smearOp->id() == COMPOSITE_COPY && qFuzzyCompare(smudgeRateOpacity, OPACITY_OPAQUE_F)) {
-        dst->fill(dst->bounds(), m_preparedDullingColor);
+        dst->fill(dst->bounds(), preparedDullingColor);
     } else {
         src->readBytes(dst->data(), dstRect);
         m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
-                             m_preparedDullingColor.data(), 0,
+                             preparedDullingColor.data(), 0,
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
                              smudgeRateOpacity);
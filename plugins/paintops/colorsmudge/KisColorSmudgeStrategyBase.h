@@ -103,11 +103,28 @@ public:
                                     KisFixedPaintDeviceSP tempFixedDevice, KisFixedPaintDeviceSP maskDab,
                                     KoColor *resultColor);
 
+    /**
+     * @return the rect sampleDullingColor() may read for \p srcRect
+     */
+    virtual QRect dullingSampleRect(const QRect &srcRect, qreal sampleRadiusValue) const;
+
     void blendBrush(const QVector<KisPainter *> dstPainters, KisColorSmudgeSourceSP srcSampleDevice,
                     KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect, const QRect &dstRect,
                     const KoColor &currentPaintColor, qreal opacity, qreal smudgeRateValue,
                     qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue);
 
+    /**
+     * A version of blendBrush() that doesn't touch the internal state of
+     * the strategy, so it can be called from multiple threads for
+     * non-intersecting dabs
+     */
+    void blendBrush(const QVector<KisPainter *> dstPainters, KisColorSmudgeSourceSP srcSampleDevice,
+                    KisFixedPaintDeviceSP maskDab, bool preserveMaskDab, const QRect &srcRect, const QRect &dstRect,
+                    const KoColor &currentPaintColor, qreal opacity, qreal smudgeRateValue,
+                    qreal maxPossibleSmudgeRateValue, qreal colorRateValue, qreal smudgeRadiusValue,
+                    DabColoringStrategy &coloringStrategy, KisFixedPaintDeviceSP blendDevice,
+                    KoColor *preparedDullingColor);
+
     void blendInBackgroundWithSmearing(KisFixedPaintDeviceSP dst, KisColorSmudgeSourceSP src, const QRect &srcRect,
                                        const QRect &dstRect, const qreal smudgeRateOpacity);
 
@@ -8,6 +8,7 @@
 
 #include "kis_image.h"
 #include "kis_fixed_paint_device.h"
+#include "kis_pointer_utils.h"
 
 KisColorSmudgeStrategyMask::KisColorSmudgeStrategyMask(KisPainter *painter, KisImageSP image, bool smearAlpha,
                                                        bool useDullingMode, bool useOverlayMode)
@@ -20,6 +21,12 @@ KisColorSmudgeStrategyBase::DabColoringStrategy &KisColorSmudgeStrategyMask::col
     return m_coloringStrategy;
 }
 
+QSharedPointer<KisColorSmudgeStrategyBase::DabColoringStrategy> KisColorSmudgeStrategyMask::createDetachedColoringStrategy()
+{
+    // the mask coloring strategy is stateless
+    return toQShared(new DabColoringStrategyMask());
+}
+
 void KisColorSmudgeStrategyMask::updateMask(KisDabCache *dabCache, const KisPaintInformation &info, const KisDabShape &shape,
                                        const QPointF &cursorPoint, QRect *dstDabRect, qreal lightnessStrength)
 {
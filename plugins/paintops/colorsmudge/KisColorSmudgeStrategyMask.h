@@ -20,6 +20,8 @@ public:
 
     DabColoringStrategy &coloringStrategy() override;
 
+    QSharedPointer<DabColoringStrategy> createDetachedColoringStrategy() override;
+
     void updateMask(KisDabCache *dabCache,
                     const KisPaintInformation& info,
                     const KisDabShape &shape,
@@ -34,6 +34,12 @@ void KisColorSmudgeStrategyMaskLegacy::sampleDullingColor(const QRect &srcRect,
                                        maskDab, resultColor);
 }
 
+QRect KisColorSmudgeStrategyMaskLegacy::dullingSampleRect(const QRect &srcRect, qreal sampleRadiusValue) const
+{
+    using namespace KisColorSmudgeSampleUtils;
+    return maxSampleRect<AveragedSampleWrapper>(srcRect, sampleRadiusValue);
+}
+
 QString KisColorSmudgeStrategyMaskLegacy::smearCompositeOp(bool smearAlpha) const
 {
     Q_UNUSED(smearAlpha);
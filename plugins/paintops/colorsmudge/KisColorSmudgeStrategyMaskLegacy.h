@@ -22,6 +22,7 @@ public:
     void sampleDullingColor(const QRect &srcRect, qreal sampleRadiusValue, KisColorSmudgeSourceSP sourceDevice,
                             KisFixedPaintDeviceSP tempFixedDevice, KisFixedPaintDeviceSP maskDab,
                             KoColor *resultColor) override;
+    QRect dullingSampleRect(const QRect &srcRect, qreal sampleRadiusValue) const override;
     QString smearCompositeOp(bool smearAlpha) const override;
     QString finalCompositeOp(bool smearAlpha) const override;
     qreal finalPainterOpacity(qreal opacity, qreal smudgeRateValue) override;
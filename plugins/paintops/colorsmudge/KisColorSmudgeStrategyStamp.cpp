@@ -23,6 +23,13 @@ KisColorSmudgeStrategyBase::DabColoringStrategy &KisColorSmudgeStrategyStamp::co
     return m_coloringStrategy;
 }
 
+QSharedPointer<KisColorSmudgeStrategyBase::DabColoringStrategy> KisColorSmudgeStrategyStamp::createDetachedColoringStrategy()
+{
+    QSharedPointer<DabColoringStrategyStamp> strategy(new DabColoringStrategyStamp());
+    strategy->setStampDab(new KisFixedPaintDevice(*m_origDab));
+    return strategy;
+}
+
 void KisColorSmudgeStrategyStamp::updateMask(KisDabCache *dabCache, const KisPaintInformation &info,
                                              const KisDabShape &shape, const QPointF &cursorPoint, QRect *dstDabRect, qreal lightnessStrength)
 {
@@ -19,6 +19,8 @@ struct KisColorSmudgeStrategyStamp : public KisColorSmudgeStrategyWithOverlay
 
     DabColoringStrategy &coloringStrategy() override;
 
+    QSharedPointer<DabColoringStrategy> createDetachedColoringStrategy() override;
+
     void updateMask(KisDabCache *dabCache,
                     const KisPaintInformation& info,
                     const KisDabShape &shape,
@@ -15,6 +15,24 @@
 
 #include "KisOverlayPaintDeviceWrapper.h"
 
+struct KisColorSmudgeStrategyWithOverlay::OverlayDetachedDab : public KisColorSmudgeStrategy::DetachedDab
+{
+    QRect srcRect;
+    QRect dstRect;
+    QVector<QRect> mirroredRects;
+
+    KoColor paintColor;
+    qreal opacity = 1.0;
+    qreal colorRateValue = 0.0;
+    qreal smudgeRateValue = 1.0;
+    qreal maxPossibleSmudgeRateValue = 1.0;
+    qreal smudgeRadiusValue = 0.0;
+
+    KisFixedPaintDeviceSP maskDab;
+    bool shouldPreserveMaskDab = true;
+    QSharedPointer<KisColorSmudgeStrategyBase::DabColoringStrategy> coloringStrategy;
+};
+
 KisColorSmudgeStrategyWithOverlay::KisColorSmudgeStrategyWithOverlay(KisPainter *painter, KisImageSP image,
                                                                      bool smearAlpha, bool useDullingMode,
                                                                      bool useOverlayMode)
@@ -43,20 +61,23 @@ void KisColorSmudgeStrategyWithOverlay::initializePainting()
                            m_smearAlpha,
                            m_initializationPainter->compositeOpId());
 
-    m_finalPainter.begin(m_layerOverlayDevice->overlay());
-    m_finalPainter.setCompositeOpId(finalCompositeOp(m_smearAlpha));
-    m_finalPainter.setSelection(m_initializationPainter->selection());
-    m_finalPainter.setChannelFlags(m_initializationPainter->channelFlags());
-    m_finalPainter.copyMirrorInformationFrom(m_initializationPainter);
+    setupFinalPainter(&m_finalPainter, m_layerOverlayDevice->overlay());
 
     if (m_imageOverlayDevice) {
         m_overlayPainter.reset(new KisPainter());
-        m_overlayPainter->begin(m_imageOverlayDevice->overlay());
-        m_overlayPainter->setCompositeOpId(finalCompositeOp(m_smearAlpha));
-        m_overlayPainter->setSelection(m_initializationPainter->selection());
-        m_overlayPainter->setChannelFlags(m_initializationPainter->channelFlags());
-        m_overlayPainter->copyMirrorInformationFrom(m_initializationPainter);
+        setupFinalPainter(m_overlayPainter.data(), m_imageOverlayDevice->overlay());
     }
+
+    m_prefetchedSourceDevice.reset(new KisColorSmudgeSourcePrefetched(m_sourceWrapperDevice));
+}
+
+void KisColorSmudgeStrategyWithOverlay::setupFinalPainter(KisPainter *painter, KisPaintDeviceSP device) const
+{
+    painter->begin(device);
+    painter->setCompositeOpId(finalCompositeOp(m_smearAlpha));
+    painter->setSelection(m_initializationPainter->selection());
+    painter->setChannelFlags(m_initializationPainter->channelFlags());
+    painter->copyMirrorInformationFrom(m_initializationPainter);
 }
 
 QVector<KisPainter *> KisColorSmudgeStrategyWithOverlay::finalPainters()
@@ -107,3 +128,107 @@ QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDab(const QRect &srcRect,
 
     return mirroredRects;
 }
+
+bool KisColorSmudgeStrategyWithOverlay::supportsDetachedDabs() const
+{
+    return true;
+}
+
+KisColorSmudgeStrategy::DetachedDabSP
+KisColorSmudgeStrategyWithOverlay::detachDab(const QRect &srcRect, const QRect &dstRect,
+                                             const KoColor &currentPaintColor, qreal opacity,
+                                             qreal colorRateValue, qreal smudgeRateValue,
+                                             qreal maxPossibleSmudgeRateValue,
+                                             qreal lightnessStrengthValue, qreal smudgeRadiusValue)
+{
+    Q_UNUSED(lightnessStrengthValue);
+
+    QSharedPointer<OverlayDetachedDab> dab(new OverlayDetachedDab());
+
+    dab->srcRect = srcRect;
+    dab->dstRect = dstRect;
+    dab->mirroredRects = m_finalPainter.calculateAllMirroredRects(dstRect);
+    dab->paintColor = currentPaintColor;
+    dab->opacity = opacity;
+    dab->colorRateValue = colorRateValue;
+    dab->smudgeRateValue = smudgeRateValue;
+    dab->maxPossibleSmudgeRateValue = maxPossibleSmudgeRateValue;
+    dab->smudgeRadiusValue = smudgeRadiusValue;
+
+    /**
+     * The dab cache may reuse its devices for the following dabs and
+     * mirroring modifies the mask in place, so the dab should own
+     * a copy of it.
+     */
+    dab->maskDab = new KisFixedPaintDevice(*m_maskDab);
+    dab->shouldPreserveMaskDab = m_shouldPreserveMaskDab;
+    dab->coloringStrategy = createDetachedColoringStrategy();
+
+    /**
+     * The dulling color sampler may grow the sampled area on restarts
+     * and, in the legacy mode, extend it beyond srcRect
+     */
+    const QRect sampledRect = dullingSampleRect(srcRect, smudgeRadiusValue) | srcRect;
+
+    dab->footprint = dab->mirroredRects;
+    dab->footprint << sampledRect;
+
+    return dab;
+}
+
+void KisColorSmudgeStrategyWithOverlay::prepareDetachedDabs(const QVector<DetachedDabSP> &dabs)
+{
+    QVector<QRect> readRects;
+
+    Q_FOREACH (DetachedDabSP dab, dabs) {
+        readRects << dab->footprint;
+    }
+
+    m_sourceWrapperDevice->readRects(readRects);
+
+    if (m_imageOverlayDevice) {
+        m_layerOverlayDevice->readRects(readRects);
+    }
+}
+
+QVector<QRect> KisColorSmudgeStrategyWithOverlay::paintDetachedDab(DetachedDabSP detachedDab)
+{
+    QSharedPointer<OverlayDetachedDab> dab = detachedDab.dynamicCast<OverlayDetachedDab>();
+    KIS_SAFE_ASSERT_RECOVER_RETURN_VALUE(dab, QVector<QRect>());
+
+    /**
+     * The painters, the blending device and the dulling color of the
+     * strategy are shared between the dabs, so every detached dab uses
+     * its own copies of them
+     */
+    KisPainter finalPainter;
+    setupFinalPainter(&finalPainter, m_layerOverlayDevice->overlay());
+
+    QVector<KisPainter*> painters;
+    painters << &finalPainter;
+
+    QScopedPointer<KisPainter> overlayPainter;
+    if (m_imageOverlayDevice) {
+        overlayPainter.reset(new KisPainter());
+        setupFinalPainter(overlayPainter.data(), m_imageOverlayDevice->overlay());
+        painters << overlayPainter.data();
+    }
+
+    KisFixedPaintDeviceSP blendDevice = new KisFixedPaintDevice(preciseColorSpace(), m_memoryAllocator);
+    KoColor dullingColor(preciseColorSpace());
+
+    blendBrush(painters,
+               m_prefetchedSourceDevice,
+               dab->maskDab, dab->shouldPreserveMaskDab,
+               dab->srcRect, dab->dstRect,
+               dab->paintColor,
+               dab->opacity,
+               dab->smudgeRateValue,
+               dab->maxPossibleSmudgeRateValue,
+               dab->colorRateValue, dab->smudgeRadiusValue,
+               *dab->coloringStrategy, blendDevice, &dullingColor);
+
+    m_layerOverlayDevice->writeRects(dab->mirroredRects);
+
+    return dab->mirroredRects;
+}
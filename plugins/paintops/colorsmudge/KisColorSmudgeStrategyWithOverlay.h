@@ -30,14 +30,35 @@ public:
                             qreal colorRateValue, qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue,
                             qreal lightnessStrengthValue, qreal smudgeRadiusValue) override;
 
+    bool supportsDetachedDabs() const override;
+
+    DetachedDabSP detachDab(const QRect &srcRect, const QRect &dstRect, const KoColor &currentPaintColor, qreal opacity,
+                            qreal colorRateValue, qreal smudgeRateValue, qreal maxPossibleSmudgeRateValue,
+                            qreal lightnessStrengthValue, qreal smudgeRadiusValue) override;
+
+    void prepareDetachedDabs(const QVector<DetachedDabSP> &dabs) override;
+
+    QVector<QRect> paintDetachedDab(DetachedDabSP dab) override;
+
 protected:
+    /**
+     * Creates a coloring strategy that is owned by a detached dab and
+     * doesn't depend on the mask prepared for the following dabs
+     */
+    virtual QSharedPointer<DabColoringStrategy> createDetachedColoringStrategy() = 0;
+
     KisFixedPaintDeviceSP m_maskDab;
     bool m_shouldPreserveMaskDab = true;
     QScopedPointer<KisOverlayPaintDeviceWrapper> m_layerOverlayDevice;
 
 private:
+    struct OverlayDetachedDab;
+
+    void setupFinalPainter(KisPainter *painter, KisPaintDeviceSP device) const;
+
     QScopedPointer<KisOverlayPaintDeviceWrapper> m_imageOverlayDevice;
     KisColorSmudgeSourceSP m_sourceWrapperDevice;
+    KisColorSmudgeSourceSP m_prefetchedSourceDevice;
     KisPainter m_finalPainter;
     QScopedPointer<KisPainter> m_overlayPainter;
     bool m_smearAlpha = true;
@@ -8,10 +8,15 @@
 
 #include <QRect>
 
+#include <algorithm>
+#include <vector>
+
 #include <KoColor.h>
 
 #include <kis_brush.h>
 #include <kis_image.h>
+#include <kis_paint_device.h>
+#include <kis_pointer_utils.h>
 #include <kis_selection.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_lod_transform.h>
@@ -30,6 +35,10 @@
 #include "KisColorSmudgeStrategyStamp.h"
 #include "KisColorSmudgeStrategyMaskLegacy.h"
 
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include <kis_default_bounds_base.h>
+
 struct ColorSmudgeInterstrokeDataFactory : public KisInterstrokeDataFactory
 {
     bool isCompatible(KisInterstrokeData *data) override {
@@ -213,20 +222,156 @@ KisSpacingInformation KisColorSmudgeOp::paintAt(const KisPaintInformation& info)
         m_hsvTransform->transform(paintColor.data(), paintColor.data(), 1);
     }
 
-    const QVector<QRect> dirtyRects =
-            m_strategy->paintDab(srcDabRect, m_dstDabRect,
-                                 paintColor,
-                                 fpOpacity, colorRate,
-                                 smudgeRate,
-                                 maxSmudgeRate,
-                                 paintThickness,
-                                 smudgeRadiusPortion);
-
-    painter()->addDirtyRects(dirtyRects);
+    if (m_useAsynchronousRendering) {
+        m_pendingDabs.append(
+            m_strategy->detachDab(srcDabRect, m_dstDabRect,
+                                  paintColor,
+                                  fpOpacity, colorRate,
+                                  smudgeRate,
+                                  maxSmudgeRate,
+                                  paintThickness,
+                                  smudgeRadiusPortion));
+    } else {
+        const QVector<QRect> dirtyRects =
+                m_strategy->paintDab(srcDabRect, m_dstDabRect,
+                                     paintColor,
+                                     fpOpacity, colorRate,
+                                     smudgeRate,
+                                     maxSmudgeRate,
+                                     paintThickness,
+                                     smudgeRadiusPortion);
+
+        painter()->addDirtyRects(dirtyRects);
+    }
 
     return spacingInfo;
 }
 
+struct KisColorSmudgeOp::UpdateSharedState
+{
+    KisPainter *painter = 0;
+    QVector<KisColorSmudgeStrategy::DetachedDabSP> dabs;
+
+    // every job writes only into the slot of its own dab
+    std::vector<QVector<QRect>> dirtyRects;
+};
+
+QVector<QVector<KisColorSmudgeStrategy::DetachedDabSP>>
+KisColorSmudgeOp::splitIntoIndependentBatches(const QVector<KisColorSmudgeStrategy::DetachedDabSP> &dabs,
+                                              bool forceSequentialDabs)
+{
+    /**
+     * Every dab samples the pixels written by the previous dabs, so
+     * the dabs with intersecting footprints must be painted in the
+     * order they were created. We split the queue into consecutive
+     * batches, where no two dabs of a batch intersect: the dabs of
+     * a batch can be painted concurrently, the batches themselves
+     * are painted one after another.
+     */
+    QVector<QVector<KisColorSmudgeStrategy::DetachedDabSP>> batches;
+
+    QVector<QRect> batchFootprint;
+    QRect batchBounds;
+
+    Q_FOREACH (KisColorSmudgeStrategy::DetachedDabSP dab, dabs) {
+        bool needsNewBatch = batches.isEmpty() || forceSequentialDabs;
+
+        for (auto it = dab->footprint.begin(); !needsNewBatch && it != dab->footprint.end(); ++it) {
+            if (!batchBounds.intersects(*it)) continue;
+
+            needsNewBatch = std::any_of(batchFootprint.begin(), batchFootprint.end(),
+                                        [it] (const QRect &rc) { return rc.intersects(*it); });
+        }
+
+        if (needsNewBatch) {
+            batches.append(QVector<KisColorSmudgeStrategy::DetachedDabSP>());
+            batchFootprint.clear();
+            batchBounds = QRect();
+        }
+
+        batches.last().append(dab);
+        batchFootprint.append(dab->footprint);
+
+        Q_FOREACH (const QRect &rc, dab->footprint) {
+            batchBounds |= rc;
+        }
+    }
+
+    return batches;
+}
+
+std::pair<int, bool> KisColorSmudgeOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    if (!m_strategy->supportsDetachedDabs()) {
+        return KisBrushBasedPaintOp::doAsynchronousUpdate(jobs);
+    }
+
+    /**
+     * The dabs are painted right in paintAt() until the stroke
+     * requests the first asynchronous update. After that the stroke
+     * is guaranteed to request the updates until all the dabs are
+     * painted.
+     */
+    m_useAsynchronousRendering = true;
+
+    const int updatePeriod = 20;
+
+    if (m_updateSharedState || m_pendingDabs.isEmpty()) {
+        return std::make_pair(updatePeriod, !m_pendingDabs.isEmpty());
+    }
+
+    m_updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_updateSharedState;
+
+    state->painter = painter();
+    state->dabs.swap(m_pendingDabs);
+    state->dirtyRects.resize(state->dabs.size());
+
+    /**
+     * The footprints don't account for the wrapped rects, so in
+     * wrap-around mode the dabs are painted strictly one by one
+     */
+    const bool forceSequentialDabs =
+        painter()->device()->defaultBounds()->wrapAroundMode();
+
+    const QVector<QVector<KisColorSmudgeStrategy::DetachedDabSP>> batches =
+        splitIntoIndependentBatches(state->dabs, forceSequentialDabs);
+
+    KisColorSmudgeStrategy *strategy = m_strategy.data();
+    int dabIndex = 0;
+
+    Q_FOREACH (const QVector<KisColorSmudgeStrategy::DetachedDabSP> &batch, batches) {
+        // reading from the overlay devices is not thread-safe, so it is
+        // done in a sequential job, which also waits for the previous batch
+        KritaUtils::addJobSequential(jobs,
+            [strategy, batch] () {
+                strategy->prepareDetachedDabs(batch);
+            }
+        );
+
+        Q_FOREACH (KisColorSmudgeStrategy::DetachedDabSP dab, batch) {
+            KritaUtils::addJobConcurrent(jobs,
+                [strategy, state, dab, dabIndex] () {
+                    state->dirtyRects[dabIndex] = strategy->paintDetachedDab(dab);
+                }
+            );
+            dabIndex++;
+        }
+    }
+
+    KritaUtils::addJobSequential(jobs,
+        [state, this] () {
+            for (const QVector<QRect> &rects : state->dirtyRects) {
+                state->painter->addDirtyRects(rects);
+            }
+
+            m_updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(updatePeriod, false);
+}
+
 KisSpacingInformation KisColorSmudgeOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     const qreal scale = m_sizeOption.apply(info) * KisLodTransform::lodToScale(painter()->device());
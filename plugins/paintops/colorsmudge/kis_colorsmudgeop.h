@@ -16,6 +16,7 @@
 #include <kis_types.h>
 
 #include "KisOverlayPaintDeviceWrapper.h"
+#include "KisColorSmudgeStrategy.h"
 #include <KisOpacityOption.h>
 #include <KisSpacingOption.h>
 #include <KisScatterOption.h>
@@ -35,8 +36,7 @@ class KisBrushBasedPaintOpSettings;
 class KisPainter;
 class KoColorSpace;
 class KisInterstrokeDataFactory;
-
-class KisColorSmudgeStrategy;
+class KisRunnableStrokeJobData;
 
 class KisColorSmudgeOp: public KisBrushBasedPaintOp
 {
@@ -46,12 +46,22 @@ public:
 
     static KisInterstrokeDataFactory* createInterstrokeDataFactory(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
     KisTimingInformation updateTimingImpl(const KisPaintInformation &info) const override;
 
+private:
+    struct UpdateSharedState;
+    typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
+    static QVector<QVector<KisColorSmudgeStrategy::DetachedDabSP>>
+        splitIntoIndependentBatches(const QVector<KisColorSmudgeStrategy::DetachedDabSP> &dabs,
+                                    bool forceSequentialDabs);
+
 private:
     bool                      m_firstRun;
 
@@ -79,6 +89,10 @@ private:
 
     KoColorTransformation *m_hsvTransform {0};
     QScopedPointer<KisColorSmudgeStrategy> m_strategy;
+
+    bool m_useAsynchronousRendering {false};
+    QVector<KisColorSmudgeStrategy::DetachedDabSP> m_pendingDabs;
+    UpdateSharedStateSP m_updateSharedState;
 };
 
 #endif // _KIS_COLORSMUDGEOP_H_
@@ -6,6 +6,8 @@
 
 #include "kis_colorsmudgeop_settings.h"
 
+#include "kis_brush_option.h"
+
 struct KisColorSmudgeOpSettings::Private
 {
     QList<KisUniformPaintOpPropertyWSP> uniformProperties;
@@ -21,6 +23,16 @@ KisColorSmudgeOpSettings::~KisColorSmudgeOpSettings()
 {
 }
 
+bool KisColorSmudgeOpSettings::needsAsynchronousUpdates() const
+{
+    /**
+     * The lightness strategy paints the dabs synchronously, so
+     * it doesn't need the asynchronous updates
+     */
+    KisBrushOptionProperties brushOption;
+    return brushOption.brushApplication(this, resourcesInterface()) != LIGHTNESSMAP;
+}
+
 #include <brushengine/kis_slider_based_paintop_property.h>
 #include <brushengine/kis_combo_based_paintop_property.h>
 #include "kis_paintop_preset.h"
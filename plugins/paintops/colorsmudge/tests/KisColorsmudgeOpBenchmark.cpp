@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisColorsmudgeOpBenchmark.h"
+
+#include "kistest.h"
+
+#include <QThread>
+
+#include <stroke_testing_utils.h>
+#include <KisAsynchronousStrokeUpdateHelper.h>
+#include <strokes/KisFreehandStrokeInfo.h>
+#include <strokes/freehand_stroke.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_settings.h>
+#include <KoCanvasResourcesIds.h>
+#include <KoColor.h>
+#include <kis_image.h>
+#include <kis_paint_device.h>
+
+
+class ColorSmudgeBenchmarkTester : public utils::StrokeTester
+{
+public:
+    ColorSmudgeBenchmarkTester(const QString &presetFileName, qreal brushSize)
+        : StrokeTester("colorsmudge_benchmark", QSize(3000, 3000), presetFileName),
+          m_brushSize(brushSize)
+    {
+    }
+
+    void setCpuCoresLimit(int value) {
+        m_cpuCoresLimit = value;
+    }
+
+protected:
+    using utils::StrokeTester::initImage;
+    void initImage(KisImageWSP image, KisNodeSP activeNode) override {
+        if (m_cpuCoresLimit > 0) {
+            image->setWorkingThreadsLimit(m_cpuCoresLimit);
+        }
+
+        // the smudge brush needs something to smudge
+        for (int x = 0; x < 3000; x += 200) {
+            activeNode->paintDevice()->fill(QRect(x, 0, 100, 3000),
+                                            KoColor(Qt::red, image->colorSpace()));
+        }
+    }
+
+    using utils::StrokeTester::modifyResourceManager;
+    void modifyResourceManager(KoCanvasResourceProvider *manager, KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisPaintOpPresetSP preset =
+            manager->resource(KoCanvasResource::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+
+        preset->settings()->setPaintOpSize(m_brushSize);
+    }
+
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo();
+
+        QScopedPointer<FreehandStrokeStrategy> stroke(
+            new FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")));
+
+        return stroke.take();
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources) override {
+        Q_UNUSED(resources);
+
+        // short segments with a flush after each of them make the
+        // asynchronous updates happen in the middle of the stroke
+        for (int y = 100; y < 2900; y += 400) {
+            for (int x = 100; x < 2900; x += 200) {
+                KisPaintInformation pi1(QPointF(x, y), 1.0);
+                KisPaintInformation pi2(QPointF(x + 200, y + 50), 1.0);
+
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, pi1, pi2));
+            }
+            image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(false));
+        }
+
+        image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
+    }
+
+private:
+    qreal m_brushSize = 100.0;
+    int m_cpuCoresLimit = -1;
+};
+
+void KisColorsmudgeOpBenchmark::benchmarkStroke_data()
+{
+    QTest::addColumn<QString>("preset");
+    QTest::addColumn<qreal>("brushSize");
+
+    const QStringList presets = {
+        "test_smudge_20px_dul_sa_new.0001.kpp",
+        "test_smudge_20px_sme_sa_new.0001.kpp",
+        "test_smudge_20px_sme_nsa_old.0001.kpp"
+    };
+
+    Q_FOREACH (const QString &preset, presets) {
+        Q_FOREACH (qreal size, QVector<qreal>({100.0, 400.0})) {
+            QTest::addRow("%s_%dpx", preset.section('.', 0, 0).toLatin1().data(), int(size))
+                << preset << size;
+        }
+    }
+}
+
+void KisColorsmudgeOpBenchmark::benchmarkStroke()
+{
+    QFETCH(QString, preset);
+    QFETCH(qreal, brushSize);
+
+    ColorSmudgeBenchmarkTester tester(preset, brushSize);
+
+    Q_FOREACH (int cores, QVector<int>({1, QThread::idealThreadCount()})) {
+        tester.setCpuCoresLimit(cores);
+        tester.benchmark();
+
+        qDebug() << qPrintable(QString("Cores: %1 Time: %2 (ms)").arg(cores).arg(tester.lastStrokeTime()));
+    }
+}
+
+KISTEST_MAIN(KisColorsmudgeOpBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISCOLORSMUDGEOPBENCHMARK_H
+#define KISCOLORSMUDGEOPBENCHMARK_H
+
+#include <QtTest>
+
+class KisColorsmudgeOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void benchmarkStroke();
+    void benchmarkStroke_data();
+};
+
+#endif // KISCOLORSMUDGEOPBENCHMARK_H
@@ -8,6 +8,8 @@
 
 #include "kistest.h"
 
+#include <algorithm>
+
 #include <qimage_based_test.h>
 #include <stroke_testing_utils.h>
 #include <brushengine/kis_paint_information.h>
@@ -15,6 +17,13 @@
 #include <brushengine/kis_paintop_preset.h>
 #include <brushengine/kis_paintop_settings.h>
 #include <KoCanvasResourcesIds.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisRunnableStrokeJobData.h>
+#include <brushengine/kis_paintop.h>
+#include <kis_distance_information.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <testutil.h>
 
 class TestColorsmudgeOp : public TestUtil::QImageBasedTest
 {
@@ -112,26 +121,144 @@ public:
     QString m_prefix;
 };
 
+namespace {
+
+const QStringList presetFiles = {
+    "test_smudge_20px_dul_nsa_new.0001.kpp",
+    "test_smudge_20px_dul_nsa_old.0001.kpp",
+    "test_smudge_20px_dul_sa_new.0001.kpp",
+    "test_smudge_20px_dul_sa_old.0001.kpp",
+    "test_smudge_20px_sme_nsa_new.0001.kpp",
+    "test_smudge_20px_sme_nsa_old.0001.kpp",
+    "test_smudge_20px_sme_sa_new.0001.kpp",
+    "test_smudge_20px_sme_sa_old.0001.kpp"
+};
+
+/**
+ * Runs the jobs in the order they were added, but the concurrent jobs
+ * between two sequential ones are run backwards, so that the result
+ * depends on the order of the dabs if they are split into the batches
+ * incorrectly
+ */
+void runJobs(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    auto it = jobs.begin();
+
+    while (it != jobs.end()) {
+        auto endIt = std::find_if(it, jobs.end(),
+                                  [] (KisRunnableStrokeJobData *job) {
+                                      return job->sequentiality() != KisStrokeJobData::CONCURRENT;
+                                  });
+
+        if (it == endIt) {
+            ++endIt;
+        }
+
+        std::reverse(it, endIt);
+        it = endIt;
+    }
+
+    Q_FOREACH (KisRunnableStrokeJobData *job, jobs) {
+        job->run();
+        delete job;
+    }
+    jobs.clear();
+}
+
+bool doAsynchronousUpdate(KisPainter &gc)
+{
+    QVector<KisRunnableStrokeJobData*> jobs;
+    bool needsMoreUpdates = false;
+    std::tie(std::ignore, needsMoreUpdates) = gc.paintOp()->doAsynchronousUpdate(jobs);
+
+    const bool hasJobs = !jobs.isEmpty();
+    runJobs(jobs);
+
+    return hasJobs || needsMoreUpdates;
+}
+
+KisPaintDeviceSP paintStroke(const QString &presetFileName, bool useOverlay, bool asynchronous)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, 200, 200, cs, "colorsmudge test");
+
+    KisPaintLayerSP paint1 = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(paint1, image->root(), 0);
+    paint1->paintDevice()->fill(QRect(80, 5, 50, 190), KoColor(Qt::red, cs));
+
+    KisPaintLayerSP paintBg = new KisPaintLayer(image, "paintBg", OPACITY_OPAQUE_U8);
+    image->addNode(paintBg, image->root(), 0);
+    paintBg->paintDevice()->fill(QRect(0, 100, 200, 100), KoColor(Qt::white, cs));
+
+    KisNodeSP targetNode = paint1;
+
+    if (useOverlay) {
+        KisPaintLayerSP paint2 = new KisPaintLayer(image, "paint2", OPACITY_OPAQUE_U8);
+        image->addNode(paint2, image->root(), paint1);
+        targetNode = paint2;
+    }
+
+    image->initialRefreshGraph();
+
+    QScopedPointer<KoCanvasResourceProvider> manager(
+        utils::createResourceManager(image, 0, presetFileName));
+
+    manager->setResource(KoCanvasResource::ForegroundColor, KoColor(Qt::green, cs));
+
+    KisPaintOpPresetSP preset =
+        manager->resource(KoCanvasResource::CurrentPaintOpPreset).value<KisPaintOpPresetSP>();
+    preset->settings()->setProperty("MergedPaint", useOverlay);
+
+    KisResourcesSnapshotSP resources =
+        new KisResourcesSnapshot(image, targetNode, manager.data());
+
+    KisPainter gc(targetNode->paintDevice());
+    resources->setupPainter(&gc);
+
+    if (asynchronous) {
+        // the first request switches the paintop into the asynchronous mode
+        doAsynchronousUpdate(gc);
+    }
+
+    KisDistanceInformation dist;
+
+    const QVector<qreal> pressureLevels = {1.0, 0.8, 0.5};
+
+    int yOffset = 20;
+    Q_FOREACH (qreal pressure, pressureLevels) {
+        gc.paintLine(KisPaintInformation(QPointF(20, yOffset), pressure),
+                     KisPaintInformation(QPointF(180, yOffset), pressure), &dist);
+
+        // the following dabs smudge the ones that are still pending
+        if (asynchronous) {
+            doAsynchronousUpdate(gc);
+        }
+
+        gc.paintLine(KisPaintInformation(QPointF(180, yOffset + 30), pressure),
+                     KisPaintInformation(QPointF(100, yOffset), pressure), &dist);
+
+        yOffset += 60;
+    }
+
+    if (asynchronous) {
+        while (doAsynchronousUpdate(gc));
+    }
+
+    return targetNode->paintDevice();
+}
+
+}
+
 void KisColorsmudgeOpTest::test_data()
 {
     QTest::addColumn<QString>("testName");
     QTest::addColumn<QString>("preset");
     QTest::addColumn<bool>("overlay");
 
-    QStringList files = {
-        "test_smudge_20px_dul_nsa_new.0001.kpp",
-        "test_smudge_20px_dul_nsa_old.0001.kpp",
-        "test_smudge_20px_dul_sa_new.0001.kpp",
-        "test_smudge_20px_dul_sa_old.0001.kpp",
-        "test_smudge_20px_sme_nsa_new.0001.kpp",
-        "test_smudge_20px_sme_nsa_old.0001.kpp",
-        "test_smudge_20px_sme_sa_new.0001.kpp",
-        "test_smudge_20px_sme_sa_old.0001.kpp"
-    };
-
     for (int i = 0; i < 2; i++) {
         const bool useOverlay = bool(i);
-        Q_FOREACH (const QString &file, files) {
+        Q_FOREACH (const QString &file, presetFiles) {
             QRegularExpression re("test_smudge_(.+).0001.kpp");
             const QString name = QString("%1_%2").arg(useOverlay ? "over" : "norm").arg(re.match(file).captured(1));
             const QByteArray nameLatin = name.toLatin1();
@@ -150,4 +277,37 @@ void KisColorsmudgeOpTest::test()
     t.test(testName, preset, overlay);
 }
 
+void KisColorsmudgeOpTest::testAsynchronousRendering_data()
+{
+    QTest::addColumn<QString>("preset");
+    QTest::addColumn<bool>("overlay");
+
+    for (int i = 0; i < 2; i++) {
+        const bool useOverlay = bool(i);
+        Q_FOREACH (const QString &file, presetFiles) {
+            QRegularExpression re("test_smudge_(.+).0001.kpp");
+            const QString name = QString("%1_%2").arg(useOverlay ? "over" : "norm").arg(re.match(file).captured(1));
+            const QByteArray nameLatin = name.toLatin1();
+            QTest::addRow("%s", nameLatin.data()) << file << useOverlay;
+        }
+    }
+}
+
+void KisColorsmudgeOpTest::testAsynchronousRendering()
+{
+    QFETCH(QString, preset);
+    QFETCH(bool, overlay);
+
+    KisPaintDeviceSP syncDevice = paintStroke(preset, overlay, false);
+    KisPaintDeviceSP asyncDevice = paintStroke(preset, overlay, true);
+
+    const QRect rc = syncDevice->exactBounds() | asyncDevice->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     syncDevice->convertToQImage(0, rc),
+                                     asyncDevice->convertToQImage(0, rc), 1, 1));
+}
+
 KISTEST_MAIN(KisColorsmudgeOpTest)
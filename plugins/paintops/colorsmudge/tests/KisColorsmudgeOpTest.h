@@ -16,6 +16,9 @@ private Q_SLOTS:
 
     void test();
     void test_data();
+
+    void testAsynchronousRendering_data();
+    void testAsynchronousRendering();
 };
 
 #endif // KISCOLORSMUDGEOPTEST_H
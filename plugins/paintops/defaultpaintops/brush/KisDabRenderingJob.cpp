@@ -91,7 +91,9 @@ int KisDabRenderingJobRunner::executeOneJob(KisDabRenderingJob *job,
 
     resources->syncResourcesToSeqNo(job->seqNo, job->generationInfo.info);
 
-    if (job->type == KisDabRenderingJob::Dab) {
+    // the dab job may have its original device fetched from the shape
+    // cache already, then it should only be postprocessed
+    if (job->type == KisDabRenderingJob::Dab && !job->originalDevice) {
         // TODO: thing about better interface for the reverse queue link
         job->originalDevice = parentQueue->fetchCachedPaintDevice();
 
@@ -69,6 +69,7 @@ struct KisDabRenderingQueue::Private
     int nextSeqNoToUse = 0;
     int lastPaintedJob = -1;
     int lastDabJobInQueue = -1;
+    bool hasShapeCachedDabs = false;
     QScopedPointer<CacheInterface> cacheInterface;
     const KoColorSpace *colorSpace;
     qreal averageOpacity = 0.0;
@@ -153,7 +154,19 @@ KisDabRenderingJobSP KisDabRenderingQueue::addDab(const KisDabCacheUtils::DabReq
                                                   : KisDabRenderingJob::Copy;
 
     if (job->type == KisDabRenderingJob::Dab) {
-        job->status = KisDabRenderingJob::Running;
+        m_d->hasShapeCachedDabs |= job->generationInfo.shapeCacheKey.isValid;
+        job->originalDevice = m_d->cacheInterface->fetchDabShape(job->generationInfo);
+
+        if (job->originalDevice && !job->generationInfo.needsPostprocessing) {
+            // the same shape has already been generated in this stroke
+            job->postprocessedDevice = job->originalDevice;
+            job->status = KisDabRenderingJob::Completed;
+            m_d->avgExecutionTime(0);
+        } else {
+            // if the original device has been found in the shape cache,
+            // the job will only do the postprocessing
+            job->status = KisDabRenderingJob::Running;
+        }
     } else if (job->type == KisDabRenderingJob::Postprocess ||
                job->type == KisDabRenderingJob::Copy) {
 
@@ -215,6 +228,8 @@ QList<KisDabRenderingJobSP> KisDabRenderingQueue::notifyJobFinished(int seqNo, i
     finishedJob->status = KisDabRenderingJob::Completed;
 
     if (finishedJob->type == KisDabRenderingJob::Dab) {
+        m_d->cacheInterface->putDabShape(finishedJob->generationInfo, finishedJob->originalDevice);
+
         for (auto it = finishedJobIt + 1; it != m_d->jobs.end(); ++it) {
             KisDabRenderingJobSP j = *it;
 
@@ -296,9 +311,13 @@ QList<KisRenderedDab> KisDabRenderingQueue::takeReadyDabs(bool returnMutableDabs
         m_d->jobs.isEmpty() ||
         m_d->jobs.first()->type == KisDabRenderingJob::Dab);
 
+    /**
+     * The dabs stored in the shape cache may be reused by any later
+     * job, so all of them should be copied
+     */
     const int copyJobAfterInclusive =
         returnMutableDabs && !m_d->dabsHaveSeparateOriginal() ?
-            m_d->lastDabJobInQueue :
+            (m_d->hasShapeCachedDabs ? 0 : m_d->lastDabJobInQueue) :
             std::numeric_limits<int>::max();
 
     if (oneTimeLimit < 0) {
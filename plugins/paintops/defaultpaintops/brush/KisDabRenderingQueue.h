@@ -30,6 +30,25 @@ public:
                                 bool *shouldUseCache) = 0;
 
         virtual bool hasSeparateOriginal(KisDabCacheUtils::DabRenderingResources *resources) const = 0;
+
+        /**
+         * Returns a dab with the shape described by \p di generated
+         * earlier in the stroke or null if the dab should be generated.
+         * The returned device must not be modified.
+         */
+        virtual KisFixedPaintDeviceSP fetchDabShape(const KisDabCacheUtils::DabGenerationInfo &di) {
+            Q_UNUSED(di);
+            return KisFixedPaintDeviceSP();
+        }
+
+        /**
+         * Saves the original device of a generated dab for reuse by
+         * fetchDabShape(). The device must not be modified afterwards.
+         */
+        virtual void putDabShape(const KisDabCacheUtils::DabGenerationInfo &di, KisFixedPaintDeviceSP dab) {
+            Q_UNUSED(di);
+            Q_UNUSED(dab);
+        }
     };
 
 
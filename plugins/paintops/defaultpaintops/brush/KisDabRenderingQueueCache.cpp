@@ -31,3 +31,13 @@ bool KisDabRenderingQueueCache::hasSeparateOriginal(KisDabCacheUtils::DabRenderi
 {
     return needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
+
+KisFixedPaintDeviceSP KisDabRenderingQueueCache::fetchDabShape(const KisDabCacheUtils::DabGenerationInfo &di)
+{
+    return fetchDabFromShapeCache(di);
+}
+
+void KisDabRenderingQueueCache::putDabShape(const KisDabCacheUtils::DabGenerationInfo &di, KisFixedPaintDeviceSP dab)
+{
+    putDabToShapeCache(di, dab);
+}
@@ -29,6 +29,9 @@ public:
 
     bool hasSeparateOriginal(KisDabCacheUtils::DabRenderingResources *resources) const override;
 
+    KisFixedPaintDeviceSP fetchDabShape(const KisDabCacheUtils::DabGenerationInfo &di) override;
+    void putDabShape(const KisDabCacheUtils::DabGenerationInfo &di, KisFixedPaintDeviceSP dab) override;
+
 private:
     struct Private;
     QScopedPointer<Private> m_d;
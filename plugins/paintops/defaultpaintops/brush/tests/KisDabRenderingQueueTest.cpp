@@ -486,6 +486,66 @@ void KisDabRenderingQueueTest::testRunningJobs()
     QCOMPARE(renderedDabs[1].offset, QPoint(15,15));
 }
 
+void KisDabRenderingQueueTest::testShapeCachedDabs()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisDabRenderingQueueCache *cacheInterface = new KisDabRenderingQueueCache();
+
+    KisDabRenderingQueue queue(cs, testResourcesFactory);
+    queue.setCacheInterface(cacheInterface);
+
+    KoColor color(Qt::red, cs);
+    QPointF pos1(10,10);
+    QPointF pos2(20,20);
+    QPointF pos3(30,30);
+    KisDabShape shape1;
+    KisDabShape shape2(2.0, 1.0, 0.0);
+    KisPaintInformation pi1(pos1);
+    KisPaintInformation pi2(pos2);
+    KisPaintInformation pi3(pos3);
+
+    KisDabCacheUtils::DabRequestInfo request1(color, pos1, shape1, pi1, 1.0);
+    KisDabCacheUtils::DabRequestInfo request2(color, pos2, shape2, pi2, 1.0);
+    KisDabCacheUtils::DabRequestInfo request3(color, pos3, shape1, pi3, 1.0);
+
+    KisDabRenderingJobSP job0 = queue.addDab(request1, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F);
+    QVERIFY(job0);
+    QVERIFY(job0->generationInfo.shapeCacheKey.isValid);
+
+    KisDabRenderingJobRunner runner0(job0, &queue, 0);
+    runner0.run();
+
+    KisDabRenderingJobSP job1 = queue.addDab(request2, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F);
+    QVERIFY(job1);
+    QCOMPARE(job1->type, KisDabRenderingJob::Dab);
+
+    KisDabRenderingJobRunner runner1(job1, &queue, 0);
+    runner1.run();
+
+    // the shape of the first dab is reused without rendering
+    KisDabRenderingJobSP job2 = queue.addDab(request3, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F);
+    QVERIFY(!job2);
+
+    QCOMPARE(cacheInterface->shapeCache().hits(), 1);
+    QCOMPARE(cacheInterface->shapeCache().misses(), 2);
+
+    QList<KisRenderedDab> renderedDabs = queue.takeReadyDabs();
+    QCOMPARE(renderedDabs.size(), 3);
+
+    QVERIFY(renderedDabs[0].device != renderedDabs[1].device);
+    QVERIFY(renderedDabs[2].device == renderedDabs[0].device);
+    QCOMPARE(renderedDabs[2].offset, QPoint(25,25));
+
+    // mutable dabs should never be shared with the shape cache
+    KisDabCacheUtils::DabRequestInfo request4(color, pos1, shape2, pi1, 1.0);
+    QVERIFY(!queue.addDab(request4, OPACITY_OPAQUE_F, OPACITY_OPAQUE_F));
+
+    renderedDabs = queue.takeReadyDabs(true);
+    QCOMPARE(renderedDabs.size(), 1);
+    QVERIFY(renderedDabs[0].device != job1->originalDevice);
+}
+
 #include "../KisDabRenderingExecutor.h"
 #include "KisFakeRunnableStrokeJobsExecutor.h"
 
@@ -0,0 +1,133 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDuplicateOpBenchmark.h"
+
+#include "kistest.h"
+
+#include <stroke_testing_utils.h>
+#include <KisGlobalResourcesInterface.h>
+#include <strokes/KisFreehandStrokeInfo.h>
+#include <strokes/freehand_stroke.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_registry.h>
+#include <brushengine/kis_paintop_settings.h>
+#include <KoCanvasResourcesIds.h>
+#include <KoColor.h>
+#include <kis_auto_brush.h>
+#include <kis_brush_option.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_image.h>
+#include <kis_node.h>
+#include <kis_paint_device.h>
+
+
+class DuplicateBenchmarkTester : public utils::StrokeTester
+{
+public:
+    DuplicateBenchmarkTester(int brushDiameter, bool directSampling)
+        : StrokeTester("duplicate_benchmark", QSize(3000, 3000), QString()),
+          m_brushDiameter(brushDiameter),
+          m_directSampling(directSampling)
+    {
+    }
+
+protected:
+    using utils::StrokeTester::initImage;
+    void initImage(KisImageWSP image, KisNodeSP activeNode) override {
+        const QRect rc = image->bounds();
+        const int stripeHeight = 50;
+
+        // the stripes make sure all the tiles of the source are allocated
+        for (int y = 0; y < rc.height(); y += stripeHeight) {
+            const QColor color = QColor::fromHsv((y / stripeHeight * 37) % 360, 200, 200);
+            activeNode->paintDevice()->fill(QRect(0, y, rc.width(), stripeHeight),
+                                            KoColor(color, activeNode->paintDevice()->colorSpace()));
+        }
+    }
+
+    using utils::StrokeTester::modifyResourceManager;
+    void modifyResourceManager(KoCanvasResourceProvider *manager, KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisPaintOpPresetSP preset =
+            KisPaintOpRegistry::instance()->defaultPreset(KoID("duplicate"),
+                                                          KisGlobalResourcesInterface::instance());
+
+        KisPaintOpSettingsSP settings = preset->settings();
+
+        KisCircleMaskGenerator *circle =
+            new KisCircleMaskGenerator(m_brushDiameter, 1.0, 0.5, 0.5, 2, false);
+
+        KisBrushOptionProperties brushOption;
+        brushOption.setBrush(KisBrushSP(new KisAutoBrush(circle, 0.0, 0.0)));
+        brushOption.writeOptionSetting(settings);
+
+        settings->setProperty("Duplicateop/Healing", false);
+        settings->setProperty("Duplicateop/DirectSampling", m_directSampling);
+
+        QVariant i;
+        i.setValue(preset);
+        manager->setResource(KoCanvasResource::CurrentPaintOpPreset, i);
+    }
+
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo();
+
+        QScopedPointer<FreehandStrokeStrategy> stroke(
+            new FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")));
+
+        return stroke.take();
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources) override {
+        Q_UNUSED(resources);
+
+        for (int y = 200; y < 2800; y += 300) {
+            for (int x = 200; x < 2800; x += 50) {
+                KisPaintInformation pi1(QPointF(x, y), 1.0);
+                KisPaintInformation pi2(QPointF(x + 50, y + 10), 1.0);
+
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, pi1, pi2));
+            }
+        }
+    }
+
+private:
+    int m_brushDiameter = 100;
+    bool m_directSampling = true;
+};
+
+void KisDuplicateOpBenchmark::benchmarkStroke_data()
+{
+    QTest::addColumn<int>("brushDiameter");
+    QTest::addColumn<bool>("directSampling");
+
+    Q_FOREACH (int diameter, QVector<int>({100, 300, 600})) {
+        Q_FOREACH (bool direct, QVector<bool>({false, true})) {
+            QTest::addRow("%dpx_%s", diameter, direct ? "direct" : "copy")
+                << diameter << direct;
+        }
+    }
+}
+
+void KisDuplicateOpBenchmark::benchmarkStroke()
+{
+    QFETCH(int, brushDiameter);
+    QFETCH(bool, directSampling);
+
+    DuplicateBenchmarkTester tester(brushDiameter, directSampling);
+    tester.benchmark();
+
+    qDebug() << qPrintable(QString("Time: %1 (ms)").arg(tester.lastStrokeTime()));
+}
+
+KISTEST_MAIN(KisDuplicateOpBenchmark)
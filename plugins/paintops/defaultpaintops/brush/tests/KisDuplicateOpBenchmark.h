@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDUPLICATEOPBENCHMARK_H
+#define KISDUPLICATEOPBENCHMARK_H
+
+#include <QObject>
+
+class KisDuplicateOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkStroke_data();
+    void benchmarkStroke();
+};
+
+#endif // KISDUPLICATEOPBENCHMARK_H
@@ -50,6 +50,42 @@
 #include "kis_duplicateop_settings_widget.h"
 #include <KisDuplicateOptionData.h>
 
+namespace {
+
+/**
+ * A hidden switch for benchmarking the direct sampling against
+ * copying the source into a temporary device
+ */
+const QString DUPLICATE_DIRECT_SAMPLING = "Duplicateop/DirectSampling";
+
+/**
+ * Reads the old (pre-stroke) pixels of \p rc straight from the tiles of
+ * \p device into \p dst, which is moved to the origin
+ */
+void readOldBytes(KisPaintDeviceSP device, const QRect &rc, KisFixedPaintDeviceSP dst)
+{
+    dst->setRect(QRect(QPoint(), rc.size()));
+    dst->lazyGrowBufferWithoutInitialization();
+
+    const int pixelSize = device->pixelSize();
+    quint8 *dstPtr = dst->data();
+
+    KisHLineConstIteratorSP it = device->createHLineConstIteratorNG(rc.x(), rc.y(), rc.width());
+
+    for (int y = 0; y < rc.height(); y++) {
+        int numPixels = 0;
+        do {
+            numPixels = it->nConseqPixels();
+            memcpy(dstPtr, it->oldRawData(), numPixels * pixelSize);
+            dstPtr += numPixels * pixelSize;
+        } while (it->nextPixels(numPixels));
+
+        it->nextRow();
+    }
+}
+
+}
+
 KisDuplicateOp::KisDuplicateOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
     : KisBrushBasedPaintOp(settings, painter)
     , m_image(image)
@@ -64,6 +100,8 @@ KisDuplicateOp::KisDuplicateOp(const KisPaintOpSettingsSP settings, KisPainter *
 
     m_duplicateOptionData.read(settings.data());
     m_srcdev = source()->createCompositionSourceDevice();
+    m_fixedSrcDab = new KisFixedPaintDevice(m_srcdev->colorSpace());
+    m_useDirectSampling = settings->getBool(DUPLICATE_DIRECT_SAMPLING, true);
 }
 
 KisDuplicateOp::~KisDuplicateOp()
@@ -143,6 +181,35 @@ KisSpacingInformation KisDuplicateOp::paintAt(const KisPaintInformation& info)
     qint32 sw = dstRect.width();
     qint32 sh = dstRect.height();
 
+    /**
+     * Without healing the source pixels are never modified, so there is
+     * no need to copy them into a temporary tiled device. They are read
+     * right from the source tiles and composited as a fixed device.
+     */
+    if (m_useDirectSampling &&
+        !m_duplicateOptionData.healing &&
+        *realSourceDevice->colorSpace() == *m_srcdev->colorSpace()) {
+
+        readOldBytes(realSourceDevice, QRect(srcPoint, QSize(sw, sh)), m_fixedSrcDab);
+
+        painter()->bltFixedWithFixedSelection(dstRect.x(), dstRect.y(),
+                                              m_fixedSrcDab, dab,
+                                              sw, sh);
+
+        if (painter()->hasMirroring()) {
+            // the mirroring flips both the source and the mask in place
+            KisFixedPaintDeviceSP mask = dab;
+            if (!m_dabCache->needSeparateOriginal()) {
+                mask = new KisFixedPaintDevice(*dab);
+            }
+            painter()->renderMirrorMask(dstRect, m_fixedSrcDab, mask);
+        }
+
+        painter()->setOpacityF(opacity);
+
+        return effectiveSpacing(scale);
+    }
+
     // Perspective correction ?
 
 
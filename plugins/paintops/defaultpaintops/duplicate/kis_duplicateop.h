@@ -58,7 +58,9 @@ private:
     KisDuplicateOptionData m_duplicateOptionData;
     KisDuplicateOpSettingsSP m_settings;
     KisPaintDeviceSP m_srcdev;
+    KisFixedPaintDeviceSP m_fixedSrcDab;
     KisPaintDeviceSP m_target;
+    bool m_useDirectSampling {true};
     QPointF m_duplicateStart {QPointF(0.0, 0.0)};
     bool m_duplicateStartIsSet {false};
     KisSizeOption m_sizeOption;
@@ -35,6 +35,20 @@
 #include <kis_lod_transform.h>
 #include <kis_spacing_information.h>
 #include <KisFilterOptionData.h>
+#include <kis_algebra_2d.h>
+#include <kis_pointer_utils.h>
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
+namespace {
+
+/**
+ * The cells span 4x4 tiles of the filtered device, so that the border
+ * of the needed rect of the filter is not re-read too often
+ */
+const int filteredCellSize = 256;
+
+}
 
 
 KisFilterOp::KisFilterOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
@@ -60,6 +74,11 @@ KisFilterOp::KisFilterOp(const KisPaintOpSettingsSP settings, KisPainter *painte
     }
     m_smudgeMode = data.smudgeMode;
 
+    m_useFilteredCells = m_filter && !m_smudgeMode && m_filter->supportsThreading();
+    if (m_useFilteredCells) {
+        m_filteredDevice = source()->createCompositionSourceDevice();
+    }
+
     m_rotationOption.applyFanCornersInfo(this);
 }
 
@@ -110,6 +129,24 @@ KisSpacingInformation KisFilterOp::paintAt(const KisPaintInformation& info)
     Q_ASSERT(dstRect.size() == dabRect.size());
 
 
+    if (m_useFilteredCells) {
+        if (m_useAsynchronousRendering) {
+            // the dab cache reuses its dab for the next fetch
+            DetachedDab detachedDab;
+            detachedDab.dstRect = dstRect;
+            detachedDab.dab = new KisFixedPaintDevice(*dab);
+            m_pendingDabs.append(detachedDab);
+        } else {
+            Q_FOREACH (const QRect &cellRect, takeMissingCells(dstRect)) {
+                filterCell(cellRect);
+            }
+
+            paintFilteredDab(painter(), dstRect, dab, !m_dabCache->needSeparateOriginal());
+        }
+
+        return effectiveSpacing(scale, rotation, info);
+    }
+
     // Filter the paint device
     QRect neededRect = m_filter->neededRect(dstRect, m_filterConfiguration, painter()->device()->defaultBounds()->currentLevelOfDetail());
 
@@ -135,6 +172,128 @@ KisSpacingInformation KisFilterOp::paintAt(const KisPaintInformation& info)
     return effectiveSpacing(scale, rotation, info);
 }
 
+QVector<QRect> KisFilterOp::takeMissingCells(const QRect &rc)
+{
+    QVector<QRect> cells;
+
+    /**
+     * The grid of the cells starts at the origin of the filtered
+     * device, so every cell covers whole tiles of it
+     */
+    const QPoint origin(m_filteredDevice->x(), m_filteredDevice->y());
+    const QRect deviceRect = rc.translated(-origin);
+
+    const int firstRow = KisAlgebra2D::divideFloor(deviceRect.top(), filteredCellSize);
+    const int lastRow = KisAlgebra2D::divideFloor(deviceRect.bottom(), filteredCellSize);
+    const int firstColumn = KisAlgebra2D::divideFloor(deviceRect.left(), filteredCellSize);
+    const int lastColumn = KisAlgebra2D::divideFloor(deviceRect.right(), filteredCellSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            const std::pair<int, int> cell(row, column);
+            if (m_filteredCells.contains(cell)) continue;
+
+            m_filteredCells.insert(cell);
+            cells.append(QRect(column * filteredCellSize, row * filteredCellSize,
+                               filteredCellSize, filteredCellSize).translated(origin));
+        }
+    }
+
+    return cells;
+}
+
+void KisFilterOp::filterCell(const QRect &cellRect) const
+{
+    /**
+     * Every cell is filtered in its own temporary device, so the cells
+     * can be filtered concurrently. A cell covers whole tiles of the
+     * filtered device (see takeMissingCells()), so the jobs never write
+     * into the same tile of it.
+     */
+    KisPaintDeviceSP tmpDevice = source()->createCompositionSourceDevice();
+
+    const QRect neededRect = m_filter->neededRect(cellRect, m_filterConfiguration, source()->defaultBounds()->currentLevelOfDetail());
+
+    KisPainter p(tmpDevice);
+    p.setCompositeOpId(COMPOSITE_COPY);
+    p.bitBltOldData(neededRect.topLeft(), source(), neededRect);
+
+    KisTransaction transaction(tmpDevice);
+    m_filter->process(tmpDevice, cellRect, m_filterConfiguration, 0);
+    transaction.end();
+
+    KisPainter::copyAreaOptimized(cellRect.topLeft(), tmpDevice, m_filteredDevice, cellRect);
+}
+
+void KisFilterOp::paintFilteredDab(KisPainter *painter, const QRect &dstRect,
+                                   KisFixedPaintDeviceSP dab, bool preserveDab) const
+{
+    painter->bitBltWithFixedSelection(dstRect.x(), dstRect.y(),
+                                      m_filteredDevice, dab,
+                                      0, 0,
+                                      dstRect.x(), dstRect.y(),
+                                      dstRect.width(), dstRect.height());
+
+    painter->renderMirrorMaskSafe(dstRect, m_filteredDevice, dstRect.x(), dstRect.y(), dab,
+                                  preserveDab);
+}
+
+struct KisFilterOp::UpdateSharedState
+{
+    KisPainter *painter = 0;
+    QVector<DetachedDab> dabs;
+};
+
+std::pair<int, bool> KisFilterOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    if (!m_useFilteredCells) {
+        return KisBrushBasedPaintOp::doAsynchronousUpdate(jobs);
+    }
+
+    /**
+     * The dabs are painted right in paintAt() until the stroke
+     * requests the first asynchronous update. After that the stroke
+     * is guaranteed to request the updates until all the dabs are
+     * painted.
+     */
+    m_useAsynchronousRendering = true;
+
+    const int updatePeriod = 20;
+
+    if (m_updateSharedState || m_pendingDabs.isEmpty()) {
+        return std::make_pair(updatePeriod, !m_pendingDabs.isEmpty());
+    }
+
+    m_updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_updateSharedState;
+
+    state->painter = painter();
+    state->dabs.swap(m_pendingDabs);
+
+    Q_FOREACH (const DetachedDab &dab, state->dabs) {
+        Q_FOREACH (const QRect &cellRect, takeMissingCells(dab.dstRect)) {
+            KritaUtils::addJobConcurrent(jobs,
+                [this, cellRect] () {
+                    filterCell(cellRect);
+                }
+            );
+        }
+    }
+
+    // the dabs overlap, so they are composited strictly in order
+    KritaUtils::addJobSequential(jobs,
+        [state, this] () {
+            Q_FOREACH (const DetachedDab &dab, state->dabs) {
+                paintFilteredDab(state->painter, dab.dstRect, dab.dab, false);
+            }
+
+            m_updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(updatePeriod, false);
+}
+
 KisSpacingInformation KisFilterOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     const qreal scale = m_sizeOption.apply(info) * KisLodTransform::lodToScale(painter()->device());
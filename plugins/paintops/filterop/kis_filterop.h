@@ -11,6 +11,8 @@
 #ifndef KIS_FILTEROP_H_
 #define KIS_FILTEROP_H_
 
+#include <QSet>
+
 #include "kis_brush_based_paintop.h"
 #include <KisStandardOptions.h>
 #include <KisRotationOption.h>
@@ -31,12 +33,29 @@ public:
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
     static QList<KoResourceLoadResult> prepareEmbeddedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
 
     KisSpacingInformation updateSpacingImpl(const KisPaintInformation &info) const override;
 
+private:
+
+    QVector<QRect> takeMissingCells(const QRect &rc);
+    void filterCell(const QRect &cellRect) const;
+    void paintFilteredDab(KisPainter *painter, const QRect &dstRect,
+                          KisFixedPaintDeviceSP dab, bool preserveDab) const;
+
+    struct DetachedDab {
+        QRect dstRect;
+        KisFixedPaintDeviceSP dab;
+    };
+
+    struct UpdateSharedState;
+    typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
 private:
 
     KisPaintDeviceSP m_tmpDevice;
@@ -45,6 +64,19 @@ private:
     KisFilterSP m_filter;
     KisFilterConfigurationSP m_filterConfiguration;
     bool m_smudgeMode;
+
+    /**
+     * In the non-smudge mode every dab filters the original pixels of
+     * the layer, so the filter is applied only once per cell of the
+     * stroke and the dabs are masked from the filtered cells
+     */
+    bool m_useFilteredCells {false};
+    KisPaintDeviceSP m_filteredDevice;
+    QSet<std::pair<int, int>> m_filteredCells;
+
+    bool m_useAsynchronousRendering {false};
+    QVector<DetachedDab> m_pendingDabs;
+    UpdateSharedStateSP m_updateSharedState;
 };
 
 #endif // KIS_FILTEROP_H_
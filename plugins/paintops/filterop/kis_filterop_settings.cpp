@@ -84,3 +84,16 @@ bool KisFilterOpSettings::hasPatternSettings() const
 {
     return false;
 }
+
+bool KisFilterOpSettings::needsAsynchronousUpdates() const
+{
+    /**
+     * In the smudge mode every dab filters the result of the previous
+     * dabs, so it is painted right in paintAt()
+     */
+    KisFilterOptionData data;
+    data.read(this);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->get(data.filterId);
+    return filter && !data.smudgeMode && filter->supportsThreading();
+}
@@ -37,6 +37,8 @@ public:
     void fromXML(const QDomElement& e) override;
 
     bool hasPatternSettings() const override;
+
+    bool needsAsynchronousUpdates() const override;
 };
 
 
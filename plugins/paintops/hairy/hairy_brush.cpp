@@ -14,6 +14,7 @@
 #include <QVariant>
 #include <QHash>
 #include <QVector>
+#include <QtMath>
 
 #include <kis_types.h>
 #include <kis_random_accessor_ng.h>
@@ -23,6 +24,7 @@
 
 #include <cmath>
 #include <ctime>
+#include <limits>
 
 
 HairyBrush::HairyBrush()
@@ -150,11 +152,17 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
     qreal randomX, randomY;
     qreal shear;
 
-    float inkDepletion = 0.0;
-    int inkDepletionSize = m_properties->inkDepletionCurve.size();
     int bristleCount = m_bristles.size();
-    int bristlePathSize;
     qreal threshold = 1.0 - pi2.pressure();
+
+    m_segments.clear();
+    m_segments.reserve(bristleCount);
+
+    qreal minX = std::numeric_limits<qreal>::max();
+    qreal minY = std::numeric_limits<qreal>::max();
+    qreal maxX = std::numeric_limits<qreal>::lowest();
+    qreal maxY = std::numeric_limits<qreal>::lowest();
+
     for (int i = 0; i < bristleCount; i++) {
 
         if (!m_bristles.at(i)->enabled()) continue;
@@ -195,44 +203,132 @@ void HairyBrush::paintLine(KisPaintDeviceSP dab, KisPaintDeviceSP layer, const K
         fy2 += y2;
 
         if (m_properties->threshold && (bristle->length() < threshold)) continue;
-        // paint between first and last dab
-        const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(QPointF(fx1, fy1), QPointF(fx2, fy2), 1.0);
-        bristlePathSize = m_trajectory.size();
 
-        // avoid overlapping bristle caps with antialias on
-        if (m_properties->antialias) {
-            bristlePathSize -= 1;
-        }
+        const BristleSegment segment = {bristle, QPointF(fx1, fy1), QPointF(fx2, fy2)};
+        m_segments.append(segment);
+
+        minX = qMin(minX, qMin(fx1, fx2));
+        minY = qMin(minY, qMin(fy1, fy2));
+        maxX = qMax(maxX, qMax(fx1, fx2));
+        maxY = qMax(maxY, qMax(fy1, fy2));
+    }
 
-        memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
-        for (int i = 0; i < bristlePathSize ; i++) {
+    /**
+     * In the batched mode all the bristles paint into a local buffer,
+     * which is composited into the dab in one go. The dab is transparent,
+     * so the result is exactly the same as painting the pixels one by one.
+     */
+    const bool useBatch = m_properties->batchedCompositing && !m_segments.isEmpty();
+
+    if (useBatch) {
+        // the particles and the rounded pixels may reach the next pixel
+        const QRect rect(QPoint(qFloor(minX) - 1, qFloor(minY) - 1),
+                         QPoint(qCeil(maxX) + 1, qCeil(maxY) + 1));
+        beginBatch(rect);
+    }
 
-            if (m_properties->inkDepletionEnabled) {
-                inkDepletion = fetchInkDepletion(bristle, inkDepletionSize);
+    for (const BristleSegment &segment : qAsConst(m_segments)) {
+        paintBristleSegment(segment, bristleColor, pressure);
+    }
 
-                if (m_properties->useSaturation && m_transfo != 0) {
-                    saturationDepletion(bristle, bristleColor, pressure, inkDepletion);
-                }
+    if (useBatch) {
+        endBatch();
+    }
 
-                if (m_properties->useOpacity) {
-                    opacityDepletion(bristle, bristleColor, pressure, inkDepletion);
-                }
+    m_segments.clear();
+    m_dab = nullptr;
+    m_dabAccessor = nullptr;
+}
+
+void HairyBrush::paintBristleSegment(const BristleSegment &segment, KoColor &bristleColor, qreal pressure)
+{
+    Bristle *bristle = segment.bristle;
+
+    float inkDepletion = 0.0;
+    int inkDepletionSize = m_properties->inkDepletionCurve.size();
+
+    // paint between first and last dab
+    const QVector<QPointF> bristlePath = m_trajectory.getLinearTrajectory(segment.start, segment.end, 1.0);
+    int bristlePathSize = m_trajectory.size();
+
+    // avoid overlapping bristle caps with antialias on
+    if (m_properties->antialias) {
+        bristlePathSize -= 1;
+    }
+
+    memcpy(bristleColor.data(), bristle->color().data() , m_pixelSize);
+    for (int i = 0; i < bristlePathSize ; i++) {
+
+        if (m_properties->inkDepletionEnabled) {
+            inkDepletion = fetchInkDepletion(bristle, inkDepletionSize);
 
+            if (m_properties->useSaturation && m_transfo != 0) {
+                saturationDepletion(bristle, bristleColor, pressure, inkDepletion);
             }
-            else {
-                if (bristleColor.opacityU8() != 0) {
-                    bristleColor.setOpacity(bristle->length());
-                }
+
+            if (m_properties->useOpacity) {
+                opacityDepletion(bristle, bristleColor, pressure, inkDepletion);
             }
 
-            addBristleInk(bristle, bristlePath.at(i), bristleColor);
-            bristle->setInkAmount(1.0 - inkDepletion);
-            bristle->upIncrement();
+        }
+        else {
+            if (bristleColor.opacityU8() != 0) {
+                bristleColor.setOpacity(bristle->length());
+            }
         }
 
+        addBristleInk(bristle, bristlePath.at(i), bristleColor);
+        bristle->setInkAmount(1.0 - inkDepletion);
+        bristle->upIncrement();
     }
-    m_dab = nullptr;
-    m_dabAccessor = nullptr;
+}
+
+void HairyBrush::beginBatch(const QRect &rect)
+{
+    m_batchRect = rect;
+
+    const size_t numPixels = size_t(rect.width()) * rect.height();
+    m_batchBuffer.resize(numPixels * m_pixelSize);
+
+    const KoColor transparent = KoColor::createTransparent(m_dab->colorSpace());
+    quint8 *ptr = m_batchBuffer.data();
+    for (size_t i = 0; i < numPixels; i++) {
+        memcpy(ptr, transparent.data(), m_pixelSize);
+        ptr += m_pixelSize;
+    }
+
+    m_isBatchActive = true;
+}
+
+void HairyBrush::endBatch()
+{
+    m_isBatchActive = false;
+
+    const int rowStride = m_batchRect.width() * m_pixelSize;
+
+    m_dstBuffer.resize(m_batchBuffer.size());
+    m_dab->readBytes(m_dstBuffer.data(), m_batchRect);
+
+    m_compositeOp->composite(m_dstBuffer.data(), rowStride,
+                             m_batchBuffer.data(), rowStride,
+                             0, 0,
+                             m_batchRect.height(), m_batchRect.width(),
+                             OPACITY_OPAQUE_F);
+
+    m_dab->writeBytes(m_dstBuffer.data(), m_batchRect);
+}
+
+inline quint8* HairyBrush::pixelPtr(int x, int y)
+{
+    // the pixels outside the batch rect (if any) are not touched by
+    // endBatch(), so they can safely be painted right into the dab
+    if (m_isBatchActive && m_batchRect.contains(x, y)) {
+        return m_batchBuffer.data() +
+            (size_t(y - m_batchRect.y()) * m_batchRect.width() + (x - m_batchRect.x())) * m_pixelSize;
+    }
+
+    m_dabAccessor->moveTo(x, y);
+    return m_dabAccessor->rawData();
 }
 
 
@@ -332,26 +428,27 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color, qreal weight)
     quint8 bbr = qRound((fx)  * (fy)  * opacity);
 
     const KoColorSpace * cs = m_dab->colorSpace();
-
-    m_dabAccessor->moveTo(ipx  , ipy);
-    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy);
-    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), btr, 1);
-
-    m_dabAccessor->moveTo(ipx, ipy + 1);
-    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbl, 1);
-
-    m_dabAccessor->moveTo(ipx + 1, ipy + 1);
-    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(m_dabAccessor->rawData()), OPACITY_OPAQUE_U8));
-    memcpy(m_dabAccessor->rawData(), color.data(), cs->pixelSize());
-    cs->setOpacity(m_dabAccessor->rawData(), bbr, 1);
+    quint8 *pixel = 0;
+
+    pixel = pixelPtr(ipx  , ipy);
+    btl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btl + cs->opacityU8(pixel), OPACITY_OPAQUE_U8));
+    memcpy(pixel, color.data(), cs->pixelSize());
+    cs->setOpacity(pixel, btl, 1);
+
+    pixel = pixelPtr(ipx + 1, ipy);
+    btr =  quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, btr + cs->opacityU8(pixel), OPACITY_OPAQUE_U8));
+    memcpy(pixel, color.data(), cs->pixelSize());
+    cs->setOpacity(pixel, btr, 1);
+
+    pixel = pixelPtr(ipx, ipy + 1);
+    bbl = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbl + cs->opacityU8(pixel), OPACITY_OPAQUE_U8));
+    memcpy(pixel, color.data(), cs->pixelSize());
+    cs->setOpacity(pixel, bbl, 1);
+
+    pixel = pixelPtr(ipx + 1, ipy + 1);
+    bbr = quint8(qBound<quint16>(OPACITY_TRANSPARENT_U8, bbr + cs->opacityU8(pixel), OPACITY_OPAQUE_U8));
+    memcpy(pixel, color.data(), cs->pixelSize());
+    cs->setOpacity(pixel, bbr, 1);
 }
 
 void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
@@ -386,15 +483,14 @@ void HairyBrush::paintParticle(QPointF pos, const KoColor& color)
 
 inline void HairyBrush::plotPixel(int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    m_compositeOp->composite(m_dabAccessor->rawData(), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
+    m_compositeOp->composite(pixelPtr(wx, wy), m_pixelSize, color.data() , m_pixelSize, 0, 0, 1, 1, OPACITY_OPAQUE_F);
 }
 
 inline void HairyBrush::darkenPixel(int wx, int wy, const KoColor &color)
 {
-    m_dabAccessor->moveTo(wx, wy);
-    if (m_dab->colorSpace()->opacityU8(m_dabAccessor->rawData()) < color.opacityU8()) {
-        memcpy(m_dabAccessor->rawData(), color.data(), m_pixelSize);
+    quint8 *pixel = pixelPtr(wx, wy);
+    if (m_dab->colorSpace()->opacityU8(pixel) < color.opacityU8()) {
+        memcpy(pixel, color.data(), m_pixelSize);
     }
 }
 
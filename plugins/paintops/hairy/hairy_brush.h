@@ -9,8 +9,11 @@
 
 #include <QVector>
 #include <QList>
+#include <QRect>
 #include <QTransform>
 
+#include <vector>
+
 #include <KoColor.h>
 
 #include "trajectory.h"
@@ -41,6 +44,8 @@ public:
     bool connectedPath;
     bool antialias;
     bool useCompositing;
+    /// accumulate the ink of all bristles in a local buffer and composite it once
+    bool batchedCompositing;
 
     quint8 pressureWeight;
     quint8 bristleLengthWeight;
@@ -74,6 +79,21 @@ public:
     void fromDabWithDensity(KisFixedPaintDeviceSP dab, qreal density);
 
 private:
+    struct BristleSegment {
+        Bristle *bristle;
+        QPointF start;
+        QPointF end;
+    };
+
+    /// paints the path of a single bristle between two dabs
+    void paintBristleSegment(const BristleSegment &segment, KoColor &bristleColor, qreal pressure);
+    /// prepares a transparent local buffer covering \p rect
+    void beginBatch(const QRect &rect);
+    /// composites the local buffer into the dab
+    void endBatch();
+    /// @return a pointer to the pixel in the local buffer or in the dab
+    quint8* pixelPtr(int x, int y);
+
     /// paints single bristle
     void addBristleInk(Bristle *bristle,const QPointF &pos, const KoColor &color);
     /// composite single pixel to dab
@@ -112,6 +132,13 @@ private:
     // temporary device
     KisPaintDeviceSP m_dab;
     KisRandomAccessorSP m_dabAccessor;
+
+    // the bristles' ink accumulated in the batched mode
+    QVector<BristleSegment> m_segments;
+    bool m_isBatchActive {false};
+    QRect m_batchRect;
+    std::vector<quint8> m_batchBuffer;
+    std::vector<quint8> m_dstBuffer;
     const KoCompositeOp * m_compositeOp {nullptr};
     quint32 m_pixelSize {0};
 
@@ -29,6 +29,13 @@
 
 #include "kis_brush.h"
 
+/**
+ * The batched compositing of the bristles produces exactly the same result
+ * as painting the pixels one by one, so the option is not exposed in the GUI.
+ * The per-pixel path is kept for benchmarking.
+ */
+const QString HAIRY_BRISTLE_BATCHED_COMPOSITING = "HairyBristle/batchedCompositing";
+
 KisHairyPaintOp::KisHairyPaintOp(const KisPaintOpSettingsSP settings, KisPainter * painter, KisNodeSP node, KisImageSP image)
     : KisPaintOp(painter)
     , m_opacityOption(settings.data())
@@ -63,6 +70,7 @@ KisHairyPaintOp::KisHairyPaintOp(const KisPaintOpSettingsSP settings, KisPainter
     m_brush.setInkColor(painter->paintColor());
 
     loadSettings();
+    m_properties.batchedCompositing = settings->getBool(HAIRY_BRISTLE_BATCHED_COMPOSITING, true);
     m_brush.setProperties(&m_properties);
 }
 
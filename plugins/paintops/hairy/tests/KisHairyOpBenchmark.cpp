@@ -0,0 +1,129 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisHairyOpBenchmark.h"
+
+#include "kistest.h"
+
+#include <stroke_testing_utils.h>
+#include <KisGlobalResourcesInterface.h>
+#include <strokes/KisFreehandStrokeInfo.h>
+#include <strokes/freehand_stroke.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_registry.h>
+#include <brushengine/kis_paintop_settings.h>
+#include <KoCanvasResourcesIds.h>
+#include <kis_auto_brush.h>
+#include <kis_brush_option.h>
+#include <kis_circle_mask_generator.h>
+#include <kis_image.h>
+
+
+class HairyBenchmarkTester : public utils::StrokeTester
+{
+public:
+    HairyBenchmarkTester(int brushDiameter, bool antialias, bool batchedCompositing)
+        : StrokeTester("hairy_benchmark", QSize(3000, 3000), QString()),
+          m_brushDiameter(brushDiameter),
+          m_antialias(antialias),
+          m_batchedCompositing(batchedCompositing)
+    {
+    }
+
+protected:
+    using utils::StrokeTester::modifyResourceManager;
+    void modifyResourceManager(KoCanvasResourceProvider *manager, KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisPaintOpPresetSP preset =
+            KisPaintOpRegistry::instance()->defaultPreset(KoID("hairybrush"),
+                                                          KisGlobalResourcesInterface::instance());
+
+        KisPaintOpSettingsSP settings = preset->settings();
+
+        // every pixel of the brush tip becomes a bristle
+        KisCircleMaskGenerator *circle =
+            new KisCircleMaskGenerator(m_brushDiameter, 1.0, 1.0, 1.0, 2, false);
+
+        KisBrushOptionProperties brushOption;
+        brushOption.setBrush(KisBrushSP(new KisAutoBrush(circle, 0.0, 0.0)));
+        brushOption.writeOptionSetting(settings);
+
+        settings->setProperty("HairyBristle/density", 100.0);
+        settings->setProperty("HairyBristle/antialias", m_antialias);
+        settings->setProperty("HairyBristle/useCompositing", true);
+        settings->setProperty("HairyBristle/batchedCompositing", m_batchedCompositing);
+
+        QVariant i;
+        i.setValue(preset);
+        manager->setResource(KoCanvasResource::CurrentPaintOpPreset, i);
+    }
+
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo();
+
+        QScopedPointer<FreehandStrokeStrategy> stroke(
+            new FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")));
+
+        return stroke.take();
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources) override {
+        Q_UNUSED(resources);
+
+        for (int y = 100; y < 2900; y += 200) {
+            for (int x = 100; x < 2900; x += 20) {
+                KisPaintInformation pi1(QPointF(x, y), 1.0);
+                KisPaintInformation pi2(QPointF(x + 20, y + 5), 1.0);
+
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, pi1, pi2));
+            }
+        }
+    }
+
+private:
+    int m_brushDiameter = 30;
+    bool m_antialias = false;
+    bool m_batchedCompositing = true;
+};
+
+void KisHairyOpBenchmark::benchmarkStroke_data()
+{
+    QTest::addColumn<int>("brushDiameter");
+    QTest::addColumn<bool>("antialias");
+    QTest::addColumn<bool>("batchedCompositing");
+
+    // 30px and 60px tips give ~700 and ~2800 bristles
+    Q_FOREACH (int diameter, QVector<int>({30, 60})) {
+        Q_FOREACH (bool antialias, QVector<bool>({false, true})) {
+            Q_FOREACH (bool batched, QVector<bool>({false, true})) {
+                QTest::addRow("%dpx_%s_%s", diameter,
+                              antialias ? "aa" : "noaa",
+                              batched ? "batched" : "perpixel")
+                    << diameter << antialias << batched;
+            }
+        }
+    }
+}
+
+void KisHairyOpBenchmark::benchmarkStroke()
+{
+    QFETCH(int, brushDiameter);
+    QFETCH(bool, antialias);
+    QFETCH(bool, batchedCompositing);
+
+    HairyBenchmarkTester tester(brushDiameter, antialias, batchedCompositing);
+    tester.benchmark();
+
+    qDebug() << qPrintable(QString("Time: %1 (ms)").arg(tester.lastStrokeTime()));
+}
+
+KISTEST_MAIN(KisHairyOpBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISHAIRYOPBENCHMARK_H
+#define KISHAIRYOPBENCHMARK_H
+
+#include <QtTest>
+
+class KisHairyOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void benchmarkStroke();
+    void benchmarkStroke_data();
+};
+
+#endif // KISHAIRYOPBENCHMARK_H
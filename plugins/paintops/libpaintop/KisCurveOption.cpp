@@ -97,6 +97,18 @@ KisCurveOption::KisCurveOption(const KisCurveOptionData &data)
     , m_strengthMaxValue(data.strengthMaxValue)
     , m_sensors(generateSensors(data))
 {
+    // the sensors are evaluated in the original order, because
+    // the fuzzy sensors consume the random source of the dab
+    for (auto it = m_sensors.cbegin(); it != m_sensors.cend(); ++it) {
+        const KisDynamicSensor *sensor = it->get();
+
+        const SensorKind kind =
+            sensor->isAdditive() ? AdditiveSensor :
+            sensor->isAbsoluteRotation() ? AbsoluteRotationSensor :
+            ScalingSensor;
+
+        m_compiledSensors.push_back({sensor, kind});
+    }
 }
 
 KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const KisPaintInformation& info, bool useStrengthValue) const
@@ -104,52 +116,61 @@ KisCurveOption::ValueComponents KisCurveOption::computeValueComponents(const Kis
     ValueComponents components;
 
     if (m_useCurve) {
-        QList<double> sensorValues;
-        for (auto i = m_sensors.cbegin(); i != m_sensors.cend(); ++i) {
-            KisDynamicSensor *s(i->get());
-
-            qreal valueFromCurve = s->parameter(info);
-            if (s->isAdditive()) {
+        /**
+         * All the combination modes are accumulated in a single pass,
+         * so no temporary list of the values is needed
+         */
+        int numScalingValues = 0;
+        qreal firstScalingValue = 0.0;
+        qreal scalingSum = 0.0;
+        qreal scalingProduct = 1.0;
+        qreal scalingMax = 0.0;
+        qreal scalingMin = 0.0;
+
+        for (const CompiledSensor &compiled : m_compiledSensors) {
+            const qreal valueFromCurve = compiled.sensor->parameter(info);
+
+            switch (compiled.kind) {
+            case AdditiveSensor:
                 components.additive += valueFromCurve;
                 components.hasAdditive = true;
-            } else if (s->isAbsoluteRotation()) {
+                break;
+            case AbsoluteRotationSensor:
                 components.absoluteOffset = valueFromCurve;
-                components.hasAbsoluteOffset =true;
-            } else {
-                sensorValues << valueFromCurve;
+                components.hasAbsoluteOffset = true;
+                break;
+            case ScalingSensor:
+                if (!numScalingValues) {
+                    firstScalingValue = valueFromCurve;
+                    scalingMax = valueFromCurve;
+                    scalingMin = valueFromCurve;
+                } else {
+                    scalingMax = qMax(scalingMax, valueFromCurve);
+                    scalingMin = qMin(scalingMin, valueFromCurve);
+                }
+                scalingSum += valueFromCurve;
+                scalingProduct *= valueFromCurve;
+                numScalingValues++;
                 components.hasScaling = true;
+                break;
             }
         }
 
-        if (sensorValues.count() == 1) {
-            components.scaling = sensorValues.first();
-        } else {
-
-            if (m_curveMode == 1){           // add
-                components.scaling = 0;
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling += i;
-                }
-            } else if (m_curveMode == 2){    //max
-                components.scaling = *std::max_element(sensorValues.begin(), sensorValues.end());
-
-            } else if (m_curveMode == 3){    //min
-                components.scaling = *std::min_element(sensorValues.begin(), sensorValues.end());
-
-            } else if (m_curveMode == 4){    //difference
-                double max = *std::max_element(sensorValues.begin(), sensorValues.end());
-                double min = *std::min_element(sensorValues.begin(), sensorValues.end());
-                components.scaling = max-min;
-
-            } else {                         //multuply - default
-                double i;
-                foreach (i, sensorValues) {
-                    components.scaling *= i;
-                }
-            }
+        if (numScalingValues == 1) {
+            components.scaling = firstScalingValue;
+        } else if (m_curveMode == 1) {      // add
+            components.scaling = scalingSum;
+        } else if (!numScalingValues) {
+            // no values to combine, keep the default
+        } else if (m_curveMode == 2) {      //max
+            components.scaling = scalingMax;
+        } else if (m_curveMode == 3) {      //min
+            components.scaling = scalingMin;
+        } else if (m_curveMode == 4) {      //difference
+            components.scaling = scalingMax - scalingMin;
+        } else {                            //multiply - default
+            components.scaling = scalingProduct;
         }
-
     }
 
     if (useStrengthValue) {
@@ -62,6 +62,23 @@ public:
     bool isChecked() const;
     bool isRandom() const;
 
+private:
+    /**
+     * The role of the sensor in the combined value. It is resolved once
+     * when the option is created, so that the per-dab evaluation doesn't
+     * need to query every sensor.
+     */
+    enum SensorKind {
+        ScalingSensor,
+        AdditiveSensor,
+        AbsoluteRotationSensor
+    };
+
+    struct CompiledSensor {
+        const KisDynamicSensor *sensor;
+        SensorKind kind;
+    };
+
 private:
     bool m_isChecked;
     bool m_useCurve;
@@ -70,6 +87,7 @@ private:
     qreal m_strengthMinValue;
     qreal m_strengthMaxValue;
     std::vector<std::unique_ptr<KisDynamicSensor>> m_sensors;
+    std::vector<CompiledSensor> m_compiledSensors;
 };
 
 #endif // KISCURVEOPTION_H
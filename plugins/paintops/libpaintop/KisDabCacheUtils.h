@@ -16,6 +16,7 @@
 #include <kis_paint_information.h>
 #include <KisMirrorProperties.h>
 #include "kis_dab_shape.h"
+#include "KisDabShapeCache.h"
 
 #include "kritapaintop_export.h"
 #include <functional>
@@ -93,6 +94,10 @@ struct PAINTOP_EXPORT DabGenerationInfo
     qreal lightnessStrength = 1.0;
 
     bool needsPostprocessing = false;
+
+    /// the key of the dab in the per-stroke shape cache, invalid
+    /// if the dab cannot be cached
+    KisDabShapeCacheKey shapeCacheKey;
 };
 
 PAINTOP_EXPORT QRect correctDabRectWhenFetchedFromCache(const QRect &dabRect,
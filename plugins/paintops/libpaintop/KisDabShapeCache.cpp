@@ -0,0 +1,198 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisDabShapeCache.h"
+
+#include <list>
+
+#include <QHash>
+
+#include <KoColorSpace.h>
+#include <kis_debug.h>
+#include <kis_fixed_paint_device.h>
+
+
+bool KisDabShapeCacheKey::operator==(const KisDabShapeCacheKey &rhs) const
+{
+    return isValid == rhs.isValid &&
+           precisionLevel == rhs.precisionLevel &&
+           brushIndex == rhs.brushIndex &&
+           width == rhs.width &&
+           height == rhs.height &&
+           angle == rhs.angle &&
+           subPixelX == rhs.subPixelX &&
+           subPixelY == rhs.subPixelY &&
+           softnessFactor == rhs.softnessFactor &&
+           lightnessStrength == rhs.lightnessStrength &&
+           ratio == rhs.ratio &&
+           horizontalMirror == rhs.horizontalMirror &&
+           verticalMirror == rhs.verticalMirror &&
+           color == rhs.color;
+}
+
+uint qHash(const KisDabShapeCacheKey &key, uint seed)
+{
+    uint hash = seed;
+
+    hash ^= ::qHash(key.precisionLevel) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.brushIndex) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.width) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.height) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.angle) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.subPixelX) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.subPixelY) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.softnessFactor) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.lightnessStrength) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(key.ratio) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= ::qHash(int(key.horizontalMirror) | int(key.verticalMirror) << 1) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+    if (key.color.colorSpace()) {
+        hash = qHashBits(key.color.data(), key.color.colorSpace()->pixelSize(), hash);
+    }
+
+    return hash;
+}
+
+
+struct KisDabShapeCache::Private
+{
+    struct Entry {
+        KisDabShapeCacheKey key;
+        KisFixedPaintDeviceSP dab;
+        qint64 bytes = 0;
+    };
+
+    using EntriesList = std::list<Entry>;
+
+    Private(int _maxEntries, qint64 _maxBytes)
+        : maxEntries(_maxEntries),
+          maxBytes(_maxBytes)
+    {
+    }
+
+    const int maxEntries;
+    const qint64 maxBytes;
+
+    /// the most recently used entries are at the front
+    EntriesList entries;
+    QHash<KisDabShapeCacheKey, EntriesList::iterator> index;
+    qint64 bytes = 0;
+
+    int hits = 0;
+    int misses = 0;
+
+    void evictLeastRecentlyUsed();
+};
+
+void KisDabShapeCache::Private::evictLeastRecentlyUsed()
+{
+    while (!entries.empty() &&
+           (int(entries.size()) > maxEntries || bytes > maxBytes)) {
+
+        const Entry &entry = entries.back();
+        bytes -= entry.bytes;
+        index.remove(entry.key);
+        entries.pop_back();
+    }
+}
+
+
+KisDabShapeCache::KisDabShapeCache(int maxEntries, qint64 maxBytes)
+    : m_d(new Private(maxEntries, maxBytes))
+{
+}
+
+KisDabShapeCache::~KisDabShapeCache()
+{
+    if (m_d->hits + m_d->misses > 0) {
+        dbgPlugins << "Dab shape cache:"
+                   << "hits" << m_d->hits
+                   << "misses" << m_d->misses
+                   << "hit rate" << hitRate()
+                   << "entries" << m_d->entries.size()
+                   << "bytes" << m_d->bytes;
+    }
+}
+
+KisFixedPaintDeviceSP KisDabShapeCache::fetch(const KisDabShapeCacheKey &key)
+{
+    if (!key.isValid) return KisFixedPaintDeviceSP();
+
+    auto it = m_d->index.find(key);
+    if (it == m_d->index.end()) {
+        m_d->misses++;
+        return KisFixedPaintDeviceSP();
+    }
+
+    m_d->hits++;
+
+    Private::EntriesList::iterator entryIt = it.value();
+    m_d->entries.splice(m_d->entries.begin(), m_d->entries, entryIt);
+
+    return entryIt->dab;
+}
+
+void KisDabShapeCache::put(const KisDabShapeCacheKey &key, KisFixedPaintDeviceSP dab)
+{
+    if (!key.isValid || !dab) return;
+
+    const qint64 dabBytes = qint64(dab->bounds().width()) * dab->bounds().height() *
+        dab->colorSpace()->pixelSize();
+
+    auto it = m_d->index.find(key);
+    if (it != m_d->index.end()) {
+        Private::EntriesList::iterator entryIt = it.value();
+
+        m_d->bytes += dabBytes - entryIt->bytes;
+        entryIt->dab = dab;
+        entryIt->bytes = dabBytes;
+        m_d->entries.splice(m_d->entries.begin(), m_d->entries, entryIt);
+    } else {
+        Private::Entry entry;
+        entry.key = key;
+        entry.dab = dab;
+        entry.bytes = dabBytes;
+
+        m_d->entries.push_front(entry);
+        m_d->index.insert(key, m_d->entries.begin());
+        m_d->bytes += dabBytes;
+    }
+
+    m_d->evictLeastRecentlyUsed();
+}
+
+void KisDabShapeCache::clear()
+{
+    m_d->entries.clear();
+    m_d->index.clear();
+    m_d->bytes = 0;
+}
+
+int KisDabShapeCache::size() const
+{
+    return int(m_d->entries.size());
+}
+
+qint64 KisDabShapeCache::bytes() const
+{
+    return m_d->bytes;
+}
+
+int KisDabShapeCache::hits() const
+{
+    return m_d->hits;
+}
+
+int KisDabShapeCache::misses() const
+{
+    return m_d->misses;
+}
+
+qreal KisDabShapeCache::hitRate() const
+{
+    const int total = m_d->hits + m_d->misses;
+    return total > 0 ? qreal(m_d->hits) / total : 0.0;
+}
@@ -0,0 +1,101 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISDABSHAPECACHE_H
+#define KISDABSHAPECACHE_H
+
+#include <QScopedPointer>
+
+#include <KoColor.h>
+#include "kis_types.h"
+
+#include "kritapaintop_export.h"
+
+
+/**
+ * The key of the dab in KisDabShapeCache. All the shape parameters of
+ * the dab are quantized into buckets of the size defined by the precision
+ * level of the paintop, so the dabs that would be considered "the same"
+ * by KisDabCacheBase fall into the same bucket.
+ *
+ * A default-constructed key is invalid, that is, the dab cannot be cached
+ */
+struct PAINTOP_EXPORT KisDabShapeCacheKey
+{
+    bool isValid = false;
+
+    int precisionLevel = 0;
+    int brushIndex = 0;
+    int width = 0;
+    int height = 0;
+    qint64 angle = 0;
+    qint64 subPixelX = 0;
+    qint64 subPixelY = 0;
+    qint64 softnessFactor = 0;
+    qint64 lightnessStrength = 0;
+    qint64 ratio = 0;
+    bool horizontalMirror = false;
+    bool verticalMirror = false;
+
+    KoColor color;
+
+    bool operator==(const KisDabShapeCacheKey &rhs) const;
+    bool operator!=(const KisDabShapeCacheKey &rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+PAINTOP_EXPORT uint qHash(const KisDabShapeCacheKey &key, uint seed = 0);
+
+
+/**
+ * @brief A bounded per-stroke LRU cache of the generated dabs
+ *
+ * KisDabCacheBase can reuse the previous dab only when the next one is
+ * nearly identical. With pressure-varying size or rotation jitter the
+ * shapes of the dabs keep jumping between a few values, so the dabs get
+ * regenerated by the mask generator all the time. This cache keeps the
+ * recently generated dabs, so the repeated shapes can be reused instead.
+ *
+ * The devices stored in the cache are shared with the cache and must
+ * never be modified after they have been put into it.
+ *
+ * The class is not thread-safe, the callers should serialize the access
+ * to it themselves.
+ */
+class PAINTOP_EXPORT KisDabShapeCache
+{
+public:
+    KisDabShapeCache(int maxEntries = 128, qint64 maxBytes = 32 * 1024 * 1024);
+    ~KisDabShapeCache();
+
+    /**
+     * @return the cached dab for \p key or null if there is no such
+     * dab in the cache. The dab becomes the most recently used one.
+     */
+    KisFixedPaintDeviceSP fetch(const KisDabShapeCacheKey &key);
+
+    /**
+     * Puts \p dab into the cache evicting the least recently used
+     * dabs if the cache gets too big. Invalid keys are ignored.
+     */
+    void put(const KisDabShapeCacheKey &key, KisFixedPaintDeviceSP dab);
+
+    void clear();
+
+    int size() const;
+    qint64 bytes() const;
+
+    int hits() const;
+    int misses() const;
+    qreal hitRate() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISDABSHAPECACHE_H
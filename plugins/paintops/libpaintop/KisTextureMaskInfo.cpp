@@ -16,7 +16,6 @@
 
 #include <kis_algebra_2d.h>
 #include <kis_lod_transform.h>
-#include <kis_iterator_ng.h>
 
 #include <QGlobalStatic>
 
@@ -103,6 +102,17 @@ KisPaintDeviceSP KisTextureMaskInfo::mask() {
     return m_mask;
 }
 
+const quint8 *KisTextureMaskInfo::maskData() const {
+    return !m_maskData.isEmpty() ? m_maskData.constData() : nullptr;
+}
+
+qint64 KisTextureMaskInfo::memoryFootprint() const {
+    if (!m_mask) return 0;
+
+    return qint64(m_maskBounds.width()) * m_maskBounds.height() * m_mask->pixelSize() +
+        m_maskData.size();
+}
+
 QRect KisTextureMaskInfo::maskBounds() const {
     return m_maskBounds;
 }
@@ -174,7 +184,12 @@ void KisTextureMaskInfo::recalculateMask()
     const int width = mask.width();
     const int height = mask.height();
 
-    KisHLineIteratorSP iter = m_mask->createHLineIteratorNG(0, 0, width);
+    if (useAlpha) {
+        m_maskData.clear();
+    } else {
+        m_maskData.resize(width * height);
+    }
+    quint8 *maskDataPtr = m_maskData.data();
 
     for (int row = 0; row < height; ++row) {
         for (int col = 0; col < width; ++col) {
@@ -228,16 +243,15 @@ void KisTextureMaskInfo::recalculateMask()
                 int finalValue = qRound(neutralAdjustedValue * 255.0);
                 pixel[row * width + col] = QColor(finalValue, finalValue, finalValue, qRound(alpha * 255.0)).rgba();
             } else {
-                cs->setOpacity(iter->rawData(), neutralAdjustedValue, 1);
-                iter->nextPixel();
+                cs->setOpacity(maskDataPtr, neutralAdjustedValue, 1);
+                maskDataPtr++;
             }
         }
-        if (!useAlpha) {
-            iter->nextRow();
-        }
     }
     if (useAlpha) {
         m_mask->convertFromQImage(mask, 0);
+    } else {
+        m_mask->writeBytes(m_maskData.constData(), 0, 0, width, height);
     }
     m_maskBounds = QRect(0, 0, width, height);
 }
@@ -260,13 +274,42 @@ KisTextureMaskInfoCache *KisTextureMaskInfoCache::instance()
 KisTextureMaskInfoSP KisTextureMaskInfoCache::fetchCachedTextureInfo(KisTextureMaskInfoSP info) {
     QMutexLocker locker(&m_mutex);
 
-    KisTextureMaskInfoSP &cachedInfo =
-            info->levelOfDetail() > 0 ? m_lodInfo : m_mainInfo;
-
-    if (!cachedInfo || *cachedInfo != *info) {
-        cachedInfo = info;
-        cachedInfo->recalculateMask();
+    for (auto it = m_infos.begin(); it != m_infos.end(); ++it) {
+        if (**it == *info) {
+            KisTextureMaskInfoSP cachedInfo = *it;
+            m_infos.erase(it);
+            m_infos.prepend(cachedInfo);
+            return cachedInfo;
+        }
     }
 
-    return cachedInfo;
+    info->recalculateMask();
+    m_infos.prepend(info);
+    evictLeastRecentlyUsed();
+
+    return info;
+}
+
+void KisTextureMaskInfoCache::evictLeastRecentlyUsed()
+{
+    /**
+     * The masks of the big patterns may take quite a lot of memory,
+     * so limit the total size of the cache as well. The most recently
+     * used mask is never evicted, since it has just been requested.
+     */
+    const int maxEntries = 16;
+    const qint64 maxBytes = 128 * 1024 * 1024;
+
+    qint64 bytes = 0;
+    int numEntries = 0;
+
+    for (auto it = m_infos.begin(); it != m_infos.end(); ++it) {
+        bytes += (*it)->memoryFootprint();
+        numEntries++;
+
+        if (numEntries > 1 && (numEntries > maxEntries || bytes > maxBytes)) {
+            m_infos.erase(it, m_infos.end());
+            break;
+        }
+    }
 }
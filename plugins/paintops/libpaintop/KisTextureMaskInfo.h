@@ -11,6 +11,7 @@
 #include <kis_paint_device.h>
 #include <QSharedPointer>
 #include <QMutex>
+#include <QVector>
 
 
 #include <boost/operators.hpp>
@@ -40,8 +41,24 @@ public:
 
     KisPaintDeviceSP mask();
 
+    /**
+     * The pre-converted alpha8 mask stored as a single contiguous
+     * buffer of maskBounds().width() * maskBounds().height() bytes.
+     * The texture option can read it directly instead of tiling the
+     * mask device into a temporary device for every dab.
+     *
+     * @return null if the mask is not an alpha8 one (that is, when
+     *         the alpha of the pattern is preserved)
+     */
+    const quint8 *maskData() const;
+
     QRect maskBounds() const;
 
+    /**
+     * @return an estimate of the memory used by the mask
+     */
+    qint64 memoryFootprint() const;
+
     bool fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface, bool invertAdditionally);
 
     void recalculateMask();
@@ -65,21 +82,34 @@ private:
     int m_cutoffPolicy = 0;
 
     KisPaintDeviceSP m_mask;
+    QVector<quint8> m_maskData;
     QRect m_maskBounds;
 
 };
 
 typedef QSharedPointer<KisTextureMaskInfo> KisTextureMaskInfoSP;
 
+/**
+ * A global LRU cache of the calculated texture masks. The masks are
+ * shared across all the strokes and keyed by all the properties of
+ * KisTextureMaskInfo, so every combination of the pattern, its scale,
+ * level of detail, brightness, contrast, etc. is converted only once.
+ * Switching between a few textured presets or painting on different
+ * levels of detail doesn't recalculate the masks anymore.
+ */
 struct KisTextureMaskInfoCache
 {
     static KisTextureMaskInfoCache *instance();
     KisTextureMaskInfoSP fetchCachedTextureInfo(KisTextureMaskInfoSP info);
 
+private:
+    void evictLeastRecentlyUsed();
+
 private:
     QMutex m_mutex;
-    QSharedPointer<KisTextureMaskInfo> m_lodInfo;
-    QSharedPointer<KisTextureMaskInfo> m_mainInfo;
+
+    /// the most recently used masks are at the front
+    QList<KisTextureMaskInfoSP> m_infos;
 };
 
 #endif // KISTEXTUREMASKINFO_H
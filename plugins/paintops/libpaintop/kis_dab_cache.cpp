@@ -215,11 +215,39 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
         return fetchFromCache(&resources, info, dstDabRect);
     }
 
-    // 3. Generate new dab
+    // 3. Try to reuse a dab with the same shape generated earlier in the stroke
+
+    const bool useShapeCache = di.shapeCacheKey.isValid && !forceNormalizedRGBAImageStamp;
+
+    if (useShapeCache) {
+        KisFixedPaintDeviceSP cachedDab = fetchDabFromShapeCache(di);
+
+        if (cachedDab && *cachedDab->colorSpace() == *cs) {
+            if (di.needsPostprocessing) {
+                m_d->dabOriginal = cachedDab;
+            } else {
+                m_d->dab = cachedDab;
+            }
+
+            return fetchFromCache(&resources, info, dstDabRect);
+        }
+
+        /**
+         * The devices we have might be still owned by the shape cache,
+         * so the new dab should be generated into fresh ones
+         */
+        if (di.needsPostprocessing) {
+            m_d->dabOriginal = new KisFixedPaintDevice(cs);
+        } else {
+            m_d->dab = new KisFixedPaintDevice(cs);
+        }
+    }
+
+    // 4. Generate new dab
 
     generateDab(di, &resources, &m_d->dab, forceNormalizedRGBAImageStamp);
 
-    // 4. Do postprocessing
+    // 5. Do postprocessing
     if (di.needsPostprocessing) {
         if (!m_d->dabOriginal || *cs != *m_d->dabOriginal->colorSpace()) {
             m_d->dabOriginal = new KisFixedPaintDevice(cs);
@@ -227,7 +255,13 @@ KisFixedPaintDeviceSP KisDabCache::fetchDabCommon(const KoColorSpace *cs,
 
         *m_d->dabOriginal = *m_d->dab;
 
+        if (useShapeCache) {
+            putDabToShapeCache(di, m_d->dabOriginal);
+        }
+
         postProcessDab(m_d->dab, di.dstDabRect.topLeft(), info, &resources);
+    } else if (useShapeCache) {
+        putDabToShapeCache(di, m_d->dab);
     }
 
     return m_d->dab;
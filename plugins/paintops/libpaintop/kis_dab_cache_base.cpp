@@ -16,6 +16,9 @@
 #include <kis_precision_option.h>
 #include <kis_fixed_paint_device.h>
 #include <brushengine/kis_paintop.h>
+#include <kis_global.h>
+
+#include <cmath>
 
 #include <kundo2command.h>
 
@@ -82,7 +85,10 @@ struct KisDabCacheBase::Private {
 
     SavedDabParameters lastSavedDabParameters;
 
+    KisDabShapeCache shapeCache;
+
     static qreal positiveFraction(qreal x);
+    static qint64 quantize(qreal value, qreal step);
 };
 
 
@@ -112,6 +118,11 @@ void KisDabCacheBase::disableSubpixelPrecision()
     m_d->subPixelPrecisionDisabled = true;
 }
 
+const KisDabShapeCache &KisDabCacheBase::shapeCache() const
+{
+    return m_d->shapeCache;
+}
+
 inline KisDabCacheBase::SavedDabParameters
 KisDabCacheBase::getDabParameters(KisBrushSP brush,
                               const KoColor& color,
@@ -168,6 +179,49 @@ qreal KisDabCacheBase::Private::positiveFraction(qreal x) {
     return fraction;
 }
 
+qint64 KisDabCacheBase::Private::quantize(qreal value, qreal step)
+{
+    return qint64(std::floor(value / step));
+}
+
+inline KisDabShapeCacheKey
+KisDabCacheBase::getShapeCacheKey(const SavedDabParameters &params, int precisionLevel) const
+{
+    const PrecisionValues &prec = precisionLevels[precisionLevel];
+
+    KisDabShapeCacheKey key;
+
+    key.isValid = true;
+    key.precisionLevel = precisionLevel;
+    key.brushIndex = params.index;
+
+    /**
+     * The size tolerance is relative, so the size buckets are spaced
+     * logarithmically. The exact size of the cached dab may differ, so
+     * the dab rect should be corrected when the dab is reused.
+     */
+    if (prec.sizeFrac > 0) {
+        const qreal logStep = std::log1p(prec.sizeFrac);
+        key.width = qRound(std::log(qMax(1, params.width)) / logStep);
+        key.height = qRound(std::log(qMax(1, params.height)) / logStep);
+    } else {
+        key.width = params.width;
+        key.height = params.height;
+    }
+
+    key.angle = Private::quantize(normalizeAngle(params.angle), prec.angle);
+    key.subPixelX = Private::quantize(params.subPixelX, prec.subPixel);
+    key.subPixelY = Private::quantize(params.subPixelY, prec.subPixel);
+    key.softnessFactor = Private::quantize(params.softnessFactor, prec.softnessFactor);
+    key.lightnessStrength = Private::quantize(params.lightnessStrength, prec.lightnessStrength);
+    key.ratio = Private::quantize(params.ratio, prec.ratio);
+    key.horizontalMirror = params.mirrorProperties.horizontalMirror;
+    key.verticalMirror = params.mirrorProperties.verticalMirror;
+    key.color = params.color;
+
+    return key;
+}
+
 inline
 KisDabCacheBase::DabPosition
 KisDabCacheBase::calculateDabRect(KisBrushSP brush,
@@ -281,8 +335,22 @@ void KisDabCacheBase::fetchDabGenerationInfo(bool hasDabInCache,
 
     if (!*shouldUseCache) {
         m_d->lastSavedDabParameters = newParams;
+
+        if (supportsCaching && di->solidColorFill) {
+            di->shapeCacheKey = getShapeCacheKey(newParams, precisionLevel);
+        }
     }
 
     di->needsPostprocessing = needSeparateOriginal(resources->textureOption.data(), resources->sharpnessOption.data());
 }
 
+
+KisFixedPaintDeviceSP KisDabCacheBase::fetchDabFromShapeCache(const KisDabCacheUtils::DabGenerationInfo &di)
+{
+    return m_d->shapeCache.fetch(di.shapeCacheKey);
+}
+
+void KisDabCacheBase::putDabToShapeCache(const KisDabCacheUtils::DabGenerationInfo &di, KisFixedPaintDeviceSP dab)
+{
+    m_d->shapeCache.put(di.shapeCacheKey, dab);
+}
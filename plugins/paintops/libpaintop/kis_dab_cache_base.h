@@ -63,6 +63,12 @@ public:
     bool needSeparateOriginal(KisTextureOption *textureOption,
                               KisSharpnessOption *sharpnessOption) const;
 
+    /**
+     * The per-stroke cache of the recently generated dabs, see
+     * KisDabShapeCache for details
+     */
+    const KisDabShapeCache& shapeCache() const;
+
 protected:
     /**
      * Fetches all the necessary information for dab generation and
@@ -86,6 +92,22 @@ protected:
                                 KisDabCacheUtils::DabGenerationInfo *di,
                                 bool *shouldUseCache);
 
+    /**
+     * Looks up a dab with the shape described by \p di in the per-stroke
+     * shape cache. Should be called on a cache miss reported by
+     * fetchDabGenerationInfo() before generating the dab. The returned
+     * device is shared with the cache, so it must not be modified.
+     *
+     * @return null if the dab should be generated
+     */
+    KisFixedPaintDeviceSP fetchDabFromShapeCache(const KisDabCacheUtils::DabGenerationInfo &di);
+
+    /**
+     * Saves the original (not postprocessed) dab generated for \p di
+     * into the shape cache. The device must not be modified afterwards.
+     */
+    void putDabToShapeCache(const KisDabCacheUtils::DabGenerationInfo &di, KisFixedPaintDeviceSP dab);
+
 private:
     struct SavedDabParameters;
     struct DabPosition;
@@ -98,6 +120,9 @@ private:
                                                qreal lightnessStrength,
                                                MirrorProperties mirrorProperties);
 
+    inline KisDabShapeCacheKey getShapeCacheKey(const SavedDabParameters &params,
+                                                int precisionLevel) const;
+
     inline KisDabCacheBase::DabPosition
     calculateDabRect(KisBrushSP brush, const QPointF &cursorPoint,
                      KisDabShape,
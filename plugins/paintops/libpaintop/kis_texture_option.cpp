@@ -34,6 +34,7 @@
 #include <strokes/KisMaskingBrushCompositeOpBase.h>
 #include <strokes/KisMaskingBrushCompositeOpFactory.h>
 #include <kis_random_accessor_ng.h>
+#include <kis_algebra_2d.h>
 #include <KoCompositeOpRegistry.h>
 
 #include <KoCanvasResourcesIds.h>
@@ -277,22 +278,10 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
         return;
     }
 
-    QRect rect = dab->bounds();
-    KisPaintDeviceSP mask = m_maskInfo->mask();
     const QRect maskBounds = m_maskInfo->maskBounds();
 
-    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), m_cachedPaintDevice);
-    KisPaintDeviceSP maskPatch = g.device();
-
-    int x = offset.x() % maskBounds.width() - m_offsetX;
-    int y = offset.y() % maskBounds.height() - m_offsetY;
-
-    const QRect maskPatchRect = QRect(x, y, rect.width(), rect.height());
-
-    KisFillPainter fillPainter(maskPatch);
-    fillPainter.setCompositeOpId(COMPOSITE_COPY);
-    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
-    fillPainter.end();
+    const int x = offset.x() % maskBounds.width() - m_offsetX;
+    const int y = offset.y() % maskBounds.height() - m_offsetY;
 
     // Compute final strength
     qreal strength = m_strengthOption.apply(info);
@@ -339,45 +328,106 @@ void KisTextureOption::apply(KisFixedPaintDeviceSP dab, const QPoint &offset, co
                         compositeOpId, alphaChannelType, dab->pixelSize(),
                         alphaChannelOffset, strength, m_useSoftTexturing));
 
-    // Apply the mask to the dab
-    {
-        quint8 *dabIt = nullptr;
-        KisRandomConstAccessorSP maskPatchIt = maskPatch->createRandomConstAccessorNG();
+    if (const quint8 *maskData = m_maskInfo->maskData()) {
+        applyMaskData(dab, maskData, maskBounds.size(), QPoint(x, y), compositeOp.data());
+        return;
+    }
 
-        qint32 dabY = dab->bounds().y();
-        qint32 maskPatchY = maskPatchRect.y();
-        qint32 rowsRemaining = dab->bounds().height();
-        const qint32 dabRowStride = dab->bounds().width() * dab->pixelSize();
+    applyMaskDevice(dab, m_maskInfo->mask(), maskBounds, QPoint(x, y), compositeOp.data(), m_cachedPaintDevice);
+}
 
-        while (rowsRemaining > 0) {
-            qint32 dabX = dab->bounds().x();
-            qint32 maskPatchX = maskPatchRect.x();
-            const qint32 numContiguousMaskPatchRows = maskPatchIt->numContiguousRows(maskPatchY);
-            const qint32 rows = std::min(rowsRemaining, numContiguousMaskPatchRows);
-            qint32 columnsRemaining = dab->bounds().width();
+void KisTextureOption::applyMaskDevice(KisFixedPaintDeviceSP dab, KisPaintDeviceSP mask, const QRect &maskBounds,
+                                       const QPoint &maskOffset, KisMaskingBrushCompositeOpBase *compositeOp,
+                                       KisCachedPaintDevice &cachedPaintDevice)
+{
+    QRect rect = dab->bounds();
 
-            while (columnsRemaining > 0) {
-                const qint32 numContiguousMaskPatchColumns = maskPatchIt->numContiguousColumns(maskPatchX);
-                const qint32 columns = std::min(columnsRemaining, numContiguousMaskPatchColumns);
+    KisCachedPaintDevice::Guard g(mask, KoColorSpaceRegistry::instance()->alpha8(), cachedPaintDevice);
+    KisPaintDeviceSP maskPatch = g.device();
 
-                const qint32 maskPatchRowStride = maskPatchIt->rowStride(maskPatchX, maskPatchY);
+    const QRect maskPatchRect = QRect(maskOffset, rect.size());
 
-                dabIt = dab->data() + (dabY * dab->bounds().width() + dabX) * dab->pixelSize();
-                maskPatchIt->moveTo(maskPatchX, maskPatchY);
+    KisFillPainter fillPainter(maskPatch);
+    fillPainter.setCompositeOpId(COMPOSITE_COPY);
+    fillPainter.fillRect(kisGrowRect(maskPatchRect, 1), mask, maskBounds);
+    fillPainter.end();
 
-                compositeOp->composite(maskPatchIt->rawDataConst(), maskPatchRowStride,
-                                       dabIt, dabRowStride,
-                                       columns, rows);
+    quint8 *dabIt = nullptr;
+    KisRandomConstAccessorSP maskPatchIt = maskPatch->createRandomConstAccessorNG();
 
-                dabX += columns;
-                maskPatchX += columns;
-                columnsRemaining -= columns;
+    qint32 dabY = dab->bounds().y();
+    qint32 maskPatchY = maskPatchRect.y();
+    qint32 rowsRemaining = dab->bounds().height();
+    const qint32 dabRowStride = dab->bounds().width() * dab->pixelSize();
 
-            }
+    while (rowsRemaining > 0) {
+        qint32 dabX = dab->bounds().x();
+        qint32 maskPatchX = maskPatchRect.x();
+        const qint32 numContiguousMaskPatchRows = maskPatchIt->numContiguousRows(maskPatchY);
+        const qint32 rows = std::min(rowsRemaining, numContiguousMaskPatchRows);
+        qint32 columnsRemaining = dab->bounds().width();
 
-            dabY += rows;
-            maskPatchY += rows;
-            rowsRemaining -= rows;
+        while (columnsRemaining > 0) {
+            const qint32 numContiguousMaskPatchColumns = maskPatchIt->numContiguousColumns(maskPatchX);
+            const qint32 columns = std::min(columnsRemaining, numContiguousMaskPatchColumns);
+
+            const qint32 maskPatchRowStride = maskPatchIt->rowStride(maskPatchX, maskPatchY);
+
+            dabIt = dab->data() + (dabY * dab->bounds().width() + dabX) * dab->pixelSize();
+            maskPatchIt->moveTo(maskPatchX, maskPatchY);
+
+            compositeOp->composite(maskPatchIt->rawDataConst(), maskPatchRowStride,
+                                   dabIt, dabRowStride,
+                                   columns, rows);
+
+            dabX += columns;
+            maskPatchX += columns;
+            columnsRemaining -= columns;
+
+        }
+
+        dabY += rows;
+        maskPatchY += rows;
+        rowsRemaining -= rows;
+    }
+}
+
+void KisTextureOption::applyMaskData(KisFixedPaintDeviceSP dab, const quint8 *maskData, const QSize &maskSize,
+                                     const QPoint &maskOffset, KisMaskingBrushCompositeOpBase *compositeOp)
+{
+    /**
+     * The mask is a single contiguous buffer, so we just split the dab
+     * into the pieces that don't cross the borders of the pattern and
+     * compose every piece directly from the buffer. The pattern is
+     * repeated in both directions.
+     */
+
+    const QRect rect = dab->bounds();
+    const int pixelSize = dab->pixelSize();
+    const int dabRowStride = rect.width() * pixelSize;
+    const int maskRowStride = maskSize.width();
+
+    int dabY = 0;
+    int maskY = KisAlgebra2D::wrapValue(maskOffset.y(), maskSize.height());
+
+    while (dabY < rect.height()) {
+        const int rows = qMin(rect.height() - dabY, maskSize.height() - maskY);
+
+        int dabX = 0;
+        int maskX = KisAlgebra2D::wrapValue(maskOffset.x(), maskSize.width());
+
+        while (dabX < rect.width()) {
+            const int columns = qMin(rect.width() - dabX, maskSize.width() - maskX);
+
+            compositeOp->composite(maskData + maskY * maskRowStride + maskX, maskRowStride,
+                                   dab->data() + dabY * dabRowStride + dabX * pixelSize, dabRowStride,
+                                   columns, rows);
+
+            dabX += columns;
+            maskX = 0;
         }
+
+        dabY += rows;
+        maskY = 0;
     }
 }
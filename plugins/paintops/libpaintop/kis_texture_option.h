@@ -24,6 +24,7 @@ class KoPattern;
 class KoResource;
 class KisPropertiesConfiguration;
 class KisResourcesInterface;
+class KisMaskingBrushCompositeOpBase;
 
 #include <KisStandardOptions.h>
 #include <KisTextureOptionData.h>
@@ -56,6 +57,11 @@ public:
 private:
     void applyLightness(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info);
     void applyGradient(KisFixedPaintDeviceSP dab, const QPoint& offset, const KisPaintInformation& info);
+    static void applyMaskDevice(KisFixedPaintDeviceSP dab, KisPaintDeviceSP mask, const QRect &maskBounds,
+                                const QPoint &maskOffset, KisMaskingBrushCompositeOpBase *compositeOp,
+                                KisCachedPaintDevice &cachedPaintDevice);
+    static void applyMaskData(KisFixedPaintDeviceSP dab, const quint8 *maskData, const QSize &maskSize,
+                              const QPoint &maskOffset, KisMaskingBrushCompositeOpBase *compositeOp);
     void fillProperties(const KisPropertiesConfiguration *setting, KisResourcesInterfaceSP resourcesInterface, KoCanvasResourcesInterfaceSP canvasResourcesInterface);
 private:
 
@@ -73,6 +79,8 @@ private:
     KisTextureMaskInfoSP m_maskInfo;
     KisBrushTextureFlags m_flags;
     KisCachedPaintDevice m_cachedPaintDevice;
+
+    friend class KisTextureOptionTest;
 };
 
 #endif // KIS_TEXTURE_OPTION_H
@@ -11,15 +11,14 @@
 KisDynamicSensor::KisDynamicSensor(const KoID &id,
                                      const KisSensorData &data,
                                      std::optional<KisCubicCurve> curveOverride)
-    : m_id(id),
-      m_curve(curveOverride ?
-                  *curveOverride :
-                  KisCubicCurve(data.curve))
+    : m_id(id)
 {
     KIS_SAFE_ASSERT_RECOVER_NOOP(id == data.id);
 
-    if (m_curve->isIdentity()) {
-        m_curve = std::nullopt;
+    const KisCubicCurve curve = curveOverride ? *curveOverride : KisCubicCurve(data.curve);
+
+    if (!curve.isIdentity()) {
+        m_curveTransfer = curve.floatTransfer(256);
     }
 }
 
@@ -35,12 +34,11 @@ KoID KisDynamicSensor::id() const
 qreal KisDynamicSensor::parameter(const KisPaintInformation &info) const
 {
     const qreal val = value(info);
-    if (m_curve) {
+    if (!m_curveTransfer.isEmpty()) {
         qreal scaledVal = isAdditive() ? additiveToScaling(val) :
                           isAbsoluteRotation() ? KisAlgebra2D::wrapValue(val + 0.5, 0.0, 1.0) : val;
 
-        const QVector<qreal> transfer = m_curve->floatTransfer(256);
-        scaledVal = KisCubicCurve::interpolateLinear(scaledVal, transfer);
+        scaledVal = KisCubicCurve::interpolateLinear(scaledVal, m_curveTransfer);
 
         return isAdditive() ? scalingToAdditive(scaledVal) :
                isAbsoluteRotation() ? KisAlgebra2D::wrapValue(scaledVal + 0.5, 0.0, 1.0) : scaledVal;
@@ -7,6 +7,7 @@
 #define KISDYNAMICSENSOR_H
 
 #include <optional>
+#include <QVector>
 #include <kis_cubic_curve.h>
 #include <KoID.h>
 
@@ -43,7 +44,13 @@ public:
 
 private:
     KoID m_id;
-    std::optional<KisCubicCurve> m_curve;
+
+    /**
+     * The curve is sampled once when the sensor is created, so the
+     * per-dab evaluation doesn't touch the shared curve data at all.
+     * The table is empty if the curve is an identity.
+     */
+    QVector<qreal> m_curveTransfer;
 };
 
 #endif // KISDYNAMICSENSOR_H
@@ -0,0 +1,120 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisCurveOptionBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <memory>
+#include <vector>
+
+#include <KisCurveOption.h>
+#include <KisCurveOptionData.h>
+#include <kis_paint_information.h>
+
+namespace {
+
+const int NUM_DABS = 100000;
+
+// the number of options enabled in a heavy preset
+const int NUM_OPTIONS = 12;
+
+KisCurveOptionData createOptionData(int index, int numSensors, int curveMode)
+{
+    KisCurveOptionData data(KoID(QString("Option%1").arg(index)));
+    data.isChecked = true;
+    data.useCurve = true;
+    data.useSameCurve = false;
+    data.curveMode = curveMode;
+
+    // the sensors that don't need the distance information
+    KisKritaSensorData &sensors = data.sensorStruct();
+    std::vector<KisSensorData*> candidates = {
+        &sensors.sensorPressure,
+        &sensors.sensorXTilt,
+        &sensors.sensorYTilt,
+        &sensors.sensorTiltElevation,
+        &sensors.sensorTiltDirection,
+        &sensors.sensorRotation,
+        &sensors.sensorSpeed,
+        &sensors.sensorTangentialPressure,
+        &sensors.sensorPerspective
+    };
+
+    for (int i = 0; i < int(candidates.size()); i++) {
+        candidates[i]->isActive = i < numSensors;
+        candidates[i]->curve = "0,0;0.3,0.1;0.7,0.8;1,1;";
+    }
+
+    return data;
+}
+
+}
+
+void KisCurveOptionBenchmark::benchmarkComputeValue_data()
+{
+    QTest::addColumn<int>("numSensors");
+    QTest::addColumn<int>("curveMode");
+
+    Q_FOREACH (int numSensors, QVector<int>({1, 3, 9})) {
+        Q_FOREACH (int curveMode, QVector<int>({0, 2})) {
+            QTest::addRow("%d_sensors_mode_%d", numSensors, curveMode)
+                << numSensors << curveMode;
+        }
+    }
+}
+
+void KisCurveOptionBenchmark::benchmarkComputeValue()
+{
+    QFETCH(int, numSensors);
+    QFETCH(int, curveMode);
+
+    std::vector<std::unique_ptr<KisCurveOption>> options;
+    for (int i = 0; i < NUM_OPTIONS; i++) {
+        options.emplace_back(new KisCurveOption(createOptionData(i, numSensors, curveMode)));
+    }
+
+    QRandomGenerator random(42);
+
+    std::vector<KisPaintInformation> infos;
+    infos.reserve(NUM_DABS);
+
+    for (int i = 0; i < NUM_DABS; i++) {
+        infos.emplace_back(QPointF(i % 1000, i / 1000),
+                           random.generateDouble(),
+                           random.bounded(120.0) - 60.0,
+                           random.bounded(120.0) - 60.0,
+                           random.bounded(360.0),
+                           random.generateDouble(),
+                           random.generateDouble(),
+                           i,
+                           random.generateDouble());
+    }
+
+    qreal result = 0.0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QBENCHMARK_ONCE {
+        for (const KisPaintInformation &info : infos) {
+            for (const std::unique_ptr<KisCurveOption> &option : options) {
+                result += option->computeSizeLikeValue(info);
+            }
+        }
+    }
+
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    // prevent the compiler from optimizing the evaluation out
+    QVERIFY(!qIsNaN(result));
+
+    qDebug() << qPrintable(QString("%1 options: %2 ns per dab")
+                           .arg(NUM_OPTIONS)
+                           .arg(qreal(elapsed) / NUM_DABS, 0, 'f', 1));
+}
+
+SIMPLE_TEST_MAIN(KisCurveOptionBenchmark)
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISCURVEOPTIONBENCHMARK_H
+#define KISCURVEOPTIONBENCHMARK_H
+
+#include <simpletest.h>
+
+class KisCurveOptionBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkComputeValue_data();
+    void benchmarkComputeValue();
+};
+
+#endif // KISCURVEOPTIONBENCHMARK_H
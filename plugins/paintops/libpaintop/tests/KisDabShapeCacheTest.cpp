@@ -0,0 +1,99 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisDabShapeCacheTest.h"
+
+#include <KoColorSpaceRegistry.h>
+#include <kis_fixed_paint_device.h>
+
+#include <KisDabShapeCache.h>
+
+namespace {
+
+KisDabShapeCacheKey createKey(int width)
+{
+    KisDabShapeCacheKey key;
+    key.isValid = true;
+    key.width = width;
+    key.height = width;
+    key.color = KoColor(Qt::black, KoColorSpaceRegistry::instance()->rgb8());
+    return key;
+}
+
+KisFixedPaintDeviceSP createDab(int width)
+{
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dab->setRect(QRect(0, 0, width, width));
+    dab->initialize();
+    return dab;
+}
+
+}
+
+void KisDabShapeCacheTest::testFetchAndPut()
+{
+    KisDabShapeCache cache;
+
+    KisFixedPaintDeviceSP dab = createDab(10);
+
+    QVERIFY(!cache.fetch(createKey(10)));
+
+    cache.put(createKey(10), dab);
+    QCOMPARE(cache.fetch(createKey(10)), dab);
+    QVERIFY(!cache.fetch(createKey(11)));
+
+    // the color is a part of the key
+    KisDabShapeCacheKey whiteKey = createKey(10);
+    whiteKey.color = KoColor(Qt::white, KoColorSpaceRegistry::instance()->rgb8());
+    QVERIFY(!cache.fetch(whiteKey));
+
+    // invalid keys are never cached
+    cache.put(KisDabShapeCacheKey(), dab);
+    QVERIFY(!cache.fetch(KisDabShapeCacheKey()));
+
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.bytes(), qint64(10 * 10 * 4));
+    QCOMPARE(cache.hits(), 1);
+    QCOMPARE(cache.misses(), 3);
+    QCOMPARE(cache.hitRate(), 0.25);
+}
+
+void KisDabShapeCacheTest::testEvictionByCount()
+{
+    KisDabShapeCache cache(2);
+
+    cache.put(createKey(1), createDab(1));
+    cache.put(createKey(2), createDab(2));
+
+    // make the first dab the most recently used one
+    QVERIFY(cache.fetch(createKey(1)));
+
+    cache.put(createKey(3), createDab(3));
+
+    QCOMPARE(cache.size(), 2);
+    QVERIFY(cache.fetch(createKey(1)));
+    QVERIFY(!cache.fetch(createKey(2)));
+    QVERIFY(cache.fetch(createKey(3)));
+}
+
+void KisDabShapeCacheTest::testEvictionBySize()
+{
+    KisDabShapeCache cache(100, 2 * 10 * 10 * 4);
+
+    cache.put(createKey(10), createDab(10));
+    cache.put(createKey(11), createDab(10));
+    QCOMPARE(cache.size(), 2);
+
+    cache.put(createKey(12), createDab(10));
+    QCOMPARE(cache.size(), 2);
+    QCOMPARE(cache.bytes(), qint64(2 * 10 * 10 * 4));
+    QVERIFY(!cache.fetch(createKey(10)));
+
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+    QCOMPARE(cache.bytes(), qint64(0));
+}
+
+SIMPLE_TEST_MAIN(KisDabShapeCacheTest)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISDABSHAPECACHETEST_H
+#define KISDABSHAPECACHETEST_H
+
+#include <simpletest.h>
+
+class KisDabShapeCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testFetchAndPut();
+    void testEvictionByCount();
+    void testEvictionBySize();
+};
+
+#endif // KISDABSHAPECACHETEST_H
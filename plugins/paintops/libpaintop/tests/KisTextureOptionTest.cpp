@@ -0,0 +1,89 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#include "KisTextureOptionTest.h"
+
+#include <QRandomGenerator>
+
+#include <KoColorSpaceRegistry.h>
+#include <KoCompositeOpRegistry.h>
+#include <kis_fixed_paint_device.h>
+#include <kis_paint_device.h>
+#include <strokes/KisMaskingBrushCompositeOpBase.h>
+#include <strokes/KisMaskingBrushCompositeOpFactory.h>
+
+#include <kis_texture_option.h>
+
+void KisTextureOptionTest::testApplyMaskData_data()
+{
+    QTest::addColumn<QString>("compositeOpId");
+    QTest::addColumn<qreal>("scale");
+    QTest::addColumn<QPoint>("maskOffset");
+    QTest::addColumn<QSize>("dabSize");
+
+    QTest::newRow("offset") << COMPOSITE_MULT << 1.0 << QPoint(13, 7) << QSize(20, 20);
+    QTest::newRow("negative-offset") << COMPOSITE_MULT << 1.0 << QPoint(-45, -3) << QSize(30, 30);
+    QTest::newRow("wrap") << COMPOSITE_MULT << 1.0 << QPoint(90, 50) << QSize(150, 130);
+    QTest::newRow("wrap-many-tiles") << COMPOSITE_SUBTRACT << 1.0 << QPoint(0, 0) << QSize(300, 200);
+    QTest::newRow("scale-down") << COMPOSITE_MULT << 0.3 << QPoint(5, 11) << QSize(64, 64);
+    QTest::newRow("scale-min") << COMPOSITE_DARKEN << 0.01 << QPoint(-1, 1) << QSize(17, 9);
+    QTest::newRow("scale-up") << QString("height") << 2.5 << QPoint(-120, 70) << QSize(100, 100);
+}
+
+void KisTextureOptionTest::testApplyMaskData()
+{
+    QFETCH(QString, compositeOpId);
+    QFETCH(qreal, scale);
+    QFETCH(QPoint, maskOffset);
+    QFETCH(QSize, dabSize);
+
+    QRandomGenerator random(42);
+
+    // the scale of the texture only changes the size of the mask
+    const QSize maskSize(qMax(2, qRound(100 * scale)), qMax(2, qRound(60 * scale)));
+    const QRect maskBounds(QPoint(), maskSize);
+
+    QVector<quint8> maskData(maskSize.width() * maskSize.height());
+    for (quint8 &value : maskData) {
+        value = random.bounded(256);
+    }
+
+    KisPaintDeviceSP mask = new KisPaintDevice(KoColorSpaceRegistry::instance()->alpha8());
+    mask->writeBytes(maskData.constData(), maskBounds);
+
+    KisFixedPaintDeviceSP dab = new KisFixedPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dab->setRect(QRect(QPoint(), dabSize));
+    dab->initialize();
+
+    quint8 *dabData = dab->data();
+    const int dabBytes = dabSize.width() * dabSize.height() * dab->pixelSize();
+    for (int i = 0; i < dabBytes; i++) {
+        dabData[i] = random.bounded(256);
+    }
+
+    KisFixedPaintDeviceSP referenceDab = new KisFixedPaintDevice(*dab);
+
+    QScopedPointer<KisMaskingBrushCompositeOpBase> compositeOp(
+        KisMaskingBrushCompositeOpFactory::createForAlphaSrc(compositeOpId, KoChannelInfo::UINT8,
+                                                             dab->pixelSize(), 3, 0.8));
+
+    KisCachedPaintDevice cachedPaintDevice;
+    KisTextureOption::applyMaskDevice(referenceDab, mask, maskBounds, maskOffset,
+                                      compositeOp.data(), cachedPaintDevice);
+    KisTextureOption::applyMaskData(dab, maskData.constData(), maskSize, maskOffset, compositeOp.data());
+
+    const quint8 *referenceData = referenceDab->data();
+
+    for (int i = 0; i < dabBytes; i++) {
+        if (dabData[i] != referenceData[i]) {
+            const int pixel = i / dab->pixelSize();
+            QFAIL(QString("Different pixel at %1,%2: %3 (expected %4)")
+                  .arg(pixel % dabSize.width()).arg(pixel / dabSize.width())
+                  .arg(dabData[i]).arg(referenceData[i]).toLatin1());
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisTextureOptionTest)
@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#ifndef KISTEXTUREOPTIONTEST_H
+#define KISTEXTUREOPTIONTEST_H
+
+#include <simpletest.h>
+
+class KisTextureOptionTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testApplyMaskData_data();
+    void testApplyMaskData();
+};
+
+#endif // KISTEXTUREOPTIONTEST_H
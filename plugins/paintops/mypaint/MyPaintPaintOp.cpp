@@ -82,11 +82,40 @@ KisSpacingInformation KisMyPaintPaintOp::paintAt(const KisPaintInformation& info
     mypaint_brush_stroke_to(m_brush->brush(), m_surface->surface(), info.pos().x(), info.pos().y(), info.pressure(),
                            info.xTilt(), info.yTilt(), m_dtime);
 
+    if (!m_useAsynchronousRendering) {
+        m_surface->flushDabs();
+    }
+
     m_previousTime = info.currentTime();
 
     return computeSpacing(info, lodScale);
 }
 
+std::pair<int, bool> KisMyPaintPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    if (!m_surface->usesTiledRendering()) {
+        return KisPaintOp::doAsynchronousUpdate(jobs);
+    }
+
+    /**
+     * The dabs are painted right in paintAt() until the stroke
+     * requests the first asynchronous update. After that the stroke
+     * is guaranteed to request the updates until all the dabs are
+     * painted.
+     */
+    m_useAsynchronousRendering = true;
+
+    /**
+     * The jobs are queued before the next paintAt(), and the stroke
+     * adds a sequential job after them, so get_color() never reads
+     * the tiles while they are being painted
+     */
+    m_surface->addFlushJobs(jobs);
+
+    const int updatePeriod = 20;
+    return std::make_pair(updatePeriod, false);
+}
+
 KisSpacingInformation KisMyPaintPaintOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     KisSpacingInformation spacingInfo = computeSpacing(info, KisLodTransform::lodToScale(painter()->device()));
@@ -27,6 +27,8 @@ public:
     KisMyPaintPaintOp(const KisPaintOpSettingsSP settings, KisPainter * painter, KisNodeSP node, KisImageSP image);
     ~KisMyPaintPaintOp() override;
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
@@ -46,6 +48,7 @@ private:
     KisImageWSP m_image;
     double m_dtime, m_radius, m_previousTime = 0;
     bool m_isStrokeStarted;
+    bool m_useAsynchronousRendering {false};
 };
 
 #endif // KIS_MY_PAINTOP_H_
@@ -132,6 +132,12 @@ bool KisMyPaintOpSettings::paintIncremental()
     return true;
 }
 
+bool KisMyPaintOpSettings::needsAsynchronousUpdates() const
+{
+    // the dabs are painted tile-parallel in the asynchronous updates
+    return true;
+}
+
 void KisMyPaintOpSettings::resetSettings(const QStringList &preserveProperties)
 {
     QStringList allKeys = preserveProperties;
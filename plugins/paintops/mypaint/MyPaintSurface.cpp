@@ -19,6 +19,13 @@
 #include <qmath.h>
 #include <KoCompositeOpRegistry.h>
 #include <KoMixColorsOp.h>
+#include <QMap>
+#include <QSharedPointer>
+#include <kis_default_bounds_base.h>
+#include <kis_random_accessor_ng.h>
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+#include <tiles3/kis_tile_data_interface.h>
 
 using namespace std;
 
@@ -57,6 +64,21 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     // devices for mask information
     static const KoColorSpace *maskCs = KoColorSpaceRegistry::instance()->alpha8();
     m_maskDevice = KisFixedPaintDeviceSP(new KisFixedPaintDevice(maskCs));
+
+    /**
+     * When the overlay has the same color space as the device, the dabs
+     * can be painted right into the tiles of the device without copying
+     * the pixels back and forth. Selection, mirroring, channel flags and
+     * wrap-around need the per-dab path.
+     */
+    KisPaintDeviceSP device = painter->device();
+    m_useTiledRendering =
+        *m_precisePainterWrapper.overlayColorSpace() == *device->colorSpace() &&
+        device->colorSpace()->channelCount() == 4 &&
+        !painter->selection() &&
+        !painter->hasMirroring() &&
+        painter->channelFlags().isEmpty() &&
+        !device->defaultBounds()->wrapAroundMode();
 }
 
 KisMyPaintSurface::~KisMyPaintSurface()
@@ -98,6 +120,10 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
                             float * color_r, float * color_g, float * color_b, float * color_a) {
 
     MyPaintSurfaceInternal *surface = static_cast<MyPaintSurfaceInternal*>(self);
+
+    // the color is sampled from the dabs painted so far
+    surface->m_owner->flushDabs();
+
     if (surface->bitDepth == KoChannelInfo::UINT8) {
         surface->m_owner->getColorImpl<quint8>(self, x, y, radius, color_r, color_g, color_b, color_a);
     }
@@ -115,154 +141,173 @@ void KisMyPaintSurface::get_color(MyPaintSurface *self, float x, float y, float
 }
 
 
-/*GIMP's draw_dab and get_color code*/
-template <typename channelType>
-int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
-                                float color_b, float opaque, float hardness, float color_a,
-                                float aspect_ratio, float angle, float lock_alpha, float colorize) {
+KisMyPaintSurface::DabInfo::DabInfo(float _x, float _y, float _radius, float _color_r, float _color_g,
+                                    float _color_b, float _opaque, float _hardness, float _color_a,
+                                    float _aspect_ratio, float _angle, float _colorize, bool _eraser)
+    : x(_x),
+      y(_y),
+      radius(_radius),
+      color_r(_color_r),
+      color_g(_color_g),
+      color_b(_color_b),
+      color_a(_color_a),
+      opaque(_opaque),
+      eraser(_eraser),
+      outer(QPointF(_x, _y), _radius)
+{
+    one_over_radius2 = 1.0f / (radius * radius);
+    const double angle_rad = kisDegreesToRadians(_angle);
+    cs = cos(angle_rad);
+    sn = sin(angle_rad);
 
-    Q_UNUSED(self);
-    Q_UNUSED(lock_alpha);
-    const float one_over_radius2 = 1.0f / (radius * radius);
-    const double angle_rad = kisDegreesToRadians(angle);
-    const float cs = cos(angle_rad);
-    const float sn = sin(angle_rad);
-    float normal_mode;
-    float segment1_slope;
-    float segment2_slope;
-    float r_aa_start;
-
-    hardness = CLAMP (hardness, 0.0f, 1.0f);
+    hardness = CLAMP (_hardness, 0.0f, 1.0f);
     segment1_slope = -(1.0f / hardness - 1.0f);
     segment2_slope = -hardness / (1.0f - hardness);
-    aspect_ratio = max(1.0f, aspect_ratio);
+    aspect_ratio = max(1.0f, _aspect_ratio);
 
     r_aa_start = radius - 1.0f;
     r_aa_start = max(r_aa_start, 0.0f);
     r_aa_start = (r_aa_start * r_aa_start) / aspect_ratio;
 
-    normal_mode = opaque * (1.0f - colorize);
-    colorize = opaque * colorize;
+    normal_mode = opaque * (1.0f - _colorize);
+    colorize = opaque * _colorize;
 
     const QPoint pt = QPoint(x - radius - 1, y - radius - 1);
     const QSize sz = QSize(2 * (radius+1), 2 * (radius+1));
 
-    const QRect dabRectAligned = QRect(pt, sz);
-    const QPointF center = QPointF(x, y);
-
-    KisAlgebra2D::OuterCircle outer(center, radius);
-    m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
-    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
-    KisSequentialIterator it(m_dab, dabRectAligned);
+    rect = QRect(pt, sz);
+}
 
-    quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
+/*GIMP's draw_dab and get_color code*/
+template <typename channelType>
+inline bool KisMyPaintSurface::blendPixel(const DabInfo &dab, int xp, int yp, channelType *nativeArray) {
 
-    float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
-    float minValue = KoColorSpaceMathsTraits<channelType>::min;
-    bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
+    const float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
+    const float minValue = KoColorSpaceMathsTraits<channelType>::min;
 
+    if(dab.outer.fadeSq(QPoint(xp, yp)) > 1.0f) {
+        return false;
+    }
 
-    m_maskDevice->setRect(dabRectAligned);
-    m_maskDevice->lazyGrowBufferWithoutInitialization();
+    float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
 
+    if (dab.radius < 3.0) {
+        rr = calculate_rr_antialiased (xp, yp, dab.x, dab.y, dab.aspect_ratio, dab.sn, dab.cs, dab.one_over_radius2, dab.r_aa_start);
+    }
+    else {
+        rr = calculate_rr (xp, yp, dab.x, dab.y, dab.aspect_ratio, dab.sn, dab.cs, dab.one_over_radius2);
+    }
 
-    // Dmitry says that going with the pointer should be in the same order
-    // as using the sequential iterator
-    quint8* maskPointer = m_maskDevice->data();
+    base_alpha = calculate_alpha_for_rr (rr, dab.hardness, dab.segment1_slope, dab.segment2_slope);
+    alpha = base_alpha * dab.normal_mode;
 
+    // the pixels outside the mask are never written
+    if (!(alpha > minValue)) {
+        return false;
+    }
 
-    while(it.nextPixel()) {
+    b = nativeArray[0]/unitValue;
+    g = nativeArray[1]/unitValue;
+    r = nativeArray[2]/unitValue;
+    dst_alpha = nativeArray[3]/unitValue;
 
-        // first initialize to 0;
-        *maskPointer = 0;
+    if (unitValue == 1.0f) {
+        swap(b, r);
+    }
 
-        QPoint pt(it.x(), it.y());
+    a = alpha * (dab.color_a - dst_alpha) + dst_alpha;
 
-        if(outer.fadeSq(pt) > 1.0f) {
-            maskPointer++;
-            continue;
+    if (dab.eraser) {
+        alpha = 1 - (dab.opaque*base_alpha);
+        a = dst_alpha * alpha ;
+    } else {
+        if (a > 0.0f) {
+            float src_term = (alpha * dab.color_a) / a;
+            float dst_term = 1.0f - src_term;
+            r = dab.color_r * src_term + r * dst_term;
+            g = dab.color_g * src_term + g * dst_term;
+            b = dab.color_b * src_term + b * dst_term;
         }
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
+        if (dab.colorize > 0.0f && base_alpha > 0.0f) {
 
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
-        }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
-        }
+            alpha = base_alpha * dab.colorize;
+            a = alpha + dst_alpha - alpha * dst_alpha;
 
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
+            if (a > 0.0f) {
 
-        m_tempPainter->selection();
-        alpha = base_alpha * normal_mode;
+                float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
+                float out_r = r, out_g = g, out_b = b;
 
-        // set alpha to mask
-        if (alpha > minValue) {
-            *maskPointer = (quint8)(maskUnitValue);
-        }
+                float src_term = alpha / a;
+                float dst_term = 1.0f - src_term;
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+                RGBToHSL(dab.color_r, dab.color_g, dab.color_b, &pixel_h, &pixel_s, &pixel_l);
+                RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
 
-        b = nativeArray[0]/unitValue;
-        g = nativeArray[1]/unitValue;
-        r = nativeArray[2]/unitValue;
-        dst_alpha = nativeArray[3]/unitValue;
+                out_h = pixel_h;
+                out_s = pixel_s;
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
+                HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+
+                r = (float)out_r * src_term + r * dst_term;
+                g = (float)out_g * src_term + g * dst_term;
+                b = (float)out_b * src_term + b * dst_term;
+            }
         }
+    }
 
-        a = alpha * (color_a - dst_alpha) + dst_alpha;
+    if (unitValue == 1.0f) {
+        swap(b, r);
+    }
+    nativeArray[0] = KoColorSpaceMaths<float, channelType>::scaleToA(b);
+    nativeArray[1] = KoColorSpaceMaths<float, channelType>::scaleToA(g);
+    nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
+    nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
 
-        if (eraser) {
-            alpha = 1 - (opaque*base_alpha);
-            a = dst_alpha * alpha ;
-        } else {
-            if (a > 0.0f) {
-                float src_term = (alpha * color_a) / a;
-                float dst_term = 1.0f - src_term;
-                r = color_r * src_term + r * dst_term;
-                g = color_g * src_term + g * dst_term;
-                b = color_b * src_term + b * dst_term;
-            }
+    return true;
+}
 
-            if (colorize > 0.0f && base_alpha > 0.0f) {
+template <typename channelType>
+int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float radius, float color_r, float color_g,
+                                float color_b, float opaque, float hardness, float color_a,
+                                float aspect_ratio, float angle, float lock_alpha, float colorize) {
 
-                alpha = base_alpha * colorize;
-                a = alpha + dst_alpha - alpha * dst_alpha;
+    Q_UNUSED(self);
+    Q_UNUSED(lock_alpha);
 
-                if (a > 0.0f) {
+    const bool eraser = painter()->compositeOpId() == COMPOSITE_ERASE;
 
-                    float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
-                    float out_r = r, out_g = g, out_b = b;
+    const DabInfo dab(x, y, radius, color_r, color_g, color_b,
+                      opaque, hardness, color_a,
+                      aspect_ratio, angle, colorize, eraser);
 
-                    float src_term = alpha / a;
-                    float dst_term = 1.0f - src_term;
+    if (m_useTiledRendering) {
+        m_pendingDabs.push_back(dab);
+        return 1;
+    }
 
-                    RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
-                    RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
+    const QRect dabRectAligned = dab.rect;
 
-                    out_h = pixel_h;
-                    out_s = pixel_s;
+    m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
+    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
+    KisSequentialIterator it(m_dab, dabRectAligned);
 
-                    HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+    quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
 
-                    r = (float)out_r * src_term + r * dst_term;
-                    g = (float)out_g * src_term + g * dst_term;
-                    b = (float)out_b * src_term + b * dst_term;
-                }
-            }
-        }
+    m_maskDevice->setRect(dabRectAligned);
+    m_maskDevice->lazyGrowBufferWithoutInitialization();
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
-        nativeArray[0] = KoColorSpaceMaths<float, channelType>::scaleToA(b);
-        nativeArray[1] = KoColorSpaceMaths<float, channelType>::scaleToA(g);
-        nativeArray[2] = KoColorSpaceMaths<float, channelType>::scaleToA(r);
-        nativeArray[3] = KoColorSpaceMaths<float, channelType>::scaleToA(a);
 
+    // Dmitry says that going with the pointer should be in the same order
+    // as using the sequential iterator
+    quint8* maskPointer = m_maskDevice->data();
+
+
+    while(it.nextPixel()) {
+        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+
+        *maskPointer = blendPixel(dab, it.x(), it.y(), nativeArray) ? maskUnitValue : 0;
         maskPointer++;
     }
 
@@ -275,6 +320,152 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     return 1;
 }
 
+void KisMyPaintSurface::flushDabs()
+{
+    if (m_pendingDabs.empty()) return;
+
+    QVector<TileDabs> tiles;
+    QVector<QRect> dirtyRects;
+    splitDabsIntoTiles(m_pendingDabs, tiles, dirtyRects);
+
+    Q_FOREACH (const TileDabs &tile, tiles) {
+        paintTileDabs(m_pendingDabs, tile);
+    }
+
+    m_pendingDabs.clear();
+    painter()->addDirtyRects(dirtyRects);
+}
+
+void KisMyPaintSurface::addFlushJobs(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    if (m_pendingDabs.empty()) return;
+
+    struct SharedState {
+        std::vector<DabInfo> dabs;
+        QVector<TileDabs> tiles;
+        QVector<QRect> dirtyRects;
+    };
+
+    QSharedPointer<SharedState> state(new SharedState());
+    state->dabs.swap(m_pendingDabs);
+    splitDabsIntoTiles(state->dabs, state->tiles, state->dirtyRects);
+
+    for (int i = 0; i < state->tiles.size(); i++) {
+        KritaUtils::addJobConcurrent(jobs,
+            [this, state, i] () {
+                paintTileDabs(state->dabs, state->tiles[i]);
+            }
+        );
+    }
+
+    KisPainter *painter = this->painter();
+
+    KritaUtils::addJobSequential(jobs,
+        [painter, state] () {
+            painter->addDirtyRects(state->dirtyRects);
+        }
+    );
+}
+
+bool KisMyPaintSurface::usesTiledRendering() const
+{
+    return m_useTiledRendering;
+}
+
+void KisMyPaintSurface::splitDabsIntoTiles(const std::vector<DabInfo> &dabs,
+                                           QVector<TileDabs> &tiles,
+                                           QVector<QRect> &dirtyRects) const
+{
+    const QPoint offset = m_painter->device()->offset();
+    const int tileWidth = KisTileData::WIDTH;
+    const int tileHeight = KisTileData::HEIGHT;
+
+    QMap<std::pair<int, int>, int> tileIndexes;
+
+    /**
+     * Every pixel belongs to exactly one tile, so painting each tile's
+     * dabs in the queue order gives exactly the same result as painting
+     * the dabs one by one, and the tiles are independent from each other.
+     */
+    for (int i = 0; i < int(dabs.size()); i++) {
+        const QRect &rc = dabs[i].rect;
+        if (rc.isEmpty()) continue;
+
+        dirtyRects.append(rc);
+
+        const int firstRow = KisAlgebra2D::divideFloor(rc.top() - offset.y(), tileHeight);
+        const int lastRow = KisAlgebra2D::divideFloor(rc.bottom() - offset.y(), tileHeight);
+        const int firstColumn = KisAlgebra2D::divideFloor(rc.left() - offset.x(), tileWidth);
+        const int lastColumn = KisAlgebra2D::divideFloor(rc.right() - offset.x(), tileWidth);
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                auto it = tileIndexes.find(std::make_pair(row, column));
+
+                if (it == tileIndexes.end()) {
+                    it = tileIndexes.insert(std::make_pair(row, column), tiles.size());
+
+                    TileDabs tile;
+                    tile.tileRect = QRect(offset.x() + column * tileWidth,
+                                          offset.y() + row * tileHeight,
+                                          tileWidth, tileHeight);
+                    tiles.append(tile);
+                }
+
+                tiles[it.value()].dabIndexes.append(i);
+            }
+        }
+    }
+}
+
+void KisMyPaintSurface::paintTileDabs(const std::vector<DabInfo> &dabs, const TileDabs &tile)
+{
+    if (m_surface->bitDepth == KoChannelInfo::UINT8) {
+        paintTileDabsImpl<quint8>(dabs, tile);
+    }
+    else if (m_surface->bitDepth == KoChannelInfo::UINT16) {
+        paintTileDabsImpl<quint16>(dabs, tile);
+    }
+#if defined HAVE_OPENEXR
+    else if (m_surface->bitDepth == KoChannelInfo::FLOAT16) {
+        paintTileDabsImpl<half>(dabs, tile);
+    }
+#endif
+    else {
+        paintTileDabsImpl<float>(dabs, tile);
+    }
+}
+
+template <typename channelType>
+void KisMyPaintSurface::paintTileDabsImpl(const std::vector<DabInfo> &dabs, const TileDabs &tile)
+{
+    KisPaintDeviceSP device = m_painter->device();
+    KisRandomAccessorSP it = device->createRandomAccessorNG();
+    const int pixelSize = device->pixelSize();
+
+    Q_FOREACH (int index, tile.dabIndexes) {
+        const DabInfo &dab = dabs[index];
+        const QRect rc = dab.rect & tile.tileRect;
+
+        for (int y = rc.top(); y <= rc.bottom(); y++) {
+            int x = rc.left();
+
+            while (x <= rc.right()) {
+                it->moveTo(x, y);
+
+                const int columns = qMin(it->numContiguousColumns(x), rc.right() - x + 1);
+                quint8 *pixel = it->rawData();
+
+                for (int i = 0; i < columns; i++) {
+                    blendPixel(dab, x, y, reinterpret_cast<channelType*>(pixel));
+                    pixel += pixelSize;
+                    x++;
+                }
+            }
+        }
+    }
+}
+
 template <typename channelType>
 void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, float radius,
                             float * color_r, float * color_g, float * color_b, float * color_a) {
@@ -298,8 +489,15 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     const float one_over_radius2 = 1.0f / (radius * radius);
     quint32 sum_weight = 0.0f;
 
-    m_precisePainterWrapper.readRect(dabRectAligned);
-    KisPaintDeviceSP activeDev = m_precisePainterWrapper.overlay();
+    KisPaintDeviceSP activeDev;
+    if (m_useTiledRendering) {
+        // the dabs are painted right into the device
+        activeDev = painter()->device();
+    } else {
+        m_precisePainterWrapper.readRect(dabRectAligned);
+        activeDev = m_precisePainterWrapper.overlay();
+    }
+
     if(m_image) {
         //m_image->blockUpdates();
         m_backgroundPainter->device()->clear();
@@ -309,8 +507,6 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     } else if (m_imageDevice) {
         m_backgroundPainter->bitBlt(dabRectAligned.topLeft(), m_imageDevice, dabRectAligned);
         activeDev = m_backgroundPainter->device();
-    } else {
-        m_precisePainterWrapper.readRect(dabRectAligned);
     }
 
     KisSequentialIterator it(activeDev, dabRectAligned);
@@ -18,10 +18,15 @@
 #include <kis_marker_painter.h>
 #include <kis_sequential_iterator.h>
 #include <KisOverlayPaintDeviceWrapper.h>
+#include <kis_algebra_2d.h>
+
+#include <vector>
 
 #include <libmypaint/mypaint-brush.h>
 #include <libmypaint/mypaint-surface.h>
 
+class KisRunnableStrokeJobData;
+
 class KisMyPaintSurface
 {
 public:
@@ -69,6 +74,27 @@ public:
                   float sn, float cs, float one_over_radius2);
 
 
+    /**
+     * Paints all the dabs queued by draw_dab() in the tiled mode. The
+     * queue is split by the tiles of the painted device, and every
+     * tile applies its dabs in the order they were queued.
+     *
+     * The dabs are written right into the tiles of the device, so the
+     * tiled mode is used only when the device doesn't need any overlay,
+     * selection, mirroring or channel flags. Otherwise every dab is
+     * painted right in draw_dab().
+     */
+    void flushDabs();
+
+    /**
+     * Does the same as flushDabs(), but in the stroke jobs: one
+     * concurrent job per tile, followed by a sequential job that
+     * reports the dirty rects to the painter.
+     */
+    void addFlushJobs(QVector<KisRunnableStrokeJobData*> &jobs);
+
+    bool usesTiledRendering() const;
+
     KisPainter* painter();
     void paint(KoColor *color, KoColor* bgColor);
     qreal calculateOpacity(float angle, float hardness, float opaque, float x, float y,
@@ -76,6 +102,57 @@ public:
 
     MyPaintSurface* surface();
 
+private:
+    struct DabInfo {
+        DabInfo(float x, float y, float radius, float color_r, float color_g,
+                float color_b, float opaque, float hardness, float color_a,
+                float aspect_ratio, float angle, float colorize, bool eraser);
+
+        float x;
+        float y;
+        float radius;
+        float color_r;
+        float color_g;
+        float color_b;
+        float color_a;
+        float opaque;
+        float hardness;
+        float aspect_ratio;
+        float one_over_radius2;
+        float cs;
+        float sn;
+        float segment1_slope;
+        float segment2_slope;
+        float r_aa_start;
+        float normal_mode;
+        float colorize;
+        bool eraser;
+
+        QRect rect;
+        KisAlgebra2D::OuterCircle outer;
+    };
+
+    /**
+     * Blends the dab into a single pixel. Returns false and leaves the
+     * pixel untouched if the pixel is not covered by the dab.
+     */
+    template <typename channelType>
+    inline bool blendPixel(const DabInfo &dab, int xp, int yp, channelType *nativeArray);
+
+    struct TileDabs {
+        QRect tileRect;
+        QVector<int> dabIndexes;
+    };
+
+    void splitDabsIntoTiles(const std::vector<DabInfo> &dabs,
+                            QVector<TileDabs> &tiles,
+                            QVector<QRect> &dirtyRects) const;
+
+    void paintTileDabs(const std::vector<DabInfo> &dabs, const TileDabs &tile);
+
+    template <typename channelType>
+    void paintTileDabsImpl(const std::vector<DabInfo> &dabs, const TileDabs &tile);
+
 private:
     KisPainter *m_painter;
     KisPaintDeviceSP m_imageDevice;
@@ -88,6 +165,8 @@ private:
     KisFixedPaintDeviceSP m_blendDevice;
     KisFixedPaintDeviceSP m_maskDevice;
 
+    bool m_useTiledRendering = false;
+    std::vector<DabInfo> m_pendingDabs;
 };
 
 #endif // KIS_MYPAINT_SURFACE_H
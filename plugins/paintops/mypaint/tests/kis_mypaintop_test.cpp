@@ -41,6 +41,7 @@ void KisMyPaintOpTest::testDab() {
     QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, dst));
 
     surface->draw_dab(surface->surface(), 250, 250, 100, 0, 0, 1, 1, 0.8, 1, 1, 90, 0, 0);
+    surface->flushDabs();
 
     QImage img = dst->convertToQImage(0, dst->exactBounds().x(), dst->exactBounds().y(), dst->exactBounds().width(), dst->exactBounds().height());
     QImage source(QString(FILES_DATA_DIR) + QDir::separator() + "draw_dab.png");
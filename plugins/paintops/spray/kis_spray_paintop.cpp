@@ -22,6 +22,32 @@
 #include <kis_lod_transform.h>
 #include <kis_paintop_plugin_utils.h>
 #include <KoResourceLoadResult.h>
+#include <KisRunnableStrokeJobData.h>
+#include <KisRunnableStrokeJobUtils.h>
+
+namespace {
+/**
+ * The particles of a dab are split into the chunks of a fixed
+ * size, so the result doesn't depend on the number of threads
+ */
+const int particlesPerChunk = 256;
+}
+
+struct KisSprayPaintOp::DetachedDab
+{
+    SprayDabParticles particles;
+    /// the value of the opacity option for the dab
+    qreal opacity = 1.0;
+
+    /// the background and the particle chunks in the order of compositing
+    QVector<KisPaintDeviceSP> chunks;
+};
+
+struct KisSprayPaintOp::UpdateSharedState
+{
+    KisPainter *painter = 0;
+    QVector<DetachedDabSP> dabs;
+};
 
 
 KisSprayPaintOp::KisSprayPaintOp(const KisPaintOpSettingsSP settings, KisPainter *painter, KisNodeSP node, KisImageSP image)
@@ -96,13 +122,46 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
         m_dab->clear();
     }
 
+    /**
+     * After the first asynchronous update the painter is in use by the
+     * update jobs, so its opacity is not touched in paintAt() anymore
+     */
+    const bool useDetachedDab =
+        m_useAsynchronousRendering && m_sprayBrush.supportsDetachedRendering();
+
     qreal rotation = m_rotationOption.apply(info);
-    qreal origOpacity = m_opacityOption.apply(painter(), info);
+    qreal origOpacity = OPACITY_OPAQUE_F;
+    qreal detachedOpacity = OPACITY_OPAQUE_F;
+    if (useDetachedDab) {
+        detachedOpacity = m_opacityOption.apply(info);
+    } else {
+        origOpacity = m_opacityOption.apply(painter(), info);
+    }
     // Spray Brush is capable of working with zero scale,
     // so no additional checks for 'zero'ness are needed
     const qreal scale = m_sizeOption.apply(info);
     const qreal lodScale = KisLodTransform::lodToScale(painter()->device());
 
+    if (useDetachedDab) {
+        /**
+         * The particles are generated right here, because they consume
+         * the random source of the stroke, but painted later in
+         * doAsynchronousUpdate()
+         */
+        DetachedDabSP dab(new DetachedDab());
+        dab->particles = m_sprayBrush.generateParticles(m_dab,
+                                                        m_node->paintDevice(),
+                                                        info,
+                                                        rotation,
+                                                        scale, lodScale,
+                                                        painter()->paintColor(),
+                                                        painter()->backgroundColor());
+        dab->opacity = detachedOpacity;
+
+        m_pendingDabs.append(dab);
+
+        return computeSpacing(info, lodScale);
+    }
 
     m_sprayBrush.paint(m_dab,
                        m_node->paintDevice(),
@@ -120,6 +179,103 @@ KisSpacingInformation KisSprayPaintOp::paintAt(const KisPaintInformation& info)
     return computeSpacing(info, lodScale);
 }
 
+std::pair<int, bool> KisSprayPaintOp::doAsynchronousUpdate(QVector<KisRunnableStrokeJobData *> &jobs)
+{
+    if (!m_sprayBrush.supportsDetachedRendering()) {
+        return KisPaintOp::doAsynchronousUpdate(jobs);
+    }
+
+    /**
+     * The dabs are painted right in paintAt() until the stroke
+     * requests the first asynchronous update. After that the stroke
+     * is guaranteed to request the updates until all the dabs are
+     * painted.
+     */
+    m_useAsynchronousRendering = true;
+
+    const int updatePeriod = 20;
+
+    if (m_updateSharedState || m_pendingDabs.isEmpty()) {
+        return std::make_pair(updatePeriod, !m_pendingDabs.isEmpty());
+    }
+
+    m_updateSharedState = toQShared(new UpdateSharedState());
+    UpdateSharedStateSP state = m_updateSharedState;
+
+    state->painter = painter();
+    state->dabs.swap(m_pendingDabs);
+
+    const SprayBrush *sprayBrush = &m_sprayBrush;
+
+    /**
+     * Every chunk of particles is painted into its own device, so all
+     * the chunks of all the dabs can be painted concurrently
+     */
+    Q_FOREACH (DetachedDabSP dab, state->dabs) {
+        if (dab->particles.fillBackground) {
+            KisPaintDeviceSP device = source()->createCompositionSourceDevice();
+            dab->chunks.append(device);
+
+            KritaUtils::addJobConcurrent(jobs,
+                [sprayBrush, dab, device] () {
+                    sprayBrush->paintDetachedBackground(device, dab->particles);
+                }
+            );
+        }
+
+        const int numParticles = dab->particles.particles.size();
+
+        for (int begin = 0; begin < numParticles; begin += particlesPerChunk) {
+            const int end = qMin(begin + particlesPerChunk, numParticles);
+
+            KisPaintDeviceSP device = source()->createCompositionSourceDevice();
+            dab->chunks.append(device);
+
+            KritaUtils::addJobConcurrent(jobs,
+                [sprayBrush, dab, device, begin, end] () {
+                    sprayBrush->paintDetachedParticles(device, dab->particles, begin, end);
+                }
+            );
+        }
+    }
+
+    const bool useOpacityOption = m_opacityOption.isChecked();
+
+    // the dabs overlap, so they are composited strictly in order
+    KritaUtils::addJobSequential(jobs,
+        [state, useOpacityOption, this] () {
+            Q_FOREACH (DetachedDabSP dab, state->dabs) {
+                if (dab->chunks.isEmpty()) continue;
+
+                KisPaintDeviceSP dabDevice = dab->chunks.first();
+
+                if (dab->chunks.size() > 1) {
+                    KisPainter gc(dabDevice);
+                    for (int i = 1; i < dab->chunks.size(); i++) {
+                        const QRect rc = dab->chunks[i]->extent();
+                        gc.bitBlt(rc.topLeft(), dab->chunks[i], rc);
+                    }
+                }
+
+                const qreal origOpacity = state->painter->opacityF();
+                if (useOpacityOption) {
+                    state->painter->setOpacityUpdateAverage(
+                        qBound<qreal>(OPACITY_TRANSPARENT_F, origOpacity * dab->opacity, OPACITY_OPAQUE_F));
+                }
+
+                const QRect rc = dabDevice->extent();
+                state->painter->bitBlt(rc.topLeft(), dabDevice, rc);
+                state->painter->renderMirrorMask(rc, dabDevice);
+                state->painter->setOpacityF(origOpacity);
+            }
+
+            m_updateSharedState.clear();
+        }
+    );
+
+    return std::make_pair(updatePeriod, false);
+}
+
 KisSpacingInformation KisSprayPaintOp::updateSpacingImpl(const KisPaintInformation &info) const
 {
     return computeSpacing(info, KisLodTransform::lodToScale(painter()->device()));
@@ -34,6 +34,8 @@ public:
 
     static QList<KoResourceLoadResult> prepareLinkedResources(const KisPaintOpSettingsSP settings, KisResourcesInterfaceSP resourcesInterface);
 
+    std::pair<int, bool> doAsynchronousUpdate(QVector<KisRunnableStrokeJobData*> &jobs) override;
+
 protected:
 
     KisSpacingInformation paintAt(const KisPaintInformation& info) override;
@@ -45,6 +47,12 @@ protected:
 private:
     KisSpacingInformation computeSpacing(const KisPaintInformation &info, qreal lodScale) const;
 
+    struct DetachedDab;
+    typedef QSharedPointer<DetachedDab> DetachedDabSP;
+
+    struct UpdateSharedState;
+    typedef QSharedPointer<UpdateSharedState> UpdateSharedStateSP;
+
 private:
     KisSprayShapeOptionData m_shapeProperties;
     KisSprayOpOption m_sprayOpOption;
@@ -63,6 +71,10 @@ private:
     KisOpacityOption m_opacityOption;
     KisRateOption m_rateOption;
     KisNodeSP m_node;
+
+    bool m_useAsynchronousRendering {false};
+    QVector<DetachedDabSP> m_pendingDabs;
+    UpdateSharedStateSP m_updateSharedState;
 };
 
 #endif // KIS_SPRAY_PAINTOP_H_
@@ -13,6 +13,7 @@
 #include "KisSprayShapeOptionData.h"
 #include <KisOptimizedBrushOutline.h>
 #include <KisSprayOpOptionData.h>
+#include "spray_brush.h"
 
 struct KisSprayPaintOpSettings::Private
 {
@@ -66,6 +67,22 @@ bool KisSprayPaintOpSettings::paintIncremental()
     return data.paintingMode == enumPaintingMode::BUILDUP;
 }
 
+bool KisSprayPaintOpSettings::needsAsynchronousUpdates() const
+{
+    /**
+     * Only the ellipse and rectangle particles with the colors not
+     * depending on the layer are painted in the asynchronous jobs,
+     * other particles are painted right in paintAt()
+     */
+    KisSprayShapeOptionData shapeData;
+    shapeData.read(this);
+
+    KisColorOptionData colorData;
+    colorData.read(this);
+
+    return SprayBrush::supportsDetachedRendering(shapeData, colorData);
+}
+
 
 KisOptimizedBrushOutline KisSprayPaintOpSettings::brushOutline(const KisPaintInformation &info, const OutlineMode &mode, qreal alignForZoom)
 {
@@ -28,6 +28,7 @@
 #include <brushengine/kis_paint_information.h>
 #include <kis_fixed_paint_device.h>
 #include <kis_cross_device_color_sampler.h>
+#include <kis_assert.h>
 
 #include "kis_spray_paintop_settings.h"
 
@@ -94,60 +95,88 @@ void SprayBrush::paint(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                        qreal rotation, qreal scale,
                        qreal additionalScale,
                        const KoColor &color, const KoColor &bgColor)
+{
+    const SprayDabParticles particles =
+        generateParticles(dab, source, info, rotation, scale, additionalScale, color, bgColor);
+
+    paintParticles(dab, info, particles);
+}
+
+bool SprayBrush::supportsDetachedRendering() const
+{
+    return supportsDetachedRendering(*m_shapeProperties, *m_colorProperties);
+}
+
+bool SprayBrush::supportsDetachedRendering(const KisSprayShapeOptionData &shapeProperties,
+                                           const KisColorOptionData &colorProperties)
+{
+    return shapeProperties.enabled &&
+        (shapeProperties.shape == 0 || shapeProperties.shape == 1) &&
+        !colorProperties.sampleInputColor &&
+        !colorProperties.mixBgColor;
+}
+
+SprayDabParticles SprayBrush::generateParticles(KisPaintDeviceSP dab, KisPaintDeviceSP source,
+                                                const KisPaintInformation& info,
+                                                qreal rotation, qreal scale,
+                                                qreal additionalScale,
+                                                const KoColor &color, const KoColor &bgColor)
 {
     if (m_sprayOpOption->data.angularDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_uniformDistribution);
+        return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_uniformDistribution);
     } else {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_angularCurveBasedDistribution);
+        return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor, m_sprayOpOption->m_angularCurveBasedDistribution);
     }
 }
 
 template <typename AngularDistribution>
-void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
-                           const KisPaintInformation& info,
-                           qreal rotation, qreal scale,
-                           qreal additionalScale,
-                           const KoColor &color,
-                           const KoColor &bgColor,
-                           const AngularDistribution &angularDistribution)
+SprayDabParticles SprayBrush::generateParticlesImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
+                                                    const KisPaintInformation& info,
+                                                    qreal rotation, qreal scale,
+                                                    qreal additionalScale,
+                                                    const KoColor &color,
+                                                    const KoColor &bgColor,
+                                                    const AngularDistribution &angularDistribution)
 {
     if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Uniform) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_uniformDistribution);
+            return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                         angularDistribution, m_sprayOpOption->m_uniformDistribution);
         } else {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_uniformDistributionPolarDistance);
+            return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                         angularDistribution, m_sprayOpOption->m_uniformDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_Gaussian) {
         if (m_sprayOpOption->data.radialDistributionCenterBiased) {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_normalDistribution);
+            return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                         angularDistribution, m_sprayOpOption->m_normalDistribution);
         } else {
-            paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                      angularDistribution, m_sprayOpOption->m_normalDistributionPolarDistance);
+            return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                         angularDistribution, m_sprayOpOption->m_normalDistributionPolarDistance);
         }
     } else if (m_sprayOpOption->data.radialDistributionType == KisSprayOpOptionData::ParticleDistribution_ClusterBased) {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                  angularDistribution, m_sprayOpOption->m_clusterBasedDistributionPolarDistance);
+        return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                     angularDistribution, m_sprayOpOption->m_clusterBasedDistributionPolarDistance);
     } else {
-        paintImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
-                  angularDistribution, m_sprayOpOption->m_radialCurveBasedDistributionPolarDistance);
+        return generateParticlesImpl(dab, source, info, rotation, scale, additionalScale, color, bgColor,
+                                     angularDistribution, m_sprayOpOption->m_radialCurveBasedDistributionPolarDistance);
     }
 }
 
 template <typename AngularDistribution, typename RadialDistribution>
-void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
-                           const KisPaintInformation& info,
-                           qreal rotation, qreal scale,
-                           qreal additionalScale,
-                           const KoColor &color,
-                           const KoColor &bgColor,
-                           const AngularDistribution &angularDistribution,
-                           const RadialDistribution &radialDistribution)
+SprayDabParticles SprayBrush::generateParticlesImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
+                                                    const KisPaintInformation& info,
+                                                    qreal rotation, qreal scale,
+                                                    qreal additionalScale,
+                                                    const KoColor &color,
+                                                    const KoColor &bgColor,
+                                                    const AngularDistribution &angularDistribution,
+                                                    const RadialDistribution &radialDistribution)
 {
+    SprayDabParticles result;
+
     if (!angularDistribution.isValid() || !radialDistribution.isValid()) {
-        return;
+        return result;
     }
 
     KisRandomSourceSP randomSource = info.randomSource();
@@ -174,7 +203,6 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
     qreal x = info.pos().x();
     qreal y = info.pos().y();
-    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
 
     Q_ASSERT(color.colorSpace()->pixelSize() == dab->pixelSize());
     m_inkColor = color;
@@ -199,26 +227,37 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
         m_particlesCount = m_sprayOpOption->data.particleCount;
     }
 
+    result.center = QPointF(x, y);
+    result.radius = m_radius;
+    result.additionalScale = additionalScale;
+    result.effectiveSize = effectiveSize;
+
+    if (m_colorProperties->fillBackground) {
+        result.fillBackground = true;
+        result.bgColor = bgColor;
+        result.bgOpacity = m_particleOpacity;
+    }
+
     QHash<QString, QVariant> params;
     qreal nx, ny;
-    int ix, iy;
 
     qreal angle;
     qreal length;
     qreal rotationZ = 0.0;
     qreal particleScale = 1.0;
+    qreal hue = 0.0;
+    qreal saturation = 0.0;
+    qreal value = 0.0;
 
     bool shouldColor = true;
-    if (m_colorProperties->fillBackground) {
-        m_painter->setPaintColor(bgColor);
-        paintCircle(m_painter, x, y, m_radius);
-    }
 
     QTransform m;
     m.reset();
     m.rotateRadians(-rotation + deg2rad(m_sprayOpOption->data.brushRotation));
     m.scale(m_sprayOpOption->data.scale, m_sprayOpOption->data.scale);
 
+    result.particles.reserve(m_particlesCount);
+
     for (quint32 i = 0; i < m_particlesCount; i++) {
         // generate random angle
         angle = angularDistribution(randomSource) * M_PI * 2;
@@ -280,9 +319,12 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             }
 
             if (m_colorProperties->useRandomHSV && m_transfo) {
-                params["h"] = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
-                params["s"] = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
-                params["v"] = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
+                hue = (m_colorProperties->hue / 180.0) * randomSource->generateNormalized();
+                saturation = (m_colorProperties->saturation / 100.0) * randomSource->generateNormalized();
+                value = (m_colorProperties->value / 100.0) * randomSource->generateNormalized();
+                params["h"] = hue;
+                params["s"] = saturation;
+                params["v"] = value;
                 m_transfo->setParameters(params);
                 m_transfo->setParameter(3, 1);//sets the type to HSV. For some reason 0 is not an option.
                 m_transfo->setParameter(4, false);//sets the colorize to false.
@@ -292,60 +334,92 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             if (m_colorProperties->useRandomOpacity) {
                 const qreal alpha = randomSource->generateNormalized();
                 m_inkColor.setOpacity(alpha);
-                m_painter->setOpacityF(alpha);
+                m_particleOpacity = alpha;
             }
 
             if (!m_colorProperties->colorPerParticle) {
                 shouldColor = false;
             }
+        }
+
+        SprayParticle particle;
+        particle.pos = QPointF(nx + x, ny + y);
+        particle.rotationZ = rotationZ;
+        particle.particleScale = particleScale;
+        particle.jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
+        particle.jitteredHeight = qMax(1.0 * additionalScale, effectiveSize.height() * particleScale * additionalScale);
+        particle.color = m_inkColor;
+        particle.opacity = m_particleOpacity;
+        particle.hue = hue;
+        particle.saturation = saturation;
+        particle.value = value;
+
+        result.particles.append(particle);
 
-            m_painter->setPaintColor(m_inkColor);
+        if (m_colorProperties->colorPerParticle){
+            m_inkColor=color;//reset color//
         }
+    }
+    // recover from jittering of color,
+    // m_inkColor.opacity is recovered with every paint
+
+    return result;
+}
+
+void SprayBrush::paintParticles(KisPaintDeviceSP dab,
+                                const KisPaintInformation& info,
+                                const SprayDabParticles &particles)
+{
+    if (particles.fillBackground) {
+        m_painter->setOpacityF(particles.bgOpacity);
+        m_painter->setPaintColor(particles.bgColor);
+        paintCircle(m_painter, particles.center.x(), particles.center.y(), particles.radius);
+    }
+
+    KisRandomAccessorSP accessor = dab->createRandomAccessorNG();
+    int ix, iy;
 
-        qreal jitteredWidth = qMax(1.0 * additionalScale, effectiveSize.width() * particleScale * additionalScale);
-        qreal jitteredHeight = qMax(1.0 * additionalScale, effectiveSize.height() * particleScale * additionalScale);
+    const qreal additionalScale = particles.additionalScale;
+
+    for (const SprayParticle &particle : particles.particles) {
+        const qreal px = particle.pos.x();
+        const qreal py = particle.pos.y();
+
+        m_painter->setOpacityF(particle.opacity);
+        m_painter->setPaintColor(particle.color);
 
         if (m_shapeProperties->enabled){
         switch (m_shapeProperties->shape){
             // ellipse
             case 0:
-            {
-                if (effectiveSize.width() == effectiveSize.height()){
-                    paintCircle(m_painter, nx + x, ny + y, jitteredWidth * 0.5);
-                }
-                else {
-                    paintEllipse(m_painter, nx + x, ny + y, jitteredWidth * 0.5 , jitteredHeight * 0.5, rotationZ);
-                }
-                break;
-            }
             // rectangle
             case 1:
             {
-                paintRectangle(m_painter, nx + x, ny + y, qRound(jitteredWidth) , qRound(jitteredHeight), rotationZ);
+                paintShapeParticle(m_painter, particles, particle);
                 break;
             }
             // wu-particle
             case 2: {
-                paintParticle(accessor, m_inkColor, nx + x, ny + y);
+                paintParticle(accessor, particle.color, px, py);
                 break;
             }
             // pixel
             case 3: {
-                ix = qRound(nx + x);
-                iy = qRound(ny + y);
+                ix = qRound(px);
+                iy = qRound(py);
                 accessor->moveTo(ix, iy);
-                memcpy(accessor->rawData(), m_inkColor.data(), m_dabPixelSize);
+                memcpy(accessor->rawData(), particle.color.data(), m_dabPixelSize);
                 break;
             }
             case 4: {
                 if (!m_brushQImage.isNull()) {
 
                     QTransform m;
-                    m.rotate(rad2deg(rotationZ));
+                    m.rotate(rad2deg(particle.rotationZ));
                     m.scale(additionalScale, additionalScale);
 
                     if (m_shapeDynamicsProperties->randomSize) {
-                        m.scale(particleScale, particleScale);
+                        m.scale(particle.particleScale, particle.particleScale);
                     }
                     m_transformed = m_brushQImage.transformed(m, Qt::SmoothTransformation);
                     m_imageDevice->convertFromQImage(m_transformed, 0);
@@ -353,6 +427,7 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                     QRect rc = m_transformed.rect();
 
                     if (m_colorProperties->useRandomHSV && m_transfo) {
+                        setHSVParameters(particle);
 
                         for (int y = rc.y(); y < rc.y() + rc.height(); y++) {
                             for (int x = rc.x(); x < rc.x() + rc.width(); x++) {
@@ -362,8 +437,8 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                         }
                     }
 
-                    ix = qRound(nx + x - rc.width() * 0.5);
-                    iy = qRound(ny + y - rc.height() * 0.5);
+                    ix = qRound(px - rc.width() * 0.5);
+                    iy = qRound(py - rc.height() * 0.5);
                     m_painter->bitBlt(QPoint(ix, iy), m_imageDevice, rc);
                     m_imageDevice->clear();
                     break;
@@ -373,10 +448,9 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
             // Auto-brush
         }
         else {
-            KisDabShape shape(particleScale * additionalScale, 1.0, -rotationZ);
+            KisDabShape shape(particle.particleScale * additionalScale, 1.0, -particle.rotationZ);
             QPointF hotSpot = m_brush->hotSpot(shape, info);
-            QPointF pos(nx + x, ny + y);
-            QPointF pt = pos - hotSpot;
+            QPointF pt = particle.pos - hotSpot;
 
             qint32 ix;
             qreal xFraction;
@@ -394,6 +468,8 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
                           shape, info, xFraction, yFraction);
 
                 if (m_colorProperties->useRandomHSV && m_transfo) {
+                    setHSVParameters(particle);
+
                     quint8 * dabPointer = m_fixedDab->data();
                     int pixelCount = m_fixedDab->bounds().width() * m_fixedDab->bounds().height();
                     m_transfo->transform(dabPointer, dabPointer, pixelCount);
@@ -401,17 +477,73 @@ void SprayBrush::paintImpl(KisPaintDeviceSP dab, KisPaintDeviceSP source,
 
             }
             else {
-                m_brush->mask(m_fixedDab, m_inkColor, shape,
+                m_brush->mask(m_fixedDab, particle.color, shape,
                               info, xFraction, yFraction);
             }
             m_painter->bltFixed(QPoint(ix, iy), m_fixedDab, m_fixedDab->bounds());
         }
-        if (m_colorProperties->colorPerParticle){
-            m_inkColor=color;//reset color//
+    }
+}
+
+void SprayBrush::paintShapeParticle(KisPainter *painter,
+                                    const SprayDabParticles &particles,
+                                    const SprayParticle &particle) const
+{
+    const qreal px = particle.pos.x();
+    const qreal py = particle.pos.y();
+
+    if (m_shapeProperties->shape == 0) {
+        if (particles.effectiveSize.width() == particles.effectiveSize.height()){
+            paintCircle(painter, px, py, particle.jitteredWidth * 0.5);
+        }
+        else {
+            paintEllipse(painter, px, py, particle.jitteredWidth * 0.5 , particle.jitteredHeight * 0.5, particle.rotationZ);
         }
+    } else {
+        paintRectangle(painter, px, py, qRound(particle.jitteredWidth) , qRound(particle.jitteredHeight), particle.rotationZ);
     }
-    // recover from jittering of color,
-    // m_inkColor.opacity is recovered with every paint
+}
+
+void SprayBrush::paintDetachedParticles(KisPaintDeviceSP dab,
+                                        const SprayDabParticles &particles,
+                                        int begin, int end) const
+{
+    KIS_SAFE_ASSERT_RECOVER_RETURN(supportsDetachedRendering());
+
+    KisPainter painter(dab);
+    painter.setFillStyle(KisPainter::FillStyleForegroundColor);
+    painter.setMaskImageSize(particles.effectiveSize.width(), particles.effectiveSize.height());
+
+    for (int i = begin; i < end; i++) {
+        const SprayParticle &particle = particles.particles[i];
+
+        painter.setOpacityF(particle.opacity);
+        painter.setPaintColor(particle.color);
+        paintShapeParticle(&painter, particles, particle);
+    }
+}
+
+void SprayBrush::paintDetachedBackground(KisPaintDeviceSP dab,
+                                         const SprayDabParticles &particles) const
+{
+    if (!particles.fillBackground) return;
+
+    KisPainter painter(dab);
+    painter.setFillStyle(KisPainter::FillStyleForegroundColor);
+    painter.setOpacityF(particles.bgOpacity);
+    painter.setPaintColor(particles.bgColor);
+    paintCircle(&painter, particles.center.x(), particles.center.y(), particles.radius);
+}
+
+void SprayBrush::setHSVParameters(const SprayParticle &particle)
+{
+    QHash<QString, QVariant> params;
+    params["h"] = particle.hue;
+    params["s"] = particle.saturation;
+    params["v"] = particle.value;
+    m_transfo->setParameters(params);
+    m_transfo->setParameter(3, 1);
+    m_transfo->setParameter(4, false);
 }
 
 
@@ -453,7 +585,7 @@ void SprayBrush::paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor
     memcpy(writeAccessor->rawData(), pcolor.data(), m_dabPixelSize);
 }
 
-void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius)
+void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius) const
 {
     QPainterPath path;
     path.addEllipse(QPointF(x,y),radius,radius);
@@ -461,7 +593,7 @@ void SprayBrush::paintCircle(KisPainter* painter, qreal x, qreal y, qreal radius
 }
 
 
-void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle)
+void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qreal b, qreal angle) const
 {
     QPainterPath path;
     path.addEllipse(QPointF(), a, b);
@@ -472,7 +604,7 @@ void SprayBrush::paintEllipse(KisPainter* painter, qreal x, qreal y, qreal a, qr
     painter->fillPainterPath(path);
 }
 
-void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle)
+void SprayBrush::paintRectangle(KisPainter* painter, qreal x, qreal y, qreal width, qreal height, qreal angle) const
 {
     QPainterPath path;
     path.addRect(QRectF(-0.5 * width, -0.5 * height, width, height));
@@ -24,10 +24,53 @@
 
 
 #include <QImage>
+#include <QPointF>
+#include <QSize>
+#include <QVector>
 #include <kis_brush.h>
 
 class KisPaintInformation;
 
+/**
+ * A single particle of the spray dab with all its random
+ * parameters already resolved
+ */
+struct SprayParticle
+{
+    QPointF pos;
+    qreal rotationZ {0.0};
+    qreal particleScale {1.0};
+    qreal jitteredWidth {1.0};
+    qreal jitteredHeight {1.0};
+
+    KoColor color;
+    qreal opacity {1.0};
+
+    /// parameters of the random HSV transformation of the particle
+    qreal hue {0.0};
+    qreal saturation {0.0};
+    qreal value {0.0};
+};
+
+/**
+ * All the particles of a single spray dab. Generating the particles
+ * consumes the random source of the stroke, so it is done sequentially,
+ * but the particles themselves can be painted in any order.
+ */
+struct SprayDabParticles
+{
+    QPointF center;
+    qreal radius {0.0};
+    qreal additionalScale {1.0};
+    QSize effectiveSize;
+
+    bool fillBackground {false};
+    KoColor bgColor;
+    qreal bgOpacity {1.0};
+
+    QVector<SprayParticle> particles;
+};
+
 class SprayBrush
 {
 
@@ -51,12 +94,63 @@ public:
 
     void setFixedDab(KisFixedPaintDeviceSP dab);
 
+    /**
+     * @return true if the particles can be painted with
+     * paintDetachedParticles(), that is, the particles are
+     * ellipses or rectangles painted with a painter and their
+     * colors don't depend on the pixels of the layer
+     */
+    bool supportsDetachedRendering() const;
+
+    /**
+     * The same as supportsDetachedRendering(), but for the options
+     * that are not loaded into a brush yet
+     *
+     * The colors sampled from the layer or mixed with the background
+     * are computed when the particles are generated, so with detached
+     * rendering they would not see the dabs which are still waiting
+     * for the asynchronous update.
+     */
+    static bool supportsDetachedRendering(const KisSprayShapeOptionData &shapeProperties,
+                                          const KisColorOptionData &colorProperties);
+
+    /**
+     * Generates the particles of the dab without painting them. The dab
+     * device is used only to initialize the color space specific data.
+     */
+    SprayDabParticles generateParticles(KisPaintDeviceSP dab,
+                                        KisPaintDeviceSP source,
+                                        const KisPaintInformation& info,
+                                        qreal rotation,
+                                        qreal scale,
+                                        qreal additionalScale,
+                                        const KoColor &color,
+                                        const KoColor &bgColor);
+
+    /**
+     * Paints particles [begin, end) into \p dab. The method uses its
+     * own painter, so it can be called concurrently for different
+     * devices. Should be used only if supportsDetachedRendering() is true.
+     */
+    void paintDetachedParticles(KisPaintDeviceSP dab,
+                                const SprayDabParticles &particles,
+                                int begin, int end) const;
+
+    /**
+     * Paints the background circle of the dab (if it is needed) into \p dab.
+     * Can be called concurrently for different devices.
+     */
+    void paintDetachedBackground(KisPaintDeviceSP dab,
+                                 const SprayDabParticles &particles) const;
+
 private:
     int m_dabSeqNo {0};
     KoColor m_inkColor;
     qreal m_radius {1.0};
     quint32 m_particlesCount {1};
     quint8 m_dabPixelSize {1};
+    /// the opacity of the last colored particle, the background is painted with it
+    qreal m_particleOpacity {1.0};
 
     KisPainter * m_painter {nullptr};
     KisPaintDeviceSP m_imageDevice;
@@ -76,33 +170,43 @@ private:
 
 private:
     template <typename AngularDistribution>
-    void paintImpl(KisPaintDeviceSP dab,
-                   KisPaintDeviceSP source,
-                   const KisPaintInformation& info,
-                   qreal rotation,
-                   qreal scale,
-                   qreal additionalScale,
-                   const KoColor &color,
-                   const KoColor &bgColor,
-                   const AngularDistribution &angularDistribution);
+    SprayDabParticles generateParticlesImpl(KisPaintDeviceSP dab,
+                                            KisPaintDeviceSP source,
+                                            const KisPaintInformation& info,
+                                            qreal rotation,
+                                            qreal scale,
+                                            qreal additionalScale,
+                                            const KoColor &color,
+                                            const KoColor &bgColor,
+                                            const AngularDistribution &angularDistribution);
     template <typename AngularDistribution, typename RadialDistribution>
-    void paintImpl(KisPaintDeviceSP dab,
-                   KisPaintDeviceSP source,
-                   const KisPaintInformation& info,
-                   qreal rotation,
-                   qreal scale,
-                   qreal additionalScale,
-                   const KoColor &color,
-                   const KoColor &bgColor,
-                   const AngularDistribution &angularDistribution,
-                   const RadialDistribution &radialDistribution);
+    SprayDabParticles generateParticlesImpl(KisPaintDeviceSP dab,
+                                            KisPaintDeviceSP source,
+                                            const KisPaintInformation& info,
+                                            qreal rotation,
+                                            qreal scale,
+                                            qreal additionalScale,
+                                            const KoColor &color,
+                                            const KoColor &bgColor,
+                                            const AngularDistribution &angularDistribution,
+                                            const RadialDistribution &radialDistribution);
+
+    /// paints the generated particles into the dab one by one
+    void paintParticles(KisPaintDeviceSP dab,
+                        const KisPaintInformation& info,
+                        const SprayDabParticles &particles);
+    /// paints an ellipse or a rectangle particle
+    void paintShapeParticle(KisPainter *painter,
+                            const SprayDabParticles &particles,
+                            const SprayParticle &particle) const;
+    void setHSVParameters(const SprayParticle &particle);
     /// rotation in radians according the settings (gauss distribution, uniform distribution or fixed angle)
     qreal rotationAngle(KisRandomSourceSP randomSource);
     /// Paints Wu Particle
     void paintParticle(KisRandomAccessorSP &writeAccessor, const KoColor &color, qreal rx, qreal ry);
-    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius);
-    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle);
-    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle);
+    void paintCircle(KisPainter * painter, qreal x, qreal y, qreal radius) const;
+    void paintEllipse(KisPainter * painter, qreal x, qreal y, qreal a, qreal b, qreal angle) const;
+    void paintRectangle(KisPainter * painter, qreal x, qreal y, qreal width, qreal height, qreal angle) const;
 
     void paintOutline(KisPaintDeviceSP dev, const KoColor& painterColor, qreal posX, qreal posY, qreal radius);
 
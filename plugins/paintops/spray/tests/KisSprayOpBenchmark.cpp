@@ -0,0 +1,170 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSprayOpBenchmark.h"
+
+#include "kistest.h"
+
+#include <QThread>
+
+#include <stroke_testing_utils.h>
+#include <KisAsynchronousStrokeUpdateHelper.h>
+#include <KisGlobalResourcesInterface.h>
+#include <strokes/KisFreehandStrokeInfo.h>
+#include <strokes/freehand_stroke.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_registry.h>
+#include <brushengine/kis_paintop_settings.h>
+#include <KoCanvasResourcesIds.h>
+#include <kis_image.h>
+
+
+namespace {
+const int IMAGE_SIZE = 3000;
+const int DAB_STEP = 400;
+}
+
+class SprayBenchmarkTester : public utils::StrokeTester
+{
+public:
+    SprayBenchmarkTester(int shape, int particleCount)
+        : StrokeTester("spray_benchmark", QSize(IMAGE_SIZE, IMAGE_SIZE), QString()),
+          m_shape(shape),
+          m_particleCount(particleCount)
+    {
+    }
+
+    void setCpuCoresLimit(int value) {
+        m_cpuCoresLimit = value;
+    }
+
+    int numDabs() const {
+        const int dabsPerRow = (IMAGE_SIZE - DAB_STEP) / DAB_STEP + 1;
+        return dabsPerRow * dabsPerRow;
+    }
+
+protected:
+    using utils::StrokeTester::initImage;
+    void initImage(KisImageWSP image, KisNodeSP activeNode) override {
+        Q_UNUSED(activeNode);
+
+        if (m_cpuCoresLimit > 0) {
+            image->setWorkingThreadsLimit(m_cpuCoresLimit);
+        }
+    }
+
+    using utils::StrokeTester::modifyResourceManager;
+    void modifyResourceManager(KoCanvasResourceProvider *manager, KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisPaintOpPresetSP preset =
+            KisPaintOpRegistry::instance()->defaultPreset(KoID("spraybrush"),
+                                                          KisGlobalResourcesInterface::instance());
+
+        KisPaintOpSettingsSP settings = preset->settings();
+
+        // the particle count is fixed, so the throughput is easy to compute
+        settings->setProperty("Spray/diameter", 300);
+        settings->setProperty("Spray/aspect", 1.0);
+        settings->setProperty("Spray/scale", 1.0);
+        settings->setProperty("Spray/spacing", 0.5);
+        settings->setProperty("Spray/useDensity", false);
+        settings->setProperty("Spray/particleCount", m_particleCount);
+        settings->setProperty("Spray/radialDistributionType", "uniform");
+
+        settings->setProperty("SprayShape/enabled", true);
+        settings->setProperty("SprayShape/shape", m_shape);
+        settings->setProperty("SprayShape/width", 8);
+        settings->setProperty("SprayShape/height", 8);
+        settings->setProperty("SprayShape/proportional", false);
+
+        QVariant i;
+        i.setValue(preset);
+        manager->setResource(KoCanvasResource::CurrentPaintOpPreset, i);
+    }
+
+    KisStrokeStrategy* createStroke(KisResourcesSnapshotSP resources,
+                                    KisImageWSP image) override {
+        Q_UNUSED(image);
+
+        KisFreehandStrokeInfo *strokeInfo = new KisFreehandStrokeInfo();
+
+        QScopedPointer<FreehandStrokeStrategy> stroke(
+            new FreehandStrokeStrategy(resources, strokeInfo, kundo2_noi18n("Freehand Stroke")));
+
+        return stroke.take();
+    }
+
+    using utils::StrokeTester::addPaintingJobs;
+    void addPaintingJobs(KisImageWSP image, KisResourcesSnapshotSP resources) override {
+        Q_UNUSED(resources);
+
+        // every job paints exactly one dab, a flush after each row
+        // makes the asynchronous updates happen in the middle of the stroke
+        for (int y = DAB_STEP / 2; y < IMAGE_SIZE - DAB_STEP / 2; y += DAB_STEP) {
+            for (int x = DAB_STEP / 2; x < IMAGE_SIZE - DAB_STEP / 2; x += DAB_STEP) {
+                KisPaintInformation pi(QPointF(x, y), 1.0);
+                image->addJob(strokeId(), new FreehandStrokeStrategy::Data(0, pi));
+            }
+            image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(false));
+        }
+
+        image->addJob(strokeId(), new KisAsynchronousStrokeUpdateHelper::UpdateData(true));
+    }
+
+private:
+    int m_shape = 0;
+    int m_particleCount = 1000;
+    int m_cpuCoresLimit = -1;
+};
+
+void KisSprayOpBenchmark::benchmarkParticles_data()
+{
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<int>("particleCount");
+
+    const QVector<std::pair<int, QString>> shapes = {
+        {0, "ellipse"},
+        {1, "rectangle"}
+    };
+
+    for (const auto &shape : shapes) {
+        Q_FOREACH (int count, QVector<int>({1000, 10000})) {
+            QTest::addRow("%s_%d", shape.second.toLatin1().data(), count)
+                << shape.first << count;
+        }
+    }
+}
+
+void KisSprayOpBenchmark::benchmarkParticles()
+{
+    QFETCH(int, shape);
+    QFETCH(int, particleCount);
+
+    SprayBenchmarkTester tester(shape, particleCount);
+
+    QVector<int> coresLimits;
+    for (int cores = 1; cores < QThread::idealThreadCount(); cores *= 2) {
+        coresLimits << cores;
+    }
+    coresLimits << QThread::idealThreadCount();
+
+    Q_FOREACH (int cores, coresLimits) {
+        tester.setCpuCoresLimit(cores);
+        tester.benchmark();
+
+        const qreal particlesPerSecond =
+            qreal(tester.numDabs()) * particleCount / qMax(1, tester.lastStrokeTime()) * 1000.0;
+
+        qDebug() << qPrintable(QString("Cores: %1 Time: %2 (ms) Particles/s: %3")
+                               .arg(cores)
+                               .arg(tester.lastStrokeTime())
+                               .arg(particlesPerSecond, 0, 'f', 0));
+    }
+}
+
+KISTEST_MAIN(KisSprayOpBenchmark)
@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSPRAYOPBENCHMARK_H
+#define KISSPRAYOPBENCHMARK_H
+
+#include <QtTest>
+
+class KisSprayOpBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void benchmarkParticles();
+    void benchmarkParticles_data();
+};
+
+#endif // KISSPRAYOPBENCHMARK_H
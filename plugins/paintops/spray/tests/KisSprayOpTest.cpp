@@ -0,0 +1,171 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisSprayOpTest.h"
+
+#include "kistest.h"
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+#include <KisRunnableStrokeJobData.h>
+#include <brushengine/kis_paint_information.h>
+#include <brushengine/kis_paintop.h>
+#include <brushengine/kis_paintop_preset.h>
+#include <brushengine/kis_paintop_registry.h>
+#include <brushengine/kis_paintop_settings.h>
+#include <brushengine/kis_random_source.h>
+#include <kis_distance_information.h>
+#include <kis_image.h>
+#include <kis_paint_layer.h>
+#include <kis_painter.h>
+#include <testutil.h>
+
+
+namespace {
+
+KisPaintOpPresetSP createPreset(int shape, bool fillBackground)
+{
+    KisPaintOpPresetSP preset =
+        KisPaintOpRegistry::instance()->defaultPreset(KoID("spraybrush"),
+                                                      KisGlobalResourcesInterface::instance());
+
+    KisPaintOpSettingsSP settings = preset->settings();
+
+    settings->setProperty("Spray/diameter", 100);
+    settings->setProperty("Spray/aspect", 1.0);
+    settings->setProperty("Spray/scale", 1.0);
+    settings->setProperty("Spray/spacing", 0.5);
+    settings->setProperty("Spray/useDensity", false);
+    // more than one chunk of particles per dab
+    settings->setProperty("Spray/particleCount", 600);
+
+    settings->setProperty("SprayShape/enabled", true);
+    settings->setProperty("SprayShape/shape", shape);
+    settings->setProperty("SprayShape/width", 6);
+    settings->setProperty("SprayShape/height", 6);
+    settings->setProperty("SprayShape/proportional", false);
+
+    settings->setProperty("ColorOption/fillBackground", fillBackground);
+    settings->setProperty("ColorOption/useRandomOpacity", true);
+    settings->setProperty("ColorOption/sampleInputColor", false);
+    settings->setProperty("ColorOption/mixBgColor", false);
+
+    return preset;
+}
+
+/**
+ * Runs the jobs in the order they were added, which is one of the
+ * orders the strokes framework may run them in
+ */
+void runJobs(QVector<KisRunnableStrokeJobData*> &jobs)
+{
+    Q_FOREACH (KisRunnableStrokeJobData *job, jobs) {
+        job->run();
+        delete job;
+    }
+    jobs.clear();
+}
+
+bool doAsynchronousUpdate(KisPainter &gc)
+{
+    QVector<KisRunnableStrokeJobData*> jobs;
+    bool needsMoreUpdates = false;
+    std::tie(std::ignore, needsMoreUpdates) = gc.paintOp()->doAsynchronousUpdate(jobs);
+
+    const bool hasJobs = !jobs.isEmpty();
+    runJobs(jobs);
+
+    return hasJobs || needsMoreUpdates;
+}
+
+KisPaintDeviceSP paintStroke(KisPaintOpPresetSP preset, bool asynchronous)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    KisImageSP image = new KisImage(0, 500, 200, cs, "spray test");
+    KisPaintLayerSP layer = new KisPaintLayer(image, "paint1", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    KisPainter gc(layer->paintDevice());
+    gc.setPaintColor(KoColor(Qt::red, cs));
+    gc.setBackgroundColor(KoColor(Qt::blue, cs));
+    gc.setPaintOpPreset(preset, layer, image);
+
+    if (asynchronous) {
+        // the first request switches the paintop into the asynchronous mode
+        doAsynchronousUpdate(gc);
+    }
+
+    // both strokes consume the same random sequence
+    KisRandomSourceSP randomSource = new KisRandomSource(1234);
+    KisDistanceInformation dist;
+
+    for (int i = 0; i < 10; i++) {
+        KisPaintInformation pi(QPointF(50 + 40 * i, 100), 0.5 + 0.05 * i);
+        pi.setRandomSource(randomSource);
+        gc.paintAt(pi, &dist);
+
+        // the dabs overlap, some of them are composited in the middle of the stroke
+        if (asynchronous && i % 3 == 2) {
+            doAsynchronousUpdate(gc);
+        }
+    }
+
+    if (asynchronous) {
+        while (doAsynchronousUpdate(gc));
+    }
+
+    return layer->paintDevice();
+}
+
+}
+
+void KisSprayOpTest::testAsynchronousRendering_data()
+{
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<bool>("fillBackground");
+
+    QTest::newRow("ellipse") << 0 << false;
+    QTest::newRow("rectangle") << 1 << false;
+    QTest::newRow("ellipse-background") << 0 << true;
+}
+
+void KisSprayOpTest::testAsynchronousRendering()
+{
+    QFETCH(int, shape);
+    QFETCH(bool, fillBackground);
+
+    KisPaintOpPresetSP preset = createPreset(shape, fillBackground);
+    QVERIFY(preset->settings()->needsAsynchronousUpdates());
+
+    KisPaintDeviceSP syncDevice = paintStroke(preset, false);
+    KisPaintDeviceSP asyncDevice = paintStroke(preset, true);
+
+    const QRect rc = syncDevice->exactBounds() | asyncDevice->exactBounds();
+    QVERIFY(!rc.isEmpty());
+
+    QPoint errpoint;
+    QVERIFY(TestUtil::compareQImages(errpoint,
+                                     syncDevice->convertToQImage(0, rc),
+                                     asyncDevice->convertToQImage(0, rc), 1, 1));
+}
+
+void KisSprayOpTest::testNoAsynchronousUpdatesForLayerColors()
+{
+    KisPaintOpPresetSP preset = createPreset(0, false);
+    QVERIFY(preset->settings()->needsAsynchronousUpdates());
+
+    // the colors are taken from the layer when the particles are generated
+    preset->settings()->setProperty("ColorOption/sampleInputColor", true);
+    QVERIFY(!preset->settings()->needsAsynchronousUpdates());
+
+    preset->settings()->setProperty("ColorOption/sampleInputColor", false);
+    preset->settings()->setProperty("ColorOption/mixBgColor", true);
+    QVERIFY(!preset->settings()->needsAsynchronousUpdates());
+}
+
+KISTEST_MAIN(KisSprayOpTest)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISSPRAYOPTEST_H
+#define KISSPRAYOPTEST_H
+
+#include <QtTest>
+
+class KisSprayOpTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+
+    void testAsynchronousRendering();
+    void testAsynchronousRendering_data();
+
+    void testNoAsynchronousUpdatesForLayerColors();
+};
+
+#endif // KISSPRAYOPTEST_H
@@ -0,0 +1,68 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 The Krita Team
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __MULTIARCH_TEST_UTIL_H
+#define __MULTIARCH_TEST_UTIL_H
+
+#include <QString>
+
+#include <KoMultiArchBuildSupport.h>
+
+
+namespace TestUtil {
+
+/**
+ * Calls FactoryType::create<_impl>() for the architecture \p archName
+ * (one of KisSupportedArchitectures::availableArchNames()) instead of
+ * the best one chosen by createOptimizedClass(), so that the benchmarks
+ * could compare the architectures side by side.
+ *
+ * The per-arch specializations of the libraries are not exported, so
+ * the factory should be compiled for all the architectures by the
+ * benchmark itself (ko_compile_for_all_implementations()). Unknown
+ * names fall back to the scalar version.
+ */
+template<class FactoryType, class... Args>
+auto createClassForArch(const QString &archName, Args &&...param)
+{
+#ifdef HAVE_XSIMD
+#ifdef Q_PROCESSOR_X86
+    if (archName == QLatin1String(xsimd::fma3<xsimd::avx2>::name())) {
+        return FactoryType::template create<xsimd::fma3<xsimd::avx2>>(
+            std::forward<Args>(param)...);
+    } else if (archName == QLatin1String(xsimd::avx::name())) {
+        return FactoryType::template create<xsimd::avx>(
+            std::forward<Args>(param)...);
+    } else if (archName == QLatin1String(xsimd::sse4_1::name())) {
+        return FactoryType::template create<xsimd::sse4_1>(
+            std::forward<Args>(param)...);
+    } else if (archName == QLatin1String(xsimd::ssse3::name())) {
+        return FactoryType::template create<xsimd::ssse3>(
+            std::forward<Args>(param)...);
+    } else if (archName == QLatin1String(xsimd::sse2::name())) {
+        return FactoryType::template create<xsimd::sse2>(
+            std::forward<Args>(param)...);
+    }
+#elif XSIMD_WITH_NEON64
+    if (archName == QLatin1String(xsimd::neon64::name())) {
+        return FactoryType::template create<xsimd::neon64>(
+            std::forward<Args>(param)...);
+    }
+#elif XSIMD_WITH_NEON
+    if (archName == QLatin1String(xsimd::neon::name())) {
+        return FactoryType::template create<xsimd::neon>(
+            std::forward<Args>(param)...);
+    }
+#endif
+#endif // HAVE_XSIMD
+
+    return FactoryType::template create<xsimd::generic>(
+        std::forward<Args>(param)...);
+}
+
+}
+
+#endif /* __MULTIARCH_TEST_UTIL_H */